@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace carla {
@@ -58,6 +59,15 @@ namespace detail {
       _list = std::make_shared<ListT>();
     }
 
+    /// Replaces the list by @a list and returns the previous one, no
+    /// modification can happen in between.
+    std::shared_ptr<const ListT> Exchange(ListT list) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto previous = Load();
+      _list = std::make_shared<ListT>(std::move(list));
+      return previous;
+    }
+
     /// Returns a pointer to the list.
     std::shared_ptr<const ListT> Load() const {
       return _list.load();
@@ -0,0 +1,288 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/BufferPool.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace carla {
+
+  // ===========================================================================
+  // -- Size classes -----------------------------------------------------------
+  // ===========================================================================
+
+  constexpr size_t BufferPool::NUMBER_OF_SIZE_CLASSES;
+
+  static constexpr size_t MIN_CLASS_SIZE = 1024u;
+
+  static constexpr size_t CLASSES_PER_POWER_OF_TWO = 4u;
+
+  /// Capacity of the buffers allocated for the size class @a index. The first
+  /// class holds the buffers smaller than MIN_CLASS_SIZE, which are not
+  /// allocated by the pool and only serve pops without a size.
+  static size_t GetClassSize(size_t index) {
+    if (index == 0u) {
+      return 0u;
+    }
+    --index;
+    const size_t base = MIN_CLASS_SIZE << (index / CLASSES_PER_POWER_OF_TWO);
+    return base + (index % CLASSES_PER_POWER_OF_TWO) * (base / CLASSES_PER_POWER_OF_TWO);
+  }
+
+  /// Biggest size class whose size is not greater than @a capacity, a buffer of
+  /// this capacity can serve any pop of this class.
+  static size_t GetFloorClass(size_t capacity) {
+    if (capacity < MIN_CLASS_SIZE) {
+      return 0u;
+    }
+    size_t power = 0u;
+    while ((capacity >> power) >= (MIN_CLASS_SIZE << 1u)) {
+      ++power;
+    }
+    const size_t base = MIN_CLASS_SIZE << power;
+    const size_t step = base / CLASSES_PER_POWER_OF_TWO;
+    return 1u + power * CLASSES_PER_POWER_OF_TWO + (capacity - base) / step;
+  }
+
+  /// Smallest size class whose size is not lower than @a size, never the class
+  /// of the small buffers.
+  static size_t GetCeilClass(size_t size) {
+    const size_t index = (std::max<size_t>)(GetFloorClass(size), 1u);
+    return GetClassSize(index) < size ? index + 1u : index;
+  }
+
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Ask the kernel to back the 2MB-aligned part of the block with
+  /// transparent huge pages. The pages are not touched yet, so they are
+  /// faulted directly as huge pages.
+  static void AdviseHugePages(unsigned char *data, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    constexpr uintptr_t huge_page_size = 2u * 1024u * 1024u;
+    const auto address = reinterpret_cast<uintptr_t>(data);
+    const uintptr_t begin = (address + huge_page_size - 1u) & ~(huge_page_size - 1u);
+    const uintptr_t end = (address + size) & ~(huge_page_size - 1u);
+    if (end > begin) {
+      // We don't care if it fails, huge pages are only a hint.
+      ::madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#else
+    (void)data;
+    (void)size;
+#endif
+  }
+
+  // ===========================================================================
+  // -- BufferPool -------------------------------------------------------------
+  // ===========================================================================
+
+  BufferPool::~BufferPool() {
+    Clear();
+  }
+
+  size_t BufferPool::GetAllocationSize(size_t size) {
+    const size_t index = GetCeilClass(size);
+    return index < NUMBER_OF_SIZE_CLASSES ? GetClassSize(index) : size;
+  }
+
+  Buffer BufferPool::Pop() {
+    Buffer item;
+    const size_t index = _last_class.load(std::memory_order_relaxed);
+    Track(TryPop(index, item));
+#if __cplusplus >= 201703L // C++17
+    item._parent_pool = weak_from_this();
+#else
+    item._parent_pool = shared_from_this();
+#endif
+    return item;
+  }
+
+  Buffer BufferPool::Pop(size_t size) {
+    if (size > Buffer::max_size()) {
+      throw_exception(std::invalid_argument("message size too big"));
+    }
+    Buffer item;
+    const size_t index = GetCeilClass(size);
+    bool hit = false;
+    // A buffer of the next class up is still a good fit, it wastes at most a
+    // class step.
+    for (auto i = index; !hit && (i < (std::min)(index + 2u, NUMBER_OF_SIZE_CLASSES)); ++i) {
+      hit = TryPop(i, item) && (item.capacity() >= size);
+    }
+    if (!hit) {
+      Allocate(item, GetAllocationSize(size));
+    }
+    Track(hit);
+    item._size = static_cast<Buffer::size_type>(size);
+#if __cplusplus >= 201703L // C++17
+    item._parent_pool = weak_from_this();
+#else
+    item._parent_pool = shared_from_this();
+#endif
+    return item;
+  }
+
+  void BufferPool::Trim() {
+    TrimIdle(Now(), false);
+  }
+
+  void BufferPool::Clear() {
+    TrimIdle(Now(), true);
+  }
+
+  BufferPoolStatistics BufferPool::GetStatistics() const {
+    BufferPoolStatistics result;
+    result.hits = _counters.hits;
+    result.misses = _counters.misses;
+    result.discarded = _counters.discarded;
+    result.trimmed = _counters.trimmed;
+    result.buffers_resident = _counters.buffers_resident;
+    result.bytes_resident = _counters.bytes_resident;
+    return result;
+  }
+
+  BufferPoolStatistics BufferPool::GetGlobalStatistics() {
+    auto &counters = GlobalCounters();
+    BufferPoolStatistics result;
+    result.hits = counters.hits;
+    result.misses = counters.misses;
+    result.discarded = counters.discarded;
+    result.trimmed = counters.trimmed;
+    result.buffers_resident = counters.buffers_resident;
+    result.bytes_resident = counters.bytes_resident;
+    return result;
+  }
+
+  BufferPool::Counters &BufferPool::GlobalCounters() {
+    static Counters counters;
+    return counters;
+  }
+
+  bool BufferPool::TryPop(size_t index, Buffer &buffer) {
+    DEBUG_ASSERT(index < NUMBER_OF_SIZE_CLASSES);
+    auto &size_class = _classes[index];
+    const auto now = Now();
+    size_class.last_used.store(now, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(size_class.mutex);
+      if (!size_class.buffers.empty()) {
+        buffer = std::move(size_class.buffers.back());
+        size_class.buffers.pop_back();
+      }
+    }
+    if (buffer.capacity() > 0u) {
+      AddResident(-1, -static_cast<int64_t>(buffer.capacity()));
+    }
+    if (_settings.trim_after.milliseconds() > 0u) {
+      // Check the other classes a few times per trimming period.
+      const auto period = static_cast<int64_t>(_settings.trim_after.milliseconds() / 4u);
+      auto last_trim = _last_trim.load(std::memory_order_relaxed);
+      if ((now - last_trim > period) &&
+          _last_trim.compare_exchange_strong(last_trim, now)) {
+        TrimIdle(now, false);
+      }
+    }
+    return buffer.capacity() > 0u;
+  }
+
+  void BufferPool::Push(Buffer &&buffer) {
+    const size_t capacity = buffer.capacity();
+    const size_t index = GetFloorClass(capacity);
+    bool keep = index < NUMBER_OF_SIZE_CLASSES;
+    if (keep && (_settings.max_resident_bytes > 0u)) {
+      keep = (_counters.bytes_resident + capacity) <= _settings.max_resident_bytes;
+    }
+    if (keep) {
+      auto &size_class = _classes[index];
+      // The pooled buffer must not come back here when released by Trim.
+      buffer._parent_pool.reset();
+      std::lock_guard<std::mutex> lock(size_class.mutex);
+      if (size_class.buffers.size() < _settings.max_buffers_per_class) {
+        size_class.buffers.emplace_back(std::move(buffer));
+        size_class.last_used.store(Now(), std::memory_order_relaxed);
+        _last_class.store(index, std::memory_order_relaxed);
+        AddResident(1, static_cast<int64_t>(capacity));
+        return;
+      }
+    }
+    ++_counters.discarded;
+    ++GlobalCounters().discarded;
+    buffer.clear();
+  }
+
+  void BufferPool::Allocate(Buffer &buffer, size_t size) const {
+    log_debug("buffer pool: allocating buffer of", size, "bytes");
+    buffer._data.reset(new Buffer::value_type[size]);
+    buffer._capacity = static_cast<Buffer::size_type>(size);
+    if ((_settings.huge_page_threshold > 0u) && (size >= _settings.huge_page_threshold)) {
+      AdviseHugePages(buffer._data.get(), size);
+    }
+  }
+
+  void BufferPool::TrimIdle(int64_t now, bool force) {
+    const auto idle = static_cast<int64_t>(_settings.trim_after.milliseconds());
+    if (!force && (idle == 0)) {
+      return;
+    }
+    size_t buffers = 0u;
+    size_t bytes = 0u;
+    for (auto &size_class : _classes) {
+      if (force || (now - size_class.last_used.load(std::memory_order_relaxed) > idle)) {
+        Release(size_class, buffers, bytes);
+      }
+    }
+    if (buffers > 0u) {
+      log_debug("buffer pool: released", buffers, "buffers,", bytes, "bytes");
+      _counters.trimmed += buffers;
+      GlobalCounters().trimmed += buffers;
+      AddResident(-static_cast<int64_t>(buffers), -static_cast<int64_t>(bytes));
+    }
+  }
+
+  void BufferPool::Release(SizeClass &size_class, size_t &buffers, size_t &bytes) {
+    std::vector<Buffer> released;
+    {
+      std::lock_guard<std::mutex> lock(size_class.mutex);
+      released.swap(size_class.buffers);
+    }
+    // Deleted outside the lock.
+    buffers += released.size();
+    for (auto &buffer : released) {
+      bytes += buffer.capacity();
+    }
+  }
+
+  void BufferPool::Track(bool hit) {
+    if (hit) {
+      ++_counters.hits;
+      ++GlobalCounters().hits;
+    } else {
+      ++_counters.misses;
+      ++GlobalCounters().misses;
+    }
+  }
+
+  void BufferPool::AddResident(int64_t buffers, int64_t bytes) {
+    _counters.buffers_resident += static_cast<size_t>(buffers);
+    _counters.bytes_resident += static_cast<size_t>(bytes);
+    auto &global = GlobalCounters();
+    global.buffers_resident += static_cast<size_t>(buffers);
+    global.bytes_resident += static_cast<size_t>(bytes);
+  }
+
+} // namespace carla
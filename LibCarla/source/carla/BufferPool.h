@@ -7,54 +7,153 @@
 #pragma once
 
 #include "carla/Buffer.h"
+#include "carla/Time.h"
 
-#if defined(__clang__)
-#  pragma clang diagnostic push
-#  pragma clang diagnostic ignored "-Wold-style-cast"
-#endif
-#include "moodycamel/ConcurrentQueue.h"
-#if defined(__clang__)
-#  pragma clang diagnostic pop
-#endif
-
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace carla {
 
+  /// Limits of a BufferPool.
+  struct BufferPoolSettings {
+    /// Maximum number of buffers kept in each size class.
+    size_t max_buffers_per_class = 8u;
+
+    /// Maximum number of bytes kept by the pool, zero means no limit.
+    size_t max_resident_bytes = 0u;
+
+    /// The buffers of a size class that has not been used for this long are
+    /// released, zero disables trimming.
+    time_duration trim_after = time_duration::seconds(30u);
+
+    /// Buffers of this size or bigger are backed by huge pages if the system
+    /// supports them, zero disables huge pages.
+    size_t huge_page_threshold = 4u * 1024u * 1024u;
+  };
+
+  /// Counters of a BufferPool, or of all the pools of the process.
+  struct BufferPoolStatistics {
+    /// Pops served with a pooled buffer.
+    size_t hits = 0u;
+
+    /// Pops that had to allocate a new buffer.
+    size_t misses = 0u;
+
+    /// Buffers released on return because the pool was full.
+    size_t discarded = 0u;
+
+    /// Buffers released because their size class was idle.
+    size_t trimmed = 0u;
+
+    /// Buffers currently kept by the pool.
+    size_t buffers_resident = 0u;
+
+    /// Bytes currently kept by the pool.
+    size_t bytes_resident = 0u;
+  };
+
   /// A pool of Buffer. Buffers popped from this pool automatically return to
   /// the pool on destruction so the allocated memory can be reused.
   ///
-  /// @warning Buffers adjust their size only by growing, they never shrink
-  /// unless explicitly cleared. The allocated memory is only deleted when this
-  /// pool is destroyed.
+  /// Buffers are kept in size classes (four per power of two, starting at
+  /// 1KB), so a pop only reuses memory of a similar size. Buffers smaller than
+  /// 1KB, grown by the user after a pop without size, are kept in a class of
+  /// their own that only serves pops without size. Each class and the
+  /// pool as a whole are bounded, buffers returned to a full pool are
+  /// released.
+  ///
+  /// @warning Buffers adjust their size only by growing, a buffer popped
+  /// without a size hint may be bigger than needed.
   class BufferPool : public std::enable_shared_from_this<BufferPool> {
   public:
 
     BufferPool() = default;
 
-    explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}
-
-    /// Pop a Buffer from the queue, creates a new one if the queue is empty.
-    Buffer Pop() {
-      Buffer item;
-      _queue.try_dequeue(item); // we don't care if it fails.
-#if __cplusplus >= 201703L // C++17
-      item._parent_pool = weak_from_this();
-#else
-      item._parent_pool = shared_from_this();
-#endif
-      return item;
+    explicit BufferPool(const BufferPoolSettings &settings) : _settings(settings) {}
+
+    ~BufferPool();
+
+    /// Pop a Buffer of the size class most recently returned to the pool,
+    /// creates a new empty one if there is none. Meant for streams whose
+    /// messages have (approximately) the same size.
+    Buffer Pop();
+
+    /// Pop a Buffer with room for at least @a size bytes, allocates a new one
+    /// if the matching size class is empty. The size of the returned buffer is
+    /// @a size.
+    Buffer Pop(size_t size);
+
+    /// Release the buffers of the size classes that have been idle for longer
+    /// than BufferPoolSettings::trim_after. Trimming also happens periodically
+    /// when popping.
+    void Trim();
+
+    /// Release all the buffers kept by the pool.
+    void Clear();
+
+    const BufferPoolSettings &GetSettings() const {
+      return _settings;
     }
 
+    BufferPoolStatistics GetStatistics() const;
+
+    /// Statistics accumulated by all the pools of the process.
+    static BufferPoolStatistics GetGlobalStatistics();
+
+    /// Capacity allocated by Pop(size), i.e. @a size rounded up to its size
+    /// class.
+    static size_t GetAllocationSize(size_t size);
+
   private:
 
     friend class Buffer;
 
-    void Push(Buffer &&buffer) {
-      _queue.enqueue(std::move(buffer));
-    }
+    struct Counters {
+      std::atomic_size_t hits{0u};
+      std::atomic_size_t misses{0u};
+      std::atomic_size_t discarded{0u};
+      std::atomic_size_t trimmed{0u};
+      std::atomic_size_t buffers_resident{0u};
+      std::atomic_size_t bytes_resident{0u};
+    };
+
+    struct SizeClass {
+      std::mutex mutex;
+      std::vector<Buffer> buffers;
+      std::atomic<int64_t> last_used{0};
+    };
+
+    static constexpr size_t NUMBER_OF_SIZE_CLASSES = 1u + 4u * 20u + 1u;
+
+    static Counters &GlobalCounters();
+
+    bool TryPop(size_t index, Buffer &buffer);
+
+    void Push(Buffer &&buffer);
+
+    void Allocate(Buffer &buffer, size_t size) const;
+
+    void TrimIdle(int64_t now, bool force);
+
+    void Release(SizeClass &size_class, size_t &buffers, size_t &bytes);
+
+    void Track(bool hit);
+
+    void AddResident(int64_t buffers, int64_t bytes);
+
+    const BufferPoolSettings _settings;
+
+    std::array<SizeClass, NUMBER_OF_SIZE_CLASSES> _classes;
+
+    std::atomic_size_t _last_class{0u};
+
+    std::atomic<int64_t> _last_trim{0};
 
-    moodycamel::ConcurrentQueue<Buffer> _queue;
+    Counters _counters;
   };
 
 } // namespace carla
@@ -0,0 +1,141 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ThreadPool.h"
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace carla {
+
+namespace detail {
+
+  /// Ranges of a ParallelForRanges call. The calling thread and the tasks
+  /// posted to the pool claim ranges until there are none left, so the call
+  /// completes even if the pool is busy, e.g. when it is nested in another
+  /// call. A task that starts after the call returned finds no range to run
+  /// and does not touch the function of the call.
+  class ParallelForRangesState {
+  public:
+
+    ParallelForRangesState(size_t number_of_ranges, std::function<void(size_t)> run_range)
+      : _number_of_ranges(number_of_ranges),
+        _run_range(std::move(run_range)) {}
+
+    void Work() {
+      for (size_t range = _next_range++; range < _number_of_ranges; range = _next_range++) {
+        try {
+          _run_range(range);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if (!_exception) {
+            _exception = std::current_exception();
+          }
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (++_completed_ranges == _number_of_ranges) {
+          _completed.notify_all();
+        }
+      }
+    }
+
+    /// Waits for the ranges claimed by other threads and rethrows the first
+    /// exception thrown by any range.
+    void Wait() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _completed.wait(lock, [this]() { return _completed_ranges == _number_of_ranges; });
+      if (_exception) {
+        std::rethrow_exception(_exception);
+      }
+    }
+
+  private:
+
+    const size_t _number_of_ranges;
+
+    const std::function<void(size_t)> _run_range;
+
+    std::atomic_size_t _next_range{0u};
+
+    std::mutex _mutex;
+
+    std::condition_variable _completed;
+
+    size_t _completed_ranges = 0u;
+
+    std::exception_ptr _exception;
+  };
+
+  /// Pool shared by the ParallelForRanges calls that do not provide their
+  /// own, started on first use with one thread less than the hardware threads
+  /// since the calling thread takes part too. It is never destroyed, joining
+  /// threads while unloading a library may deadlock.
+  inline ThreadPool &GetParallelForPool() {
+    static ThreadPool *pool = []() {
+      auto *new_pool = new ThreadPool();
+      new_pool->AsyncRun(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+      return new_pool;
+    }();
+    return *pool;
+  }
+
+} // namespace detail
+
+  /// Splits [0, @a size) in up to @a number_of_threads contiguous ranges and
+  /// calls @a func(begin, end) for each of them, running them in the calling
+  /// thread and in the threads of @a pool. With zero or one thread everything
+  /// runs in the calling thread. Waits for all the ranges to finish and
+  /// rethrows the first exception thrown by @a func, if any.
+  ///
+  /// The threads of @a pool are reused between calls, so this is cheap enough
+  /// for per-tick work. The ranges are spread among the threads of the pool
+  /// that are idle, if none is the calling thread runs all of them.
+  template <typename FuncT>
+  void ParallelForRanges(ThreadPool &pool, size_t size, size_t number_of_threads, FuncT &&func) {
+    const size_t max_number_of_ranges =
+        std::max<size_t>(1u, std::min(number_of_threads, size));
+    if (max_number_of_ranges == 1u) {
+      func(size_t(0u), size);
+      return;
+    }
+    const size_t range_size = (size + max_number_of_ranges - 1u) / max_number_of_ranges;
+    const size_t number_of_ranges = (size + range_size - 1u) / range_size;
+    auto state = std::make_shared<detail::ParallelForRangesState>(
+        number_of_ranges,
+        [&func, size, range_size](size_t range) {
+          const size_t begin = range * range_size;
+          func(begin, std::min(begin + range_size, size));
+        });
+    for (size_t i = 1u; i < number_of_ranges; ++i) {
+      boost::asio::post(pool.io_context(), [state]() { state->Work(); });
+    }
+    state->Work();
+    state->Wait();
+  }
+
+  /// @copydoc ParallelForRanges(ThreadPool &, size_t, size_t, FuncT &&)
+  ///
+  /// Uses a pool shared by the whole process.
+  template <typename FuncT>
+  void ParallelForRanges(size_t size, size_t number_of_threads, FuncT &&func) {
+    ParallelForRanges(
+        detail::GetParallelForPool(),
+        size,
+        number_of_threads,
+        std::forward<FuncT>(func));
+  }
+
+} // namespace carla
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/BufferPool.h"
 #include "carla/client/detail/Simulator.h"
 #include "carla/client/World.h"
 #include "carla/PythonUtil.h"
@@ -50,6 +51,12 @@ namespace client {
       return _simulator->GetServerVersion();
     }
 
+    /// Statistics of the buffer pools used by the sensor streams of this
+    /// process.
+    BufferPoolStatistics GetBufferPoolStatistics() const {
+      return BufferPool::GetGlobalStatistics();
+    }
+
     std::vector<std::string> GetAvailableMaps() const {
       return _simulator->GetAvailableMaps();
     }
@@ -153,6 +160,25 @@ namespace client {
       return responses;
     }
 
+    /// Apply the controls of many vehicles in a single message, cheaper to
+    /// send and to dispatch than the equivalent batch of commands.
+    void ApplyVehicleControlBatch(
+        rpc::VehicleControlBatch batch,
+        bool do_tick_cue = false) const {
+      _simulator->ApplyVehicleControlBatch(std::move(batch), do_tick_cue);
+    }
+
+    /// Return the actors whose control or light state could not be applied.
+    std::vector<rpc::ActorId> ApplyVehicleControlBatchSync(
+        rpc::VehicleControlBatch batch,
+        bool do_tick_cue = false) const {
+      auto failed = _simulator->ApplyVehicleControlBatchSync(std::move(batch), false);
+      if (do_tick_cue)
+        _simulator->Tick(_simulator->GetNetworkingTimeout());
+
+      return failed;
+    }
+
   private:
 
     std::shared_ptr<detail::Simulator> _simulator;
@@ -34,21 +34,22 @@ namespace client {
   bool FileTransfer::FileExists(std::string file) {
     // Check if the file exists or not
     struct stat buffer;
+    std::string fullpath = GetFilePath(file);
+
+    return (stat(fullpath.c_str(), &buffer) == 0);
+  }
+
+  std::string FileTransfer::GetFilePath(std::string file) {
     std::string fullpath = _filesBaseFolder;
     fullpath += "/";
     fullpath += ::carla::version();
     fullpath += "/";
     fullpath += file;
-
-    return (stat(fullpath.c_str(), &buffer) == 0);
+    return fullpath;
   }
 
   bool FileTransfer::WriteFile(std::string path, std::vector<uint8_t> content) {
-    std::string writePath = _filesBaseFolder;
-    writePath += "/";
-    writePath += ::carla::version();
-    writePath += "/";
-    writePath += path;
+    std::string writePath = GetFilePath(path);
 
     // Validate and create the file path
     carla::FileSystem::ValidateFilePath(writePath);
@@ -67,11 +68,7 @@ namespace client {
   }
 
   std::vector<uint8_t> FileTransfer::ReadFile(std::string path) {
-    std::string fullpath = _filesBaseFolder;
-    fullpath += "/";
-    fullpath += ::carla::version();
-    fullpath += "/";
-    fullpath += path;
+    std::string fullpath = GetFilePath(path);
     // Read the binary file from the base folder
     std::ifstream file(fullpath, std::ios::binary);
     std::vector<uint8_t> content(std::istreambuf_iterator<char>(file), {});
@@ -28,6 +28,9 @@ namespace client {
 
     static bool FileExists(std::string file);
 
+    /// Full path of @a file inside the cache folder of this version.
+    static std::string GetFilePath(std::string file);
+
     static bool WriteFile(std::string path, std::vector<uint8_t> content);
 
     static std::vector<uint8_t> ReadFile(std::string path);
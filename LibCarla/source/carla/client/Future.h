@@ -0,0 +1,149 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Time.h"
+
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace carla {
+namespace client {
+
+  // ===========================================================================
+  // -- Future -----------------------------------------------------------------
+  // ===========================================================================
+
+  /// Result of a request to the simulator that may not have arrived yet. The
+  /// requests are sent as soon as the future is created, so many of them can
+  /// be in flight at once over the same connection.
+  ///
+  /// Copies of a future share the same result, which is retrieved and
+  /// converted only once. Waiting for the result never waits for another
+  /// thread retrieving it.
+  template <typename T>
+  class Future {
+  public:
+
+    using value_type = T;
+
+    /// Waits up to the given time for the result, returns whether it arrived.
+    /// It may be called concurrently with the GetFunction and after it, e.g.
+    /// by waiting on a std::shared_future.
+    using WaitFunction = std::function<bool(time_duration)>;
+
+    /// Waits for the result and returns it, or throws.
+    using GetFunction = std::function<T()>;
+
+    Future() = default;
+
+    Future(WaitFunction wait_for, GetFunction get)
+      : _state(std::make_shared<State>(std::move(wait_for), std::move(get))) {}
+
+    /// Whether this future refers to a request.
+    bool IsValid() const {
+      return _state != nullptr;
+    }
+
+    /// Whether the result arrived, never blocks.
+    bool IsReady() const {
+      return WaitFor(time_duration::milliseconds(0u));
+    }
+
+    /// Wait up to @a timeout for the result.
+    ///
+    /// @return whether the result arrived.
+    bool WaitFor(time_duration timeout) const;
+
+    /// Wait for the result and return it. Throws the same exceptions than the
+    /// blocking request, including a TimeoutException if the result does not
+    /// arrive within the timeout of the client.
+    const T &Get() const;
+
+    /// Return a future of the result of applying @a functor to the result of
+    /// this one.
+    template <typename FunctorT>
+    auto Then(FunctorT &&functor) const
+        -> Future<std::decay_t<decltype(functor(std::declval<const T &>()))>>;
+
+  private:
+
+    struct State {
+      State(WaitFunction wait_for, GetFunction get)
+        : wait_for(std::move(wait_for)),
+          get(std::move(get)) {}
+
+      const WaitFunction wait_for;
+
+      const GetFunction get;
+
+      std::once_flag once;
+
+      /// Set once the value or the exception are stored.
+      std::atomic_bool done{false};
+
+      boost::optional<T> value;
+
+      std::exception_ptr exception;
+    };
+
+    std::shared_ptr<State> _state;
+  };
+
+  // ===========================================================================
+  // -- Future implementation --------------------------------------------------
+  // ===========================================================================
+
+  template <typename T>
+  bool Future<T>::WaitFor(time_duration timeout) const {
+    DEBUG_ASSERT(IsValid());
+    if (_state->done.load(std::memory_order_acquire)) {
+      return true;
+    }
+    return _state->wait_for(timeout);
+  }
+
+  template <typename T>
+  const T &Future<T>::Get() const {
+    DEBUG_ASSERT(IsValid());
+    std::call_once(_state->once, [this]() {
+      try {
+        _state->value = _state->get();
+      } catch (...) {
+        _state->exception = std::current_exception();
+      }
+      _state->done.store(true, std::memory_order_release);
+    });
+    if (_state->exception != nullptr) {
+      std::rethrow_exception(_state->exception);
+    }
+    return *_state->value;
+  }
+
+  template <typename T>
+  template <typename FunctorT>
+  auto Future<T>::Then(FunctorT &&functor) const
+      -> Future<std::decay_t<decltype(functor(std::declval<const T &>()))>> {
+    using result_type = std::decay_t<decltype(functor(std::declval<const T &>()))>;
+    auto self = *this;
+    return Future<result_type>(
+        [self](time_duration timeout) { return self.WaitFor(timeout); },
+        [self, functor=std::forward<FunctorT>(functor)]() -> result_type {
+          return functor(self.Get());
+        });
+  }
+
+} // namespace client
+} // namespace carla
@@ -10,17 +10,32 @@
 #include "carla/client/Waypoint.h"
 #include "carla/opendrive/OpenDriveParser.h"
 #include "carla/road/Map.h"
+#include "carla/road/MapSnapshot.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 
 #include <sstream>
+#include <thread>
 
 namespace carla {
 namespace client {
 
   static auto MakeMap(const std::string &opendrive_contents) {
     auto stream = std::istringstream(opendrive_contents);
-    auto map = opendrive::OpenDriveParser::Load(stream.str());
+    auto map = opendrive::OpenDriveParser::Load(stream.str(), std::thread::hardware_concurrency());
+    if (!map.has_value()) {
+      throw_exception(std::runtime_error("failed to generate map"));
+    }
+    return std::move(*map);
+  }
+
+  static auto MakeMap(
+      const std::string &opendrive_contents,
+      const std::vector<uint8_t> &snapshot) {
+    auto map = opendrive::OpenDriveParser::Load(
+        opendrive_contents,
+        snapshot,
+        std::thread::hardware_concurrency());
     if (!map.has_value()) {
       throw_exception(std::runtime_error("failed to generate map"));
     }
@@ -39,6 +54,15 @@ namespace client {
     open_drive_file = xodr_content;
   }
 
+  Map::Map(
+      rpc::MapInfo description,
+      std::string xodr_content,
+      const std::vector<uint8_t> &snapshot)
+    : _description(std::move(description)),
+      _map(MakeMap(xodr_content, snapshot)) {
+    open_drive_file = std::move(xodr_content);
+  }
+
   Map::~Map() = default;
 
   SharedPtr<Waypoint> Map::GetWaypoint(
@@ -56,6 +80,24 @@ namespace client {
     nullptr;
   }
 
+  std::vector<SharedPtr<Waypoint>> Map::GetWaypoints(
+      const std::vector<geom::Location> &locations,
+      bool project_to_road,
+      int32_t lane_type,
+      size_t number_of_threads) const {
+    auto waypoints = project_to_road ?
+        _map.GetClosestWaypointsOnRoad(locations, lane_type, number_of_threads) :
+        _map.GetWaypoints(locations, lane_type, number_of_threads);
+    std::vector<SharedPtr<Waypoint>> result;
+    result.reserve(waypoints.size());
+    for (auto &waypoint : waypoints) {
+      result.emplace_back(waypoint.has_value() ?
+          SharedPtr<Waypoint>(new Waypoint{shared_from_this(), *waypoint}) :
+          nullptr);
+    }
+    return result;
+  }
+
   SharedPtr<Waypoint> Map::GetWaypointXODR(
       carla::road::RoadId road_id,
       carla::road::LaneId lane_id,
@@ -188,5 +230,9 @@ namespace client {
     traffic_manager::InMemoryMap::Cook(shared_from_this(), path);
   }
 
+  std::vector<uint8_t> Map::GetSnapshot() const {
+    return road::MapSnapshot::Write(_map, road::MapSnapshot::ComputeChecksum(open_drive_file));
+  }
+
 } // namespace client
 } // namespace carla
@@ -16,6 +16,7 @@
 #include "Landmark.h"
 
 #include <string>
+#include <vector>
 
 namespace carla {
 namespace geom { class GeoLocation; }
@@ -33,6 +34,13 @@ namespace client {
 
     explicit Map(std::string name, std::string xodr_content);
 
+    /// Builds the map reusing the data of @a snapshot if it was built from
+    /// @a xodr_content, see road::MapSnapshot.
+    explicit Map(
+        rpc::MapInfo description,
+        std::string xodr_content,
+        const std::vector<uint8_t> &snapshot);
+
     ~Map();
 
     const std::string &GetName() const {
@@ -56,6 +64,14 @@ namespace client {
         bool project_to_road = true,
         int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
 
+    /// Batched version of GetWaypoint, the waypoint at position i corresponds
+    /// to @a locations[i] and is null if not found.
+    std::vector<SharedPtr<Waypoint>> GetWaypoints(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving),
+        size_t number_of_threads = 0u) const;
+
     SharedPtr<Waypoint> GetWaypointXODR(
       carla::road::RoadId road_id,
       carla::road::LaneId lane_id,
@@ -97,6 +113,10 @@ namespace client {
     /// Cooks InMemoryMap used by the traffic manager
     void CookInMemoryMap(const std::string& path) const;
 
+    /// Binary snapshot of the data computed when building this map, loading
+    /// the map with it skips these computations.
+    std::vector<uint8_t> GetSnapshot() const;
+
   private:
 
     std::string open_drive_file;
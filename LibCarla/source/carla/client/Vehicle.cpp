@@ -99,10 +99,21 @@ namespace client {
     return GetEpisode().Lock()->GetVehiclePhysicsControl(*this);
   }
 
+  Future<Vehicle::PhysicsControl> Vehicle::GetPhysicsControlAsync() const {
+    return GetEpisode().Lock()->GetVehiclePhysicsControlAsync(*this);
+  }
+
   Vehicle::LightState Vehicle::GetLightState() const {
     return GetEpisode().Lock()->GetVehicleLightState(*this).GetLightStateEnum();
   }
 
+  Future<Vehicle::LightState> Vehicle::GetLightStateAsync() const {
+    return GetEpisode().Lock()->GetVehicleLightStateAsync(*this).Then(
+        [](const rpc::VehicleLightState &light_state) {
+          return light_state.GetLightStateEnum();
+        });
+  }
+
   float Vehicle::GetSpeedLimit() const {
     return GetEpisode().Lock()->GetActorSnapshot(*this).state.vehicle_data.speed_limit;
   }
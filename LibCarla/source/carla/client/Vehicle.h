@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/client/Actor.h"
+#include "carla/client/Future.h"
 #include "carla/rpc/AckermannControllerSettings.h"
 #include "carla/rpc/TrafficLightState.h"
 #include "carla/rpc/VehicleAckermannControl.h"
@@ -94,12 +95,18 @@ namespace client {
     /// @warning This function does call the simulator.
     PhysicsControl GetPhysicsControl() const;
 
+    /// Same as GetPhysicsControl, without waiting for the response.
+    Future<PhysicsControl> GetPhysicsControlAsync() const;
+
     /// Return the current open lights (LightState) of this vehicle.
     ///
     /// @note This function does not call the simulator, it returns the data
     /// received in the last tick.
     LightState GetLightState() const;
 
+    /// Same as GetLightState, without waiting for the response.
+    Future<LightState> GetLightStateAsync() const;
+
     /// Return the speed limit currently affecting this vehicle.
     ///
     /// @note This function does not call the simulator, it returns the data
@@ -37,6 +37,10 @@ namespace client {
     return _episode.Lock()->GetBlueprintLibrary();
   }
 
+  Future<SharedPtr<BlueprintLibrary>> World::GetBlueprintLibraryAsync() const {
+    return _episode.Lock()->GetBlueprintLibraryAsync();
+  }
+
   rpc::VehicleLightStateList World::GetVehiclesLightStates() const {
     return _episode.Lock()->GetVehiclesLightStates();
   }
@@ -164,6 +168,10 @@ namespace client {
     _episode.Lock()->SetPedestriansSeed(seed);
   }
 
+  void World::SetPedestriansNumberOfThreads(size_t number_of_threads) {
+    _episode.Lock()->SetPedestriansNumberOfThreads(number_of_threads);
+  }
+
   SharedPtr<Actor> World::GetTrafficSign(const Landmark& landmark) const {
     SharedPtr<ActorList> actors = GetActors();
     SharedPtr<TrafficSign> result;
@@ -227,6 +235,10 @@ namespace client {
     return _episode.Lock()->GetLevelBBs(queried_tag);
   }
 
+  Future<std::vector<geom::BoundingBox>> World::GetLevelBBsAsync(uint8_t queried_tag) const {
+    return _episode.Lock()->GetLevelBBsAsync(queried_tag);
+  }
+
   std::vector<rpc::EnvironmentObject> World::GetEnvironmentObjects(uint8_t queried_tag) const {
     return _episode.Lock()->GetEnvironmentObjects(queried_tag);
   }
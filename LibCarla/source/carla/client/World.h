@@ -9,6 +9,7 @@
 #include "carla/Memory.h"
 #include "carla/Time.h"
 #include "carla/client/DebugHelper.h"
+#include "carla/client/Future.h"
 #include "carla/client/Landmark.h"
 #include "carla/client/Waypoint.h"
 #include "carla/client/Junction.h"
@@ -71,6 +72,9 @@ namespace client {
     /// can be used to spawning actor into the world.
     SharedPtr<BlueprintLibrary> GetBlueprintLibrary() const;
 
+    /// Same as GetBlueprintLibrary, without waiting for the response.
+    Future<SharedPtr<BlueprintLibrary>> GetBlueprintLibraryAsync() const;
+
     /// Returns a list of pairs where the firts element is the vehicle ID
     /// and the second one is the light state
     rpc::VehicleLightStateList GetVehiclesLightStates() const;
@@ -148,6 +152,11 @@ namespace client {
     /// set the seed to use with random numbers in the pedestrians module
     void SetPedestriansSeed(unsigned int seed);
 
+    /// set the number of threads that update the pedestrians crowd, which is
+    /// split in tiles of the map updated in parallel; zero or one updates them
+    /// in the calling thread
+    void SetPedestriansNumberOfThreads(size_t number_of_threads);
+
     SharedPtr<Actor> GetTrafficSign(const Landmark& landmark) const;
 
     SharedPtr<Actor> GetTrafficLight(const Landmark& landmark) const;
@@ -171,6 +180,9 @@ namespace client {
     /// Returns all the BBs of all the elements of the level
     std::vector<geom::BoundingBox> GetLevelBBs(uint8_t queried_tag) const;
 
+    /// Same as GetLevelBBs, without waiting for the response.
+    Future<std::vector<geom::BoundingBox>> GetLevelBBsAsync(uint8_t queried_tag) const;
+
     std::vector<rpc::EnvironmentObject> GetEnvironmentObjects(uint8_t queried_tag) const;
 
     void EnableEnvironmentObjects(
@@ -0,0 +1,160 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/rpc/ActorId.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Actors added to and removed from an episode between two frames.
+  struct ActorLifecycleChanges {
+    /// False if the log does not cover the requested frames, the changes are
+    /// empty and the caller has to compare its actors with a snapshot.
+    bool complete = false;
+
+    /// Sorted by id.
+    std::vector<ActorId> added;
+
+    /// Sorted by id.
+    std::vector<ActorId> removed;
+  };
+
+  // ===========================================================================
+  // -- ActorLifecycleLog ------------------------------------------------------
+  // ===========================================================================
+
+  /// Keeps the actors added and removed by the last episode states received,
+  /// so whoever tracks the actors of the episode (e.g., the traffic manager)
+  /// does work proportional to the changes instead of comparing the whole
+  /// actor list every frame.
+  class ActorLifecycleLog : private NonCopyable {
+  public:
+
+    static constexpr size_t DEFAULT_CAPACITY = 512u;
+
+    explicit ActorLifecycleLog(size_t capacity = DEFAULT_CAPACITY)
+      : _capacity(std::max<size_t>(capacity, 1u)) {}
+
+    /// Forget all the changes, the next ones recorded are the changes of
+    /// @a episode_id after @a frame.
+    void Reset(uint64_t episode_id, uint64_t frame);
+
+    /// Records the actors added and removed by the state of @a frame. Frames
+    /// without changes do not need to be recorded.
+    void Record(
+        uint64_t frame,
+        std::vector<ActorId> added,
+        std::vector<ActorId> removed);
+
+    /// Retrieve the net changes of @a episode_id in the frames after
+    /// @a from_frame up to @a to_frame, both included.
+    ActorLifecycleChanges GetChanges(
+        uint64_t episode_id,
+        uint64_t from_frame,
+        uint64_t to_frame) const;
+
+  private:
+
+    struct Entry {
+      uint64_t frame;
+      std::vector<ActorId> added;
+      std::vector<ActorId> removed;
+    };
+
+    const size_t _capacity;
+
+    mutable std::mutex _mutex;
+
+    uint64_t _episode_id = 0u;
+
+    /// The changes of all the frames after it are recorded.
+    uint64_t _first_frame = 0u;
+
+    /// Sorted by frame.
+    std::deque<Entry> _entries;
+  };
+
+  // ===========================================================================
+  // -- ActorLifecycleLog implementation ---------------------------------------
+  // ===========================================================================
+
+  inline void ActorLifecycleLog::Reset(uint64_t episode_id, uint64_t frame) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _episode_id = episode_id;
+    _first_frame = frame;
+    _entries.clear();
+  }
+
+  inline void ActorLifecycleLog::Record(
+      uint64_t frame,
+      std::vector<ActorId> added,
+      std::vector<ActorId> removed) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (frame <= _first_frame) {
+      return;
+    }
+    // States are usually received in order, otherwise keep the entries sorted.
+    auto it = _entries.end();
+    while (it != _entries.begin() && std::prev(it)->frame > frame) {
+      --it;
+    }
+    _entries.insert(it, Entry{frame, std::move(added), std::move(removed)});
+    while (_entries.size() > _capacity) {
+      _first_frame = _entries.front().frame;
+      _entries.pop_front();
+    }
+  }
+
+  inline ActorLifecycleChanges ActorLifecycleLog::GetChanges(
+      uint64_t episode_id,
+      uint64_t from_frame,
+      uint64_t to_frame) const {
+    ActorLifecycleChanges changes;
+    std::vector<ActorId> added;
+    std::vector<ActorId> removed;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if ((episode_id != _episode_id) || (from_frame < _first_frame)) {
+        return changes;
+      }
+      auto it = std::upper_bound(_entries.begin(), _entries.end(), from_frame,
+          [](uint64_t frame, const Entry &entry) { return frame < entry.frame; });
+      for (; it != _entries.end() && it->frame <= to_frame; ++it) {
+        added.insert(added.end(), it->added.begin(), it->added.end());
+        removed.insert(removed.end(), it->removed.begin(), it->removed.end());
+      }
+    }
+    changes.complete = true;
+    // Actor ids are not reused within an episode, an actor both added and
+    // removed in these frames was never in a snapshot seen by the caller.
+    // Callers that learn about actors by other means (e.g., the vehicles
+    // registered with the traffic manager) have to check those themselves.
+    std::sort(added.begin(), added.end());
+    std::sort(removed.begin(), removed.end());
+    std::set_difference(
+        added.begin(), added.end(),
+        removed.begin(), removed.end(),
+        std::back_inserter(changes.added));
+    std::set_difference(
+        removed.begin(), removed.end(),
+        added.begin(), added.end(),
+        std::back_inserter(changes.removed));
+    return changes;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <iterator>
 #include <mutex>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
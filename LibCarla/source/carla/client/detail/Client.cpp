@@ -10,6 +10,7 @@
 #include "carla/Version.h"
 #include "carla/client/FileTransfer.h"
 #include "carla/client/TimeoutException.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/rpc/AckermannControllerSettings.h"
 #include "carla/rpc/ActorDescription.h"
 #include "carla/rpc/BoneTransformDataIn.h"
@@ -26,7 +27,11 @@
 
 #include <rpc/rpc_error.h>
 
+#include <boost/optional.hpp>
+
+#include <future>
 #include <thread>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -59,6 +64,10 @@ namespace detail {
 
     template <typename ... Args>
     auto RawCall(const std::string &function, Args && ... args) {
+      boost::optional<profiler::ScopedTrace> trace;
+      if (profiler::Tracer::IsEnabled()) {
+        trace.emplace(GetTracePoint(function));
+      }
       try {
         return rpc_client.call(function, std::forward<Args>(args) ...);
       } catch (const ::rpc::timeout &) {
@@ -77,12 +86,47 @@ namespace detail {
       return Get(response);
     }
 
+    /// Send the request without waiting, the response is converted when the
+    /// result is retrieved from the returned future.
+    template <typename T, typename ... Args>
+    Future<T> CallWithFuture(const std::string &function, Args && ... args) {
+      using R = typename carla::rpc::Response<T>;
+      // Shared, so the future can be waited for after its result was taken.
+      auto future = std::make_shared<std::shared_future<clmdep_msgpack::object_handle>>(
+          rpc_client.future_call(function, std::forward<Args>(args) ...).share());
+      return Future<T>(
+          [future](time_duration timeout) {
+            return future->wait_for(timeout.to_chrono()) == std::future_status::ready;
+          },
+          [future, endpoint=endpoint, timeout=GetTimeout()]() -> T {
+            if (future->wait_for(timeout.to_chrono()) != std::future_status::ready) {
+              throw_exception(TimeoutException(endpoint, timeout));
+            }
+            const auto &object = future->get();
+            auto response = object.template as<R>();
+            if (response.HasError()) {
+              throw_exception(std::runtime_error(response.GetError().What()));
+            }
+            return Get(response);
+          });
+    }
+
     template <typename ... Args>
     void AsyncCall(const std::string &function, Args && ... args) {
       // Discard returned future.
       rpc_client.async_call(function, std::forward<Args>(args) ...);
     }
 
+    /// Trace point of the calls to @a function, only looked up while tracing.
+    static profiler::TracePoint &GetTracePoint(const std::string &function) {
+      static thread_local std::unordered_map<std::string, profiler::TracePoint *> trace_points;
+      auto &trace_point = trace_points[function];
+      if (trace_point == nullptr) {
+        trace_point = &profiler::Tracer::GetTracePoint("rpc_client", function);
+      }
+      return *trace_point;
+    }
+
     time_duration GetTimeout() const {
       auto timeout = rpc_client.get_timeout();
       DEBUG_ASSERT(timeout.has_value());
@@ -122,6 +166,10 @@ namespace detail {
     _pimpl->AsyncCall("destroy_traffic_manager", port);
   }
 
+  void Client::RequestEpisodeStateKeyframe() const {
+    _pimpl->AsyncCall("request_episode_state_keyframe");
+  }
+
   Client::~Client() = default;
 
   void Client::SetTimeout(time_duration timeout) {
@@ -194,6 +242,10 @@ namespace detail {
     return _pimpl->CallAndWait<std::string>("get_map_data");
   }
 
+  std::vector<uint8_t> Client::GetMapSnapshot() const {
+    return _pimpl->CallAndWait<std::vector<uint8_t>>("get_map_snapshot");
+  }
+
   std::vector<uint8_t> Client::GetNavigationMesh() const {
     return _pimpl->CallAndWait<std::vector<uint8_t>>("get_navigation_mesh");
   }
@@ -247,6 +299,10 @@ namespace detail {
     return _pimpl->CallAndWait<std::vector<rpc::ActorDefinition>>("get_actor_definitions");
   }
 
+  Future<std::vector<rpc::ActorDefinition>> Client::GetActorDefinitionsAsync() {
+    return _pimpl->CallWithFuture<std::vector<rpc::ActorDefinition>>("get_actor_definitions");
+  }
+
   rpc::Actor Client::GetSpectator() {
     return _pimpl->CallAndWait<carla::rpc::Actor>("get_spectator");
   }
@@ -283,6 +339,16 @@ namespace detail {
     return _pimpl->CallAndWait<carla::rpc::VehicleLightState>("get_vehicle_light_state", vehicle);
   }
 
+  Future<rpc::VehiclePhysicsControl> Client::GetVehiclePhysicsControlAsync(
+      rpc::ActorId vehicle) const {
+    return _pimpl->CallWithFuture<carla::rpc::VehiclePhysicsControl>("get_physics_control", vehicle);
+  }
+
+  Future<rpc::VehicleLightState> Client::GetVehicleLightStateAsync(
+      rpc::ActorId vehicle) const {
+    return _pimpl->CallWithFuture<carla::rpc::VehicleLightState>("get_vehicle_light_state", vehicle);
+  }
+
   void Client::ApplyPhysicsControlToVehicle(
       rpc::ActorId vehicle,
       const rpc::VehiclePhysicsControl &physics_control) {
@@ -622,6 +688,17 @@ namespace detail {
     return result.as<std::vector<rpc::CommandResponse>>();
   }
 
+  void Client::ApplyVehicleControlBatch(rpc::VehicleControlBatch batch, bool do_tick_cue) {
+    _pimpl->AsyncCall("apply_vehicle_control_batch", std::move(batch), do_tick_cue);
+  }
+
+  std::vector<rpc::ActorId> Client::ApplyVehicleControlBatchSync(
+      rpc::VehicleControlBatch batch,
+      bool do_tick_cue) {
+    return _pimpl->CallAndWait<std::vector<rpc::ActorId>>(
+        "apply_vehicle_control_batch", std::move(batch), do_tick_cue);
+  }
+
   uint64_t Client::SendTickCue() {
     return _pimpl->CallAndWait<uint64_t>("tick_cue");
   }
@@ -644,6 +721,11 @@ namespace detail {
     return _pimpl->CallAndWait<return_t>("get_all_level_BBs", queried_tag);
   }
 
+  Future<std::vector<geom::BoundingBox>> Client::GetLevelBBsAsync(uint8_t queried_tag) const {
+    using return_t = std::vector<geom::BoundingBox>;
+    return _pimpl->CallWithFuture<return_t>("get_all_level_BBs", queried_tag);
+  }
+
   std::vector<rpc::EnvironmentObject> Client::GetEnvironmentObjects(uint8_t queried_tag) const {
     using return_t = std::vector<rpc::EnvironmentObject>;
     return _pimpl->CallAndWait<return_t>("get_environment_objects", queried_tag);
@@ -9,6 +9,7 @@
 #include "carla/Memory.h"
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/client/Future.h"
 #include "carla/geom/Transform.h"
 #include "carla/geom/Location.h"
 #include "carla/rpc/Actor.h"
@@ -25,6 +26,7 @@
 #include "carla/rpc/MapLayer.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
 #include "carla/rpc/TrafficLightState.h"
+#include "carla/rpc/VehicleControlBatch.h"
 #include "carla/rpc/VehicleDoor.h"
 #include "carla/rpc/VehicleLightStateList.h"
 #include "carla/rpc/VehicleLightState.h"
@@ -88,6 +90,10 @@ namespace detail {
 
     void DestroyTrafficManager(uint16_t port) const;
 
+    /// Ask the server to send every actor in the next episode state, when a
+    /// delta arrives without its keyframe.
+    void RequestEpisodeStateKeyframe() const;
+
     void SetTimeout(time_duration timeout);
 
     time_duration GetTimeout() const;
@@ -131,6 +137,9 @@ namespace detail {
 
     std::string GetMapData() const;
 
+    /// Binary snapshot of the current map, see road::MapSnapshot.
+    std::vector<uint8_t> GetMapSnapshot() const;
+
     void RequestFile(const std::string &name) const;
 
     std::vector<uint8_t> GetCacheFile(const std::string &name, const bool request_otherwise = true) const;
@@ -139,6 +148,9 @@ namespace detail {
 
     std::vector<rpc::ActorDefinition> GetActorDefinitions();
 
+    /// Same as GetActorDefinitions, without waiting for the response.
+    Future<std::vector<rpc::ActorDefinition>> GetActorDefinitionsAsync();
+
     rpc::Actor GetSpectator();
 
     rpc::EpisodeSettings GetEpisodeSettings();
@@ -155,6 +167,12 @@ namespace detail {
 
     rpc::VehicleLightState GetVehicleLightState(rpc::ActorId vehicle) const;
 
+    /// Same as GetVehiclePhysicsControl, without waiting for the response.
+    Future<rpc::VehiclePhysicsControl> GetVehiclePhysicsControlAsync(rpc::ActorId vehicle) const;
+
+    /// Same as GetVehicleLightState, without waiting for the response.
+    Future<rpc::VehicleLightState> GetVehicleLightStateAsync(rpc::ActorId vehicle) const;
+
     void ApplyPhysicsControlToVehicle(
         rpc::ActorId vehicle,
         const rpc::VehiclePhysicsControl &physics_control);
@@ -389,6 +407,15 @@ namespace detail {
         std::vector<rpc::Command> commands,
         bool do_tick_cue);
 
+    void ApplyVehicleControlBatch(
+        rpc::VehicleControlBatch batch,
+        bool do_tick_cue);
+
+    /// Return the actors whose control or light state could not be applied.
+    std::vector<rpc::ActorId> ApplyVehicleControlBatchSync(
+        rpc::VehicleControlBatch batch,
+        bool do_tick_cue);
+
     uint64_t SendTickCue();
 
     std::vector<rpc::LightState> QueryLightsStateToServer() const;
@@ -402,6 +429,9 @@ namespace detail {
     /// Returns all the BBs of all the elements of the level
     std::vector<geom::BoundingBox> GetLevelBBs(uint8_t queried_tag) const;
 
+    /// Same as GetLevelBBs, without waiting for the response.
+    Future<std::vector<geom::BoundingBox>> GetLevelBBsAsync(uint8_t queried_tag) const;
+
     std::vector<rpc::EnvironmentObject> GetEnvironmentObjects(uint8_t queried_tag) const;
 
     void EnableEnvironmentObjects(
@@ -40,7 +40,9 @@ using namespace std::chrono_literals;
   Episode::Episode(Client &client, const rpc::EpisodeInfo &info)
     : _client(client),
       _state(std::make_shared<EpisodeState>(info.id)),
-      _token(info.token) {}
+      _token(info.token) {
+    _actor_lifecycle_log.Reset(info.id, 0u);
+  }
 
   Episode::~Episode() {
     try {
@@ -57,8 +59,22 @@ using namespace std::chrono_literals;
       if (self != nullptr) {
 
         auto data = sensor::Deserializer::Deserialize(std::move(buffer));
-        auto next = std::make_shared<const EpisodeState>(CastData(*data));
+        const auto &raw_state = CastData(*data);
         auto prev = self->GetState();
+        if (!prev->CanApply(raw_state)) {
+          // The keyframe of this delta was lost, ask for a new one instead of
+          // waiting for the next interval. Once per keyframe, the following
+          // deltas refer to the same one until it arrives.
+          log_debug("episode state delta of frame", raw_state.GetFrame(), "skipped, missing keyframe");
+          if (raw_state.GetBaseFrame() != self->_requested_keyframe_base) {
+            self->_requested_keyframe_base = raw_state.GetBaseFrame();
+            self->_client.RequestEpisodeStateKeyframe();
+          }
+          return;
+        }
+        // Keyframes are also compared with the previous state to find the
+        // actors added and removed.
+        auto next = std::make_shared<const EpisodeState>(raw_state, *prev);
 
         // TODO: Update how the map change is detected
         bool HasMapChanged = next->HasMapChanged();
@@ -79,6 +95,18 @@ using namespace std::chrono_literals;
         else {
           bool episode_changed = (next->GetEpisodeId() != prev->GetEpisodeId());
 
+          // Log the actors added and removed before the state is visible, so
+          // the changes up to any published state are known.
+          if (episode_changed) {
+            self->_actor_lifecycle_log.Reset(next->GetEpisodeId(), next->GetFrame());
+          } else if (prev->GetFrame() < next->GetFrame() &&
+                     (!next->GetAddedActorIds().empty() || !next->GetRemovedActorIds().empty())) {
+            self->_actor_lifecycle_log.Record(
+                next->GetFrame(),
+                next->GetAddedActorIds(),
+                next->GetRemovedActorIds());
+          }
+
           do {
             if (prev->GetFrame() >= next->GetFrame() && !episode_changed) {
               self->_on_tick_callbacks.Call(next);
@@ -11,6 +11,7 @@
 #include "carla/RecurrentSharedFuture.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/WorldSnapshot.h"
+#include "carla/client/detail/ActorLifecycleLog.h"
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
@@ -67,6 +68,15 @@ namespace detail {
 
     std::vector<rpc::Actor> GetActors();
 
+    /// Retrieve the actors added to and removed from the episode
+    /// @a episode_id in the frames after @a from_frame up to @a to_frame.
+    ActorLifecycleChanges GetActorLifecycleChanges(
+        uint64_t episode_id,
+        uint64_t from_frame,
+        uint64_t to_frame) const {
+      return _actor_lifecycle_log.GetChanges(episode_id, from_frame, to_frame);
+    }
+
     boost::optional<WorldSnapshot> WaitForState(time_duration timeout) {
       return _snapshot.WaitFor(timeout);
     }
@@ -134,6 +144,8 @@ namespace detail {
 
     CachedActorList _actors;
 
+    ActorLifecycleLog _actor_lifecycle_log;
+
     CallbackList<WorldSnapshot> _on_tick_callbacks;
 
     CallbackList<WorldSnapshot> _on_map_change_callbacks;
@@ -146,6 +158,10 @@ namespace detail {
 
     bool _pending_exceptions = false;
 
+    /// Base frame of the last delta that requested a keyframe, only used by
+    /// the stream callback.
+    uint64_t _requested_keyframe_base = 0u;
+
     bool _should_update_map = true;
   };
 
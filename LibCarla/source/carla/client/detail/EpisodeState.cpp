@@ -10,7 +10,48 @@ namespace carla {
 namespace client {
 namespace detail {
 
+  static bool CompareIds(const ActorSnapshot &lhs, const ActorSnapshot &rhs) {
+    return lhs.id < rhs.id;
+  }
+
+  /// Snapshots of the actors in @a state, sorted by id.
+  static std::vector<ActorSnapshot> GetSortedSnapshots(
+      const sensor::data::RawEpisodeState &state) {
+    std::vector<ActorSnapshot> actors;
+    actors.reserve(state.size());
+    for (auto &&actor : state) {
+      actors.emplace_back(ActorSnapshot{
+          actor.id,
+          actor.actor_state,
+          actor.transform,
+          actor.velocity,
+          actor.angular_velocity,
+          actor.acceleration,
+          actor.state});
+    }
+    // The server sends the actors in the order of its registry.
+    if (!std::is_sorted(actors.begin(), actors.end(), CompareIds)) {
+      std::sort(actors.begin(), actors.end(), CompareIds);
+    }
+    DEBUG_ASSERT(std::adjacent_find(actors.begin(), actors.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.id == rhs.id; }) == actors.end());
+    return actors;
+  }
+
   EpisodeState::EpisodeState(const sensor::data::RawEpisodeState &state)
+    : _episode_id(state.GetEpisodeId()),
+      _timestamp(
+          state.GetFrame(),
+          state.GetGameTimeStamp(),
+          state.GetDeltaSeconds(),
+          state.GetPlatformTimeStamp()),
+      _map_origin(state.GetMapOrigin()),
+      _simulation_state(state.GetSimulationState()),
+      _actors(GetSortedSnapshots(state)) {}
+
+  EpisodeState::EpisodeState(
+      const sensor::data::RawEpisodeState &state,
+      const EpisodeState &previous)
     : _episode_id(state.GetEpisodeId()),
       _timestamp(
           state.GetFrame(),
@@ -19,20 +60,64 @@ namespace detail {
           state.GetPlatformTimeStamp()),
       _map_origin(state.GetMapOrigin()),
       _simulation_state(state.GetSimulationState()) {
-    _actors.reserve(state.size());
-    for (auto &&actor : state) {
-      DEBUG_ONLY(auto result = )
-      _actors.emplace(
-          actor.id,
-          ActorSnapshot{
-              actor.id,
-              actor.actor_state,
-              actor.transform,
-              actor.velocity,
-              actor.angular_velocity,
-              actor.acceleration,
-              actor.state});
-      DEBUG_ASSERT(result.second);
+    if (!state.IsDelta()) {
+      _actors = GetSortedSnapshots(state);
+      if (_episode_id != previous.GetEpisodeId()) {
+        _added_actor_ids.reserve(_actors.size());
+        for (const auto &actor : _actors) {
+          _added_actor_ids.emplace_back(actor.id);
+        }
+        return;
+      }
+      // Both tables are sorted by id.
+      auto prev = previous._actors.begin();
+      auto next = _actors.begin();
+      while (prev != previous._actors.end() || next != _actors.end()) {
+        if (next == _actors.end() || (prev != previous._actors.end() && prev->id < next->id)) {
+          _removed_actor_ids.emplace_back(prev->id);
+          ++prev;
+        } else if (prev == previous._actors.end() || next->id < prev->id) {
+          _added_actor_ids.emplace_back(next->id);
+          ++next;
+        } else {
+          ++prev;
+          ++next;
+        }
+      }
+      return;
+    }
+
+    DEBUG_ASSERT(_episode_id == previous.GetEpisodeId());
+    DEBUG_ASSERT(state.GetBaseFrame() <= previous.GetFrame());
+
+    const auto changed = GetSortedSnapshots(state);
+    const auto removed_ids = state.GetRemovedActorIds();
+    std::vector<ActorId> removed(removed_ids.begin(), removed_ids.end());
+    std::sort(removed.begin(), removed.end());
+
+    // Merge both sorted tables, the changed actors replace the previous ones.
+    _actors.reserve(previous._actors.size() + changed.size());
+    auto prev = previous._actors.begin();
+    auto next = changed.begin();
+    auto removed_it = removed.begin();
+    while (prev != previous._actors.end() || next != changed.end()) {
+      if (next == changed.end() || (prev != previous._actors.end() && prev->id < next->id)) {
+        removed_it = std::lower_bound(removed_it, removed.end(), prev->id);
+        if (removed_it == removed.end() || *removed_it != prev->id) {
+          _actors.emplace_back(*prev);
+        } else {
+          _removed_actor_ids.emplace_back(prev->id);
+        }
+        ++prev;
+      } else {
+        if (prev != previous._actors.end() && prev->id == next->id) {
+          ++prev;
+        } else {
+          _added_actor_ids.emplace_back(next->id);
+        }
+        _actors.emplace_back(*next);
+        ++next;
+      }
     }
   }
 
@@ -6,7 +6,6 @@
 
 #pragma once
 
-#include "carla/Iterator.h"
 #include "carla/ListView.h"
 #include "carla/NonCopyable.h"
 #include "carla/client/ActorSnapshot.h"
@@ -14,16 +13,22 @@
 #include "carla/geom/Vector3DInt.h"
 #include "carla/sensor/data/RawEpisodeState.h"
 
+#include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
 namespace detail {
 
   /// Represents the state of all the actors of an episode at a given frame.
+  ///
+  /// The actors are kept in a contiguous table sorted by id, so a delta from
+  /// the server is applied by merging it with the table of the previous
+  /// state.
   class EpisodeState
     : public std::enable_shared_from_this<EpisodeState>,
       private NonCopyable {
@@ -36,6 +41,16 @@ namespace detail {
 
     explicit EpisodeState(const sensor::data::RawEpisodeState &state);
 
+    /// Applies @a state on @a previous, and keeps the actors added and removed
+    /// since @a previous. If @a state belongs to another episode every actor
+    /// counts as added.
+    ///
+    /// @pre If @a state is a delta, it is of the same episode and its base
+    /// frame is not after the frame of @a previous.
+    EpisodeState(
+        const sensor::data::RawEpisodeState &state,
+        const EpisodeState &previous);
+
     auto GetEpisodeId() const {
       return _episode_id;
     }
@@ -44,6 +59,13 @@ namespace detail {
       return _timestamp.frame;
     }
 
+    /// Whether @a state can be applied on this state. A keyframe always can, a
+    /// delta only on a state of the same episode at or after its keyframe.
+    bool CanApply(const sensor::data::RawEpisodeState &state) const {
+      return !state.IsDelta() ||
+          ((state.GetEpisodeId() == _episode_id) && (state.GetBaseFrame() <= GetFrame()));
+    }
+
     const auto &GetTimestamp() const {
       return _timestamp;
     }
@@ -61,7 +83,7 @@ namespace detail {
     }
 
     bool ContainsActorSnapshot(ActorId actor_id) const {
-      return _actors.find(actor_id) != _actors.end();
+      return Find(actor_id) != _actors.end();
     }
 
     ActorSnapshot GetActorSnapshot(ActorId id) const {
@@ -77,9 +99,20 @@ namespace detail {
     }
 
     auto GetActorIds() const {
+      auto get_id = [](const ActorSnapshot &actor) -> const ActorId & { return actor.id; };
       return MakeListView(
-          iterator::make_map_keys_const_iterator(_actors.begin()),
-          iterator::make_map_keys_const_iterator(_actors.end()));
+          boost::make_transform_iterator(_actors.begin(), get_id),
+          boost::make_transform_iterator(_actors.end(), get_id));
+    }
+
+    /// Actors not present in the previous state, sorted by id.
+    const std::vector<ActorId> &GetAddedActorIds() const {
+      return _added_actor_ids;
+    }
+
+    /// Actors of the previous state not present anymore, sorted by id.
+    const std::vector<ActorId> &GetRemovedActorIds() const {
+      return _removed_actor_ids;
     }
 
     size_t size() const {
@@ -87,20 +120,29 @@ namespace detail {
     }
 
     auto begin() const {
-      return iterator::make_map_values_const_iterator(_actors.begin());
+      return _actors.cbegin();
     }
 
     auto end() const {
-      return iterator::make_map_values_const_iterator(_actors.end());
+      return _actors.cend();
     }
 
   private:
 
+    std::vector<ActorSnapshot>::const_iterator Find(ActorId id) const {
+      auto it = std::lower_bound(
+          _actors.begin(),
+          _actors.end(),
+          id,
+          [](const ActorSnapshot &actor, ActorId id) { return actor.id < id; });
+      return (it != _actors.end() && it->id == id) ? it : _actors.end();
+    }
+
     template <typename T>
     void CopyActorSnapshotIfPresent(ActorId id, T &value) const {
-      auto it = _actors.find(id);
+      auto it = Find(id);
       if (it != _actors.end()) {
-        value = it->second;
+        value = *it;
       }
     }
 
@@ -112,7 +154,12 @@ namespace detail {
 
     SimulationState _simulation_state;
 
-    std::unordered_map<ActorId, ActorSnapshot> _actors;
+    /// Sorted by id.
+    std::vector<ActorSnapshot> _actors;
+
+    std::vector<ActorId> _added_actor_ids;
+
+    std::vector<ActorId> _removed_actor_ids;
   };
 
 } // namespace detail
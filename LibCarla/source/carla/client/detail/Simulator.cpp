@@ -17,10 +17,12 @@
 #include "carla/client/TimeoutException.h"
 #include "carla/client/WalkerAIController.h"
 #include "carla/client/detail/ActorFactory.h"
+#include "carla/road/MapSnapshot.h"
 #include "carla/trafficmanager/TrafficManager.h"
 #include "carla/sensor/Deserializer.h"
 
 #include <exception>
+#include <sstream>
 #include <thread>
 
 using namespace std::string_literals;
@@ -150,6 +152,14 @@ namespace detail {
     return false;
   }
 
+  /// Name of the snapshot of the map described by @a open_drive inside the
+  /// cache folder.
+  static std::string GetMapSnapshotFileName(const std::string &open_drive) {
+    std::ostringstream file_name;
+    file_name << "MapSnapshots/" << std::hex << road::MapSnapshot::ComputeChecksum(open_drive) << ".bin";
+    return file_name.str();
+  }
+
   SharedPtr<Map> Simulator::GetCurrentMap() {
     DEBUG_ASSERT(_episode != nullptr);
     if (!_cached_map || _episode->HasMapChangedSinceLastCall()) {
@@ -170,12 +180,41 @@ namespace detail {
       std::string XODRFolder = map_base_path + "/OpenDrive/" + map_name + ".xodr";
       if (FileTransfer::FileExists(XODRFolder) == false) _client.GetRequiredFiles();
       _open_drive_file = _client.GetMapData();
-      _cached_map = MakeShared<Map>(map_info, _open_drive_file);
+      const auto snapshot = GetMapSnapshot(_open_drive_file);
+      _cached_map = MakeShared<Map>(map_info, _open_drive_file, snapshot);
+      if (snapshot.empty()) {
+        // Store the snapshot of the map built here for the next clients.
+        FileTransfer::WriteFile(GetMapSnapshotFileName(_open_drive_file), _cached_map->GetSnapshot());
+      }
     }
 
     return _cached_map;
   }
 
+  std::vector<uint8_t> Simulator::GetMapSnapshot(const std::string &open_drive) {
+    const uint64_t checksum = road::MapSnapshot::ComputeChecksum(open_drive);
+    const std::string file_name = GetMapSnapshotFileName(open_drive);
+    if (FileTransfer::FileExists(file_name)) {
+      auto snapshot = FileTransfer::ReadFile(file_name);
+      if (road::MapSnapshot::GetChecksum(snapshot) == checksum) {
+        return snapshot;
+      }
+    }
+    std::vector<uint8_t> snapshot;
+    try {
+      snapshot = _client.GetMapSnapshot();
+    } catch (const std::exception &e) {
+      // Servers without snapshot support.
+      log_debug("map snapshot not available from the server:", e.what());
+      return {};
+    }
+    if (road::MapSnapshot::GetChecksum(snapshot) != checksum) {
+      return {};
+    }
+    FileTransfer::WriteFile(file_name, snapshot);
+    return snapshot;
+  }
+
   // ===========================================================================
   // -- Required files ---------------------------------------------------------
   // ===========================================================================
@@ -240,6 +279,13 @@ namespace detail {
     return MakeShared<BlueprintLibrary>(std::move(defs));
   }
 
+  Future<SharedPtr<BlueprintLibrary>> Simulator::GetBlueprintLibraryAsync() {
+    return _client.GetActorDefinitionsAsync().Then(
+        [](const std::vector<rpc::ActorDefinition> &defs) {
+          return MakeShared<BlueprintLibrary>(defs);
+        });
+  }
+
   rpc::VehicleLightStateList Simulator::GetVehiclesLightStates() {
     return _client.GetVehiclesLightStates();
   }
@@ -326,6 +372,13 @@ namespace detail {
     navigation->SetPedestriansSeed(seed);
   }
 
+  void Simulator::SetPedestriansNumberOfThreads(size_t number_of_threads) {
+    DEBUG_ASSERT(_episode != nullptr);
+    auto navigation = _episode->CreateNavigationIfMissing();
+    DEBUG_ASSERT(navigation != nullptr);
+    navigation->SetPedestriansNumberOfThreads(number_of_threads);
+  }
+
   // ===========================================================================
   // -- General operations with actors -----------------------------------------
   // ===========================================================================
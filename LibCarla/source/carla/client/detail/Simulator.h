@@ -111,6 +111,16 @@ namespace detail {
       return WorldSnapshot{_episode->GetState()};
     }
 
+    /// Actors added to and removed from the episode @a episode_id in the
+    /// frames after @a from_frame up to @a to_frame.
+    ActorLifecycleChanges GetActorLifecycleChanges(
+        uint64_t episode_id,
+        uint64_t from_frame,
+        uint64_t to_frame) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetActorLifecycleChanges(episode_id, from_frame, to_frame);
+    }
+
     /// @}
     // =========================================================================
     /// @name Map related methods
@@ -225,6 +235,8 @@ namespace detail {
 
     SharedPtr<BlueprintLibrary> GetBlueprintLibrary();
 
+    Future<SharedPtr<BlueprintLibrary>> GetBlueprintLibraryAsync();
+
     /// Returns a list of pairs where the firts element is the vehicle ID
     /// and the second one is the light state
     rpc::VehicleLightStateList GetVehiclesLightStates();
@@ -253,11 +265,23 @@ namespace detail {
       return _client.GetVehicleLightState(vehicle.GetId());
     }
 
+    Future<rpc::VehiclePhysicsControl> GetVehiclePhysicsControlAsync(const Vehicle &vehicle) const {
+      return _client.GetVehiclePhysicsControlAsync(vehicle.GetId());
+    }
+
+    Future<rpc::VehicleLightState> GetVehicleLightStateAsync(const Vehicle &vehicle) const {
+      return _client.GetVehicleLightStateAsync(vehicle.GetId());
+    }
+
     /// Returns all the BBs of all the elements of the level
     std::vector<geom::BoundingBox> GetLevelBBs(uint8_t queried_tag) const {
       return _client.GetLevelBBs(queried_tag);
     }
 
+    Future<std::vector<geom::BoundingBox>> GetLevelBBsAsync(uint8_t queried_tag) const {
+      return _client.GetLevelBBsAsync(queried_tag);
+    }
+
     std::vector<rpc::EnvironmentObject> GetEnvironmentObjects(uint8_t queried_tag) const {
       return _client.GetEnvironmentObjects(queried_tag);
     }
@@ -298,6 +322,8 @@ namespace detail {
 
     void SetPedestriansSeed(unsigned int seed);
 
+    void SetPedestriansNumberOfThreads(size_t number_of_threads);
+
     /// @}
     // =========================================================================
     /// @name General operations with actors
@@ -667,6 +693,14 @@ namespace detail {
       return _client.ApplyBatchSync(std::move(commands), do_tick_cue);
     }
 
+    void ApplyVehicleControlBatch(rpc::VehicleControlBatch batch, bool do_tick_cue) {
+      _client.ApplyVehicleControlBatch(std::move(batch), do_tick_cue);
+    }
+
+    auto ApplyVehicleControlBatchSync(rpc::VehicleControlBatch batch, bool do_tick_cue) {
+      return _client.ApplyVehicleControlBatchSync(std::move(batch), do_tick_cue);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations lights
@@ -727,6 +761,11 @@ namespace detail {
 
     bool ShouldUpdateMap(rpc::MapInfo& map_info);
 
+    /// Returns the snapshot of the map described by @a open_drive from the
+    /// cache folder, or requests it to the server. Returns an empty snapshot
+    /// if none of them has it.
+    std::vector<uint8_t> GetMapSnapshot(const std::string &open_drive);
+
     Client _client;
 
     SharedPtr<LightManager> _light_manager;
@@ -89,6 +89,11 @@ namespace detail {
       _nav.SetSeed(seed);
     }
 
+    // set the number of threads updating the crowd
+    void SetPedestriansNumberOfThreads(size_t number_of_threads) {
+      _nav.SetNumberOfThreads(number_of_threads);
+    }
+
   private:
 
     Client &_client;
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "carla/ParallelFor.h"
+
 #include <vector>
 
 #include <boost/geometry.hpp>
@@ -25,6 +27,14 @@ namespace geom {
     typedef boost::geometry::model::point<float, Dimension, boost::geometry::cs::cartesian> BPoint;
     typedef std::pair<BPoint, T> TreeElement;
 
+    PointCloudRtree() = default;
+
+    /// Bulk loads @a elements with the packing algorithm, which is faster
+    /// than inserting them one by one and builds a tree with less overlap
+    /// between nodes.
+    explicit PointCloudRtree(const std::vector<TreeElement> &elements)
+      : _rtree(elements.begin(), elements.end()) {}
+
     void InsertElement(const BPoint &point, const T &element) {
       _rtree.insert(std::make_pair(point, element));
     }
@@ -61,6 +71,25 @@ namespace geom {
       return query_result;
     }
 
+    /// Batched version of GetNearestNeighbours, the result at position i
+    /// holds the neighbours of @a points[i]. The queries are split among
+    /// @a number_of_threads threads, zero runs them in the calling thread.
+    std::vector<std::vector<TreeElement>> GetNearestNeighboursBatch(
+        const std::vector<BPoint> &points,
+        size_t number_neighbours = 1,
+        size_t number_of_threads = 0u) const {
+      std::vector<std::vector<TreeElement>> query_results(points.size());
+      ParallelForRanges(points.size(), number_of_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          query_results[i].reserve(number_neighbours);
+          _rtree.query(
+              boost::geometry::index::nearest(points[i], static_cast<unsigned int>(number_neighbours)),
+              std::back_inserter(query_results[i]));
+        }
+      });
+      return query_results;
+    }
+
     size_t GetTreeSize() const {
       return _rtree.size();
     }
@@ -82,6 +111,13 @@ namespace geom {
     typedef boost::geometry::model::segment<BPoint> BSegment;
     typedef std::pair<BSegment, std::pair<T, T>> TreeElement;
 
+    SegmentCloudRtree() = default;
+
+    /// Bulk loads @a elements with the packing algorithm, see
+    /// PointCloudRtree.
+    explicit SegmentCloudRtree(const std::vector<TreeElement> &elements)
+      : _rtree(elements.begin(), elements.end()) {}
+
     void InsertElement(const BSegment &segment, const T &element_start, const T &element_end) {
       _rtree.insert(std::make_pair(segment, std::make_pair(element_start, element_end)));
     }
@@ -121,6 +157,24 @@ namespace geom {
       return query_result;
     }
 
+    /// Batched version of GetNearestNeighbours, see PointCloudRtree.
+    template<typename Geometry>
+    std::vector<std::vector<TreeElement>> GetNearestNeighboursBatch(
+        const std::vector<Geometry> &geometries,
+        size_t number_neighbours = 1,
+        size_t number_of_threads = 0u) const {
+      std::vector<std::vector<TreeElement>> query_results(geometries.size());
+      ParallelForRanges(geometries.size(), number_of_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          query_results[i].reserve(number_neighbours);
+          _rtree.query(
+              boost::geometry::index::nearest(geometries[i], static_cast<unsigned int>(number_neighbours)),
+              std::back_inserter(query_results[i]));
+        }
+      });
+      return query_results;
+    }
+
     /// Returns segments that intersec the specified geometry
     /// Warning: intersection between 3D segments is not implemented by boost
     template<typename Geometry>
@@ -132,10 +186,26 @@ namespace geom {
       return query_result;
     }
 
+    /// Same as above, filling @a query_result so its memory can be reused
+    /// between queries.
+    template<typename Geometry>
+    void GetIntersections(const Geometry &geometry, std::vector<TreeElement> &query_result) const {
+      query_result.clear();
+      _rtree.query(
+          boost::geometry::index::intersects(geometry),
+          std::back_inserter(query_result));
+    }
+
     size_t GetTreeSize() const {
       return _rtree.size();
     }
 
+    /// Returns all the elements stored in the tree, in the order of its
+    /// leaves.
+    std::vector<TreeElement> GetElements() const {
+      return std::vector<TreeElement>(_rtree.begin(), _rtree.end());
+    }
+
   private:
 
     boost::geometry::index::rtree<TreeElement, boost::geometry::index::linear<16>> _rtree;
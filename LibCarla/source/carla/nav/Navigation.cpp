@@ -9,13 +9,16 @@
 #include <cmath>
 
 #include "carla/Logging.h"
+#include "carla/ParallelFor.h"
 #include "carla/nav/Navigation.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/geom/Math.h"
 
+#include <algorithm>
 #include <iterator>
 #include <fstream>
 #include <mutex>
+#include <unordered_set>
 
 namespace carla {
 namespace nav {
@@ -31,8 +34,11 @@ namespace nav {
   // these settings are the same than in RecastBuilder, so if you change the height of the agent, 
   // you should do the same in RecastBuilder
   static const int   MAX_POLYS = 256;
-  static const int   MAX_AGENTS = 500;
+  static const int   INITIAL_AGENTS_PER_CROWD = 128;
   static const int   MAX_QUERY_SEARCH_NODES = 2048;
+  static const size_t PATH_CACHE_SIZE = 4096u;
+  // minimum number of paths computed by each thread of a batch
+  static const size_t MIN_PATHS_PER_THREAD = 8u;
   static const float AGENT_HEIGHT = 1.8f;
   static const float AGENT_RADIUS = 0.3f;
 
@@ -43,12 +49,46 @@ namespace nav {
   static const float AREA_GRASS_COST =  1.0f;
   static const float AREA_ROAD_COST  = 10.0f;
 
+  // size of the square tiles of the partitioned crowd
+  static const float CROWD_TILE_SIZE = 200.0f;
+  // distance a walker can go out of its tile before moving to the crowd of the next one,
+  // to avoid moving it back and forth when it walks along the border
+  static const float CROWD_TILE_MARGIN = 5.0f;
+  // vehicles are added to all crowds closer than this distance, so walkers near the border
+  // of a tile can avoid the vehicles of the tile next to it
+  static const float CROWD_VEHICLE_MARGIN = 30.0f;
+  // walkers closer than this distance to the border of their tile have a ghost agent in the crowds
+  // of the tiles next to it, as far as the walkers look for neighbours to avoid
+  static const float CROWD_GHOST_MARGIN = 10.0f;
+
+  // return the tile coordinate of a position
+  static int TileCoordinate(float position) {
+    return static_cast<int>(std::floor(position / CROWD_TILE_SIZE));
+  }
+
+  // return the key of a tile
+  static uint64_t TileKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32u) | static_cast<uint32_t>(y);
+  }
+
   // return a random float
   static float frand() {
     return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
   }
 
-  Navigation::Navigation() {
+  // return a pool with the threads that help the calling thread
+  static std::shared_ptr<ThreadPool> MakeThreadPool(size_t number_of_threads) {
+    auto pool = std::make_shared<ThreadPool>();
+    if (number_of_threads > 1u) {
+      pool->AsyncRun(number_of_threads - 1u);
+    }
+    return pool;
+  }
+
+  Navigation::Navigation()
+    : _path_cache(PATH_CACHE_SIZE),
+      _number_of_threads(1u),
+      _thread_pool(MakeThreadPool(_number_of_threads)) {
     // assign walker manager
     _walker_manager.SetNav(this);
   }
@@ -58,11 +98,19 @@ namespace nav {
     _time_to_unblock = 0.0f;
     _mapped_walkers_id.clear();
     _mapped_vehicles_id.clear();
-    _mapped_by_index.clear();
+    _mapped_walker_ghosts.clear();
     _walkers_blocked_position.clear();
     _yaw_walkers.clear();
     _binary_mesh.clear();
-    dtFreeCrowd(_crowd);
+    for (auto &tile : _crowds) {
+      dtFreeCrowd(tile.crowd);
+    }
+    _crowds.clear();
+    _crowd_by_tile.clear();
+    for (dtNavMeshQuery *query : _path_queries) {
+      dtFreeNavMeshQuery(query);
+    }
+    _path_queries.clear();
     dtFreeNavMeshQuery(_nav_query);
     dtFreeNavMesh(_nav_mesh);
   }
@@ -181,6 +229,16 @@ namespace nav {
     _nav_query = dtAllocNavMeshQuery();
     _nav_query->init(_nav_mesh, MAX_QUERY_SEARCH_NODES);
 
+    // the path queries and the cached paths are for the previous mesh
+    {
+      std::lock_guard<std::mutex> lock(_path_queries_mutex);
+      for (dtNavMeshQuery *query : _path_queries) {
+        dtFreeNavMeshQuery(query);
+      }
+      _path_queries.clear();
+    }
+    _path_cache.Clear();
+
     // copy
     _binary_mesh = std::move(content);
     _ready = true;
@@ -198,54 +256,71 @@ namespace nav {
       return;
     }
 
-    DEBUG_ASSERT(_crowd == nullptr);
+    // remove the crowds of a previous navigation mesh, the crowd of each tile is created
+    // when the first walker enters it
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &tile : _crowds) {
+      dtFreeCrowd(tile.crowd);
+    }
+    _crowds.clear();
+    _crowd_by_tile.clear();
+    _mapped_walkers_id.clear();
+    _mapped_vehicles_id.clear();
+    _mapped_walker_ghosts.clear();
+  }
+
+  dtCrowd *Navigation::AllocateCrowd(int max_agents) const {
 
     // create and init
-    _crowd = dtAllocCrowd();
+    dtCrowd *crowd = dtAllocCrowd();
+    if (crowd == nullptr) {
+      return nullptr;
+    }
     // these radius should be the maximum size of the vehicles (CarlaCola for Carla)
     const float max_agent_radius = AGENT_RADIUS * 20;
-    if (!_crowd->init(MAX_AGENTS, max_agent_radius, _nav_mesh)) {
+    if (!crowd->init(max_agents, max_agent_radius, _nav_mesh)) {
       logging::log("Nav: failed to create crowd");
-      return;
+      dtFreeCrowd(crowd);
+      return nullptr;
     }
 
     // set different filters
     // filter 0 can not walk on roads
-    _crowd->getEditableFilter(0)->setIncludeFlags(CARLA_TYPE_WALKABLE);
-    _crowd->getEditableFilter(0)->setExcludeFlags(CARLA_TYPE_ROAD);
-    _crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-    _crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+    crowd->getEditableFilter(0)->setIncludeFlags(CARLA_TYPE_WALKABLE);
+    crowd->getEditableFilter(0)->setExcludeFlags(CARLA_TYPE_ROAD);
+    crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+    crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
     // filter 1 can walk on roads
-    _crowd->getEditableFilter(1)->setIncludeFlags(CARLA_TYPE_WALKABLE);
-    _crowd->getEditableFilter(1)->setExcludeFlags(CARLA_TYPE_NONE);
-    _crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-    _crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+    crowd->getEditableFilter(1)->setIncludeFlags(CARLA_TYPE_WALKABLE);
+    crowd->getEditableFilter(1)->setExcludeFlags(CARLA_TYPE_NONE);
+    crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+    crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
 
     // Setup local avoidance params to different qualities.
     dtObstacleAvoidanceParams params;
     // Use mostly default settings, copy from dtCrowd.
-    memcpy(&params, _crowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
+    memcpy(&params, crowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
 
     // Low (11)
     params.velBias = 0.5f;
     params.adaptiveDivs = 5;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 1;
-    _crowd->setObstacleAvoidanceParams(0, &params);
+    crowd->setObstacleAvoidanceParams(0, &params);
 
     // Medium (22)
     params.velBias = 0.5f;
     params.adaptiveDivs = 5;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 2;
-    _crowd->setObstacleAvoidanceParams(1, &params);
+    crowd->setObstacleAvoidanceParams(1, &params);
 
     // Good (45)
     params.velBias = 0.5f;
     params.adaptiveDivs = 7;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 3;
-    _crowd->setObstacleAvoidanceParams(2, &params);
+    crowd->setObstacleAvoidanceParams(2, &params);
 
     // High (66)
     params.velBias = 0.5f;
@@ -253,117 +328,220 @@ namespace nav {
     params.adaptiveRings = 3;
     params.adaptiveDepth = 3;
 
-    _crowd->setObstacleAvoidanceParams(3, &params);
+    crowd->setObstacleAvoidanceParams(3, &params);
+
+    return crowd;
   }
 
-  // return the path points to go from one position to another
-  bool Navigation::GetPath(carla::geom::Location from,
-                           carla::geom::Location to,
-                           dtQueryFilter * filter,
-                           std::vector<carla::geom::Location> &path,
-                           std::vector<unsigned char> &area) {
-    // path found
-    float straight_path[MAX_POLYS * 3];
-    unsigned char straight_path_flags[MAX_POLYS];
-    dtPolyRef straight_path_polys[MAX_POLYS];
-    int num_straight_path;
-    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
+  int Navigation::GetOrCreateTileCrowd(int x, int y) {
+    const uint64_t key = TileKey(x, y);
+    auto it = _crowd_by_tile.find(key);
+    if (it != _crowd_by_tile.end()) {
+      return it->second;
+    }
 
-    // polys in path
-    dtPolyRef polys[MAX_POLYS];
-    int num_polys;
+    CrowdTile tile;
+    tile.crowd = AllocateCrowd(INITIAL_AGENTS_PER_CROWD);
+    if (tile.crowd == nullptr) {
+      return -1;
+    }
+    tile.x = x;
+    tile.y = y;
+    const int index = static_cast<int>(_crowds.size());
+    _crowds.emplace_back(std::move(tile));
+    _crowd_by_tile[key] = index;
 
-    // check if all is ready
-    if (!_ready) {
+    // vehicles already near the tile will be added on the next vehicles update
+    return index;
+  }
+
+  // add a copy of an agent to another crowd, keeping its movement and target
+  static int CopyAgent(const dtCrowdAgent &agent, dtCrowd &target) {
+    const int index = target.addAgent(agent.npos, &agent.params);
+    if (index == -1) {
+      return -1;
+    }
+
+    // keep its movement
+    dtCrowdAgent *copy = target.getEditableAgent(index);
+    dtVcopy(copy->vel, agent.vel);
+    dtVcopy(copy->dvel, agent.dvel);
+    dtVcopy(copy->nvel, agent.nvel);
+    copy->paused = agent.paused;
+    if (agent.params.useObb) {
+      copy->state = agent.state;
+    }
+
+    // request its target again, the new crowd plans the path from the current position
+    if (agent.targetState == DT_CROWDAGENT_TARGET_VELOCITY) {
+      target.requestMoveVelocity(index, agent.targetPos);
+    } else if (agent.targetState != DT_CROWDAGENT_TARGET_NONE && agent.targetRef) {
+      target.requestMoveTarget(index, agent.targetRef, agent.targetPos);
+    }
+
+    return index;
+  }
+
+  bool Navigation::GrowCrowd(int crowd) {
+    dtCrowd *old = _crowds[static_cast<size_t>(crowd)].crowd;
+    dtCrowd *bigger = AllocateCrowd(2 * old->getAgentCount());
+    if (bigger == nullptr) {
       return false;
     }
 
-    DEBUG_ASSERT(_nav_query != nullptr);
+    // copy all the agents and remap their actors
+    std::unordered_map<int, ActorId> actors;
+    for (auto &&entry : _crowds[static_cast<size_t>(crowd)].actors) {
+      const int index = CopyAgent(*old->getAgent(entry.first), *bigger);
+      DEBUG_ASSERT(index != -1);
+      actors[index] = entry.second;
+      RemapAgent(entry.second, CrowdAgentIndex { crowd, entry.first }, CrowdAgentIndex { crowd, index });
+    }
 
-    // point extension
-    float poly_pick_ext[3];
-    poly_pick_ext[0] = 2;
-    poly_pick_ext[1] = 4;
-    poly_pick_ext[2] = 2;
+    // exchange
+    _crowds[static_cast<size_t>(crowd)].crowd = bigger;
+    _crowds[static_cast<size_t>(crowd)].actors = std::move(actors);
+    dtFreeCrowd(old);
+    return true;
+  }
 
-    // filter
-    dtQueryFilter filter2;
-    if (filter == nullptr) {
-      filter2.setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-      filter2.setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
-      filter2.setIncludeFlags(CARLA_TYPE_WALKABLE);
-      filter2.setExcludeFlags(CARLA_TYPE_NONE);
-      filter = &filter2;
+  CrowdAgentIndex Navigation::AddAgentToCrowd(int crowd, ActorId id, const float *position,
+  const dtCrowdAgentParams &params) {
+    CrowdAgentIndex result;
+    if (crowd == -1) {
+      return result;
     }
+    int index = _crowds[static_cast<size_t>(crowd)].crowd->addAgent(position, &params);
+    if (index == -1) {
+      // the crowd is full, double its capacity instead of limiting the number of agents
+      if (!GrowCrowd(crowd)) {
+        return result;
+      }
+      index = _crowds[static_cast<size_t>(crowd)].crowd->addAgent(position, &params);
+      if (index == -1) {
+        return result;
+      }
+    }
+    _crowds[static_cast<size_t>(crowd)].actors[index] = id;
+    result.crowd = crowd;
+    result.index = index;
+    return result;
+  }
 
-    // set the points
-    dtPolyRef start_ref = 0;
-    dtPolyRef end_ref = 0;
-    float start_pos[3] = { from.x, from.z, from.y };
-    float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
+  CrowdAgentIndex Navigation::MoveAgentToCrowd(ActorId id, CrowdAgentIndex from, int crowd) {
+    if (crowd == -1) {
+      return from;
     }
-    if (!start_ref || !end_ref) {
-      return false;
+    DEBUG_ASSERT(crowd != from.crowd);
+    dtCrowd *source = _crowds[static_cast<size_t>(from.crowd)].crowd;
+    int index = CopyAgent(*source->getAgent(from.index), *_crowds[static_cast<size_t>(crowd)].crowd);
+    if (index == -1) {
+      // the crowd is full, double its capacity
+      if (!GrowCrowd(crowd)) {
+        return from;
+      }
+      index = CopyAgent(*source->getAgent(from.index), *_crowds[static_cast<size_t>(crowd)].crowd);
+      if (index == -1) {
+        return from;
+      }
     }
+    _crowds[static_cast<size_t>(crowd)].actors[index] = id;
+    RemoveAgentFromCrowd(from);
 
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      // get the path of nodes
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+    CrowdAgentIndex to { crowd, index };
+    RemapAgent(id, from, to);
+    return to;
+  }
+
+  void Navigation::RemapAgent(ActorId id, CrowdAgentIndex from, CrowdAgentIndex to) {
+    auto walker = _mapped_walkers_id.find(id);
+    if (walker != _mapped_walkers_id.end()) {
+      if (walker->second == from) {
+        walker->second = to;
+        return;
+      }
+      // or one of its ghosts
+      auto ghosts = _mapped_walker_ghosts.find(id);
+      if (ghosts != _mapped_walker_ghosts.end()) {
+        for (auto &index : ghosts->second) {
+          if (index == from) {
+            index = to;
+          }
+        }
+      }
+      return;
+    }
+    auto vehicle = _mapped_vehicles_id.find(id);
+    if (vehicle != _mapped_vehicles_id.end()) {
+      for (auto &index : vehicle->second) {
+        if (index == from) {
+          index = to;
+        }
+      }
     }
+  }
 
-    // get the path of points
-    num_straight_path = 0;
-    if (num_polys == 0) {
-      return false;
+  void Navigation::RemoveAgentFromCrowd(CrowdAgentIndex index) {
+    if (index.crowd == -1 || index.index == -1) {
+      return;
     }
+    CrowdTile &tile = _crowds[static_cast<size_t>(index.crowd)];
+    tile.crowd->removeAgent(index.index);
+    tile.actors.erase(index.index);
+  }
 
-    // in case of partial path, make sure the end point is clamped to the last
-    // polygon
-    float end_pos2[3];
-    dtVcopy(end_pos2, end_pos);
-    if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+  dtCrowdAgent *Navigation::GetEditableAgent(CrowdAgentIndex index) {
+    if (index.crowd == -1 || index.index == -1) {
+      return nullptr;
     }
+    return _crowds[static_cast<size_t>(index.crowd)].crowd->getEditableAgent(index.index);
+  }
 
-    // get the points
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
+  std::vector<dtCrowd *> Navigation::GetCrowds() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<dtCrowd *> crowds;
+    crowds.reserve(_crowds.size());
+    for (auto &&tile : _crowds) {
+      crowds.emplace_back(tile.crowd);
     }
+    return crowds;
+  }
 
-    // copy the path to the output buffer
-    path.clear();
-    path.reserve(static_cast<unsigned long>(num_straight_path));
-    unsigned char area_type;
-    for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
-      // save coordinate for Unreal axis (x, z, y)
-      path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
-      // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
+  // take a path query object from the pool, allocating one if all are in use
+  dtNavMeshQuery *Navigation::AcquirePathQuery() {
+    {
+      std::lock_guard<std::mutex> lock(_path_queries_mutex);
+      if (!_path_queries.empty()) {
+        dtNavMeshQuery *query = _path_queries.back();
+        _path_queries.pop_back();
+        return query;
       }
-      area.emplace_back(area_type);
     }
+    dtNavMeshQuery *query = dtAllocNavMeshQuery();
+    if (query == nullptr) {
+      return nullptr;
+    }
+    if (dtStatusFailed(query->init(_nav_mesh, MAX_QUERY_SEARCH_NODES))) {
+      dtFreeNavMeshQuery(query);
+      return nullptr;
+    }
+    return query;
+  }
 
-    return true;
+  // return a path query object to the pool
+  void Navigation::ReleasePathQuery(dtNavMeshQuery *query) {
+    std::lock_guard<std::mutex> lock(_path_queries_mutex);
+    _path_queries.emplace_back(query);
   }
 
-  bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
-  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
+  // compute the path points to go from one position to another using the path cache;
+  // the query object is used by a single thread and the mesh is only read, so no lock is needed
+  bool Navigation::ComputePath(dtNavMeshQuery &query,
+                               const dtQueryFilter &filter,
+                               carla::geom::Location from,
+                               carla::geom::Location to,
+                               std::vector<carla::geom::Location> &path,
+                               std::vector<unsigned char> &area) {
     // path found
     float straight_path[MAX_POLYS * 3];
     unsigned char straight_path_flags[MAX_POLYS];
@@ -371,97 +549,160 @@ namespace nav {
     int num_straight_path = 0;
     int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
 
-    // polys in path
-    dtPolyRef polys[MAX_POLYS];
-    int num_polys;
-
-    // check if all is ready
-    if (!_ready) {
-      return false;
-    }
-
-    DEBUG_ASSERT(_nav_query != nullptr);
-
     // point extension
     float poly_pick_ext[3] = {2,4,2};
 
-    // get current filter from agent
-    auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end())
-      return false;
-
-    const dtQueryFilter *filter;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
-    }
-
     // set the points
     dtPolyRef start_ref = 0;
     dtPolyRef end_ref = 0;
     float start_pos[3] = { from.x, from.z, from.y };
     float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
-    }
+    query.findNearestPoly(start_pos, poly_pick_ext, &filter, &start_ref, 0);
+    query.findNearestPoly(end_pos, poly_pick_ext, &filter, &end_ref, 0);
     if (!start_ref || !end_ref) {
       return false;
     }
 
-    // get the path of nodes
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+    // get the path of nodes, from the cache if it was already found
+    PathCache::Key key { start_ref, end_ref, filter.getIncludeFlags(), filter.getExcludeFlags() };
+    std::vector<dtPolyRef> polys;
+    if (!_path_cache.Get(key, polys)) {
+      dtPolyRef found[MAX_POLYS];
+      int num_polys = 0;
+      const dtStatus status = query.findPath(start_ref, end_ref, start_pos, end_pos, &filter,
+          found, &num_polys, MAX_POLYS);
+      polys.assign(found, found + num_polys);
+      // a partial path depends on the search limits, it is not cached
+      if (dtStatusSucceed(status) && !dtStatusDetail(status, DT_PARTIAL_RESULT)) {
+        _path_cache.Put(key, polys);
+      }
     }
 
     // get the path of points
-    if (num_polys == 0) {
+    if (polys.empty()) {
       return false;
     }
+    const int num_polys = static_cast<int>(polys.size());
 
     // in case of partial path, make sure the end point is clamped to the last
     // polygon
     float end_pos2[3];
     dtVcopy(end_pos2, end_pos);
-    if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+    if (polys.back() != end_ref) {
+      query.closestPointOnPoly(polys.back(), end_pos, end_pos2, 0);
     }
 
     // get the points
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
-    }
+    query.findStraightPath(start_pos, end_pos2, polys.data(), num_polys,
+    straight_path, straight_path_flags,
+    straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
 
     // copy the path to the output buffer
     path.clear();
+    area.clear();
     path.reserve(static_cast<unsigned long>(num_straight_path));
-    unsigned char area_type;
+    area.reserve(static_cast<unsigned long>(num_straight_path));
+    // the end point has no polygon, it keeps the area of the previous point
+    unsigned char area_type = 0;
     for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
       // save coordinate for Unreal axis (x, z, y)
       path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
       // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
-      }
+      _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
       area.emplace_back(area_type);
     }
 
     return true;
   }
 
+  // return the path points to go from one position to another
+  bool Navigation::GetPath(carla::geom::Location from,
+                           carla::geom::Location to,
+                           dtQueryFilter * filter,
+                           std::vector<carla::geom::Location> &path,
+                           std::vector<unsigned char> &area) {
+    // check if all is ready
+    if (!_ready) {
+      return false;
+    }
+
+    // filter
+    dtQueryFilter filter2;
+    if (filter == nullptr) {
+      filter2.setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+      filter2.setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+      filter2.setIncludeFlags(CARLA_TYPE_WALKABLE);
+      filter2.setExcludeFlags(CARLA_TYPE_NONE);
+      filter = &filter2;
+    }
+
+    dtNavMeshQuery *query = AcquirePathQuery();
+    if (query == nullptr) {
+      return false;
+    }
+    const bool found = ComputePath(*query, *filter, from, to, path, area);
+    ReleasePathQuery(query);
+    return found;
+  }
+
+  bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
+  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
+    std::vector<AgentRoute> routes = GetAgentRoutes({ AgentRouteRequest { id, from, to } });
+    path = std::move(routes[0].path);
+    area = std::move(routes[0].area);
+    return routes[0].found;
+  }
+
+  // return the routes of many agents, computed in parallel
+  std::vector<AgentRoute> Navigation::GetAgentRoutes(const std::vector<AgentRouteRequest> &requests) {
+    std::vector<AgentRoute> routes(requests.size());
+
+    // check if all is ready
+    if (!_ready) {
+      return routes;
+    }
+
+    // get the current filter of each agent, copied as the crowds can be replaced when they grow
+    std::vector<dtQueryFilter> filters(requests.size());
+    std::vector<unsigned char> valid(requests.size(), 0u);
+    size_t number_of_threads;
+    std::shared_ptr<ThreadPool> thread_pool;
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (size_t i = 0u; i < requests.size(); ++i) {
+        auto it = _mapped_walkers_id.find(requests[i].id);
+        if (it == _mapped_walkers_id.end()) {
+          continue;
+        }
+        dtCrowd *crowd = _crowds[static_cast<size_t>(it->second.crowd)].crowd;
+        filters[i] = *crowd->getFilter(crowd->getAgent(it->second.index)->params.queryFilterType);
+        valid[i] = 1u;
+      }
+      number_of_threads = _number_of_threads;
+      thread_pool = _thread_pool;
+    }
+
+    // split the paths among the threads, each one with its own query object
+    number_of_threads = std::min(number_of_threads,
+        (requests.size() + MIN_PATHS_PER_THREAD - 1u) / MIN_PATHS_PER_THREAD);
+    ParallelForRanges(*thread_pool, requests.size(), number_of_threads, [&](size_t begin, size_t end) {
+      dtNavMeshQuery *query = AcquirePathQuery();
+      if (query == nullptr) {
+        return;
+      }
+      for (size_t i = begin; i < end; ++i) {
+        if (valid[i]) {
+          routes[i].found = ComputePath(*query, filters[i], requests[i].from, requests[i].to,
+              routes[i].path, routes[i].area);
+        }
+      }
+      ReleasePathQuery(query);
+    });
+
+    return routes;
+  }
+
   // create a new walker in crowd
   bool Navigation::AddWalker(ActorId id, carla::geom::Location from) {
     dtCrowdAgentParams params;
@@ -471,8 +712,6 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
-
     // set parameters
     memset(&params, 0, sizeof(params));
     params.radius = AGENT_RADIUS;
@@ -499,23 +738,22 @@ namespace nav {
     // from Unreal coordinates (subtract half height to move pivot from center
     // (unreal) to bottom (recast))
     float point_from[3] = { from.x, from.z - (AGENT_HEIGHT / 2.0f), from.y };
-    // add walker
-    int index;
+    // add walker to the crowd of its tile
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      index = _crowd->addAgent(point_from, &params);
-      if (index == -1) {
+      const int crowd = GetOrCreateTileCrowd(TileCoordinate(from.x), TileCoordinate(from.y));
+      CrowdAgentIndex index = AddAgentToCrowd(crowd, id, point_from, params);
+      if (index.index == -1) {
         return false;
       }
-    }
 
-    // save the id
-    _mapped_walkers_id[id] = index;
-    _mapped_by_index[index] = id;
+      // save the id
+      _mapped_walkers_id[id] = index;
 
-    // init yaw
-    _yaw_walkers[id] = 0.0f;
+      // init yaw
+      _yaw_walkers[id] = 0.0f;
+    }
 
     // add walker for the route planning
     _walker_manager.AddWalker(id);
@@ -533,8 +771,6 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
-
     // get the bounding box extension plus some space around
     float marge = 0.8f;
     float hx = vehicle.bounding.extent.x + marge;
@@ -556,42 +792,6 @@ namespace nav {
     box_corner3 += vehicle.transform.location;
     box_corner4 += vehicle.transform.location;
 
-    // check if this actor exists
-    auto it = _mapped_vehicles_id.find(vehicle.id);
-    if (it != _mapped_vehicles_id.end()) {
-      // get the index found
-      int index = it->second;
-      if (index != -1) {
-        // get the agent
-        dtCrowdAgent *agent;
-        {
-          // critical section, force single thread running this
-          std::lock_guard<std::mutex> lock(_mutex);
-          agent = _crowd->getEditableAgent(index);
-        }
-        if (agent) {
-          // update its position
-          agent->npos[0] = vehicle.transform.location.x;
-          agent->npos[1] = vehicle.transform.location.z;
-          agent->npos[2] = vehicle.transform.location.y;
-          // update its oriented bounding box
-          agent->params.obb[0]  = box_corner1.x;
-          agent->params.obb[1]  = box_corner1.z;
-          agent->params.obb[2]  = box_corner1.y;
-          agent->params.obb[3]  = box_corner2.x;
-          agent->params.obb[4]  = box_corner2.z;
-          agent->params.obb[5]  = box_corner2.y;
-          agent->params.obb[6]  = box_corner3.x;
-          agent->params.obb[7]  = box_corner3.z;
-          agent->params.obb[8]  = box_corner3.y;
-          agent->params.obb[9]  = box_corner4.x;
-          agent->params.obb[10] = box_corner4.z;
-          agent->params.obb[11] = box_corner4.y;
-        }
-        return true;
-      }
-    }
-
     // set parameters
     memset(&params, 0, sizeof(params));
     params.radius = 2;
@@ -627,27 +827,66 @@ namespace nav {
                             vehicle.transform.location.z,
                             vehicle.transform.location.y };
 
-    // add walker
-    int index;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      index = _crowd->addAgent(point_from, &params);
-      if (index == -1) {
-        logging::log("Vehicle agent not added to the crowd by some problem!");
-        return false;
-      }
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // the vehicle has an agent in each existing crowd closer than the margin
+    const cg::Location &location = vehicle.transform.location;
+    const int min_x = TileCoordinate(location.x - CROWD_VEHICLE_MARGIN);
+    const int max_x = TileCoordinate(location.x + CROWD_VEHICLE_MARGIN);
+    const int min_y = TileCoordinate(location.y - CROWD_VEHICLE_MARGIN);
+    const int max_y = TileCoordinate(location.y + CROWD_VEHICLE_MARGIN);
+    auto is_near = [&](const CrowdTile &tile) {
+      return tile.x >= min_x && tile.x <= max_x && tile.y >= min_y && tile.y <= max_y;
+    };
 
-      // mark as valid
-      dtCrowdAgent *agent = _crowd->getEditableAgent(index);
+    // update its agents in crowds still near, and remove the others
+    std::vector<CrowdAgentIndex> &indices = _mapped_vehicles_id[vehicle.id];
+    std::vector<CrowdAgentIndex> updated;
+    updated.reserve(indices.size());
+    for (auto &&index : indices) {
+      if (!is_near(_crowds[static_cast<size_t>(index.crowd)])) {
+        RemoveAgentFromCrowd(index);
+        continue;
+      }
+      dtCrowdAgent *agent = GetEditableAgent(index);
       if (agent) {
-        agent->state = DT_CROWDAGENT_STATE_WALKING;
+        // update its position
+        dtVcopy(agent->npos, point_from);
+        // update its oriented bounding box
+        memcpy(agent->params.obb, params.obb, sizeof(params.obb));
       }
+      updated.emplace_back(index);
     }
+    indices = std::move(updated);
 
-    // save the id
-    _mapped_vehicles_id[vehicle.id] = index;
-    _mapped_by_index[index] = vehicle.id;
+    // add it to the near crowds that don't have it yet
+    for (int x = min_x; x <= max_x; ++x) {
+      for (int y = min_y; y <= max_y; ++y) {
+        auto it = _crowd_by_tile.find(TileKey(x, y));
+        if (it == _crowd_by_tile.end()) {
+          continue;
+        }
+        const int crowd = it->second;
+        auto found = std::find_if(indices.begin(), indices.end(), [crowd](const CrowdAgentIndex &index) {
+          return index.crowd == crowd;
+        });
+        if (found != indices.end()) {
+          continue;
+        }
+        CrowdAgentIndex index = AddAgentToCrowd(crowd, vehicle.id, point_from, params);
+        if (index.index == -1) {
+          logging::log("Vehicle agent not added to the crowd by some problem!");
+          continue;
+        }
+        // mark as valid
+        dtCrowdAgent *agent = GetEditableAgent(index);
+        if (agent) {
+          agent->state = DT_CROWDAGENT_STATE_WALKING;
+        }
+        indices.emplace_back(index);
+      }
+    }
 
     return true;
   }
@@ -660,42 +899,46 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
 
-    // get the internal walker index
-    auto it = _mapped_walkers_id.find(id);
-    if (it != _mapped_walkers_id.end()) {
-      // remove from crowd
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _crowd->removeAgent(it->second);
+      // get the internal vehicle indices
+      auto vehicle = _mapped_vehicles_id.find(id);
+      if (vehicle != _mapped_vehicles_id.end()) {
+        // remove from all crowds
+        for (auto &&index : vehicle->second) {
+          RemoveAgentFromCrowd(index);
+        }
+        // remove from mapping
+        _mapped_vehicles_id.erase(vehicle);
+        return true;
       }
-      _walker_manager.RemoveWalker(id);
-      // remove from mapping
-      _mapped_walkers_id.erase(it);
-      _mapped_by_index.erase(it->second);
 
-      return true;
-    }
-
-    // get the internal vehicle index
-    it = _mapped_vehicles_id.find(id);
-    if (it != _mapped_vehicles_id.end()) {
+      // get the internal walker index
+      auto walker = _mapped_walkers_id.find(id);
+      if (walker == _mapped_walkers_id.end()) {
+        return false;
+      }
       // remove from crowd
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _crowd->removeAgent(it->second);
+      RemoveAgentFromCrowd(walker->second);
+      // remove its ghosts
+      auto ghosts = _mapped_walker_ghosts.find(id);
+      if (ghosts != _mapped_walker_ghosts.end()) {
+        for (auto &&index : ghosts->second) {
+          RemoveAgentFromCrowd(index);
+        }
+        _mapped_walker_ghosts.erase(ghosts);
       }
       // remove from mapping
-      _mapped_vehicles_id.erase(it);
-      _mapped_by_index.erase(it->second);
-
-      return true;
+      _mapped_walkers_id.erase(walker);
+      _walkers_blocked_position.erase(id);
+      _yaw_walkers.erase(id);
     }
 
-    return false;
+    _walker_manager.RemoveWalker(id);
+
+    return true;
   }
 
   // add/update/delete vehicles in crowd
@@ -703,8 +946,12 @@ namespace nav {
     std::unordered_set<carla::rpc::ActorId> updated;
 
     // add all current mapped vehicles in the set
-    for (auto &&entry : _mapped_vehicles_id) {
-      updated.insert(entry.first);
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &&entry : _mapped_vehicles_id) {
+        updated.insert(entry.first);
+      }
     }
 
     // add all vehicles (if already exists, it gets updated only)
@@ -732,7 +979,8 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
 
     // get the internal index
     auto it = _mapped_walkers_id.find(id);
@@ -741,14 +989,10 @@ namespace nav {
     }
 
     // get the agent
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      dtCrowdAgent *agent = _crowd->getEditableAgent(it->second);
-      if (agent) {
-        agent->params.maxSpeed = max_speed;
-        return true;
-      }
+    dtCrowdAgent *agent = GetEditableAgent(it->second);
+    if (agent) {
+      agent->params.maxSpeed = max_speed;
+      return true;
     }
 
     return false;
@@ -763,9 +1007,12 @@ namespace nav {
     }
 
     // get the internal index
-    auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      return false;
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_mapped_walkers_id.find(id) == _mapped_walkers_id.end()) {
+        return false;
+      }
     }
 
     return _walker_manager.SetWalkerRoute(id, to);
@@ -780,26 +1027,31 @@ namespace nav {
     }
 
     // get the internal index
-    auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      return false;
+    CrowdAgentIndex index;
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _mapped_walkers_id.find(id);
+      if (it == _mapped_walkers_id.end()) {
+        return false;
+      }
+      index = it->second;
     }
 
-    return SetWalkerDirectTargetIndex(it->second, to);
+    return SetWalkerDirectTargetIndex(index, to);
   }
 
   // set a new target point to go directly without events
-  bool Navigation::SetWalkerDirectTargetIndex(int index, carla::geom::Location to) {
+  bool Navigation::SetWalkerDirectTargetIndex(CrowdAgentIndex index, carla::geom::Location to) {
 
     // check if all is ready
     if (!_ready) {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
     DEBUG_ASSERT(_nav_query != nullptr);
 
-    if (index == -1) {
+    if (index.crowd == -1 || index.index == -1) {
       return false;
     }
 
@@ -810,19 +1062,187 @@ namespace nav {
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      const dtQueryFilter *filter = _crowd->getFilter(0);
+      if (static_cast<size_t>(index.crowd) >= _crowds.size()) {
+        return false;
+      }
+      dtCrowd *crowd = _crowds[static_cast<size_t>(index.crowd)].crowd;
+      const dtQueryFilter *filter = crowd->getFilter(0);
       dtPolyRef target_ref;
-      _nav_query->findNearestPoly(point_to, _crowd->getQueryHalfExtents(), filter, &target_ref, nearest);
+      _nav_query->findNearestPoly(point_to, crowd->getQueryHalfExtents(), filter, &target_ref, nearest);
       if (!target_ref) {
         return false;
       }
 
-      res = _crowd->requestMoveTarget(index, target_ref, point_to);
+      res = crowd->requestMoveTarget(index.index, target_ref, point_to);
     }
 
     return res;
   }
 
+  // update the crowds of all tiles in parallel
+  void Navigation::UpdateCrowds(float delta_seconds) {
+    if (_crowds.empty()) {
+      return;
+    }
+
+    // each crowd owns its navigation mesh query, path queue, proximity grid and obstacle avoidance
+    // query, and the navigation mesh is only read, so the crowds can be updated at the same time;
+    // balance the work by giving the biggest crowds to different threads
+    const size_t number_of_threads = std::max<size_t>(1u, std::min(_number_of_threads, _crowds.size()));
+    std::vector<size_t> order(_crowds.size());
+    for (size_t i = 0u; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      return _crowds[a].actors.size() > _crowds[b].actors.size();
+    });
+    std::vector<std::vector<size_t>> groups(number_of_threads);
+    std::vector<size_t> load(number_of_threads, 0u);
+    for (size_t crowd : order) {
+      const size_t group = static_cast<size_t>(
+          std::min_element(load.begin(), load.end()) - load.begin());
+      groups[group].emplace_back(crowd);
+      load[group] += _crowds[crowd].actors.size() + 1u;
+    }
+
+    ParallelForRanges(*_thread_pool, groups.size(), number_of_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        for (size_t crowd : groups[i]) {
+          _crowds[crowd].crowd->update(delta_seconds, nullptr);
+        }
+      }
+    });
+  }
+
+  // move the walkers that left their tile to the crowd of their new tile
+  void Navigation::MigrateWalkers() {
+    std::vector<std::pair<ActorId, std::pair<int, int>>> migrations;
+    for (auto &&entry : _mapped_walkers_id) {
+      const CrowdTile &tile = _crowds[static_cast<size_t>(entry.second.crowd)];
+      const dtCrowdAgent *agent = tile.crowd->getAgent(entry.second.index);
+      if (!agent->active) {
+        continue;
+      }
+      // from Recast coordinates to Unreal coordinates
+      const float x = agent->npos[0];
+      const float y = agent->npos[2];
+      const float min_x = static_cast<float>(tile.x) * CROWD_TILE_SIZE - CROWD_TILE_MARGIN;
+      const float min_y = static_cast<float>(tile.y) * CROWD_TILE_SIZE - CROWD_TILE_MARGIN;
+      const float max_x = static_cast<float>(tile.x + 1) * CROWD_TILE_SIZE + CROWD_TILE_MARGIN;
+      const float max_y = static_cast<float>(tile.y + 1) * CROWD_TILE_SIZE + CROWD_TILE_MARGIN;
+      if (x < min_x || x > max_x || y < min_y || y > max_y) {
+        migrations.emplace_back(entry.first, std::make_pair(TileCoordinate(x), TileCoordinate(y)));
+      }
+    }
+
+    for (auto &&migration : migrations) {
+      const int crowd = GetOrCreateTileCrowd(migration.second.first, migration.second.second);
+      MoveAgentToCrowd(migration.first, _mapped_walkers_id[migration.first], crowd);
+    }
+  }
+
+  // keep a ghost of each walker near the border of its tile in the crowds of the tiles next to it,
+  // updated after the crowds so they are avoided at their current position in the next update
+  void Navigation::UpdateGhosts() {
+    for (auto &&entry : _mapped_walkers_id) {
+      const ActorId id = entry.first;
+      const CrowdAgentIndex walker_index = entry.second;
+      const dtCrowdAgent *agent = GetEditableAgent(walker_index);
+      auto ghosts = _mapped_walker_ghosts.find(id);
+      if (agent == nullptr || !agent->active) {
+        if (ghosts != _mapped_walker_ghosts.end()) {
+          for (auto &&index : ghosts->second) {
+            RemoveAgentFromCrowd(index);
+          }
+          _mapped_walker_ghosts.erase(ghosts);
+        }
+        continue;
+      }
+
+      // from Recast coordinates to Unreal coordinates
+      const float x = agent->npos[0];
+      const float y = agent->npos[2];
+      const int min_x = TileCoordinate(x - CROWD_GHOST_MARGIN);
+      const int max_x = TileCoordinate(x + CROWD_GHOST_MARGIN);
+      const int min_y = TileCoordinate(y - CROWD_GHOST_MARGIN);
+      const int max_y = TileCoordinate(y + CROWD_GHOST_MARGIN);
+      if (ghosts == _mapped_walker_ghosts.end() && min_x == max_x && min_y == max_y &&
+          _crowds[static_cast<size_t>(walker_index.crowd)].x == min_x &&
+          _crowds[static_cast<size_t>(walker_index.crowd)].y == min_y) {
+        // far from the borders of its tile, the common case
+        continue;
+      }
+
+      // copy the state of the walker, the crowds may be replaced when they grow
+      float position[3];
+      float velocity[3];
+      dtVcopy(position, agent->npos);
+      dtVcopy(velocity, agent->vel);
+      dtCrowdAgentParams params = agent->params;
+      params.maxAcceleration = 0.0f;
+      params.collisionQueryRange = 0;
+      params.obstacleAvoidanceType = 0;
+      params.separationWeight = 0.0f;
+      params.updateFlags = 0;
+
+      // the existing crowds near the walker, other than its own
+      std::vector<int> near_crowds;
+      for (int tile_x = min_x; tile_x <= max_x; ++tile_x) {
+        for (int tile_y = min_y; tile_y <= max_y; ++tile_y) {
+          auto it = _crowd_by_tile.find(TileKey(tile_x, tile_y));
+          if (it != _crowd_by_tile.end() && it->second != walker_index.crowd) {
+            near_crowds.emplace_back(it->second);
+          }
+        }
+      }
+
+      // move its ghosts in crowds still near, and remove the others
+      std::vector<CrowdAgentIndex> updated;
+      if (ghosts != _mapped_walker_ghosts.end()) {
+        for (auto &&index : ghosts->second) {
+          if (std::find(near_crowds.begin(), near_crowds.end(), index.crowd) == near_crowds.end()) {
+            RemoveAgentFromCrowd(index);
+            continue;
+          }
+          dtCrowdAgent *ghost = GetEditableAgent(index);
+          if (ghost) {
+            dtVcopy(ghost->npos, position);
+            dtVcopy(ghost->vel, velocity);
+          }
+          updated.emplace_back(index);
+        }
+      }
+
+      // add it to the near crowds that don't have it yet
+      for (int crowd : near_crowds) {
+        auto found = std::find_if(updated.begin(), updated.end(), [crowd](const CrowdAgentIndex &index) {
+          return index.crowd == crowd;
+        });
+        if (found != updated.end()) {
+          continue;
+        }
+        CrowdAgentIndex index = AddAgentToCrowd(crowd, id, position, params);
+        if (index.index == -1) {
+          continue;
+        }
+        dtCrowdAgent *ghost = GetEditableAgent(index);
+        if (ghost) {
+          dtVcopy(ghost->vel, velocity);
+          ghost->state = DT_CROWDAGENT_STATE_WALKING;
+        }
+        updated.emplace_back(index);
+      }
+
+      if (updated.empty()) {
+        if (ghosts != _mapped_walker_ghosts.end()) {
+          _mapped_walker_ghosts.erase(ghosts);
+        }
+      } else {
+        _mapped_walker_ghosts[id] = std::move(updated);
+      }
+    }
+  }
+
   // update all walkers in crowd
   void Navigation::UpdateCrowd(const client::detail::EpisodeState &state) {
 
@@ -831,14 +1251,14 @@ namespace nav {
       return;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
-
     // update crowd agents
     _delta_seconds = state.GetTimestamp().delta_seconds;
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      _crowd->update(static_cast<float>(_delta_seconds), nullptr);
+      UpdateCrowds(static_cast<float>(_delta_seconds));
+      MigrateWalkers();
+      UpdateGhosts();
     }
 
     // update the walkers route
@@ -846,68 +1266,38 @@ namespace nav {
 
     // update the time to check for blocked agents
     _time_to_unblock += _delta_seconds;
+    if (_time_to_unblock < AGENT_UNBLOCK_TIME) {
+      return;
+    }
+    _time_to_unblock = 0.0;
 
-    // check all active agents
-    int total_unblocked = 0;
-    int total_agents;
+    // check all active walkers not paused, getting the blocked ones in a single pass
+    std::vector<ActorId> blocked;
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      total_agents = _crowd->getAgentCount();
-    }
-    const dtCrowdAgent *ag;
-    for (int i = 0; i < total_agents; ++i) {
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        ag = _crowd->getAgent(i);
-      }
-      if (!ag->active || ag->paused) {
-        continue;
-      }
+      for (auto &&entry : _mapped_walkers_id) {
+        const dtCrowdAgent *agent = GetEditableAgent(entry.second);
+        if (agent == nullptr || !agent->active || agent->paused) {
+          continue;
+        }
 
-      // check only pedestrians not paused, and no vehicles
-      if (!ag->params.useObb && !ag->paused) {
-        bool reset_target_pos = false;
-        bool use_same_filter = false;
-
-        // check for unblocking actors
-        if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-          // get the distance moved by each actor
-          carla::geom::Vector3D previous = _walkers_blocked_position[i];
-          carla::geom::Vector3D current = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
-          carla::geom::Vector3D distance = current - previous;
-          float d = distance.SquaredLength();
-          if (d < AGENT_UNBLOCK_DISTANCE_SQUARED) {
-            ++total_unblocked;
-            reset_target_pos = true;
-            use_same_filter = true;
-          }
-          // update with current position
-          _walkers_blocked_position[i] = current;
-
-          // check to assign a new target position
-          if (reset_target_pos) {
-            // set if the agent can cross roads or not
-            if (!use_same_filter) {
-              if (frand() <= _probability_crossing) {
-                SetAgentFilter(i, 1);
-              } else {
-                SetAgentFilter(i, 0);
-              }
-            }
-            // set a new random target
-            carla::geom::Location location;
-            GetRandomLocation(location, nullptr);
-            _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
-          }
+        // get the distance moved by each actor
+        carla::geom::Vector3D &previous = _walkers_blocked_position[entry.first];
+        carla::geom::Vector3D current = carla::geom::Vector3D(agent->npos[0], agent->npos[1], agent->npos[2]);
+        carla::geom::Vector3D distance = current - previous;
+        if (distance.SquaredLength() < AGENT_UNBLOCK_DISTANCE_SQUARED) {
+          blocked.emplace_back(entry.first);
         }
+        // update with current position
+        previous = current;
       }
     }
 
-    // check for resetting time
-    if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-      _time_to_unblock = 0.0f;
+    // set a new random target to the blocked walkers, computing all the routes at once (outside
+    // the lock, the walker manager calls back this class)
+    if (!blocked.empty()) {
+      _walker_manager.SetWalkerRoutes(blocked);
     }
   }
 
@@ -919,7 +1309,8 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
 
     // get the internal index
     auto it = _mapped_walkers_id.find(id);
@@ -927,21 +1318,9 @@ namespace nav {
       return false;
     }
 
-    // get the index found
-    int index = it->second;
-    if (index == -1) {
-      return false;
-    }
-
     // get the walker
-    const dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
-    }
-
-    if (!agent->active) {
+    const dtCrowdAgent *agent = GetEditableAgent(it->second);
+    if (agent == nullptr || !agent->active) {
       return false;
     }
 
@@ -964,13 +1343,14 @@ namespace nav {
     }
 
     // interpolate current and target angle
-    float shortest_angle = fmod(yaw - _yaw_walkers[id] + 540.0f, 360.0f) - 180.0f;
+    float &previous_yaw = _yaw_walkers[id];
+    float shortest_angle = fmod(yaw - previous_yaw + 540.0f, 360.0f) - 180.0f;
     float per = (speed / 1.5f);
     if (per > 1.0f) per = 1.0f;
     float rotation_speed = per * 6.0f;
-    trans.rotation.yaw = _yaw_walkers[id] +
+    trans.rotation.yaw = previous_yaw +
     (shortest_angle * rotation_speed * static_cast<float>(_delta_seconds));
-    _yaw_walkers[id] = trans.rotation.yaw;
+    previous_yaw = trans.rotation.yaw;
 
     return true;
   }
@@ -983,7 +1363,8 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
 
     // get the internal index
     auto it = _mapped_walkers_id.find(id);
@@ -991,21 +1372,9 @@ namespace nav {
       return false;
     }
 
-    // get the index found
-    int index = it->second;
-    if (index == -1) {
-      return false;
-    }
-
     // get the walker
-    const dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
-    }
-
-    if (!agent->active) {
+    const dtCrowdAgent *agent = GetEditableAgent(it->second);
+    if (agent == nullptr || !agent->active) {
       return false;
     }
 
@@ -1024,7 +1393,8 @@ namespace nav {
       return 0.0f;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
 
     // get the internal index
     auto it = _mapped_walkers_id.find(id);
@@ -1032,18 +1402,10 @@ namespace nav {
       return 0.0f;
     }
 
-    // get the index found
-    int index = it->second;
-    if (index == -1) {
-      return 0.0f;
-    }
-
     // get the walker
-    const dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
+    const dtCrowdAgent *agent = GetEditableAgent(it->second);
+    if (agent == nullptr) {
+      return 0.0f;
     }
 
     return sqrt(agent->vel[0] * agent->vel[0] + agent->vel[1] * agent->vel[1] + agent->vel[2] *
@@ -1091,17 +1453,14 @@ namespace nav {
     return (rounds > 0);
   }
 
-  // assign a filter index to an agent
-  void Navigation::SetAgentFilter(int agent_index, int filter_index)
+  // assign a filter index to an agent (the lock must be taken)
+  void Navigation::SetAgentFilter(CrowdAgentIndex agent_index, int filter_index)
   {
     // get the walker
-    dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(agent_index);
+    dtCrowdAgent *agent = GetEditableAgent(agent_index);
+    if (agent) {
+      agent->params.queryFilterType = static_cast<unsigned char>(filter_index);
     }
-    agent->params.queryFilterType = static_cast<unsigned char>(filter_index);
   }
 
   // set the probability that an agent could cross the roads in its path following
@@ -1113,6 +1472,16 @@ namespace nav {
     _probability_crossing = percentage;
   }
 
+  // set the number of threads used to update the crowd tiles
+  void Navigation::SetNumberOfThreads(size_t number_of_threads)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (number_of_threads != _number_of_threads) {
+      _thread_pool = MakeThreadPool(number_of_threads);
+    }
+    _number_of_threads = number_of_threads;
+  }
+
   // set an agent as paused for the crowd
   void Navigation::PauseAgent(ActorId id, bool pause) {
     // check if all is ready
@@ -1120,7 +1489,8 @@ namespace nav {
       return;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
 
     // get the internal index
     auto it = _mapped_walkers_id.find(id);
@@ -1128,18 +1498,10 @@ namespace nav {
       return;
     }
 
-    // get the index found
-    int index = it->second;
-    if (index == -1) {
-      return;
-    }
-
     // get the walker
-    dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(index);
+    dtCrowdAgent *agent = GetEditableAgent(it->second);
+    if (agent == nullptr) {
+      return;
     }
 
     // mark
@@ -1147,41 +1509,50 @@ namespace nav {
   }
 
   bool Navigation::HasVehicleNear(ActorId id, float distance, carla::geom::Location direction) {
+    float dir[3] = { direction.x, direction.z, direction.y };
+
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+
     // get the internal index (walker or vehicle)
+    CrowdAgentIndex index;
     auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      it = _mapped_vehicles_id.find(id);
-      if (it == _mapped_vehicles_id.end()) {
+    if (it != _mapped_walkers_id.end()) {
+      index = it->second;
+    } else {
+      auto vehicle = _mapped_vehicles_id.find(id);
+      if (vehicle == _mapped_vehicles_id.end() || vehicle->second.empty()) {
         return false;
       }
+      index = vehicle->second.front();
     }
 
-    float dir[3] = { direction.x, direction.z, direction.y };
-    bool result;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      result = _crowd->hasVehicleNear(it->second, distance * distance, dir, false);
-    }
-    return result;
+    return _crowds[static_cast<size_t>(index.crowd)].crowd->hasVehicleNear(
+        index.index, distance * distance, dir, false);
   }
 
   /// make agent look at some location
   bool Navigation::SetWalkerLookAt(ActorId id, carla::geom::Location location) {
+
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+
     // get the internal index (walker or vehicle)
+    CrowdAgentIndex index;
     auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      it = _mapped_vehicles_id.find(id);
-      if (it == _mapped_vehicles_id.end()) {
+    if (it != _mapped_walkers_id.end()) {
+      index = it->second;
+    } else {
+      auto vehicle = _mapped_vehicles_id.find(id);
+      if (vehicle == _mapped_vehicles_id.end() || vehicle->second.empty()) {
         return false;
       }
+      index = vehicle->second.front();
     }
 
-    dtCrowdAgent *agent;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(it->second);
+    dtCrowdAgent *agent = GetEditableAgent(index);
+    if (agent == nullptr) {
+      return false;
     }
 
     // get the position
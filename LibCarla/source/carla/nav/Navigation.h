@@ -7,10 +7,12 @@
 #pragma once
 
 #include "carla/AtomicList.h"
+#include "carla/ThreadPool.h"
 #include "carla/client/detail/EpisodeState.h"
 #include "carla/geom/BoundingBox.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
+#include "carla/nav/PathCache.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/rpc/ActorId.h"
 #include <recast/Recast.h>
@@ -20,6 +22,8 @@
 #include <recast/DetourNavMeshQuery.h>
 #include <recast/DetourCommon.h>
 
+#include <memory>
+
 namespace carla {
 namespace nav {
 
@@ -43,6 +47,31 @@ namespace nav {
     CARLA_TYPE_WALKABLE   = CARLA_TYPE_SIDEWALK | CARLA_TYPE_CROSSWALK | CARLA_TYPE_GRASS | CARLA_TYPE_ROAD,
   };
 
+  /// position of an agent in the partitioned crowd: the crowd simulating its
+  /// tile and its index inside that crowd
+  struct CrowdAgentIndex {
+    int crowd { -1 };
+    int index { -1 };
+
+    bool operator==(const CrowdAgentIndex &rhs) const {
+      return crowd == rhs.crowd && index == rhs.index;
+    }
+  };
+
+  /// request of a route for an agent, to compute many of them at once
+  struct AgentRouteRequest {
+    ActorId id;
+    carla::geom::Location from;
+    carla::geom::Location to;
+  };
+
+  /// route computed for an AgentRouteRequest
+  struct AgentRoute {
+    bool found { false };
+    std::vector<carla::geom::Location> path;
+    std::vector<unsigned char> area;
+  };
+
   /// struct to send info about vehicles to the crowd
   struct VehicleCollisionInfo {
     carla::rpc::ActorId id;
@@ -54,6 +83,12 @@ namespace nav {
   ///
   /// This class gets the binary content of the map from the server, which is required for the path finding.
   /// Then this class can add or remove pedestrians, and also set target points to walk for each one.
+  ///
+  /// The crowd is partitioned in square tiles of the map, each one simulated by its own dtCrowd that grows
+  /// on demand, so the number of walkers is not limited and the tiles can be updated in parallel. Walkers move
+  /// to the crowd of a new tile when they leave theirs, and vehicles are added to all the crowds near them.
+  /// Walkers near the border of their tile have a ghost agent in the crowds of the tiles next to it, so the
+  /// walkers at both sides of the border avoid each other.
   class Navigation : private NonCopyable {
 
   public:
@@ -70,10 +105,12 @@ namespace nav {
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
     bool GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+    /// return the routes of many agents, computed in parallel with a query object for each thread
+    std::vector<AgentRoute> GetAgentRoutes(const std::vector<AgentRouteRequest> &requests);
 
     /// set the seed to use with random numbers
     void SetSeed(unsigned int seed);
-    /// create the crowd object
+    /// reset the partitioned crowd, the crowd of each tile is created when the first walker enters it
     void CreateCrowd(void);
     /// create a new walker
     bool AddWalker(ActorId id, carla::geom::Location from);
@@ -89,7 +126,7 @@ namespace nav {
     bool SetWalkerTarget(ActorId id, carla::geom::Location to);
     // set a new target point to go directly without events
     bool SetWalkerDirectTarget(ActorId id, carla::geom::Location to);
-    bool SetWalkerDirectTargetIndex(int index, carla::geom::Location to);
+    bool SetWalkerDirectTargetIndex(CrowdAgentIndex index, carla::geom::Location to);
     /// get the walker current transform
     bool GetWalkerTransform(ActorId id, carla::geom::Transform &trans);
     /// get the walker current location
@@ -102,6 +139,9 @@ namespace nav {
     bool GetRandomLocation(carla::geom::Location &location, dtQueryFilter * filter = nullptr) const;
     /// set the probability that an agent could cross the roads in its path following
     void SetPedestriansCrossFactor(float percentage);
+    /// set the number of threads used to update the crowd tiles, zero or one (the default) updates them in
+    /// the calling thread
+    void SetNumberOfThreads(size_t number_of_threads);
     /// set an agent as paused for the crowd
     void PauseAgent(ActorId id, bool pause);
     /// return if the agent has a vehicle near (as neighbour)
@@ -109,7 +149,8 @@ namespace nav {
     /// make agent look at some location
     bool SetWalkerLookAt(ActorId id, carla::geom::Location location);
 
-    dtCrowd *GetCrowd() { return _crowd; };
+    /// return the crowds of all the tiles
+    std::vector<dtCrowd *> GetCrowds() const;
 
     /// return the last delta seconds
     double GetDeltaSeconds() { return _delta_seconds; };
@@ -122,17 +163,31 @@ namespace nav {
     /// meshes
     dtNavMesh *_nav_mesh { nullptr };
     dtNavMeshQuery *_nav_query { nullptr };
-    /// crowd
-    dtCrowd *_crowd { nullptr };
-    /// mapping Id
-    std::unordered_map<ActorId, int> _mapped_walkers_id;
-    std::unordered_map<ActorId, int> _mapped_vehicles_id;
-    // mapping by index also
-    std::unordered_map<int, ActorId> _mapped_by_index;
+    /// query objects to compute paths without locking the crowd, one for each thread using them
+    std::vector<dtNavMeshQuery *> _path_queries;
+    std::mutex _path_queries_mutex;
+    /// polygons of the last paths found
+    PathCache _path_cache;
+    /// crowd simulating one tile of the map
+    struct CrowdTile {
+      dtCrowd *crowd { nullptr };
+      int x { 0 };
+      int y { 0 };
+      /// actor of each agent index
+      std::unordered_map<int, ActorId> actors;
+    };
+    std::vector<CrowdTile> _crowds;
+    /// crowd index of each tile key
+    std::unordered_map<uint64_t, int> _crowd_by_tile;
+    /// mapping Id (vehicles are in all the crowds near them)
+    std::unordered_map<ActorId, CrowdAgentIndex> _mapped_walkers_id;
+    std::unordered_map<ActorId, std::vector<CrowdAgentIndex>> _mapped_vehicles_id;
+    /// ghost agents of the walkers near the border of their tile, in the crowds of the tiles next to it
+    std::unordered_map<ActorId, std::vector<CrowdAgentIndex>> _mapped_walker_ghosts;
     /// store walkers yaw angle from previous tick
     std::unordered_map<ActorId, float> _yaw_walkers;
     /// saves the position of each actor at intervals and check if any is blocked
-    std::unordered_map<int, carla::geom::Vector3D> _walkers_blocked_position;
+    std::unordered_map<ActorId, carla::geom::Vector3D> _walkers_blocked_position;
     double _time_to_unblock { 0.0 };
 
     /// walker manager for the route planning with events
@@ -142,8 +197,43 @@ namespace nav {
 
     float _probability_crossing { 0.0f };
 
+    size_t _number_of_threads { 0u };
+    /// threads updating the crowd tiles and computing the routes, kept between ticks
+    std::shared_ptr<ThreadPool> _thread_pool;
+
+    /// take a path query object from the pool, allocating one if all are in use
+    dtNavMeshQuery *AcquirePathQuery();
+    /// return a path query object to the pool
+    void ReleasePathQuery(dtNavMeshQuery *query);
+    /// compute the path points to go from one position to another using the path cache
+    bool ComputePath(dtNavMeshQuery &query, const dtQueryFilter &filter,
+    carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+    /// allocate a crowd with the filters and avoidance settings of the walkers
+    dtCrowd *AllocateCrowd(int max_agents) const;
+    /// return the index of the crowd simulating a tile, creating it if needed (-1 on failure)
+    int GetOrCreateTileCrowd(int x, int y);
+    /// add an agent to a crowd, growing the crowd if it is full
+    CrowdAgentIndex AddAgentToCrowd(int crowd, ActorId id, const float *position,
+    const dtCrowdAgentParams &params);
+    /// move an agent (position, velocity and target) to another crowd, growing it if it is full
+    CrowdAgentIndex MoveAgentToCrowd(ActorId id, CrowdAgentIndex from, int crowd);
+    /// update the mapping of an actor when its agent changes of crowd or index
+    void RemapAgent(ActorId id, CrowdAgentIndex from, CrowdAgentIndex to);
+    /// remove an agent from its crowd
+    void RemoveAgentFromCrowd(CrowdAgentIndex index);
+    /// replace a crowd by another one with double capacity
+    bool GrowCrowd(int crowd);
+    /// move the walkers that left their tile to the crowd of their new tile
+    void MigrateWalkers();
+    /// update the crowds of all tiles in parallel
+    void UpdateCrowds(float delta_seconds);
+    /// add, move or remove the ghost agents of the walkers near the border of their tile
+    void UpdateGhosts();
+    /// get an agent of the partitioned crowd, nullptr if not valid
+    dtCrowdAgent *GetEditableAgent(CrowdAgentIndex index);
     /// assign a filter index to an agent
-    void SetAgentFilter(int agent_index, int filter_index);
+    void SetAgentFilter(CrowdAgentIndex agent_index, int filter_index);
   };
 
 } // namespace nav
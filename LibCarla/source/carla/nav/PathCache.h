@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <recast/DetourNavMesh.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace nav {
+
+  /// Bounded cache of the polygons of the paths between two polygons of the
+  /// navigation mesh, discarding the least recently used path when it is
+  /// full. It can be used by several threads at the same time.
+  ///
+  /// The path is found for a pair of positions inside the polygons, but any of
+  /// them is a valid corridor for other positions of the same polygons, as the
+  /// straight path is computed from the actual positions.
+  class PathCache : private NonCopyable {
+  public:
+
+    /// the polygons at both ends and the flags of the filter used
+    struct Key {
+      dtPolyRef start;
+      dtPolyRef end;
+      unsigned short include_flags;
+      unsigned short exclude_flags;
+
+      bool operator==(const Key &rhs) const {
+        return start == rhs.start && end == rhs.end &&
+            include_flags == rhs.include_flags && exclude_flags == rhs.exclude_flags;
+      }
+    };
+
+    explicit PathCache(size_t capacity)
+      : _capacity(capacity) {}
+
+    /// copy the polygons of a cached path in @a polys, return false if not cached
+    bool Get(const Key &key, std::vector<dtPolyRef> &polys) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _index.find(key);
+      if (it == _index.end()) {
+        return false;
+      }
+      // mark as the most recently used
+      _entries.splice(_entries.begin(), _entries, it->second);
+      polys = it->second->second;
+      return true;
+    }
+
+    /// add a path, removing the least recently used one if the cache is full
+    void Put(const Key &key, std::vector<dtPolyRef> polys) {
+      if (_capacity == 0u) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _index.find(key);
+      if (it != _index.end()) {
+        it->second->second = std::move(polys);
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return;
+      }
+      if (_entries.size() >= _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+      }
+      _entries.emplace_front(key, std::move(polys));
+      _index[key] = _entries.begin();
+    }
+
+    /// remove all paths, they are not valid for another navigation mesh
+    void Clear() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _index.clear();
+      _entries.clear();
+    }
+
+    size_t Size() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _entries.size();
+    }
+
+  private:
+
+    struct KeyHash {
+      size_t operator()(const Key &key) const {
+        size_t seed = 0u;
+        boost::hash_combine(seed, key.start);
+        boost::hash_combine(seed, key.end);
+        boost::hash_combine(seed, key.include_flags);
+        boost::hash_combine(seed, key.exclude_flags);
+        return seed;
+      }
+    };
+
+    using Entry = std::pair<Key, std::vector<dtPolyRef>>;
+
+    const size_t _capacity;
+
+    mutable std::mutex _mutex;
+
+    /// most recently used first
+    std::list<Entry> _entries;
+
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+  };
+
+} // namespace nav
+} // namespace carla
@@ -42,6 +42,9 @@ namespace nav {
 	// update all routes
     bool WalkerManager::Update(double delta) {
 
+        // walkers that need a new route, computed all at once at the end
+        std::vector<ActorId> reroute;
+
         // check all walkers
         for (auto &it : _walkers) {
 
@@ -73,12 +76,18 @@ namespace nav {
                         case EventResult::Continue:
                             break;
                         case EventResult::End:
-                            // next point in route
-                            SetWalkerNextPoint(it.first);
+                            // next point in route, or a new route after the last one
+                            if (info.currentIndex + 1 < info.route.size()) {
+                                SetWalkerNextPoint(it.first);
+                            } else {
+                                info.state = WALKER_STOP;
+                                _nav->PauseAgent(it.first, true);
+                                reroute.emplace_back(it.first);
+                            }
                             break;
                         case EventResult::TimeOut:
                             // unblock changing the route
-                            SetWalkerRoute(it.first);
+                            reroute.emplace_back(it.first);
                             break;
                     }
                     break;
@@ -89,6 +98,11 @@ namespace nav {
             }
         }
 
+        // set the new routes
+        if (!reroute.empty()) {
+            SetWalkerRoutes(reroute);
+        }
+
         return true;
     }
 
@@ -108,30 +122,75 @@ namespace nav {
 
 	// set a new route from its current position
     bool WalkerManager::SetWalkerRoute(ActorId id, carla::geom::Location to) {
+        return SetWalkerRoutes(std::vector<ActorId> { id }, std::vector<carla::geom::Location> { to });
+    }
+
+	// set new random routes to many walkers from their current positions
+    bool WalkerManager::SetWalkerRoutes(const std::vector<ActorId> &ids) {
         // check
         if (_nav == nullptr)
             return false;
 
-        // search
-        auto it = _walkers.find(id);
-        if (it == _walkers.end())
+        // set new random targets
+        std::vector<carla::geom::Location> locations(ids.size());
+        for (auto &location : locations) {
+            _nav->GetRandomLocation(location, nullptr);
+        }
+
+        // set the routes
+        return SetWalkerRoutes(ids, locations);
+    }
+
+	// set new routes to many walkers from their current positions
+    bool WalkerManager::SetWalkerRoutes(const std::vector<ActorId> &ids,
+    const std::vector<carla::geom::Location> &to) {
+        // check
+        if (_nav == nullptr)
             return false;
 
-        // get it
-        WalkerInfo &info = it->second;
-        std::vector<carla::geom::Location> path;
-        std::vector<unsigned char> area;
+        DEBUG_ASSERT(ids.size() == to.size());
+
+        // save both points for each route
+        bool all_found = true;
+        std::vector<AgentRouteRequest> requests;
+        std::vector<WalkerInfo *> infos;
+        requests.reserve(ids.size());
+        infos.reserve(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            // search
+            auto it = _walkers.find(ids[i]);
+            if (it == _walkers.end()) {
+                all_found = false;
+                continue;
+            }
 
-        // save both points for the route
-        _nav->GetWalkerPosition(id, info.from);
-        info.to = to;
-        info.currentIndex = 0;
-        info.state = WALKER_IDLE;
+            // get it
+            WalkerInfo &info = it->second;
+            _nav->GetWalkerPosition(ids[i], info.from);
+            info.to = to[i];
+            info.currentIndex = 0;
+            info.state = WALKER_IDLE;
+            requests.emplace_back(AgentRouteRequest { ids[i], info.from, to[i] });
+            infos.emplace_back(&info);
+        }
+
+        // get the routes from navigation
+        std::vector<AgentRoute> routes = _nav->GetAgentRoutes(requests);
 
-        // get a route from navigation
-        _nav->GetAgentRoute(id, info.from, to, path, area);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            // create each point of the route
+            BuildRoute(*infos[i], routes[i].path, routes[i].area);
 
-        // create each point of the route
+            // assign the first point to go (second in the list)
+            SetWalkerNextPoint(requests[i].id);
+        }
+
+        return all_found;
+    }
+
+    // create the points of the route with their events
+    void WalkerManager::BuildRoute(WalkerInfo &info, std::vector<carla::geom::Location> &path,
+    const std::vector<unsigned char> &area) {
         info.route.clear();
         info.route.reserve(path.size());
         unsigned char previous_area = CARLA_AREA_SIDEWALK;
@@ -156,10 +215,6 @@ namespace nav {
             }
             previous_area = area[i];
         }
-
-        // assign the first point to go (second in the list)
-        SetWalkerNextPoint(id);
-        return true;
     }
 
     // set the next point in the route
@@ -12,6 +12,9 @@
 #include "carla/nav/WalkerEvent.h"
 #include "carla/rpc/ActorId.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace carla {
 namespace nav {
 
@@ -62,6 +65,10 @@ namespace nav {
     bool SetWalkerRoute(ActorId id);
     bool SetWalkerRoute(ActorId id, carla::geom::Location to);
 
+    /// set new routes to many walkers at once, computing their paths in parallel
+    bool SetWalkerRoutes(const std::vector<ActorId> &ids);
+    bool SetWalkerRoutes(const std::vector<ActorId> &ids, const std::vector<carla::geom::Location> &to);
+
     /// set the next point in the route
     bool SetWalkerNextPoint(ActorId id);
   
@@ -78,6 +85,10 @@ namespace nav {
 
     EventResult ExecuteEvent(ActorId id, WalkerInfo &info, double delta);
 
+    /// create the points of the route with their events
+    void BuildRoute(WalkerInfo &info, std::vector<carla::geom::Location> &path,
+    const std::vector<unsigned char> &area);
+
     std::unordered_map<ActorId, WalkerInfo> _walkers;
     Navigation *_nav { nullptr };
   };
@@ -25,6 +25,35 @@ namespace carla {
 namespace opendrive {
 
   boost::optional<road::Map> OpenDriveParser::Load(const std::string &opendrive) {
+    return Load(opendrive, 0u);
+  }
+
+  boost::optional<road::Map> OpenDriveParser::Load(
+      const std::string &opendrive,
+      size_t number_of_threads) {
+    return Parse(opendrive, number_of_threads, nullptr);
+  }
+
+  boost::optional<road::Map> OpenDriveParser::Load(
+      const std::string &opendrive,
+      const std::vector<uint8_t> &snapshot,
+      size_t number_of_threads) {
+    const auto map_snapshot = road::MapSnapshot::Read(
+        snapshot,
+        road::MapSnapshot::ComputeChecksum(opendrive));
+    if (!snapshot.empty() && !map_snapshot.has_value()) {
+      log_warning("map snapshot does not match the OpenDRIVE content, building the map from scratch");
+    }
+    return Parse(
+        opendrive,
+        number_of_threads,
+        map_snapshot.has_value() ? &*map_snapshot : nullptr);
+  }
+
+  boost::optional<road::Map> OpenDriveParser::Parse(
+      const std::string &opendrive,
+      size_t number_of_threads,
+      const road::MapSnapshot *snapshot) {
     pugi::xml_document xml;
     pugi::xml_parse_result parse_result = xml.load_string(opendrive.c_str());
 
@@ -33,7 +62,7 @@ namespace opendrive {
       return {};
     }
 
-    carla::road::MapBuilder map_builder;
+    carla::road::MapBuilder map_builder(number_of_threads);
 
     parser::GeoReferenceParser::Parse(xml, map_builder);
     parser::RoadParser::Parse(xml, map_builder);
@@ -46,7 +75,7 @@ namespace opendrive {
     parser::ObjectParser::Parse(xml, map_builder);
     parser::ControllerParser::Parse(xml, map_builder);
 
-    return map_builder.Build();
+    return snapshot != nullptr ? map_builder.Build(*snapshot) : map_builder.Build();
   }
 
 } // namespace opendrive
@@ -11,6 +11,7 @@
 #include <boost/optional.hpp>
 
 #include <string>
+#include <vector>
 
 namespace carla {
 namespace opendrive {
@@ -18,7 +19,30 @@ namespace opendrive {
   class OpenDriveParser {
   public:
 
+    /// Builds the map in the calling thread.
     static boost::optional<road::Map> Load(const std::string &opendrive);
+
+    /// Builds the map using @a number_of_threads, zero builds it in the
+    /// calling thread. The resulting map does not depend on the number of
+    /// threads.
+    static boost::optional<road::Map> Load(
+        const std::string &opendrive,
+        size_t number_of_threads);
+
+    /// Builds the map reusing the data of @a snapshot, see road::MapSnapshot.
+    /// If @a snapshot was not built from @a opendrive the map is built from
+    /// scratch using @a number_of_threads.
+    static boost::optional<road::Map> Load(
+        const std::string &opendrive,
+        const std::vector<uint8_t> &snapshot,
+        size_t number_of_threads = 0u);
+
+  private:
+
+    static boost::optional<road::Map> Parse(
+        const std::string &opendrive,
+        size_t number_of_threads,
+        const road::MapSnapshot *snapshot);
   };
 
 } // namespace opendrive
@@ -0,0 +1,142 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace carla {
+namespace profiler {
+
+  /// Histogram of durations in nanoseconds with logarithmic buckets, each
+  /// power of two is split in 16 linear sub-buckets, so the values are kept
+  /// with a relative error below 1/16 (as an HDR histogram with one
+  /// significant digit). It uses a fixed amount of memory and can be updated
+  /// by several threads at the same time without locking.
+  class Histogram : private NonCopyable {
+  public:
+
+    static constexpr uint64_t SUB_BUCKET_BITS = 4u;
+
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+
+    static constexpr size_t NUMBER_OF_BUCKETS = 2u * SUB_BUCKETS + (63u - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    /// Values below 2 * SUB_BUCKETS have a bucket each.
+    static size_t GetBucketIndex(uint64_t value) {
+      if (value < 2u * SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+      }
+      const uint64_t msb = 63u - static_cast<uint64_t>(CountLeadingZeros(value));
+      const uint64_t shift = msb - SUB_BUCKET_BITS;
+      const uint64_t top = value >> shift;
+      return static_cast<size_t>(2u * SUB_BUCKETS + (shift - 1u) * SUB_BUCKETS + (top - SUB_BUCKETS));
+    }
+
+    /// Highest value that falls in the bucket @a index.
+    static uint64_t GetBucketUpperBound(size_t index) {
+      if (index < 2u * SUB_BUCKETS) {
+        return index;
+      }
+      const uint64_t shift = (index - 2u * SUB_BUCKETS) / SUB_BUCKETS + 1u;
+      const uint64_t top = (index - 2u * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+      return ((top + 1u) << shift) - 1u;
+    }
+
+    void Add(uint64_t value) {
+      _buckets[GetBucketIndex(value)].fetch_add(1u, std::memory_order_relaxed);
+      _count.fetch_add(1u, std::memory_order_relaxed);
+      _total.fetch_add(value, std::memory_order_relaxed);
+      auto min = _min.load(std::memory_order_relaxed);
+      while (value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed));
+      auto max = _max.load(std::memory_order_relaxed);
+      while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+    }
+
+    void Reset() {
+      for (auto &bucket : _buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+      _count.store(0u, std::memory_order_relaxed);
+      _total.store(0u, std::memory_order_relaxed);
+      _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      _max.store(0u, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCount() const {
+      return _count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetTotal() const {
+      return _total.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetMin() const {
+      return GetCount() > 0u ? _min.load(std::memory_order_relaxed) : 0u;
+    }
+
+    uint64_t GetMax() const {
+      return _max.load(std::memory_order_relaxed);
+    }
+
+    /// Value below which @a fraction of the values fall, within the precision
+    /// of the buckets. Zero if there are no values.
+    uint64_t GetPercentile(double fraction) const {
+      uint64_t count = 0u;
+      for (const auto &bucket : _buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+      }
+      if (count == 0u) {
+        return 0u;
+      }
+      const auto rank = static_cast<uint64_t>(fraction * static_cast<double>(count - 1u)) + 1u;
+      uint64_t accumulated = 0u;
+      for (size_t i = 0u; i < NUMBER_OF_BUCKETS; ++i) {
+        accumulated += _buckets[i].load(std::memory_order_relaxed);
+        if (accumulated >= rank) {
+          const auto max = GetMax();
+          const auto upper_bound = GetBucketUpperBound(i);
+          return upper_bound < max ? upper_bound : max;
+        }
+      }
+      return GetMax();
+    }
+
+  private:
+
+    static int CountLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanReverse64(&index, value);
+      return 63 - static_cast<int>(index);
+#else
+      return __builtin_clzll(value);
+#endif
+    }
+
+    std::array<std::atomic<uint64_t>, NUMBER_OF_BUCKETS> _buckets{};
+
+    std::atomic<uint64_t> _count{0u};
+
+    std::atomic<uint64_t> _total{0u};
+
+    std::atomic<uint64_t> _min{std::numeric_limits<uint64_t>::max()};
+
+    std::atomic<uint64_t> _max{0u};
+  };
+
+} // namespace profiler
+} // namespace carla
@@ -0,0 +1,284 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/profiler/Tracer.h"
+
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace carla {
+namespace profiler {
+
+  constexpr size_t Tracer::EVENTS_PER_THREAD;
+
+namespace detail {
+
+  std::atomic_bool TRACING_ENABLED{false};
+
+  struct TraceEvent {
+    const TracePoint *point;
+    uint64_t begin;
+    uint64_t end;
+  };
+
+  /// Ring buffer with the last events of a thread. Only the thread that owns
+  /// it writes, the exporter reads the events concurrently and discards the
+  /// ones that may have been overwritten while copying them.
+  class ThreadTraceBuffer : private NonCopyable {
+  public:
+
+    explicit ThreadTraceBuffer(uint32_t id)
+      : _id(id),
+        _events(Tracer::EVENTS_PER_THREAD) {}
+
+    uint32_t GetId() const {
+      return _id;
+    }
+
+    void Push(const TraceEvent &event) {
+      const auto head = _head.load(std::memory_order_relaxed);
+      _events[head % _events.size()] = event;
+      _head.store(head + 1u, std::memory_order_release);
+    }
+
+    /// @pre The caller holds the lock of the tracer state.
+    void CopyEvents(std::vector<TraceEvent> &events) const {
+      const auto capacity = static_cast<uint64_t>(_events.size());
+      const auto head = _head.load(std::memory_order_acquire);
+      const auto begin = std::max(_tail, head > capacity ? head - capacity : 0u);
+      std::vector<TraceEvent> copied;
+      copied.reserve(head - begin);
+      for (auto i = begin; i < head; ++i) {
+        copied.emplace_back(_events[i % capacity]);
+      }
+      // Events written after the first load may have overwritten the oldest
+      // ones.
+      const auto new_head = _head.load(std::memory_order_acquire);
+      const auto valid_begin = std::max(begin, new_head > capacity ? new_head - capacity : 0u);
+      events.insert(events.end(), copied.begin() + static_cast<std::ptrdiff_t>(valid_begin - begin), copied.end());
+    }
+
+    /// @pre The caller holds the lock of the tracer state.
+    void Clear() {
+      _tail = _head.load(std::memory_order_acquire);
+    }
+
+  private:
+
+    const uint32_t _id;
+
+    std::vector<TraceEvent> _events;
+
+    std::atomic<uint64_t> _head{0u};
+
+    /// Events before it were cleared.
+    uint64_t _tail = 0u;
+  };
+
+  struct TracerState {
+    std::mutex mutex;
+
+    /// Stable addresses.
+    std::deque<TracePoint> points;
+
+    std::unordered_map<std::string, TracePoint *> points_by_name;
+
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> buffers;
+
+    /// Buffers of finished threads, reused by new ones.
+    std::vector<ThreadTraceBuffer *> free_buffers;
+  };
+
+  /// Never destroyed, threads may still record while the process exits.
+  static TracerState &GetTracerState() {
+    static auto *state = new TracerState();
+    return *state;
+  }
+
+  /// Gives a buffer to the thread while it lives. Threads are often created
+  /// for a single parallel loop, so the buffer is given back for the next
+  /// thread instead of keeping one per thread ever created.
+  class ThreadTraceBufferHolder : private NonCopyable {
+  public:
+
+    ~ThreadTraceBufferHolder() {
+      if (_buffer != nullptr) {
+        auto &state = GetTracerState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.free_buffers.emplace_back(_buffer);
+      }
+    }
+
+    ThreadTraceBuffer &GetBuffer() {
+      if (_buffer == nullptr) {
+        auto &state = GetTracerState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.free_buffers.empty()) {
+          _buffer = state.free_buffers.back();
+          state.free_buffers.pop_back();
+        } else {
+          const auto id = static_cast<uint32_t>(state.buffers.size());
+          state.buffers.emplace_back(std::make_unique<ThreadTraceBuffer>(id));
+          _buffer = state.buffers.back().get();
+        }
+      }
+      return *_buffer;
+    }
+
+  private:
+
+    ThreadTraceBuffer *_buffer = nullptr;
+  };
+
+  static thread_local ThreadTraceBufferHolder THREAD_BUFFER;
+
+  static double ToMilliseconds(uint64_t nanoseconds) {
+    return 1e-6 * static_cast<double>(nanoseconds);
+  }
+
+  /// Enables the tracer if CARLA_TRACE_FILE is set, and writes the results to
+  /// that file at exit.
+  class TraceFileWriter : private NonCopyable {
+  public:
+
+    TraceFileWriter() {
+      const char *path = std::getenv("CARLA_TRACE_FILE");
+      if (path != nullptr && path[0] != '\0') {
+        _path = path;
+        logging::log("TRACER: writing trace to", _path);
+        Tracer::Start();
+      }
+    }
+
+    ~TraceFileWriter() {
+      if (!_path.empty()) {
+        Tracer::Stop();
+        Tracer::WriteChromeTrace(_path);
+        std::ofstream file(_path + ".csv");
+        Tracer::WriteStats(file);
+      }
+    }
+
+  private:
+
+    std::string _path;
+  };
+
+  static TraceFileWriter TRACE_FILE_WRITER;
+
+} // namespace detail
+
+  void Tracer::Reset() {
+    auto &state = detail::GetTracerState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto &point : state.points) {
+      point.GetHistogram().Reset();
+    }
+    for (auto &buffer : state.buffers) {
+      buffer->Clear();
+    }
+  }
+
+  TracePoint &Tracer::GetTracePoint(const std::string &category, const std::string &name) {
+    auto &state = detail::GetTracerState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto &point = state.points_by_name[category + "." + name];
+    if (point == nullptr) {
+      state.points.emplace_back(category, name);
+      point = &state.points.back();
+    }
+    return *point;
+  }
+
+  void Tracer::Record(TracePoint &point, uint64_t begin, uint64_t end) {
+    point.GetHistogram().Add(end - begin);
+    detail::THREAD_BUFFER.GetBuffer().Push(detail::TraceEvent{&point, begin, end});
+  }
+
+  std::vector<TraceStats> Tracer::GetStats() {
+    using detail::ToMilliseconds;
+    auto &state = detail::GetTracerState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<TraceStats> stats;
+    for (const auto &point : state.points) {
+      const auto &histogram = point.GetHistogram();
+      const auto count = histogram.GetCount();
+      if (count == 0u) {
+        continue;
+      }
+      stats.emplace_back(TraceStats{
+          point.GetCategory(),
+          point.GetName(),
+          count,
+          ToMilliseconds(histogram.GetTotal()),
+          ToMilliseconds(histogram.GetTotal()) / static_cast<double>(count),
+          ToMilliseconds(histogram.GetMin()),
+          ToMilliseconds(histogram.GetMax()),
+          ToMilliseconds(histogram.GetPercentile(0.5)),
+          ToMilliseconds(histogram.GetPercentile(0.9)),
+          ToMilliseconds(histogram.GetPercentile(0.99))});
+    }
+    std::sort(stats.begin(), stats.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.total > rhs.total;
+    });
+    return stats;
+  }
+
+  void Tracer::WriteStats(std::ostream &out) {
+    out << "# category, name, count, total (ms), mean (ms), min (ms), max (ms), p50 (ms), p90 (ms), p99 (ms)\n";
+    out << std::fixed << std::setprecision(4);
+    for (const auto &stats : GetStats()) {
+      out << stats.category << ", " << stats.name << ", " << stats.count << ", "
+          << stats.total << ", " << stats.mean << ", " << stats.minimum << ", " << stats.maximum << ", "
+          << stats.p50 << ", " << stats.p90 << ", " << stats.p99 << '\n';
+    }
+  }
+
+  bool Tracer::WriteChromeTrace(const std::string &path) {
+    std::vector<std::pair<uint32_t, std::vector<detail::TraceEvent>>> events;
+    {
+      auto &state = detail::GetTracerState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+      for (const auto &buffer : state.buffers) {
+        events.emplace_back(buffer->GetId(), std::vector<detail::TraceEvent>{});
+        buffer->CopyEvents(events.back().second);
+      }
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+      log_error("tracer: cannot write trace to", path);
+      return false;
+    }
+    // Complete events, times in microseconds.
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    file << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto &thread : events) {
+      for (const auto &event : thread.second) {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        file << "{\"name\":\"" << event.point->GetName()
+             << "\",\"cat\":\"" << event.point->GetCategory()
+             << "\",\"ph\":\"X\",\"ts\":" << 1e-3 * static_cast<double>(event.begin)
+             << ",\"dur\":" << 1e-3 * static_cast<double>(event.end - event.begin)
+             << ",\"pid\":0,\"tid\":" << thread.first << '}';
+      }
+    }
+    file << "\n]}\n";
+    return file.good();
+  }
+
+} // namespace profiler
+} // namespace carla
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/profiler/Histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace profiler {
+
+  /// A traced location of the code, with the histogram of its durations. They
+  /// are created once per call site by the CARLA_TRACE_* macros and live until
+  /// the end of the process, so events refer to them by address.
+  class TracePoint : private NonCopyable {
+  public:
+
+    TracePoint(std::string category, std::string name)
+      : _category(std::move(category)),
+        _name(std::move(name)) {}
+
+    const std::string &GetCategory() const {
+      return _category;
+    }
+
+    const std::string &GetName() const {
+      return _name;
+    }
+
+    Histogram &GetHistogram() {
+      return _histogram;
+    }
+
+    const Histogram &GetHistogram() const {
+      return _histogram;
+    }
+
+  private:
+
+    const std::string _category;
+
+    const std::string _name;
+
+    Histogram _histogram;
+  };
+
+  /// Summary of the durations of a trace point, in milliseconds.
+  struct TraceStats {
+    std::string category;
+    std::string name;
+    uint64_t count;
+    double total;
+    double mean;
+    double minimum;
+    double maximum;
+    double p50;
+    double p90;
+    double p99;
+  };
+
+namespace detail {
+
+  extern std::atomic_bool TRACING_ENABLED;
+
+} // namespace detail
+
+  /// Process-wide tracer. While enabled, each traced scope adds its duration
+  /// to the histogram of its trace point and an event to a ring buffer of the
+  /// calling thread, keeping the last events of each thread for exporting
+  /// them as a Chrome trace (readable by chrome://tracing and Perfetto).
+  ///
+  /// Tracing is disabled by default and then costs a relaxed atomic load per
+  /// scope. Setting the environment variable CARLA_TRACE_FILE enables it at
+  /// start-up, and the trace and the statistics are written at exit to that
+  /// file and to the same file with ".csv" appended.
+  class Tracer {
+  public:
+
+    static bool IsEnabled() {
+      return detail::TRACING_ENABLED.load(std::memory_order_relaxed);
+    }
+
+    static void Start() {
+      detail::TRACING_ENABLED = true;
+    }
+
+    static void Stop() {
+      detail::TRACING_ENABLED = false;
+    }
+
+    /// Discard the events and statistics recorded so far.
+    static void Reset();
+
+    /// Return the trace point of @a category and @a name, creating it the
+    /// first time. It locks, call sites are expected to keep the reference.
+    static TracePoint &GetTracePoint(const std::string &category, const std::string &name);
+
+    /// Monotonic time in nanoseconds.
+    static uint64_t Now() {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /// Record an execution of @a point from @a begin to @a end, as given by
+    /// Now().
+    static void Record(TracePoint &point, uint64_t begin, uint64_t end);
+
+    /// Statistics of every trace point executed at least once.
+    static std::vector<TraceStats> GetStats();
+
+    /// Write the statistics as comma separated values.
+    static void WriteStats(std::ostream &out);
+
+    /// Write the events kept in the ring buffers in the Chrome trace event
+    /// format, return false if the file cannot be written.
+    static bool WriteChromeTrace(const std::string &path);
+
+    /// Maximum number of events kept per thread, older events are discarded.
+    static constexpr size_t EVENTS_PER_THREAD = 1u << 14u;
+  };
+
+  /// Records the duration of its lifetime if the tracer is enabled at
+  /// construction.
+  class ScopedTrace : private NonCopyable {
+  public:
+
+    explicit ScopedTrace(TracePoint &point)
+      : _point(Tracer::IsEnabled() ? &point : nullptr),
+        _begin(_point != nullptr ? Tracer::Now() : 0u) {}
+
+    ~ScopedTrace() {
+      if (_point != nullptr) {
+        Tracer::Record(*_point, _begin, Tracer::Now());
+      }
+    }
+
+  private:
+
+    TracePoint *_point;
+
+    const uint64_t _begin;
+  };
+
+} // namespace profiler
+} // namespace carla
+
+#ifdef LIBCARLA_DISABLE_TRACING
+#  define CARLA_TRACE_SCOPE(context, name)
+#  define CARLA_TRACE_INTERVAL(context, name)
+#else
+
+/// Trace the rest of the enclosing scope as the point "context.name".
+#define CARLA_TRACE_SCOPE(context, name) \
+    static ::carla::profiler::TracePoint &carla_trace_ ## context ## _ ## name ## _point = \
+        ::carla::profiler::Tracer::GetTracePoint(#context, #name); \
+    ::carla::profiler::ScopedTrace carla_trace_ ## context ## _ ## name ## _scope( \
+        carla_trace_ ## context ## _ ## name ## _point);
+
+/// Trace the time elapsed since the previous time this thread went through
+/// this line, useful to measure frame rates.
+#define CARLA_TRACE_INTERVAL(context, name) \
+    { \
+      static ::carla::profiler::TracePoint &carla_trace_point = \
+          ::carla::profiler::Tracer::GetTracePoint(#context, #name); \
+      static thread_local uint64_t carla_trace_previous = 0u; \
+      if (::carla::profiler::Tracer::IsEnabled()) { \
+        const uint64_t carla_trace_now = ::carla::profiler::Tracer::Now(); \
+        if (carla_trace_previous != 0u) { \
+          ::carla::profiler::Tracer::Record(carla_trace_point, carla_trace_previous, carla_trace_now); \
+        } \
+        carla_trace_previous = carla_trace_now; \
+      } else { \
+        carla_trace_previous = 0u; \
+      } \
+    }
+
+#endif // LIBCARLA_DISABLE_TRACING
@@ -10,7 +10,10 @@
 #include "carla/road/RoadElementSet.h"
 #include "carla/road/element/RoadInfo.h"
 #include "carla/road/element/RoadInfoIterator.h"
+#include "carla/road/element/RoadInfoTypeIndex.h"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -23,15 +26,30 @@ namespace road {
     InformationSet() = default;
 
     InformationSet(std::vector<std::unique_ptr<element::RoadInfo>> &&vec)
-      : _road_set(std::move(vec)) {}
+      : _road_set(std::move(vec)) {
+      // Split the infos by type, each list keeps the order of the set so
+      // it is sorted by distance too.
+      element::RoadInfoTypeClassifier classify;
+      for (auto &info : _road_set.GetAll()) {
+        DEBUG_ASSERT(info != nullptr);
+        const size_t index = classify(*info);
+        if (index < _infos_by_type.size()) {
+          _infos_by_type[index].emplace_back(info.get());
+        }
+      }
+      for (auto &infos : _infos_by_type) {
+        infos.shrink_to_fit();
+      }
+    }
 
     /// Return all infos given a type from the start of the road
     template <typename T>
     std::vector<const T *> GetInfos() const {
+      const auto &infos = GetInfosOfType<T>();
       std::vector<const T *> vec;
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetAll());
-      for (; !it.IsAtEnd(); ++it) {
-        vec.emplace_back(&*it);
+      vec.reserve(infos.size());
+      for (auto *info : infos) {
+        vec.emplace_back(static_cast<const T *>(info));
       }
       return vec;
     }
@@ -40,25 +58,27 @@ namespace road {
     /// the start of the road
     template <typename T>
     const T *GetInfo(const double s) const {
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetReverseSubset(s));
-      return it.IsAtEnd() ? nullptr : &*it;
+      const auto &infos = GetInfosOfType<T>();
+      auto it = std::upper_bound(infos.begin(), infos.end(), s, LessComp());
+      return it == infos.begin() ? nullptr : static_cast<const T *>(*std::prev(it));
     }
 
     /// Return all infos given a type in a given range of the road
     template <typename T>
     std::vector<const T *> GetInfos(const double min_s, const double max_s) const {
+      const auto &infos = GetInfosOfType<T>();
       std::vector<const T *> vec;
       if(min_s < max_s) {
-        auto it = element::MakeRoadInfoIterator<T>(
-            _road_set.GetSubsetInRange(min_s, max_s)); //reverse
-        for (; !it.IsAtEnd(); ++it) {
-          vec.emplace_back(&*it);
+        auto low_bound = std::lower_bound(infos.begin(), infos.end(), min_s, LessComp());
+        auto up_bound = std::upper_bound(low_bound, infos.end(), max_s, LessComp());
+        for (auto it = low_bound; it != up_bound; ++it) {
+          vec.emplace_back(static_cast<const T *>(*it));
         }
       } else {
-        auto it = element::MakeRoadInfoIterator<T>(
-            _road_set.GetReverseSubsetInRange(max_s, min_s)); //reverse
-        for (; !it.IsAtEnd(); ++it) {
-          vec.emplace_back(&*it);
+        auto low_bound = std::lower_bound(infos.begin(), infos.end(), max_s, LessComp());
+        auto up_bound = std::upper_bound(low_bound, infos.end(), min_s, LessComp());
+        for (auto it = up_bound; it != low_bound; --it) {
+          vec.emplace_back(static_cast<const T *>(*std::prev(it)));
         }
       }
       return vec;
@@ -66,7 +86,26 @@ namespace road {
 
   private:
 
+    struct LessComp {
+      bool operator()(const element::RoadInfo *a, const double s) const {
+        return a->GetDistance() < s;
+      }
+      bool operator()(const double s, const element::RoadInfo *a) const {
+        return s < a->GetDistance();
+      }
+    };
+
+    template <typename T>
+    const std::vector<const element::RoadInfo *> &GetInfosOfType() const {
+      return _infos_by_type[element::RoadInfoTypeIndex<T>::value];
+    }
+
     RoadElementSet<std::unique_ptr<element::RoadInfo>> _road_set;
+
+    /// Infos of each type sorted by distance, indexed by RoadInfoTypeIndex.
+    std::array<
+        std::vector<const element::RoadInfo *>,
+        element::NUMBER_OF_ROAD_INFO_TYPES> _infos_by_type;
   };
 
 } // road
@@ -82,6 +82,10 @@ namespace road {
       return _road_conflicts.at(road_id);
     }
 
+    const std::unordered_map<RoadId, std::unordered_set<RoadId>> &GetRoadConflicts() const {
+      return _road_conflicts;
+    }
+
     const std::set<ContId>& GetControllers() const {
       return _controllers;
     }
@@ -16,6 +16,7 @@
 #include "carla/road/element/RoadInfoLaneOffset.h"
 #include "carla/road/element/RoadInfoLaneWidth.h"
 #include "carla/road/LaneSection.h"
+#include "carla/road/LaneTransformTable.h"
 #include "carla/road/MapData.h"
 #include "carla/road/Road.h"
 
@@ -127,6 +128,13 @@ namespace road {
   }
 
   geom::Transform Lane::ComputeTransform(const double s) const {
+    if (_transform_table != nullptr && _transform_table->Contains(s)) {
+      return _transform_table->Evaluate(s);
+    }
+    return ComputeTransformExact(s);
+  }
+
+  geom::Transform Lane::ComputeTransformExact(const double s) const {
     const Road *road = GetRoad();
     DEBUG_ASSERT(road != nullptr);
 
@@ -201,6 +209,14 @@ namespace road {
     return geom::Transform(dp.location, rot);
   }
 
+  void Lane::BuildTransformTable(double max_error) {
+    _transform_table = std::make_shared<LaneTransformTable>(*this, max_error);
+  }
+
+  void Lane::ClearTransformTable() {
+    _transform_table.reset();
+  }
+
   std::pair<geom::Vector3D, geom::Vector3D> Lane::GetCornerPositions(
       const double s, const float extra_width) const {
     const Road *road = GetRoad();
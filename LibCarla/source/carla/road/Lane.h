@@ -19,6 +19,7 @@ namespace carla {
 namespace road {
 
   class LaneSection;
+  class LaneTransformTable;
   class MapBuilder;
   class Road;
 
@@ -113,8 +114,24 @@ namespace road {
     /// Checks whether the geometry is straight or not
     bool IsStraight() const;
 
+    /// Returns the transform at @a s, interpolated from the transform table
+    /// when one has been built for this lane.
     geom::Transform ComputeTransform(const double s) const;
 
+    /// Computes the transform at @a s from the road geometry and the lane
+    /// widths, ignoring the transform table.
+    geom::Transform ComputeTransformExact(const double s) const;
+
+    /// Samples the transforms of this lane so that ComputeTransform
+    /// interpolates them, with a location error below @a max_error meters.
+    void BuildTransformTable(double max_error);
+
+    void ClearTransformTable();
+
+    const LaneTransformTable *GetTransformTable() const {
+      return _transform_table.get();
+    }
+
     /// Computes the location of the edges given a s
     std::pair<geom::Vector3D, geom::Vector3D> GetCornerPositions(
       const double s, const float extra_width = 0.f) const;
@@ -140,6 +157,8 @@ namespace road {
     std::vector<Lane *> _next_lanes;
 
     std::vector<Lane *> _prev_lanes;
+
+    std::shared_ptr<const LaneTransformTable> _transform_table;
   };
 
 } // road
@@ -0,0 +1,166 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/LaneTransformTable.h"
+
+#include "carla/geom/Math.h"
+#include "carla/road/Lane.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace carla {
+namespace road {
+
+  /// Maximum distance between two samples, so that features shorter than
+  /// the interval between the checked points are not skipped.
+  static constexpr double MAX_SAMPLE_STEP = 10.0;
+
+  /// Intervals shorter than this are not subdivided.
+  static constexpr double MIN_SAMPLE_STEP = 0.01;
+
+  /// Fraction of the requested location error checked while sampling.
+  static constexpr double SAMPLING_ERROR_MARGIN = 0.5;
+
+  /// Maximum error of the interpolated rotation, in degrees.
+  static constexpr float MAX_ANGLE_ERROR = 0.05f;
+
+  /// Returns the difference @a b - @a a in the range [-180, 180).
+  static float AngleDifference(float a, float b) {
+    float diff = std::fmod(b - a + 180.0f, 360.0f);
+    if (diff < 0.0f) {
+      diff += 360.0f;
+    }
+    return diff - 180.0f;
+  }
+
+  static geom::Location Lerp(const geom::Vector3D &a, const geom::Vector3D &b, float t) {
+    return a + t * (b - a);
+  }
+
+  static float LerpAngle(float a, float b, float t) {
+    return a + t * AngleDifference(a, b);
+  }
+
+  static geom::Transform Interpolate(
+      const geom::Transform &a,
+      const geom::Transform &b,
+      float t) {
+    return geom::Transform(
+        Lerp(a.location, b.location, t),
+        geom::Rotation(
+            LerpAngle(a.rotation.pitch, b.rotation.pitch, t),
+            LerpAngle(a.rotation.yaw, b.rotation.yaw, t),
+            0.0f));
+  }
+
+  static bool IsWithinError(
+      const geom::Transform &interpolated,
+      const geom::Transform &exact,
+      double max_error) {
+    return
+        geom::Math::Distance(interpolated.location, exact.location) <= max_error &&
+        std::abs(AngleDifference(interpolated.rotation.pitch, exact.rotation.pitch)) <= MAX_ANGLE_ERROR &&
+        std::abs(AngleDifference(interpolated.rotation.yaw, exact.rotation.yaw)) <= MAX_ANGLE_ERROR;
+  }
+
+  LaneTransformTable::LaneTransformTable(const Lane &lane, const double max_error) {
+    const double s_start = lane.GetDistance();
+    const double s_end = s_start + lane.GetLength();
+
+    // Only a few points of each interval are checked, and far from the origin
+    // the float rounding of the locations is a noticeable part of a
+    // millimeter. Half the error is left as a margin for both.
+    const double checked_error = SAMPLING_ERROR_MARGIN * max_error;
+
+    // Samples the interval [s0, s1] checking the interpolation error at the
+    // quarter and middle points, the end points are already sampled except
+    // s1 which is added after its interval.
+    auto sample = [&](double s0, const geom::Transform &t0, double s1, const geom::Transform &t1) {
+      struct Interval {
+        double s0, s1;
+        geom::Transform t0, t1;
+      };
+      std::vector<Interval> pending{{s0, s1, t0, t1}};
+      while (!pending.empty()) {
+        Interval interval = pending.back();
+        pending.pop_back();
+        const double length = interval.s1 - interval.s0;
+        const double s_mid = interval.s0 + 0.5 * length;
+        const geom::Transform t_mid = lane.ComputeTransformExact(s_mid);
+        bool split = false;
+        if (length > MIN_SAMPLE_STEP) {
+          split = !IsWithinError(Interpolate(interval.t0, interval.t1, 0.5f), t_mid, checked_error);
+          for (float t : {0.25f, 0.75f}) {
+            if (!split) {
+              split = !IsWithinError(
+                  Interpolate(interval.t0, interval.t1, t),
+                  lane.ComputeTransformExact(interval.s0 + t * length),
+                  checked_error);
+            }
+          }
+        }
+        if (split) {
+          // Processed in order of increasing s.
+          pending.push_back({s_mid, interval.s1, t_mid, interval.t1});
+          pending.push_back({interval.s0, s_mid, interval.t0, t_mid});
+        } else {
+          AddSample(interval.s1, interval.t1);
+        }
+      }
+    };
+
+    geom::Transform previous = lane.ComputeTransformExact(s_start);
+    AddSample(s_start, previous);
+    const size_t steps = std::max<size_t>(1u,
+        static_cast<size_t>(std::ceil((s_end - s_start) / MAX_SAMPLE_STEP)));
+    const double step = (s_end - s_start) / static_cast<double>(steps);
+    for (size_t i = 1u; i <= steps; ++i) {
+      const double s = i == steps ? s_end : s_start + static_cast<double>(i) * step;
+      const geom::Transform current = lane.ComputeTransformExact(s);
+      sample(_s.back(), previous, s, current);
+      previous = current;
+    }
+
+    _s.shrink_to_fit();
+    _locations.shrink_to_fit();
+    _pitch.shrink_to_fit();
+    _yaw.shrink_to_fit();
+  }
+
+  void LaneTransformTable::AddSample(double s, const geom::Transform &transform) {
+    _s.emplace_back(s);
+    _locations.emplace_back(transform.location);
+    _pitch.emplace_back(transform.rotation.pitch);
+    _yaw.emplace_back(transform.rotation.yaw);
+  }
+
+  geom::Transform LaneTransformTable::Evaluate(double s) const {
+    DEBUG_ASSERT(Contains(s));
+    auto it = std::upper_bound(_s.begin(), _s.end(), s);
+    const size_t i1 = std::min<size_t>(
+        std::max<size_t>(static_cast<size_t>(it - _s.begin()), 1u), _s.size() - 1u);
+    const size_t i0 = i1 - 1u;
+    const double length = _s[i1] - _s[i0];
+    const float t = length > 0.0 ? static_cast<float>((s - _s[i0]) / length) : 0.0f;
+    return geom::Transform(
+        Lerp(_locations[i0], _locations[i1], t),
+        geom::Rotation(
+            LerpAngle(_pitch[i0], _pitch[i1], t),
+            LerpAngle(_yaw[i0], _yaw[i1], t),
+            0.0f));
+  }
+
+  size_t LaneTransformTable::GetMemoryUsage() const {
+    return
+        _s.capacity() * sizeof(double) +
+        _locations.capacity() * sizeof(geom::Location) +
+        _pitch.capacity() * sizeof(float) +
+        _yaw.capacity() * sizeof(float);
+  }
+
+} // road
+} // carla
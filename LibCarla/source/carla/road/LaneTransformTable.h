@@ -0,0 +1,55 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/Transform.h"
+
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Lane;
+
+  /// Transforms of a lane sampled along s, so that Lane::ComputeTransform
+  /// becomes a binary search and a linear interpolation. The samples are
+  /// placed adaptively, the interpolated location differs from the exact one
+  /// by less than the error bound given on construction.
+  class LaneTransformTable {
+  public:
+
+    /// Samples @a lane between the start and the end of its lane section.
+    LaneTransformTable(const Lane &lane, double max_error);
+
+    /// Returns whether @a s is covered by the table.
+    bool Contains(double s) const {
+      return !_s.empty() && s >= _s.front() && s <= _s.back();
+    }
+
+    geom::Transform Evaluate(double s) const;
+
+    size_t GetNumberOfSamples() const {
+      return _s.size();
+    }
+
+    size_t GetMemoryUsage() const;
+
+  private:
+
+    void AddSample(double s, const geom::Transform &transform);
+
+    std::vector<double> _s;
+
+    std::vector<geom::Location> _locations;
+
+    std::vector<float> _pitch;
+
+    std::vector<float> _yaw;
+  };
+
+} // road
+} // carla
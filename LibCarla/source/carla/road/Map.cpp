@@ -6,7 +6,10 @@
 
 #include "carla/road/Map.h"
 #include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/geom/Math.h"
+#include "carla/road/LaneTransformTable.h"
 #include "carla/road/MeshFactory.h"
 #include "carla/road/element/LaneCrossingCalculator.h"
 #include "carla/road/element/RoadInfoCrosswalk.h"
@@ -17,6 +20,8 @@
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/RoadInfoSignal.h"
 
+#include <algorithm>
+#include <numeric>
 #include <vector>
 #include <unordered_map>
 #include <stdexcept>
@@ -149,6 +154,99 @@ namespace road {
     return section.ContainsLane(waypoint.lane_id);
   }
 
+  /// Interleaves the lower 16 bits of @a x and @a y (Morton order), so that
+  /// sorting by the result keeps nearby cells close to each other.
+  static uint32_t InterleaveBits(uint32_t x, uint32_t y) {
+    auto spread = [](uint32_t v) {
+      v &= 0x0000FFFFu;
+      v = (v | (v << 8u)) & 0x00FF00FFu;
+      v = (v | (v << 4u)) & 0x0F0F0F0Fu;
+      v = (v | (v << 2u)) & 0x33333333u;
+      v = (v | (v << 1u)) & 0x55555555u;
+      return v;
+    };
+    return spread(x) | (spread(y) << 1u);
+  }
+
+  /// Returns the indices of @a locations sorted along a Morton curve over
+  /// their 2D bounding box.
+  static std::vector<size_t> SortSpatially(const std::vector<geom::Location> &locations) {
+    std::vector<size_t> order(locations.size());
+    std::iota(order.begin(), order.end(), 0u);
+    if (locations.size() < 2u) {
+      return order;
+    }
+    float min_x = locations.front().x, max_x = min_x;
+    float min_y = locations.front().y, max_y = min_y;
+    for (const auto &location : locations) {
+      min_x = std::min(min_x, location.x);
+      max_x = std::max(max_x, location.x);
+      min_y = std::min(min_y, location.y);
+      max_y = std::max(max_y, location.y);
+    }
+    constexpr float max_cell = static_cast<float>(0xFFFF);
+    const float scale_x = max_x > min_x ? max_cell / (max_x - min_x) : 0.0f;
+    const float scale_y = max_y > min_y ? max_cell / (max_y - min_y) : 0.0f;
+    std::vector<uint32_t> keys(locations.size());
+    for (size_t i = 0u; i < locations.size(); ++i) {
+      keys[i] = InterleaveBits(
+          static_cast<uint32_t>((locations[i].x - min_x) * scale_x),
+          static_cast<uint32_t>((locations[i].y - min_y) * scale_y));
+    }
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return keys[lhs] < keys[rhs];
+    });
+    return order;
+  }
+
+  /// Scratch memory of a batch of closest waypoint queries. The candidate
+  /// segments are stored as separate coordinate arrays so the distances to
+  /// all of them are computed in a single vectorizable loop.
+  struct SegmentCandidates {
+    std::vector<geom::SegmentCloudRtree<Waypoint>::TreeElement> elements;
+    std::vector<float> x0, y0, z0, dx, dy, dz;
+    std::vector<float> distances;
+
+    void Load() {
+      const size_t size = elements.size();
+      for (auto *v : {&x0, &y0, &z0, &dx, &dy, &dz, &distances}) {
+        v->resize(size);
+      }
+      for (size_t i = 0u; i < size; ++i) {
+        const auto &s1 = elements[i].first.first;
+        const auto &s2 = elements[i].first.second;
+        x0[i] = s1.get<0>();
+        y0[i] = s1.get<1>();
+        z0[i] = s1.get<2>();
+        dx[i] = s2.get<0>() - x0[i];
+        dy[i] = s2.get<1>() - y0[i];
+        dz[i] = s2.get<2>() - z0[i];
+      }
+    }
+
+    /// Squared 3D distance from @a p to each candidate segment, the same
+    /// metric the rtree nearest query uses.
+    void ComputeSquaredDistances(const geom::Location &p) {
+      const size_t size = distances.size();
+      const float *px0 = x0.data(), *py0 = y0.data(), *pz0 = z0.data();
+      const float *pdx = dx.data(), *pdy = dy.data(), *pdz = dz.data();
+      float *out = distances.data();
+      for (size_t i = 0u; i < size; ++i) {
+        const float wx = p.x - px0[i];
+        const float wy = p.y - py0[i];
+        const float wz = p.z - pz0[i];
+        const float l2 = pdx[i] * pdx[i] + pdy[i] * pdy[i] + pdz[i] * pdz[i];
+        const float dot = wx * pdx[i] + wy * pdy[i] + wz * pdz[i];
+        float t = l2 > 0.0f ? dot / l2 : 0.0f;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        const float ex = wx - t * pdx[i];
+        const float ey = wy - t * pdy[i];
+        const float ez = wz - t * pdz[i];
+        out[i] = ex * ex + ey * ey + ez * ez;
+      }
+    }
+  };
+
   // ===========================================================================
   // -- Map: Geometry ----------------------------------------------------------
   // ===========================================================================
@@ -156,6 +254,7 @@ namespace road {
   boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
       const geom::Location &pos,
       int32_t lane_type) const {
+    CARLA_TRACE_SCOPE(map, closest_waypoint_on_road);
     std::vector<Rtree::TreeElement> query_result =
         _rtree.GetNearestNeighboursWithFilter(Rtree::BPoint(pos.x, pos.y, pos.z),
         [&](Rtree::TreeElement const &element) {
@@ -167,37 +266,7 @@ namespace road {
       return boost::optional<Waypoint>{};
     }
 
-    Rtree::BSegment segment = query_result.front().first;
-    Rtree::BPoint s1 = segment.first;
-    Rtree::BPoint s2 = segment.second;
-    auto distance_to_segment = geom::Math::DistanceSegmentToPoint(pos,
-        geom::Vector3D(s1.get<0>(), s1.get<1>(), s1.get<2>()),
-        geom::Vector3D(s2.get<0>(), s2.get<1>(), s2.get<2>()));
-
-    Waypoint result_start = query_result.front().second.first;
-    Waypoint result_end = query_result.front().second.second;
-
-    if (result_start.lane_id < 0) {
-      double delta_s = distance_to_segment.first;
-      double final_s = result_start.s + delta_s;
-      if (final_s >= result_end.s) {
-        return result_end;
-      } else if (delta_s <= 0) {
-        return result_start;
-      } else {
-        return GetNext(result_start, delta_s).front();
-      }
-    } else {
-      double delta_s = distance_to_segment.first;
-      double final_s = result_start.s - delta_s;
-      if (final_s <= result_end.s) {
-        return result_end;
-      } else if (delta_s <= 0) {
-        return result_start;
-      } else {
-        return GetNext(result_start, delta_s).front();
-      }
-    }
+    return ProjectOnSegment(pos, query_result.front());
   }
 
   boost::optional<Waypoint> Map::GetWaypoint(
@@ -209,16 +278,21 @@ namespace road {
       return w;
     }
 
-    const auto dist = geom::Math::Distance2D(ComputeTransform(*w).location, pos);
-    const auto lane_width_info = GetLane(*w).GetInfo<RoadInfoLaneWidth>(w->s);
-    const auto half_lane_width =
-        lane_width_info->GetPolynomial().Evaluate(w->s) * 0.5;
+    return CheckInsideLane(pos, *w);
+  }
 
-    if (dist < half_lane_width) {
-      return w;
-    }
+  std::vector<boost::optional<Waypoint>> Map::GetClosestWaypointsOnRoad(
+      const std::vector<geom::Location> &locations,
+      int32_t lane_type,
+      size_t number_of_threads) const {
+    return ComputeClosestWaypoints(locations, lane_type, number_of_threads, false);
+  }
 
-    return boost::optional<Waypoint>{};
+  std::vector<boost::optional<Waypoint>> Map::GetWaypoints(
+      const std::vector<geom::Location> &locations,
+      int32_t lane_type,
+      size_t number_of_threads) const {
+    return ComputeClosestWaypoints(locations, lane_type, number_of_threads, true);
   }
 
   boost::optional<Waypoint> Map::GetWaypoint(
@@ -265,6 +339,37 @@ namespace road {
     return GetLane(waypoint).ComputeTransform(waypoint.s);
   }
 
+  /// Calls @a func with every lane of the map, except the center lanes.
+  template <typename FuncT>
+  static void ForEachMutableLane(MapData &data, FuncT &&func) {
+    for (auto &pair : data.GetRoads()) {
+      auto &road = pair.second;
+      for (const auto &const_section : road.GetLaneSections()) {
+        auto &section = road.GetLaneSectionById(const_section.GetId());
+        for (auto &lane_pair : section.GetLanes()) {
+          if (lane_pair.first != 0) {
+            std::forward<FuncT>(func)(lane_pair.second);
+          }
+        }
+      }
+    }
+  }
+
+  size_t Map::BuildLaneTransformTables(double max_error) {
+    size_t memory_usage = 0u;
+    ForEachMutableLane(_data, [&](Lane &lane) {
+      lane.BuildTransformTable(max_error);
+      memory_usage += lane.GetTransformTable()->GetMemoryUsage();
+    });
+    return memory_usage;
+  }
+
+  void Map::ClearLaneTransformTables() {
+    ForEachMutableLane(_data, [](Lane &lane) {
+      lane.ClearTransformTable();
+    });
+  }
+
   // ===========================================================================
   // -- Map: Road information --------------------------------------------------
   // ===========================================================================
@@ -637,6 +742,7 @@ namespace road {
   }
 
   std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
+    CARLA_TRACE_SCOPE(map, generate_waypoints);
     RELEASE_ASSERT(distance > 0.0);
     std::vector<Waypoint> result;
     for (const auto &pair : _data.GetRoads()) {
@@ -713,6 +819,7 @@ namespace road {
   }
 
   std::vector<std::pair<Waypoint, Waypoint>> Map::GenerateTopology() const {
+    CARLA_TRACE_SCOPE(map, generate_topology);
     std::vector<std::pair<Waypoint, Waypoint>> result;
     for (const auto &pair : _data.GetRoads()) {
       const auto &road = pair.second;
@@ -830,6 +937,141 @@ namespace road {
   // -- Map: Private functions -------------------------------------------------
   // ===========================================================================
 
+  Waypoint Map::ProjectOnSegment(
+      const geom::Location &pos,
+      const Rtree::TreeElement &element) const {
+    Rtree::BSegment segment = element.first;
+    Rtree::BPoint s1 = segment.first;
+    Rtree::BPoint s2 = segment.second;
+    auto distance_to_segment = geom::Math::DistanceSegmentToPoint(pos,
+        geom::Vector3D(s1.get<0>(), s1.get<1>(), s1.get<2>()),
+        geom::Vector3D(s2.get<0>(), s2.get<1>(), s2.get<2>()));
+
+    Waypoint result_start = element.second.first;
+    Waypoint result_end = element.second.second;
+
+    if (result_start.lane_id < 0) {
+      double delta_s = distance_to_segment.first;
+      double final_s = result_start.s + delta_s;
+      if (final_s >= result_end.s) {
+        return result_end;
+      } else if (delta_s <= 0) {
+        return result_start;
+      } else {
+        return GetNext(result_start, delta_s).front();
+      }
+    } else {
+      double delta_s = distance_to_segment.first;
+      double final_s = result_start.s - delta_s;
+      if (final_s <= result_end.s) {
+        return result_end;
+      } else if (delta_s <= 0) {
+        return result_start;
+      } else {
+        return GetNext(result_start, delta_s).front();
+      }
+    }
+  }
+
+  boost::optional<Waypoint> Map::CheckInsideLane(
+      const geom::Location &pos,
+      Waypoint waypoint) const {
+    const auto dist = geom::Math::Distance2D(ComputeTransform(waypoint).location, pos);
+    const auto lane_width_info = GetLane(waypoint).GetInfo<RoadInfoLaneWidth>(waypoint.s);
+    const auto half_lane_width =
+        lane_width_info->GetPolynomial().Evaluate(waypoint.s) * 0.5;
+
+    if (dist < half_lane_width) {
+      return waypoint;
+    }
+
+    return boost::optional<Waypoint>{};
+  }
+
+  // Answers the queries in spatial order. The distance to the segment found
+  // for the previous query bounds the search of the next one, so most of the
+  // queries become a small box query followed by a linear scan of the
+  // candidates instead of a nearest neighbour traversal of the rtree.
+  std::vector<boost::optional<Waypoint>> Map::ComputeClosestWaypoints(
+      const std::vector<geom::Location> &locations,
+      int32_t lane_type,
+      size_t number_of_threads,
+      bool inside_lane) const {
+    CARLA_TRACE_SCOPE(map, closest_waypoints_batch);
+    // Beyond this search radius a nearest neighbour query is cheaper than
+    // scanning the candidates of the box.
+    constexpr float max_search_radius = 50.0f;
+    constexpr float search_margin = 0.01f;
+
+    std::vector<boost::optional<Waypoint>> result(locations.size());
+    const std::vector<size_t> order = SortSpatially(locations);
+
+    auto accepts = [&](const Rtree::TreeElement &element) {
+      const Lane &lane = GetLane(element.second.first);
+      return (lane_type & static_cast<int32_t>(lane.GetType())) > 0;
+    };
+
+    auto solve_range = [&](size_t begin, size_t end) {
+      SegmentCandidates candidates;
+      boost::optional<Rtree::TreeElement> previous;
+      for (size_t k = begin; k < end; ++k) {
+        const size_t index = order[k];
+        const geom::Location &pos = locations[index];
+        boost::optional<Rtree::TreeElement> closest;
+
+        if (previous.has_value()) {
+          candidates.elements.assign(1u, *previous);
+          candidates.Load();
+          candidates.ComputeSquaredDistances(pos);
+          const float radius = std::sqrt(candidates.distances.front()) + search_margin;
+          if (radius < max_search_radius) {
+            using BBox = boost::geometry::model::box<Rtree::BPoint>;
+            _rtree.GetIntersections(BBox(
+                Rtree::BPoint(pos.x - radius, pos.y - radius, pos.z - radius),
+                Rtree::BPoint(pos.x + radius, pos.y + radius, pos.z + radius)),
+                candidates.elements);
+            candidates.Load();
+            candidates.ComputeSquaredDistances(pos);
+            // Check the candidates by increasing distance, usually the first
+            // one already has the requested lane type.
+            auto &distances = candidates.distances;
+            while (!distances.empty()) {
+              auto it = std::min_element(distances.begin(), distances.end());
+              if (*it == std::numeric_limits<float>::infinity()) {
+                break;
+              }
+              const auto &element = candidates.elements[it - distances.begin()];
+              if (accepts(element)) {
+                closest = element;
+                break;
+              }
+              *it = std::numeric_limits<float>::infinity();
+            }
+          }
+        }
+
+        if (!closest.has_value()) {
+          auto query_result = _rtree.GetNearestNeighboursWithFilter(
+              Rtree::BPoint(pos.x, pos.y, pos.z),
+              accepts);
+          if (query_result.empty()) {
+            continue;
+          }
+          closest = query_result.front();
+        }
+
+        previous = closest;
+        const Waypoint waypoint = ProjectOnSegment(pos, *closest);
+        result[index] = inside_lane ? CheckInsideLane(pos, waypoint) : waypoint;
+      }
+    };
+
+    // Each thread takes a contiguous range of the sorted queries and writes to
+    // distinct positions of the result.
+    ParallelForRanges(locations.size(), number_of_threads, solve_range);
+    return result;
+  }
+
   // Adds a new element to the rtree element list using the position of the
   // waypoints both ends of the segment
   void Map::AddElementToRtree(
@@ -875,7 +1117,7 @@ namespace road {
     }
   }
 
-  void Map::CreateRtree() {
+  void Map::CreateRtree(size_t number_of_threads) {
     const double epsilon = 0.000001; // small delta in the road (set to 1
                                      // micrometer to prevent numeric errors)
     const double min_delta_s = 1;    // segments of minimum 1m through the road
@@ -896,10 +1138,9 @@ namespace road {
       });
     }
 
-    // Container of segments and waypoints
-    std::vector<Rtree::TreeElement> rtree_elements;
-    // Loop through all lanes
-    for (auto &waypoint : topology) {
+    // Generates the segments of the lane starting at waypoint
+    auto add_lane_segments = [&](const Waypoint &waypoint,
+        std::vector<Rtree::TreeElement> &rtree_elements) {
       auto &lane_start_waypoint = waypoint;
 
       auto current_waypoint = lane_start_waypoint;
@@ -916,7 +1157,7 @@ namespace road {
         remaining_length -= epsilon;
         delta_s = remaining_length;
         if (delta_s < epsilon) {
-          continue;
+          return;
         }
         auto next = GetNext(current_waypoint, delta_s);
 
@@ -980,9 +1221,30 @@ namespace road {
           }
         }
       }
+    };
+
+    // The lanes are processed in parallel, each one into its own list, and
+    // the lists are joined in the same order to build the same tree as a
+    // sequential pass
+    std::vector<std::vector<Rtree::TreeElement>> lane_elements(topology.size());
+    ParallelForRanges(topology.size(), number_of_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        add_lane_segments(topology[i], lane_elements[i]);
+      }
+    });
+
+    // Container of segments and waypoints
+    std::vector<Rtree::TreeElement> rtree_elements;
+    size_t number_of_elements = 0u;
+    for (auto &elements : lane_elements) {
+      number_of_elements += elements.size();
+    }
+    rtree_elements.reserve(number_of_elements);
+    for (auto &elements : lane_elements) {
+      rtree_elements.insert(rtree_elements.end(), elements.begin(), elements.end());
     }
-    // Add segments to Rtree
-    _rtree.InsertElements(rtree_elements);
+    // Bulk load the segments into the Rtree
+    _rtree = Rtree(rtree_elements);
   }
 
   Junction* Map::GetJunction(JuncId id) {
@@ -14,6 +14,7 @@
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/Waypoint.h"
 #include "carla/road/MapData.h"
+#include "carla/road/MapSnapshot.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
 
@@ -33,10 +34,18 @@ namespace road {
     /// -- Constructor ---------------------------------------------------------
     /// ========================================================================
 
-    Map(MapData m) : _data(std::move(m)) {
-      CreateRtree();
+    /// @a number_of_threads are used to build the rtree, zero builds it in
+    /// the calling thread.
+    Map(MapData m, size_t number_of_threads = 0u) : _data(std::move(m)) {
+      CreateRtree(number_of_threads);
     }
 
+    /// Restores the rtree from @a snapshot instead of sampling the lanes, the
+    /// snapshot must have been built from the same OpenDRIVE content as @a m.
+    Map(MapData m, const MapSnapshot &snapshot)
+      : _data(std::move(m)),
+        _rtree(snapshot._rtree_elements) {}
+
     /// ========================================================================
     /// -- Georeference --------------------------------------------------------
     /// ========================================================================
@@ -62,8 +71,39 @@ namespace road {
         LaneId lane_id,
         float s) const;
 
+    /// Batched version of GetClosestWaypointOnRoad, the result at position i
+    /// corresponds to @a locations[i]. The queries are answered in spatial
+    /// order, bounding the search of each one with the result of the previous
+    /// one, and split among @a number_of_threads threads (zero answers them
+    /// in the calling thread).
+    std::vector<boost::optional<element::Waypoint>> GetClosestWaypointsOnRoad(
+        const std::vector<geom::Location> &locations,
+        int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving),
+        size_t number_of_threads = 0u) const;
+
+    /// Batched version of GetWaypoint, see GetClosestWaypointsOnRoad.
+    std::vector<boost::optional<element::Waypoint>> GetWaypoints(
+        const std::vector<geom::Location> &locations,
+        int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving),
+        size_t number_of_threads = 0u) const;
+
     geom::Transform ComputeTransform(Waypoint waypoint) const;
 
+    /// Samples the transforms of every lane so that ComputeTransform
+    /// interpolates them instead of evaluating the road geometry, with a
+    /// location error below @a max_error meters. Returns the memory used by
+    /// the tables in bytes.
+    ///
+    /// The tables are not built when the map is loaded, so ComputeTransform
+    /// is exact by default. They are meant for the owners of a map that
+    /// compute many transforms and can afford the error, call this before
+    /// sharing the map with other threads. Call again to change the error.
+    size_t BuildLaneTransformTables(double max_error = 0.001);
+
+    /// Removes the tables built by BuildLaneTransformTables, ComputeTransform
+    /// evaluates the road geometry again.
+    void ClearLaneTransformTables();
+
     /// ========================================================================
     /// -- Road information ----------------------------------------------------
     /// ========================================================================
@@ -181,12 +221,29 @@ namespace road {
 private:
 
     friend MapBuilder;
+    friend MapSnapshot;
     MapData _data;
 
     using Rtree = geom::SegmentCloudRtree<Waypoint>;
     Rtree _rtree;
 
-    void CreateRtree();
+    void CreateRtree(size_t number_of_threads);
+
+    /// Returns the waypoint of the segment @a element closest to @a location.
+    Waypoint ProjectOnSegment(
+        const geom::Location &location,
+        const Rtree::TreeElement &element) const;
+
+    /// Returns @a waypoint if @a location lies inside its lane.
+    boost::optional<Waypoint> CheckInsideLane(
+        const geom::Location &location,
+        Waypoint waypoint) const;
+
+    std::vector<boost::optional<Waypoint>> ComputeClosestWaypoints(
+        const std::vector<geom::Location> &locations,
+        int32_t lane_type,
+        size_t number_of_threads,
+        bool inside_lane) const;
 
     /// Helper Functions for constructing the rtree element list
     void AddElementToRtree(
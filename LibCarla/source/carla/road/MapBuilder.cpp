@@ -4,6 +4,7 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include "carla/ParallelFor.h"
 #include "carla/StringUtil.h"
 #include "carla/road/MapBuilder.h"
 #include "carla/road/element/RoadInfoElevation.h"
@@ -36,6 +37,14 @@ namespace carla {
 namespace road {
 
   boost::optional<Map> MapBuilder::Build() {
+    return BuildMap(nullptr);
+  }
+
+  boost::optional<Map> MapBuilder::Build(const MapSnapshot &snapshot) {
+    return BuildMap(&snapshot);
+  }
+
+  boost::optional<Map> MapBuilder::BuildMap(const MapSnapshot *snapshot) {
 
     CreatePointersBetweenRoadSegments();
     RemoveZeroLaneValiditySignalReferences();
@@ -62,9 +71,13 @@ namespace road {
     // _map_data is a memeber of MapBuilder so you must especify if
     // you want to keep it (will return copy -> Map(const Map &))
     // or move it (will return move -> Map(Map &&))
-    Map map(std::move(_map_data));
-    CreateJunctionBoundingBoxes(map);
-    ComputeJunctionRoadConflicts(map);
+    Map map = snapshot == nullptr ?
+        Map(std::move(_map_data), _number_of_threads) :
+        Map(std::move(_map_data), *snapshot);
+    if (snapshot == nullptr || !RestoreJunctions(map, *snapshot)) {
+      CreateJunctionBoundingBoxes(map);
+      ComputeJunctionRoadConflicts(map);
+    }
     CheckSignalsOnRoads(map);
 
     return map;
@@ -835,72 +848,104 @@ namespace road {
     }
   }
 
-  void MapBuilder::CreateJunctionBoundingBoxes(Map &map) {
-    for (auto &junctionpair : map._data.GetJunctions()) {
-      auto* junction = map.GetJunction(junctionpair.first);
-      auto waypoints = map.GetJunctionWaypoints(junction->GetId(), Lane::LaneType::Any);
-      const int number_intervals = 10;
-
-      float minx = std::numeric_limits<float>::max();
-      float miny = std::numeric_limits<float>::max();
-      float minz = std::numeric_limits<float>::max();
-      float maxx = -std::numeric_limits<float>::max();
-      float maxy = -std::numeric_limits<float>::max();
-      float maxz = -std::numeric_limits<float>::max();
-
-      auto get_min_max = [&](geom::Location position) {
-        if (position.x < minx) {
-          minx = position.x;
-        }
-        if (position.y < miny) {
-          miny = position.y;
-        }
-        if (position.z < minz) {
-          minz = position.z;
-        }
-
-        if (position.x > maxx) {
-          maxx = position.x;
-        }
-        if (position.y > maxy) {
-          maxy = position.y;
-        }
-        if (position.z > maxz) {
-          maxz = position.z;
-        }
-      };
+  /// Returns the junctions of @a data, so they can be split among threads.
+  static std::vector<Junction *> GetJunctionList(MapData &data) {
+    std::vector<Junction *> junctions;
+    junctions.reserve(data.GetJunctions().size());
+    for (auto &junctionpair : data.GetJunctions()) {
+      junctions.emplace_back(&junctionpair.second);
+    }
+    return junctions;
+  }
 
-      for (auto &waypoint_p : waypoints) {
-        auto &waypoint_start = waypoint_p.first;
-        auto &waypoint_end = waypoint_p.second;
-        double interval = (waypoint_end.s - waypoint_start.s) / static_cast<double>(number_intervals);
-        auto next_wp = waypoint_end;
-        auto location = map.ComputeTransform(next_wp).location;
+  bool MapBuilder::RestoreJunctions(Map &map, const MapSnapshot &snapshot) {
+    auto &junctions = map._data.GetJunctions();
+    if (snapshot._junctions.size() != junctions.size()) {
+      return false;
+    }
+    for (const auto &junction_data : snapshot._junctions) {
+      if (junctions.count(junction_data.id) == 0u) {
+        return false;
+      }
+    }
+    for (const auto &junction_data : snapshot._junctions) {
+      Junction &junction = junctions.at(junction_data.id);
+      junction._bounding_box = junction_data.bounding_box;
+      junction._road_conflicts = junction_data.road_conflicts;
+    }
+    return true;
+  }
 
-        get_min_max(location);
+  void MapBuilder::CreateJunctionBoundingBoxes(Map &map) {
+    // Each junction only writes its own bounding box
+    const auto junctions = GetJunctionList(map._data);
+    ParallelForRanges(junctions.size(), _number_of_threads, [&](size_t begin, size_t end) {
+      for (size_t index = begin; index < end; ++index) {
+        auto* junction = junctions[index];
+        auto waypoints = map.GetJunctionWaypoints(junction->GetId(), Lane::LaneType::Any);
+        const int number_intervals = 10;
+
+        float minx = std::numeric_limits<float>::max();
+        float miny = std::numeric_limits<float>::max();
+        float minz = std::numeric_limits<float>::max();
+        float maxx = -std::numeric_limits<float>::max();
+        float maxy = -std::numeric_limits<float>::max();
+        float maxz = -std::numeric_limits<float>::max();
+
+        auto get_min_max = [&](geom::Location position) {
+          if (position.x < minx) {
+            minx = position.x;
+          }
+          if (position.y < miny) {
+            miny = position.y;
+          }
+          if (position.z < minz) {
+            minz = position.z;
+          }
 
-        next_wp = waypoint_start;
-        location = map.ComputeTransform(next_wp).location;
+          if (position.x > maxx) {
+            maxx = position.x;
+          }
+          if (position.y > maxy) {
+            maxy = position.y;
+          }
+          if (position.z > maxz) {
+            maxz = position.z;
+          }
+        };
 
-        get_min_max(location);
+        for (auto &waypoint_p : waypoints) {
+          auto &waypoint_start = waypoint_p.first;
+          auto &waypoint_end = waypoint_p.second;
+          double interval = (waypoint_end.s - waypoint_start.s) / static_cast<double>(number_intervals);
+          auto next_wp = waypoint_end;
+          auto location = map.ComputeTransform(next_wp).location;
 
-        for (int i = 0; i < number_intervals; ++i) {
-          if (interval < std::numeric_limits<double>::epsilon())
-            break;
-          auto next = map.GetNext(next_wp, interval);
-          if(next.size()){
-            next_wp = next.back();
-          }
+          get_min_max(location);
 
+          next_wp = waypoint_start;
           location = map.ComputeTransform(next_wp).location;
+
           get_min_max(location);
+
+          for (int i = 0; i < number_intervals; ++i) {
+            if (interval < std::numeric_limits<double>::epsilon())
+              break;
+            auto next = map.GetNext(next_wp, interval);
+            if(next.size()){
+              next_wp = next.back();
+            }
+
+            location = map.ComputeTransform(next_wp).location;
+            get_min_max(location);
+          }
         }
-      }
-      carla::geom::Location location(0.5f * (maxx + minx), 0.5f * (maxy + miny), 0.5f * (maxz + minz));
-      carla::geom::Vector3D extent(0.5f * (maxx - minx), 0.5f * (maxy - miny), 0.5f * (maxz - minz));
+        carla::geom::Location location(0.5f * (maxx + minx), 0.5f * (maxy + miny), 0.5f * (maxz + minz));
+        carla::geom::Vector3D extent(0.5f * (maxx - minx), 0.5f * (maxy - miny), 0.5f * (maxz - minz));
 
-      junction->_bounding_box = carla::geom::BoundingBox(location, extent);
-    }
+        junction->_bounding_box = carla::geom::BoundingBox(location, extent);
+      }
+    });
   }
 
 void MapBuilder::CreateController(
@@ -932,10 +977,13 @@ void MapBuilder::CreateController(
 }
 
   void MapBuilder::ComputeJunctionRoadConflicts(Map &map) {
-    for (auto &junctionpair : map._data.GetJunctions()) {
-      auto& junction = junctionpair.second;
-      junction._road_conflicts = (map.ComputeJunctionConflicts(junction.GetId()));
-    }
+    const auto junctions = GetJunctionList(map._data);
+    ParallelForRanges(junctions.size(), _number_of_threads, [&](size_t begin, size_t end) {
+      for (size_t index = begin; index < end; ++index) {
+        auto& junction = *junctions[index];
+        junction._road_conflicts = (map.ComputeJunctionConflicts(junction.GetId()));
+      }
+    });
   }
 
   void MapBuilder::GenerateDefaultValiditiesForSignalReferences() {
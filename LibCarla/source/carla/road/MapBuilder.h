@@ -20,8 +20,18 @@ namespace road {
   class MapBuilder {
   public:
 
+    /// @a number_of_threads are used for the geometric computations of
+    /// Build, zero runs them in the calling thread.
+    explicit MapBuilder(size_t number_of_threads = 0u)
+      : _number_of_threads(number_of_threads) {}
+
     boost::optional<Map> Build();
 
+    /// Same as above, restoring the rtree and the junction data from
+    /// @a snapshot instead of computing them. @a snapshot must have been
+    /// built from the same OpenDRIVE content.
+    boost::optional<Map> Build(const MapSnapshot &snapshot);
+
     // called from road parser
     carla::road::Road *AddRoad(
         const RoadId road_id,
@@ -364,14 +374,23 @@ namespace road {
 
   private:
 
+    size_t _number_of_threads = 0u;
+
     MapData _map_data;
 
+    boost::optional<Map> BuildMap(const MapSnapshot *snapshot);
+
     /// Create the pointers between RoadSegments based on the ids.
     void CreatePointersBetweenRoadSegments();
 
     /// Create the bounding boxes of each junction
     void CreateJunctionBoundingBoxes(Map &map);
 
+    /// Set the bounding boxes and road conflicts of each junction from
+    /// @a snapshot, returns false without modifying @a map if they do not
+    /// match its junctions.
+    bool RestoreJunctions(Map &map, const MapSnapshot &snapshot);
+
     geom::Transform ComputeSignalTransform(std::unique_ptr<Signal> &signal,  MapData &data);
 
     /// Solves the signal references in the road
@@ -0,0 +1,267 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/MapSnapshot.h"
+
+#include "carla/road/Map.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace carla {
+namespace road {
+
+  /// "CRMS" in little endian.
+  static constexpr uint32_t SNAPSHOT_MAGIC = 0x534D5243u;
+
+  /// Increase whenever the layout or the way the data is computed changes.
+  static constexpr uint32_t SNAPSHOT_VERSION = 1u;
+
+  /// Header at the beginning of a snapshot, the payload follows it.
+  struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t checksum;
+    uint64_t payload_checksum;
+    uint64_t payload_size;
+  };
+
+  static uint64_t FNV1a(const uint8_t *data, size_t size) {
+    uint64_t checksum = 14695981039346656037ull;
+    for (size_t i = 0u; i < size; ++i) {
+      checksum ^= data[i];
+      checksum *= 1099511628211ull;
+    }
+    return checksum;
+  }
+
+  template <typename T>
+  static void Append(std::vector<uint8_t> &data, const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Invalid type");
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  }
+
+  static void Append(std::vector<uint8_t> &data, const geom::Vector3D &vector) {
+    Append(data, vector.x);
+    Append(data, vector.y);
+    Append(data, vector.z);
+  }
+
+  static void Append(std::vector<uint8_t> &data, const element::Waypoint &waypoint) {
+    Append(data, waypoint.road_id);
+    Append(data, waypoint.section_id);
+    Append(data, waypoint.lane_id);
+    Append(data, waypoint.s);
+  }
+
+  /// Sequential reader of the payload that fails, instead of reading past
+  /// the end, on truncated data.
+  class PayloadReader {
+  public:
+
+    PayloadReader(const uint8_t *begin, const uint8_t *end)
+      : _position(begin),
+        _end(end) {}
+
+    template <typename T>
+    bool Read(T &value) {
+      static_assert(std::is_trivially_copyable<T>::value, "Invalid type");
+      if (static_cast<size_t>(_end - _position) < sizeof(T)) {
+        return false;
+      }
+      std::memcpy(&value, _position, sizeof(T));
+      _position += sizeof(T);
+      return true;
+    }
+
+    bool Read(geom::Vector3D &vector) {
+      return Read(vector.x) && Read(vector.y) && Read(vector.z);
+    }
+
+    bool Read(geom::Rotation &rotation) {
+      return Read(rotation.pitch) && Read(rotation.yaw) && Read(rotation.roll);
+    }
+
+    bool Read(element::Waypoint &waypoint) {
+      return
+          Read(waypoint.road_id) &&
+          Read(waypoint.section_id) &&
+          Read(waypoint.lane_id) &&
+          Read(waypoint.s);
+    }
+
+    /// Reads a count of elements of at least @a element_size bytes each,
+    /// failing if the remaining data cannot hold them.
+    bool ReadCount(uint64_t &count, size_t element_size) {
+      return
+          Read(count) &&
+          count <= static_cast<size_t>(_end - _position) / element_size;
+    }
+
+    bool AtEnd() const {
+      return _position == _end;
+    }
+
+  private:
+
+    const uint8_t *_position;
+
+    const uint8_t *_end;
+  };
+
+  static constexpr size_t SEGMENT_SIZE =
+      6u * sizeof(float) +
+      2u * (sizeof(RoadId) + sizeof(SectionId) + sizeof(LaneId) + sizeof(double));
+
+  static constexpr size_t JUNCTION_SIZE =
+      sizeof(JuncId) + 9u * sizeof(float) + sizeof(uint64_t);
+
+  static constexpr size_t ROAD_CONFLICTS_SIZE = sizeof(RoadId) + sizeof(uint64_t);
+
+  uint64_t MapSnapshot::ComputeChecksum(const std::string &opendrive) {
+    return FNV1a(reinterpret_cast<const uint8_t *>(opendrive.data()), opendrive.size());
+  }
+
+  std::vector<uint8_t> MapSnapshot::Write(const Map &map, const uint64_t checksum) {
+    const auto rtree_elements = map._rtree.GetElements();
+    const auto &junctions = map._data.GetJunctions();
+
+    std::vector<uint8_t> data(sizeof(SnapshotHeader));
+    data.reserve(
+        sizeof(SnapshotHeader) +
+        2u * sizeof(uint64_t) +
+        SEGMENT_SIZE * rtree_elements.size() +
+        JUNCTION_SIZE * junctions.size());
+
+    Append(data, static_cast<uint64_t>(rtree_elements.size()));
+    for (const auto &element : rtree_elements) {
+      const auto &segment = element.first;
+      Append(data, segment.first.template get<0>());
+      Append(data, segment.first.template get<1>());
+      Append(data, segment.first.template get<2>());
+      Append(data, segment.second.template get<0>());
+      Append(data, segment.second.template get<1>());
+      Append(data, segment.second.template get<2>());
+      Append(data, element.second.first);
+      Append(data, element.second.second);
+    }
+
+    Append(data, static_cast<uint64_t>(junctions.size()));
+    for (const auto &pair : junctions) {
+      const Junction &junction = pair.second;
+      const geom::BoundingBox bounding_box = junction.GetBoundingBox();
+      Append(data, junction.GetId());
+      Append(data, static_cast<const geom::Vector3D &>(bounding_box.location));
+      Append(data, bounding_box.extent);
+      Append(data, bounding_box.rotation.pitch);
+      Append(data, bounding_box.rotation.yaw);
+      Append(data, bounding_box.rotation.roll);
+      const auto &road_conflicts = junction.GetRoadConflicts();
+      Append(data, static_cast<uint64_t>(road_conflicts.size()));
+      for (const auto &conflicts : road_conflicts) {
+        Append(data, conflicts.first);
+        Append(data, static_cast<uint64_t>(conflicts.second.size()));
+        for (const RoadId road_id : conflicts.second) {
+          Append(data, road_id);
+        }
+      }
+    }
+
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.checksum = checksum;
+    header.payload_size = data.size() - sizeof(SnapshotHeader);
+    header.payload_checksum = FNV1a(data.data() + sizeof(SnapshotHeader), header.payload_size);
+    std::memcpy(data.data(), &header, sizeof(SnapshotHeader));
+    return data;
+  }
+
+  boost::optional<uint64_t> MapSnapshot::GetChecksum(const std::vector<uint8_t> &data) {
+    if (data.size() < sizeof(SnapshotHeader)) {
+      return {};
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, data.data(), sizeof(SnapshotHeader));
+    const uint8_t *payload = data.data() + sizeof(SnapshotHeader);
+    if (header.magic != SNAPSHOT_MAGIC ||
+        header.version != SNAPSHOT_VERSION ||
+        header.payload_size != data.size() - sizeof(SnapshotHeader) ||
+        header.payload_checksum != FNV1a(payload, header.payload_size)) {
+      return {};
+    }
+    return header.checksum;
+  }
+
+  boost::optional<MapSnapshot> MapSnapshot::Read(
+      const std::vector<uint8_t> &data,
+      const uint64_t checksum) {
+    const auto snapshot_checksum = GetChecksum(data);
+    if (!snapshot_checksum.has_value() || *snapshot_checksum != checksum) {
+      return {};
+    }
+
+    MapSnapshot snapshot;
+    PayloadReader reader(data.data() + sizeof(SnapshotHeader), data.data() + data.size());
+
+    uint64_t number_of_segments;
+    if (!reader.ReadCount(number_of_segments, SEGMENT_SIZE)) {
+      return {};
+    }
+    snapshot._rtree_elements.reserve(number_of_segments);
+    for (uint64_t i = 0u; i < number_of_segments; ++i) {
+      geom::Vector3D a;
+      geom::Vector3D b;
+      element::Waypoint start;
+      element::Waypoint end;
+      if (!reader.Read(a) || !reader.Read(b) || !reader.Read(start) || !reader.Read(end)) {
+        return {};
+      }
+      Rtree::BSegment segment(Rtree::BPoint(a.x, a.y, a.z), Rtree::BPoint(b.x, b.y, b.z));
+      snapshot._rtree_elements.emplace_back(segment, std::make_pair(start, end));
+    }
+
+    uint64_t number_of_junctions;
+    if (!reader.ReadCount(number_of_junctions, JUNCTION_SIZE)) {
+      return {};
+    }
+    snapshot._junctions.resize(number_of_junctions);
+    for (auto &junction : snapshot._junctions) {
+      uint64_t number_of_roads;
+      if (!reader.Read(junction.id) ||
+          !reader.Read(static_cast<geom::Vector3D &>(junction.bounding_box.location)) ||
+          !reader.Read(junction.bounding_box.extent) ||
+          !reader.Read(junction.bounding_box.rotation) ||
+          !reader.ReadCount(number_of_roads, ROAD_CONFLICTS_SIZE)) {
+        return {};
+      }
+      for (uint64_t i = 0u; i < number_of_roads; ++i) {
+        RoadId road_id;
+        uint64_t number_of_conflicts;
+        if (!reader.Read(road_id) ||
+            !reader.ReadCount(number_of_conflicts, sizeof(RoadId))) {
+          return {};
+        }
+        auto &conflicts = junction.road_conflicts[road_id];
+        for (uint64_t j = 0u; j < number_of_conflicts; ++j) {
+          RoadId conflict;
+          if (!reader.Read(conflict)) {
+            return {};
+          }
+          conflicts.insert(conflict);
+        }
+      }
+    }
+
+    if (!reader.AtEnd()) {
+      return {};
+    }
+    return snapshot;
+  }
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,84 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/BoundingBox.h"
+#include "carla/geom/Rtree.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+  class MapBuilder;
+
+  /// Binary snapshot of the data computed when a Map is built from its
+  /// OpenDRIVE description: the segments of the rtree and the bounding boxes
+  /// and road conflicts of the junctions. Building a map with the snapshot of
+  /// the same OpenDRIVE content skips sampling the lanes again.
+  ///
+  /// A snapshot is identified by the checksum of the OpenDRIVE content it was
+  /// built from. The data is stored in the native byte order, so it can be
+  /// cached on disk and shared between the processes of a machine.
+  class MapSnapshot {
+  public:
+
+    /// FNV-1a hash of @a opendrive, identifies the snapshots built from it.
+    static uint64_t ComputeChecksum(const std::string &opendrive);
+
+    /// Serializes the snapshot of @a map, @a checksum being the checksum of
+    /// the OpenDRIVE content @a map was built from.
+    static std::vector<uint8_t> Write(const Map &map, uint64_t checksum);
+
+    /// Returns the checksum of the OpenDRIVE content @a data was built from,
+    /// or nothing if @a data is not a valid snapshot.
+    static boost::optional<uint64_t> GetChecksum(const std::vector<uint8_t> &data);
+
+    /// Deserializes @a data, returns nothing if it is not a valid snapshot
+    /// or if it was not built from the OpenDRIVE content with @a checksum.
+    static boost::optional<MapSnapshot> Read(
+        const std::vector<uint8_t> &data,
+        uint64_t checksum);
+
+    size_t GetNumberOfSegments() const {
+      return _rtree_elements.size();
+    }
+
+  private:
+
+    friend Map;
+    friend MapBuilder;
+
+    MapSnapshot() = default;
+
+    using Rtree = geom::SegmentCloudRtree<element::Waypoint>;
+
+    struct JunctionData {
+
+      JuncId id;
+
+      geom::BoundingBox bounding_box;
+
+      std::unordered_map<RoadId, std::unordered_set<RoadId>> road_conflicts;
+    };
+
+    std::vector<Rtree::TreeElement> _rtree_elements;
+
+    std::vector<JunctionData> _junctions;
+  };
+
+} // namespace road
+} // namespace carla
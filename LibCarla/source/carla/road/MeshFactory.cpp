@@ -399,19 +399,20 @@ namespace geom {
     // Build rtree for neighborhood queries
     using Rtree = geom::PointCloudRtree<VertexInfo>;
     using Point = Rtree::BPoint;
-    Rtree rtree;
+    std::vector<Rtree::TreeElement> elements;
     for (size_t lane_mesh_idx = 0; lane_mesh_idx < lane_meshes.size(); ++lane_mesh_idx) {
       auto& mesh = lane_meshes[lane_mesh_idx];
       for(size_t i = 0; i < mesh->GetVerticesNum(); ++i) {
         auto& vertex = mesh->GetVertices()[i];
         Point point(vertex.x, vertex.y, vertex.z);
         if (i < 2 || i >= mesh->GetVerticesNum() - 2) {
-          rtree.InsertElement({point, {&vertex, lane_mesh_idx, true}});
+          elements.push_back({point, {&vertex, lane_mesh_idx, true}});
         } else {
-          rtree.InsertElement({point, {&vertex, lane_mesh_idx, false}});
+          elements.push_back({point, {&vertex, lane_mesh_idx, false}});
         }
       }
     }
+    const Rtree rtree(elements);
 
     // Find neighbors for each vertex and compute their weight
     std::vector<VertexNeighbors> vertices_neighborhoods;
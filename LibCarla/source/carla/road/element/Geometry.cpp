@@ -141,6 +141,7 @@ namespace element {
     double last_v = _poly.Evaluate(current_u);
     double last_s = 0;
     RtreeValue last_val{last_u, last_v, last_s, _poly.Tangent(current_u)};
+    std::vector<TreeElement> elements;
     while (current_s < _length + delta_u) {
       current_u += delta_u;
       double current_v = _poly.Evaluate(current_u);
@@ -153,7 +154,7 @@ namespace element {
 
       Rtree::BPoint p1(static_cast<float>(last_s));
       Rtree::BPoint p2(static_cast<float>(current_s));
-      _rtree.InsertElement(Rtree::BSegment(p1, p2), last_val, current_val);
+      elements.emplace_back(Rtree::BSegment(p1, p2), std::make_pair(last_val, current_val));
 
       last_u = current_u;
       last_v = current_v;
@@ -161,6 +162,7 @@ namespace element {
       last_val = current_val;
 
     }
+    _rtree = Rtree(elements);
   }
 
   DirectedPoint GeometryParamPoly3::PosFromDist(double dist) const {
@@ -208,6 +210,8 @@ namespace element {
         last_s,
         _polyU.Tangent(param_p),
         _polyV.Tangent(param_p) };
+    std::vector<TreeElement> elements;
+    elements.reserve(number_intervals);
     for(size_t i = 0; i < number_intervals; ++i) {
       param_p += delta_p;
       double current_u = _polyU.Evaluate(param_p);
@@ -227,7 +231,7 @@ namespace element {
 
       Rtree::BPoint p1(static_cast<float>(last_s));
       Rtree::BPoint p2(static_cast<float>(current_s));
-      _rtree.InsertElement(Rtree::BSegment(p1, p2), last_val, current_val);
+      elements.emplace_back(Rtree::BSegment(p1, p2), std::make_pair(last_val, current_val));
 
       last_u = current_u;
       last_v = current_v;
@@ -238,6 +242,7 @@ namespace element {
         break;
       }
     }
+    _rtree = Rtree(elements);
   }
 } // namespace element
 } // namespace road
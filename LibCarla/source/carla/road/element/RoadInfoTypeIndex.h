@@ -0,0 +1,89 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/road/element/RoadInfo.h"
+#include "carla/road/element/RoadInfoVisitor.h"
+
+#include <cstddef>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// Dense index of each road info type, in the order of RoadInfoVisitor.
+  template <typename T>
+  struct RoadInfoTypeIndex;
+
+#define CARLA_ROAD_INFO_TYPE_INDEX(type, index) \
+  template <> \
+  struct RoadInfoTypeIndex<type> { \
+    static constexpr size_t value = index; \
+  };
+
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoElevation, 0u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoGeometry, 1u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLane, 2u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneAccess, 3u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneBorder, 4u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneHeight, 5u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneMaterial, 6u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneOffset, 7u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneRule, 8u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneVisibility, 9u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoLaneWidth, 10u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoMarkRecord, 11u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoMarkTypeLine, 12u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoSpeed, 13u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoCrosswalk, 14u)
+  CARLA_ROAD_INFO_TYPE_INDEX(RoadInfoSignal, 15u)
+
+#undef CARLA_ROAD_INFO_TYPE_INDEX
+
+  static constexpr size_t NUMBER_OF_ROAD_INFO_TYPES = 16u;
+
+  /// Returns the RoadInfoTypeIndex of the dynamic type of a road info, or
+  /// NUMBER_OF_ROAD_INFO_TYPES if it is not known.
+  class RoadInfoTypeClassifier : private RoadInfoVisitor {
+  public:
+
+    size_t operator()(RoadInfo &info) {
+      _index = NUMBER_OF_ROAD_INFO_TYPES;
+      info.AcceptVisitor(*this);
+      return _index;
+    }
+
+  private:
+
+    template <typename T>
+    void Set() {
+      _index = RoadInfoTypeIndex<T>::value;
+    }
+
+    void Visit(RoadInfoElevation &) final { Set<RoadInfoElevation>(); }
+    void Visit(RoadInfoGeometry &) final { Set<RoadInfoGeometry>(); }
+    void Visit(RoadInfoLane &) final { Set<RoadInfoLane>(); }
+    void Visit(RoadInfoLaneAccess &) final { Set<RoadInfoLaneAccess>(); }
+    void Visit(RoadInfoLaneBorder &) final { Set<RoadInfoLaneBorder>(); }
+    void Visit(RoadInfoLaneHeight &) final { Set<RoadInfoLaneHeight>(); }
+    void Visit(RoadInfoLaneMaterial &) final { Set<RoadInfoLaneMaterial>(); }
+    void Visit(RoadInfoLaneOffset &) final { Set<RoadInfoLaneOffset>(); }
+    void Visit(RoadInfoLaneRule &) final { Set<RoadInfoLaneRule>(); }
+    void Visit(RoadInfoLaneVisibility &) final { Set<RoadInfoLaneVisibility>(); }
+    void Visit(RoadInfoLaneWidth &) final { Set<RoadInfoLaneWidth>(); }
+    void Visit(RoadInfoMarkRecord &) final { Set<RoadInfoMarkRecord>(); }
+    void Visit(RoadInfoMarkTypeLine &) final { Set<RoadInfoMarkTypeLine>(); }
+    void Visit(RoadInfoSpeed &) final { Set<RoadInfoSpeed>(); }
+    void Visit(RoadInfoCrosswalk &) final { Set<RoadInfoCrosswalk>(); }
+    void Visit(RoadInfoSignal &) final { Set<RoadInfoSignal>(); }
+
+    size_t _index = NUMBER_OF_ROAD_INFO_TYPES;
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
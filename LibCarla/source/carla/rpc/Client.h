@@ -10,6 +10,8 @@
 
 #include <rpc/client.h>
 
+#include <future>
+
 namespace carla {
 namespace rpc {
 
@@ -38,6 +40,14 @@ namespace rpc {
       _client.async_call(function, Metadata::MakeAsync(), std::forward<Args>(args)...);
     }
 
+    /// Send the request without waiting for the response, the server handles
+    /// it as a sync call and the result is delivered to the returned future.
+    /// Any number of these can be in flight at once over the same connection.
+    template <typename... Args>
+    std::future<clmdep_msgpack::object_handle> future_call(const std::string &function, Args &&... args) {
+      return _client.async_call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+    }
+
   private:
 
     ::rpc::client _client;
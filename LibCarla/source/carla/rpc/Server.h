@@ -7,7 +7,10 @@
 #pragma once
 
 #include "carla/MoveHandler.h"
+#include "carla/ThreadPool.h"
 #include "carla/Time.h"
+#include "carla/profiler/Histogram.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/rpc/Metadata.h"
 #include "carla/rpc/Response.h"
 
@@ -16,11 +19,33 @@
 
 #include <rpc/server.h>
 
+#include <chrono>
+#include <deque>
 #include <future>
+#include <string>
+#include <vector>
 
 namespace carla {
 namespace rpc {
 
+  enum class BindingType : uint8_t {
+    Sync,
+    Async,
+    ReadOnly
+  };
+
+  /// Latency of the calls to a bound function, from the moment the call is
+  /// received until its response is ready, in milliseconds.
+  struct EndpointStats {
+    std::string name;
+    BindingType binding;
+    uint64_t calls;
+    double mean;
+    double p50;
+    double p99;
+    double maximum;
+  };
+
   // ===========================================================================
   // -- Server -----------------------------------------------------------------
   // ===========================================================================
@@ -33,7 +58,10 @@ namespace rpc {
   ///
   /// Functions that are bind using `BindAsync` will run asynchronously in the
   /// worker threads. Functions that are bind using `BindSync` will run within
-  /// `SyncRunFor` function.
+  /// `SyncRunFor` function. Functions that are bind using `BindReadOnly` will
+  /// run in a separate pool of threads, concurrently with `SyncRunFor` and
+  /// with each other, so they must be thread-safe (e.g., reading an immutable
+  /// snapshot published by the game thread).
   class Server {
   public:
 
@@ -46,7 +74,11 @@ namespace rpc {
     template <typename FunctorT>
     void BindAsync(const std::string &name, FunctorT &&functor);
 
-    void AsyncRun(size_t worker_threads) {
+    template <typename FunctorT>
+    void BindReadOnly(const std::string &name, FunctorT &&functor);
+
+    void AsyncRun(size_t worker_threads, size_t read_only_threads = 2u) {
+      _read_only_pool.AsyncRun(read_only_threads);
       _server.async_run(worker_threads);
     }
 
@@ -63,12 +95,40 @@ namespace rpc {
     /// @warning does not stop the game thread.
     void Stop() {
       _server.stop();
+      _read_only_pool.Stop();
     }
 
+    /// Latency of the calls received by each bound function.
+    std::vector<EndpointStats> GetEndpointStats() const;
+
+    void ResetEndpointStats();
+
   private:
 
+    struct Endpoint {
+      Endpoint(std::string in_name, BindingType in_binding)
+        : name(std::move(in_name)),
+          binding(in_binding) {}
+
+      const std::string name;
+      const BindingType binding;
+      profiler::Histogram latency;
+    };
+
+    /// Functions are bound before running the server, the wrappers keep a
+    /// reference to their endpoint.
+    profiler::Histogram &AddEndpoint(const std::string &name, BindingType binding) {
+      _endpoints.emplace_back(name, binding);
+      return _endpoints.back().latency;
+    }
+
     boost::asio::io_context _sync_io_context;
 
+    /// Stable addresses.
+    std::deque<Endpoint> _endpoints;
+
+    ThreadPool _read_only_pool;
+
     ::rpc::server _server;
   };
 
@@ -78,6 +138,29 @@ namespace rpc {
 
 namespace detail {
 
+  /// Adds the time elapsed since @a begin to @a latency when destroyed, after
+  /// the call has returned.
+  class LatencyRecorder {
+  public:
+
+    using clock_type = std::chrono::steady_clock;
+
+    LatencyRecorder(profiler::Histogram &latency, clock_type::time_point begin)
+      : _latency(latency),
+        _begin(begin) {}
+
+    ~LatencyRecorder() {
+      const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - _begin);
+      _latency.Add(static_cast<uint64_t>(elapsed.count()));
+    }
+
+  private:
+
+    profiler::Histogram &_latency;
+
+    const clock_type::time_point _begin;
+  };
+
   template <typename T>
   struct FunctionWrapper : FunctionWrapper<decltype(&T::operator())> {};
 
@@ -105,10 +188,20 @@ namespace detail {
     /// @a functor provided is always called from the context of the io_context.
     /// I.e., we can use the io_context to run tasks on a specific thread (e.g.
     /// game thread).
+    ///
+    /// The execution of @a functor is traced as @a trace_point, and the time
+    /// since the call was received until it finished is added to @a latency.
     template <typename FuncT>
-    static auto WrapSyncCall(boost::asio::io_context &io, FuncT &&functor) {
-      return [&io, functor=std::forward<FuncT>(functor)](Metadata metadata, Args... args) -> R {
-        auto task = std::packaged_task<R()>([functor=std::move(functor), args...]() {
+    static auto WrapSyncCall(
+        boost::asio::io_context &io,
+        profiler::TracePoint &trace_point,
+        profiler::Histogram &latency,
+        FuncT &&functor) {
+      return [&io, &trace_point, &latency, functor=std::forward<FuncT>(functor)](Metadata metadata, Args... args) -> R {
+        const auto begin = LatencyRecorder::clock_type::now();
+        auto task = std::packaged_task<R()>([&trace_point, &latency, begin, functor=std::move(functor), args...]() {
+          LatencyRecorder recorder(latency, begin);
+          profiler::ScopedTrace trace(trace_point);
           return functor(args...);
         });
         if (metadata.IsResponseIgnored()) {
@@ -128,8 +221,13 @@ namespace detail {
     /// handles the metadata sent by the client. If the client called this
     /// method asynchronously, the result is ignored.
     template <typename FuncT>
-    static auto WrapAsyncCall(FuncT &&functor) {
-      return [functor=std::forward<FuncT>(functor)](::carla::rpc::Metadata metadata, Args... args) -> R {
+    static auto WrapAsyncCall(
+        profiler::TracePoint &trace_point,
+        profiler::Histogram &latency,
+        FuncT &&functor) {
+      return [&trace_point, &latency, functor=std::forward<FuncT>(functor)](::carla::rpc::Metadata metadata, Args... args) -> R {
+        LatencyRecorder recorder(latency, LatencyRecorder::clock_type::now());
+        profiler::ScopedTrace trace(trace_point);
         if (metadata.IsResponseIgnored()) {
           functor(args...);
           return R();
@@ -153,7 +251,11 @@ namespace detail {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
     _server.bind(
         name,
-        Wrapper::WrapSyncCall(_sync_io_context, std::forward<FunctorT>(functor)));
+        Wrapper::WrapSyncCall(
+            _sync_io_context,
+            profiler::Tracer::GetTracePoint("rpc", name),
+            AddEndpoint(name, BindingType::Sync),
+            std::forward<FunctorT>(functor)));
   }
 
   template <typename FunctorT>
@@ -161,7 +263,49 @@ namespace detail {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
     _server.bind(
         name,
-        Wrapper::WrapAsyncCall(std::forward<FunctorT>(functor)));
+        Wrapper::WrapAsyncCall(
+            profiler::Tracer::GetTracePoint("rpc", name),
+            AddEndpoint(name, BindingType::Async),
+            std::forward<FunctorT>(functor)));
+  }
+
+  template <typename FunctorT>
+  inline void Server::BindReadOnly(const std::string &name, FunctorT &&functor) {
+    using Wrapper = detail::FunctionWrapper<FunctorT>;
+    _server.bind(
+        name,
+        Wrapper::WrapSyncCall(
+            _read_only_pool.io_context(),
+            profiler::Tracer::GetTracePoint("rpc", name),
+            AddEndpoint(name, BindingType::ReadOnly),
+            std::forward<FunctorT>(functor)));
+  }
+
+  inline std::vector<EndpointStats> Server::GetEndpointStats() const {
+    const auto to_milliseconds = [](uint64_t nanoseconds) {
+      return 1e-6 * static_cast<double>(nanoseconds);
+    };
+    std::vector<EndpointStats> stats;
+    stats.reserve(_endpoints.size());
+    for (const auto &endpoint : _endpoints) {
+      const auto &latency = endpoint.latency;
+      const auto calls = latency.GetCount();
+      stats.emplace_back(EndpointStats{
+          endpoint.name,
+          endpoint.binding,
+          calls,
+          calls > 0u ? to_milliseconds(latency.GetTotal()) / static_cast<double>(calls) : 0.0,
+          to_milliseconds(latency.GetPercentile(0.5)),
+          to_milliseconds(latency.GetPercentile(0.99)),
+          to_milliseconds(latency.GetMax())});
+    }
+    return stats;
+  }
+
+  inline void Server::ResetEndpointStats() {
+    for (auto &endpoint : _endpoints) {
+      endpoint.latency.Reset();
+    }
   }
 
 } // namespace rpc
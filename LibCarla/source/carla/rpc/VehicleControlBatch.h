@@ -0,0 +1,193 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/MsgPack.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/VehicleControl.h"
+#include "carla/rpc/VehicleLightState.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Controls of many vehicles sent in a single message, with optional light
+  /// states for some of them. The values are stored by columns, and each
+  /// column is serialized as a single binary blob, so packing and unpacking a
+  /// batch copies memory instead of encoding every command and value.
+  ///
+  /// The blobs keep the byte order of the machine, client and server are
+  /// expected to share it as they do for the sensor data.
+  class VehicleControlBatch {
+  public:
+
+    enum Flags : uint8_t {
+      HandBrake       = 1u << 0u,
+      Reverse         = 1u << 1u,
+      ManualGearShift = 1u << 2u
+    };
+
+    void Reserve(size_t number_of_vehicles) {
+      _actors.reserve(number_of_vehicles);
+      _throttle.reserve(number_of_vehicles);
+      _steer.reserve(number_of_vehicles);
+      _brake.reserve(number_of_vehicles);
+      _flags.reserve(number_of_vehicles);
+      _gear.reserve(number_of_vehicles);
+    }
+
+    void Add(ActorId actor, const VehicleControl &control) {
+      _actors.emplace_back(actor);
+      _throttle.emplace_back(control.throttle);
+      _steer.emplace_back(control.steer);
+      _brake.emplace_back(control.brake);
+      _flags.emplace_back(static_cast<uint8_t>(
+          (control.hand_brake ? static_cast<uint8_t>(HandBrake) : 0u) |
+          (control.reverse ? static_cast<uint8_t>(Reverse) : 0u) |
+          (control.manual_gear_shift ? static_cast<uint8_t>(ManualGearShift) : 0u)));
+      _gear.emplace_back(control.gear);
+    }
+
+    void AddLightState(ActorId actor, VehicleLightState::flag_type light_state) {
+      _light_actors.emplace_back(actor);
+      _light_states.emplace_back(light_state);
+    }
+
+    void Clear() {
+      _actors.clear();
+      _throttle.clear();
+      _steer.clear();
+      _brake.clear();
+      _flags.clear();
+      _gear.clear();
+      _light_actors.clear();
+      _light_states.clear();
+    }
+
+    /// Number of vehicle controls.
+    size_t size() const {
+      return _actors.size();
+    }
+
+    bool empty() const {
+      return _actors.empty() && _light_actors.empty();
+    }
+
+    ActorId GetActorId(size_t index) const {
+      return _actors[index];
+    }
+
+    VehicleControl GetControl(size_t index) const {
+      const uint8_t flags = _flags[index];
+      return VehicleControl{
+          _throttle[index],
+          _steer[index],
+          _brake[index],
+          (flags & HandBrake) != 0u,
+          (flags & Reverse) != 0u,
+          (flags & ManualGearShift) != 0u,
+          _gear[index]};
+    }
+
+    size_t GetNumberOfLightStates() const {
+      return _light_actors.size();
+    }
+
+    ActorId GetLightStateActorId(size_t index) const {
+      return _light_actors[index];
+    }
+
+    VehicleLightState::flag_type GetLightState(size_t index) const {
+      return _light_states[index];
+    }
+
+    // =========================================================================
+    // -- Serialization --------------------------------------------------------
+    // =========================================================================
+
+    template <typename Packer>
+    void msgpack_pack(Packer &packer) const {
+      packer.pack_array(8u);
+      PackColumn(packer, _actors);
+      PackColumn(packer, _throttle);
+      PackColumn(packer, _steer);
+      PackColumn(packer, _brake);
+      PackColumn(packer, _flags);
+      PackColumn(packer, _gear);
+      PackColumn(packer, _light_actors);
+      PackColumn(packer, _light_states);
+    }
+
+    void msgpack_unpack(const clmdep_msgpack::object &o) {
+      if ((o.type != clmdep_msgpack::type::ARRAY) || (o.via.array.size != 8u)) {
+        throw_exception(clmdep_msgpack::type_error());
+      }
+      const auto *columns = o.via.array.ptr;
+      UnpackColumn(columns[0u], _actors);
+      UnpackColumn(columns[1u], _throttle);
+      UnpackColumn(columns[2u], _steer);
+      UnpackColumn(columns[3u], _brake);
+      UnpackColumn(columns[4u], _flags);
+      UnpackColumn(columns[5u], _gear);
+      UnpackColumn(columns[6u], _light_actors);
+      UnpackColumn(columns[7u], _light_states);
+      const auto number_of_vehicles = _actors.size();
+      if ((_throttle.size() != number_of_vehicles) ||
+          (_steer.size() != number_of_vehicles) ||
+          (_brake.size() != number_of_vehicles) ||
+          (_flags.size() != number_of_vehicles) ||
+          (_gear.size() != number_of_vehicles) ||
+          (_light_states.size() != _light_actors.size())) {
+        throw_exception(clmdep_msgpack::type_error());
+      }
+    }
+
+  private:
+
+    template <typename Packer, typename T>
+    static void PackColumn(Packer &packer, const std::vector<T> &column) {
+      static_assert(std::is_trivially_copyable<T>::value, "Columns must be trivially copyable");
+      const auto size = static_cast<uint32_t>(sizeof(T) * column.size());
+      packer.pack_bin(size);
+      packer.pack_bin_body(reinterpret_cast<const char *>(column.data()), size);
+    }
+
+    template <typename T>
+    static void UnpackColumn(const clmdep_msgpack::object &o, std::vector<T> &column) {
+      if ((o.type != clmdep_msgpack::type::BIN) || (o.via.bin.size % sizeof(T) != 0u)) {
+        throw_exception(clmdep_msgpack::type_error());
+      }
+      column.resize(o.via.bin.size / sizeof(T));
+      if (!column.empty()) {
+        std::memcpy(column.data(), o.via.bin.ptr, o.via.bin.size);
+      }
+    }
+
+    std::vector<ActorId> _actors;
+
+    std::vector<float> _throttle;
+
+    std::vector<float> _steer;
+
+    std::vector<float> _brake;
+
+    std::vector<uint8_t> _flags;
+
+    std::vector<int32_t> _gear;
+
+    std::vector<ActorId> _light_actors;
+
+    std::vector<VehicleLightState::flag_type> _light_states;
+  };
+
+} // namespace rpc
+} // namespace carla
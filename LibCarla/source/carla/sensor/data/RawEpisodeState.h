@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/Debug.h"
+#include "carla/ListView.h"
 #include "carla/sensor/data/ActorDynamicState.h"
 #include "carla/sensor/data/Array.h"
 #include "carla/sensor/s11n/EpisodeStateSerializer.h"
@@ -25,7 +26,9 @@ namespace data {
     friend Serializer;
 
     explicit RawEpisodeState(RawData &&data)
-      : Super(Serializer::header_offset, std::move(data)) {}
+      : Super(std::move(data), [](const RawData &d) {
+          return Serializer::GetActorsOffset(d);
+        }) {}
 
   private:
 
@@ -66,6 +69,24 @@ namespace data {
       return GetHeader().simulation_state;
     }
 
+    /// Whether this state holds only the actors that changed since the
+    /// keyframe sent at GetBaseFrame(), see EpisodeStateSerializer::Encoding.
+    bool IsDelta() const {
+      return GetHeader().encoding == Serializer::Encoding::Delta;
+    }
+
+    /// Frame of the keyframe a delta is relative to.
+    uint64_t GetBaseFrame() const {
+      return GetHeader().base_frame;
+    }
+
+    /// Ids of the actors removed since the keyframe, only in deltas.
+    auto GetRemovedActorIds() const {
+      const auto *begin = reinterpret_cast<const ActorId *>(
+          Super::GetRawData().begin() + Serializer::header_offset);
+      return MakeListView(begin, begin + GetHeader().number_of_removed_actors);
+    }
+
   };
 
 } // namespace data
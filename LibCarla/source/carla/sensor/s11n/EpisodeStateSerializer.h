@@ -11,6 +11,7 @@
 #include "carla/Memory.h"
 #include "carla/geom/Transform.h"
 #include "carla/geom/Vector3DInt.h"
+#include "carla/rpc/ActorId.h"
 #include "carla/sensor/RawData.h"
 #include "carla/sensor/data/ActorDynamicState.h"
 
@@ -33,6 +34,17 @@ namespace s11n {
       PendingLightUpdate = (0x1 << 1)
     };
 
+    /// How the actors of a message relate to the state of the episode.
+    enum class Encoding : uint8_t {
+      /// The message holds every actor of the episode.
+      Keyframe,
+      /// The message holds only the actors that changed since the keyframe
+      /// sent at frame base_frame, and the ids of the actors removed since
+      /// then. As it is relative to the keyframe and not to the previous
+      /// message, it can be applied on any state at or after base_frame.
+      Delta
+    };
+
 #pragma pack(push, 1)
     struct Header {
       uint64_t episode_id;
@@ -40,15 +52,25 @@ namespace s11n {
       float delta_seconds;
       geom::Vector3DInt map_origin;
       SimulationState simulation_state = SimulationState::None;
+      Encoding encoding = Encoding::Keyframe;
+      uint64_t base_frame = 0u;
+      uint32_t number_of_removed_actors = 0u;
     };
 #pragma pack(pop)
 
+    /// The ids of the removed actors follow the header, then the states of
+    /// the actors.
     constexpr static auto header_offset = sizeof(Header);
 
     static const Header &DeserializeHeader(const RawData &message) {
       return *reinterpret_cast<const Header *>(message.begin());
     }
 
+    static size_t GetActorsOffset(const RawData &message) {
+      return header_offset +
+          sizeof(ActorId) * DeserializeHeader(message).number_of_removed_actors;
+    }
+
     template <typename SensorT>
     static Buffer Serialize(const SensorT &, Buffer &&buffer) {
       return std::move(buffer);
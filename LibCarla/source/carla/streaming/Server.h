@@ -69,6 +69,21 @@ namespace streaming {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    /// Set the outgoing queue of each session while the server is in
+    /// synchronous (@a synchronous = true) or asynchronous mode.
+    void SetSendQueueSettings(bool synchronous, detail::tcp::SendQueueSettings settings) {
+      _server.SetSendQueueSettings(synchronous, settings);
+    }
+
+    /// Counters of messages sent and dropped by all the sessions.
+    detail::tcp::SendQueueStatistics GetSendQueueStatistics() const {
+      return _server.GetSendQueueStatistics();
+    }
+
+    void SetSharedMemory(bool enable) {
+      _server.SetSharedMemory(enable);
+    }
+
     carla::streaming::detail::token_type GetToken(carla::streaming::detail::stream_id_type sensor_id) {
       return _server.GetToken(sensor_id);
     }
@@ -0,0 +1,309 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/Compression.h"
+
+#include "carla/Debug.h"
+
+#include <cstring>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  // ===========================================================================
+  // -- LZ codec ---------------------------------------------------------------
+  // ===========================================================================
+
+namespace lz {
+
+  static constexpr size_t MIN_MATCH = 4u;
+
+  static constexpr size_t MAX_OFFSET = 65535u;
+
+  /// The last bytes of the input are always emitted as literals, this keeps
+  /// the match extension loop free of bounds checks on the reference.
+  static constexpr size_t LAST_LITERALS = 5u;
+
+  static constexpr size_t MIN_INPUT_SIZE = 13u;
+
+  static constexpr unsigned HASH_LOG = 16u;
+
+  static inline uint32_t Read32(const unsigned char *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  static inline uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32u - HASH_LOG);
+  }
+
+  static inline unsigned char *WriteLength(unsigned char *op, size_t length) {
+    while (length >= 255u) {
+      *op++ = 255u;
+      length -= 255u;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+  }
+
+  static inline unsigned char *WriteSequence(
+      unsigned char *op,
+      const unsigned char *literals,
+      size_t literal_length,
+      size_t offset,
+      size_t match_length) {
+    unsigned char *token = op++;
+    *token = static_cast<unsigned char>((literal_length < 15u ? literal_length : 15u) << 4u);
+    if (literal_length >= 15u) {
+      op = WriteLength(op, literal_length - 15u);
+    }
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+    if (match_length == 0u) {
+      return op; // last sequence.
+    }
+    *op++ = static_cast<unsigned char>(offset & 0xffu);
+    *op++ = static_cast<unsigned char>(offset >> 8u);
+    const size_t length = match_length - MIN_MATCH;
+    *token |= static_cast<unsigned char>(length < 15u ? length : 15u);
+    if (length >= 15u) {
+      op = WriteLength(op, length - 15u);
+    }
+    return op;
+  }
+
+  size_t Compress(
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      HashTable &table) {
+    unsigned char *op = destination;
+    const unsigned char *anchor = source;
+    if (size >= MIN_INPUT_SIZE) {
+      table.resize(1u << HASH_LOG, 0u);
+      const unsigned char *ip = source + 1u;
+      const unsigned char *const match_limit = source + size - LAST_LITERALS;
+      const unsigned char *const search_limit = source + size - MIN_INPUT_SIZE + 1u;
+      size_t misses = 0u;
+      while (ip < search_limit) {
+        const uint32_t sequence = Read32(ip);
+        const uint32_t hash = Hash(sequence);
+        const size_t position = static_cast<size_t>(ip - source);
+        // The entry may come from a previous input, check it is behind.
+        const size_t reference_position = table[hash];
+        table[hash] = static_cast<uint32_t>(position);
+        const unsigned char *reference = source + reference_position;
+        if ((reference_position < position) &&
+            (position - reference_position <= MAX_OFFSET) &&
+            (Read32(reference) == sequence)) {
+          const unsigned char *match_end = ip + MIN_MATCH;
+          const unsigned char *ref_end = reference + MIN_MATCH;
+          while ((match_end < match_limit) && (*match_end == *ref_end)) {
+            ++match_end;
+            ++ref_end;
+          }
+          op = WriteSequence(
+              op,
+              anchor,
+              static_cast<size_t>(ip - anchor),
+              static_cast<size_t>(ip - reference),
+              static_cast<size_t>(match_end - ip));
+          ip = match_end;
+          anchor = ip;
+          misses = 0u;
+        } else {
+          // Skip faster over data that does not compress.
+          ip += 1u + (misses++ >> 6u);
+        }
+      }
+    }
+    const size_t last_literals = static_cast<size_t>(source + size - anchor);
+    op = WriteSequence(op, anchor, last_literals, 0u, 0u);
+    DEBUG_ASSERT(static_cast<size_t>(op - destination) <= max_compressed_size(size));
+    return static_cast<size_t>(op - destination);
+  }
+
+  size_t Compress(const unsigned char *source, const size_t size, unsigned char *destination) {
+    static thread_local HashTable table;
+    return Compress(source, size, destination, table);
+  }
+
+  static inline bool ReadLength(const unsigned char *&ip, const unsigned char *end, size_t &length) {
+    unsigned char byte;
+    do {
+      if (ip >= end) {
+        return false;
+      }
+      byte = *ip++;
+      length += byte;
+    } while (byte == 255u);
+    return true;
+  }
+
+  bool Decompress(
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t decompressed_size) {
+    const unsigned char *ip = source;
+    const unsigned char *const ip_end = source + size;
+    unsigned char *op = destination;
+    unsigned char *const op_end = destination + decompressed_size;
+    while (ip < ip_end) {
+      const unsigned token = *ip++;
+      size_t literal_length = token >> 4u;
+      if ((literal_length == 15u) && !ReadLength(ip, ip_end, literal_length)) {
+        return false;
+      }
+      if ((literal_length > static_cast<size_t>(ip_end - ip)) ||
+          (literal_length > static_cast<size_t>(op_end - op))) {
+        return false;
+      }
+      std::memcpy(op, ip, literal_length);
+      ip += literal_length;
+      op += literal_length;
+      if (ip == ip_end) {
+        break; // last sequence.
+      }
+      if (ip_end - ip < 2) {
+        return false;
+      }
+      const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8u);
+      ip += 2u;
+      if ((offset == 0u) || (offset > static_cast<size_t>(op - destination))) {
+        return false;
+      }
+      size_t match_length = token & 15u;
+      if ((match_length == 15u) && !ReadLength(ip, ip_end, match_length)) {
+        return false;
+      }
+      match_length += MIN_MATCH;
+      if (match_length > static_cast<size_t>(op_end - op)) {
+        return false;
+      }
+      const unsigned char *match = op - offset;
+      if (offset >= match_length) {
+        std::memcpy(op, match, match_length);
+        op += match_length;
+      } else {
+        // Overlapping copy, repeats the last offset bytes.
+        for (size_t i = 0u; i < match_length; ++i) {
+          *op++ = *match++;
+        }
+      }
+    }
+    return op == op_end;
+  }
+
+} // namespace lz
+
+  // ===========================================================================
+  // -- Compressor -------------------------------------------------------------
+  // ===========================================================================
+
+  bool Compressor::CompressFrame(Buffer &destination) {
+    const size_t size = _frame.size();
+    if ((size == 0u) ||
+        (sizeof(CompressionHeader) + lz::max_compressed_size(size) > Buffer::max_size())) {
+      return false;
+    }
+
+    CompressionHeader header;
+    header.mode = CompressionMode::Lz;
+    header.uncompressed_size = static_cast<message_size_type>(size);
+    const unsigned char *input = _frame.data();
+
+    if (_mode == CompressionMode::DeltaLz) {
+      const uint32_t previous_id = _frame_id;
+      if (++_frame_id == 0u) {
+        _frame_id = 1u; // overflow, the next frame is a key frame.
+      }
+      header.frame_id = _frame_id;
+      const bool key_frame_requested = _key_frame_requested.exchange(false);
+      const bool is_key_frame =
+          key_frame_requested ||
+          (previous_id == 0u) ||
+          (_frame_id < previous_id) ||
+          (_previous_frame.size() != size) ||
+          (_frame_id % _key_frame_interval == 0u);
+      if (!is_key_frame) {
+        _delta.resize(size);
+        for (size_t i = 0u; i < size; ++i) {
+          _delta[i] = _frame[i] ^ _previous_frame[i];
+        }
+        header.mode = CompressionMode::DeltaLz;
+        header.reference_id = previous_id;
+        input = _delta.data();
+      }
+    }
+
+    destination.reset(sizeof(CompressionHeader) + lz::max_compressed_size(size));
+    const size_t compressed_size = lz::Compress(
+        input,
+        size,
+        destination.data() + sizeof(CompressionHeader),
+        _hash_table);
+    std::memcpy(destination.data(), &header, sizeof(CompressionHeader));
+    destination.reset(sizeof(CompressionHeader) + compressed_size);
+
+    if (_mode == CompressionMode::DeltaLz) {
+      // Delta streams always send compressed frames, otherwise the client
+      // would lose track of the reference frame.
+      _previous_frame.swap(_frame);
+      return true;
+    }
+    return compressed_size < size;
+  }
+
+  // ===========================================================================
+  // -- Decompressor -----------------------------------------------------------
+  // ===========================================================================
+
+  bool Decompressor::Decompress(const Buffer &source, Buffer &destination) {
+    CompressionHeader header;
+    if (source.size() < sizeof(header)) {
+      return false;
+    }
+    std::memcpy(&header, source.data(), sizeof(header));
+    const size_t size = header.uncompressed_size;
+
+    if (header.mode == CompressionMode::DeltaLz) {
+      if ((header.reference_id != _previous_frame_id) ||
+          (_previous_frame.size() != size)) {
+        return false; // we don't have the reference, wait for a key frame.
+      }
+    } else if (header.mode != CompressionMode::Lz) {
+      return false;
+    }
+
+    destination.reset(static_cast<uint64_t>(size));
+    if (!lz::Decompress(
+            source.data() + sizeof(header),
+            source.size() - sizeof(header),
+            destination.data(),
+            size)) {
+      return false;
+    }
+
+    if (header.mode == CompressionMode::DeltaLz) {
+      auto *data = destination.data();
+      for (size_t i = 0u; i < size; ++i) {
+        data[i] ^= _previous_frame[i];
+      }
+    }
+
+    if (header.frame_id != 0u) {
+      _previous_frame.assign(destination.begin(), destination.end());
+      _previous_frame_id = header.frame_id;
+    }
+    return true;
+  }
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
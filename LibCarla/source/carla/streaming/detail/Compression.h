@@ -0,0 +1,182 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <boost/asio/buffer.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// Compression applied to the messages of a stream. The client detects the
+  /// compressed messages and decompresses them transparently.
+  enum class CompressionMode : uint8_t {
+    /// Messages are sent as they are.
+    None,
+    /// Fast LZ compression of each message. Works well on depth and semantic
+    /// segmentation images, which have large flat regions.
+    Lz,
+    /// Each message is XORed with the previous one before the LZ stage, so
+    /// only the pixels that changed take space. Key frames, which do not depend
+    /// on previous messages, are sent periodically so new or lagging
+    /// subscribers can synchronize.
+    DeltaLz
+  };
+
+  // ===========================================================================
+  // -- LZ codec ---------------------------------------------------------------
+  // ===========================================================================
+
+  /// Byte-oriented LZ77 codec in the spirit of LZ4: greedy matching with a
+  /// single hash table, 64KB window and no entropy coding. Favours speed over
+  /// ratio.
+  namespace lz {
+
+    /// Maximum size of the compressed data for an input of @a size bytes.
+    constexpr size_t max_compressed_size(size_t size) {
+      return size + (size / 255u) + 16u;
+    }
+
+    /// Hash table of the matches found by Compress. Reusing it between calls
+    /// saves allocating and clearing it for every message, the entries left
+    /// by previous calls are validated before use.
+    using HashTable = std::vector<uint32_t>;
+
+    /// Compress @a size bytes of @a source into @a destination, which must hold
+    /// at least max_compressed_size(size) bytes. Returns the compressed size.
+    size_t Compress(
+        const unsigned char *source,
+        size_t size,
+        unsigned char *destination,
+        HashTable &table);
+
+    /// @copydoc Compress(const unsigned char *, size_t, unsigned char *, HashTable &)
+    ///
+    /// Uses a hash table of the calling thread.
+    size_t Compress(const unsigned char *source, size_t size, unsigned char *destination);
+
+    /// Decompress @a size bytes of @a source into @a destination, which must
+    /// have room for exactly @a decompressed_size bytes. Returns false if the
+    /// data is corrupted.
+    bool Decompress(
+        const unsigned char *source,
+        size_t size,
+        unsigned char *destination,
+        size_t decompressed_size);
+
+  } // namespace lz
+
+  // ===========================================================================
+  // -- Frame header -----------------------------------------------------------
+  // ===========================================================================
+
+#pragma pack(push, 1)
+
+  /// Header prepended to each compressed message.
+  struct CompressionHeader {
+    CompressionMode mode = CompressionMode::None;
+
+    /// Size of the original message.
+    message_size_type uncompressed_size = 0u;
+
+    /// Id of this frame within a delta compressed stream, zero otherwise.
+    uint32_t frame_id = 0u;
+
+    /// Id of the frame this one is XORed with, zero for key frames.
+    uint32_t reference_id = 0u;
+  };
+
+#pragma pack(pop)
+
+  // ===========================================================================
+  // -- Compressor -------------------------------------------------------------
+  // ===========================================================================
+
+  /// Compresses the messages of a stream (server side). The same compressed
+  /// message is shared by all the sessions of the stream.
+  class Compressor : private NonCopyable {
+  public:
+
+    explicit Compressor(CompressionMode mode, uint32_t key_frame_interval = 30u)
+      : _mode(mode),
+        _key_frame_interval(key_frame_interval > 0u ? key_frame_interval : 1u) {}
+
+    CompressionMode mode() const {
+      return _mode;
+    }
+
+    /// Make the next message a key frame, e.g. because a session dropped a
+    /// message and its client lost the reference of the following deltas.
+    void RequestKeyFrame() {
+      _key_frame_requested = true;
+    }
+
+    /// Compress the message made of @a buffers into @a destination. Returns
+    /// false if the message should be sent uncompressed.
+    template <typename ConstBufferSequence>
+    bool Compress(const ConstBufferSequence &buffers, Buffer &destination) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _frame.resize(boost::asio::buffer_size(buffers));
+      boost::asio::buffer_copy(boost::asio::buffer(_frame), buffers);
+      return CompressFrame(destination);
+    }
+
+  private:
+
+    bool CompressFrame(Buffer &destination);
+
+    const CompressionMode _mode;
+
+    const uint32_t _key_frame_interval;
+
+    std::mutex _mutex;
+
+    std::vector<unsigned char> _frame;
+
+    std::vector<unsigned char> _previous_frame;
+
+    std::vector<unsigned char> _delta;
+
+    lz::HashTable _hash_table;
+
+    uint32_t _frame_id = 0u;
+
+    std::atomic_bool _key_frame_requested{false};
+  };
+
+  // ===========================================================================
+  // -- Decompressor -----------------------------------------------------------
+  // ===========================================================================
+
+  /// Decompresses the messages of a stream (client side).
+  class Decompressor : private NonCopyable {
+  public:
+
+    /// Decompress @a source into @a destination. Returns false if the message
+    /// is corrupted or depends on a frame that was never received, in which
+    /// case the message should be discarded.
+    bool Decompress(const Buffer &source, Buffer &destination);
+
+  private:
+
+    std::vector<unsigned char> _previous_frame;
+
+    uint32_t _previous_frame_id = 0u;
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
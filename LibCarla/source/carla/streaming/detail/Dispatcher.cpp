@@ -20,30 +20,38 @@ namespace detail {
     // Disconnect all the sessions from their streams, this should kill any
     // session remaining since at this point the io_context should be already
     // stopped.
-    for (auto &pair : _stream_map) {
+    for (auto &shard : _shards) {
+      for (auto &pair : shard.stream_map) {
 #ifndef LIBCARLA_NO_EXCEPTIONS
-      try {
+        try {
 #endif // LIBCARLA_NO_EXCEPTIONS
-        auto stream_state = pair.second;
-        stream_state->ClearSessions();
+          auto stream_state = pair.second;
+          stream_state->ClearSessions();
 #ifndef LIBCARLA_NO_EXCEPTIONS
-      } catch (const std::exception &e) {
-        log_error("failed to clear sessions:", e.what());
-      }
+        } catch (const std::exception &e) {
+          log_error("failed to clear sessions:", e.what());
+        }
 #endif // LIBCARLA_NO_EXCEPTIONS
+      }
     }
   }
 
   carla::streaming::Stream Dispatcher::MakeStream() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    ++_cached_token._token.stream_id; // id zero only happens in overflow.
-    log_debug("New stream:", _cached_token._token.stream_id);
+    token_type token;
+    {
+      std::lock_guard<std::mutex> lock(_token_mutex);
+      ++_cached_token._token.stream_id; // id zero only happens in overflow.
+      token = _cached_token;
+    }
+    log_debug("New stream:", token.get_stream_id());
+    auto &shard = GetShard(token.get_stream_id());
+    std::lock_guard<std::mutex> lock(shard.mutex);
     std::shared_ptr<MultiStreamState> ptr;
-    auto search = _stream_map.find(_cached_token.get_stream_id());
-    if (search == _stream_map.end()) {
+    auto search = shard.stream_map.find(token.get_stream_id());
+    if (search == shard.stream_map.end()) {
       // creating new stream
-      ptr = std::make_shared<MultiStreamState>(_cached_token);
-      auto result = _stream_map.emplace(std::make_pair(_cached_token.get_stream_id(), ptr));
+      ptr = std::make_shared<MultiStreamState>(token);
+      auto result = shard.stream_map.emplace(std::make_pair(token.get_stream_id(), ptr));
       if (!result.second) {
         throw_exception(std::runtime_error("failed to create stream!"));
       }
@@ -58,31 +66,43 @@ namespace detail {
   }
 
   void Dispatcher::CloseStream(carla::streaming::detail::stream_id_type id) {
-    std::lock_guard<std::mutex> lock(_mutex);
     log_debug("Calling CloseStream for ", id);
-    auto search = _stream_map.find(id);
-    if (search != _stream_map.end()) {
-      auto stream_state = search->second;
-      if (stream_state) {
-        log_debug("Disconnecting all sessions (stream ", id, ")");
-        stream_state->ClearSessions();
+    std::shared_ptr<MultiStreamState> stream_state;
+    {
+      auto &shard = GetShard(id);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto search = shard.stream_map.find(id);
+      if (search == shard.stream_map.end()) {
+        return;
       }
-      _stream_map.erase(search);
+      stream_state = std::move(search->second);
+      shard.stream_map.erase(search);
+    }
+    if (stream_state) {
+      log_debug("Disconnecting all sessions (stream ", id, ")");
+      stream_state->ClearSessions();
     }
   }
 
   bool Dispatcher::RegisterSession(std::shared_ptr<Session> session) {
     DEBUG_ASSERT(session != nullptr);
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto search = _stream_map.find(session->get_stream_id());
-    if (search != _stream_map.end()) {
-      auto stream_state = search->second;
-      if (stream_state) {
-        log_debug("Connecting session (stream ", session->get_stream_id(), ")");
-        stream_state->ConnectSession(std::move(session));
-        log_debug("Current streams: ", _stream_map.size());
-        return true;
+    std::shared_ptr<MultiStreamState> stream_state;
+    {
+      auto &shard = GetShard(session->get_stream_id());
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto search = shard.stream_map.find(session->get_stream_id());
+      if (search != shard.stream_map.end()) {
+        stream_state = search->second;
+      }
+    }
+    if (stream_state) {
+      log_debug("Connecting session (stream ", session->get_stream_id(), ")");
+      if (stream_state->token().protocol_is_shm()) {
+        session->EnableSharedMemory();
       }
+      stream_state->ConnectSession(std::move(session));
+      log_debug("Current streams: ", CountStreams());
+      return true;
     }
     log_error("Invalid session: no stream available with id", session->get_stream_id());
     return false;
@@ -90,24 +110,29 @@ namespace detail {
 
   void Dispatcher::DeregisterSession(std::shared_ptr<Session> session) {
     DEBUG_ASSERT(session != nullptr);
-    std::lock_guard<std::mutex> lock(_mutex);
     log_debug("Calling DeregisterSession for ", session->get_stream_id());
-    auto search = _stream_map.find(session->get_stream_id());
-    if (search != _stream_map.end()) {
-      auto stream_state = search->second;
-      if (stream_state) {
-        log_debug("Disconnecting session (stream ", session->get_stream_id(), ")");
-        stream_state->DisconnectSession(session);
-        log_debug("Current streams: ", _stream_map.size());
+    std::shared_ptr<MultiStreamState> stream_state;
+    {
+      auto &shard = GetShard(session->get_stream_id());
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto search = shard.stream_map.find(session->get_stream_id());
+      if (search != shard.stream_map.end()) {
+        stream_state = search->second;
       }
     }
+    if (stream_state) {
+      log_debug("Disconnecting session (stream ", session->get_stream_id(), ")");
+      stream_state->DisconnectSession(session);
+      log_debug("Current streams: ", CountStreams());
+    }
   }
-  
+
   token_type Dispatcher::GetToken(stream_id_type sensor_id) {
-    std::lock_guard<std::mutex> lock(_mutex);
     log_debug("Searching sensor id: ", sensor_id);
-    auto search = _stream_map.find(sensor_id);
-    if (search != _stream_map.end()) {
+    auto &shard = GetShard(sensor_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto search = shard.stream_map.find(sensor_id);
+    if (search != shard.stream_map.end()) {
       log_debug("Found sensor id: ", sensor_id);
       auto stream_state = search->second;
       stream_state->ForceActive();
@@ -115,10 +140,14 @@ namespace detail {
       return stream_state->token();
     } else {
       log_debug("Not Found sensor id, creating sensor stream: ", sensor_id);
-      token_type temp_token(_cached_token);
+      token_type temp_token;
+      {
+        std::lock_guard<std::mutex> token_lock(_token_mutex);
+        temp_token = _cached_token;
+      }
       temp_token.set_stream_id(sensor_id);
       auto ptr = std::make_shared<MultiStreamState>(temp_token);
-      auto result = _stream_map.emplace(std::make_pair(temp_token.get_stream_id(), ptr));
+      auto result = shard.stream_map.emplace(std::make_pair(temp_token.get_stream_id(), ptr));
       ptr->ForceActive();
       if (!result.second) {
         log_debug("Failed to create multistream for stream ", sensor_id, " on port ", temp_token.get_port());
@@ -129,6 +158,24 @@ namespace detail {
     return token_type();
   }
 
+  void Dispatcher::SetSharedMemory(bool enable) {
+    std::lock_guard<std::mutex> lock(_token_mutex);
+    _cached_token._token.protocol = enable ?
+        token_data::protocol::shm :
+        token_data::protocol::tcp;
+  }
+
+  size_t Dispatcher::CountStreams() {
+    size_t count = 0u;
+    LOG_DEBUG_ONLY(
+      for (auto &shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.stream_map.size();
+      }
+    )
+    return count;
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
@@ -12,6 +12,7 @@
 #include "carla/streaming/detail/Stream.h"
 #include "carla/streaming/detail/Token.h"
 
+#include <array>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -43,15 +44,34 @@ namespace detail {
     
     token_type GetToken(stream_id_type sensor_id);
 
+    /// Streams created from now on place their messages in shared memory for
+    /// the clients running on the same host.
+    void SetSharedMemory(bool enable);
+
   private:
 
-    // We use a mutex here, but we assume that sessions and streams won't be
-    // created too often.
-    std::mutex _mutex;
+    /// The streams are spread among several maps, each with its own mutex, so
+    /// sessions of different streams don't contend when (de)registering.
+    struct StreamMapShard {
+      std::mutex mutex;
+      StreamMap stream_map;
+    };
+
+    static constexpr size_t NumberOfShards = 16u;
+
+    StreamMapShard &GetShard(stream_id_type id) {
+      return _shards[id % NumberOfShards];
+    }
+
+    /// Only used for logging, always zero unless debug logs are enabled.
+    size_t CountStreams();
+
+    /// Guards the cached token, used to create the streams.
+    std::mutex _token_mutex;
 
     token_type _cached_token;
 
-    StreamMap _stream_map;
+    std::array<StreamMapShard, NumberOfShards> _shards;
   };
 
 } // namespace detail
@@ -6,13 +6,11 @@
 
 #pragma once
 
-#include "carla/AtomicSharedPtr.h"
+#include "carla/AtomicList.h"
 #include "carla/Logging.h"
 #include "carla/streaming/detail/StreamStateBase.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
-#include <mutex>
-#include <vector>
 #include <atomic>
 
 namespace carla {
@@ -21,40 +19,35 @@ namespace detail {
 
   /// A stream state that can hold any number of sessions.
   ///
-  /// @todo Lacking some optimization.
+  /// The sessions are kept in a copy-on-write list, writers never lock:
+  /// connecting or disconnecting a session publishes a new list, and each
+  /// write fans out a single message to the sessions of the list it loaded.
   class MultiStreamState final : public StreamStateBase {
   public:
 
     using StreamStateBase::StreamStateBase;
 
-    MultiStreamState(const token_type &token) : 
-      StreamStateBase(token), 
-      _session(nullptr)
-      {};
-
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
-      // try write single stream
-      auto session = _session.load();
-      if (session != nullptr) {
-        auto message = Session::MakeMessage(std::move(buffers)...);
-        session->Write(std::move(message));
-        log_debug("sensor ", session->get_stream_id()," data sent");        
-        // Return here, _session is only valid if we have a 
-        // single session.
-        return; 
+      const auto sessions = _sessions.Load();
+      if (sessions->empty()) {
+        return;
       }
-
-      // try write multiple stream
-      std::lock_guard<std::mutex> lock(_mutex);
-      if (_sessions.size() > 0) {
-        auto message = Session::MakeMessage(std::move(buffers)...);
-        for (auto &s : _sessions) {
-          if (s != nullptr) {
-            s->Write(message);
-            log_debug("sensor ", s->get_stream_id()," data sent ");
-         }
-        }
+      // A client that missed a message cannot apply the deltas that follow
+      // it, the send policy of the server may drop messages of slow sessions.
+      size_t dropped = 0u;
+      for (auto &s : *sessions) {
+        dropped += s->GetNumberOfDroppedMessages();
+      }
+      if (_messages_dropped.exchange(dropped) != dropped) {
+        RequestKeyFrame();
+      }
+      // The message is serialized (and compressed) once and shared by all the
+      // sessions.
+      auto message = MakeMessage(std::move(buffers)...);
+      for (auto &s : *sessions) {
+        s->Write(message);
+        log_debug("sensor ", s->get_stream_id()," data sent");
       }
     }
 
@@ -63,69 +56,54 @@ namespace detail {
     }
 
     bool AreClientsListening() {
-      return (_sessions.size() > 0 || _force_active);
+      return (!_sessions.Load()->empty() || _force_active);
+    }
+
+    /// Number of sessions connected since the stream was created, it changes
+    /// every time a client subscribes.
+    size_t GetNumberOfConnections() const {
+      return _number_of_connections;
     }
 
     void ConnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
-      std::lock_guard<std::mutex> lock(_mutex);
-      _sessions.emplace_back(std::move(session));
-      log_debug("Connecting multistream sessions:", _sessions.size());
-      if (_sessions.size() == 1) {
-        _session.store(_sessions[0]);
-      }
-      else if (_sessions.size() > 1) {
-        _session.store(nullptr);
-      }
+      _sessions.Push(std::move(session));
+      ++_number_of_connections;
+      log_debug("Connecting multistream sessions:", _sessions.Load()->size());
     }
 
     void DisconnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
-      std::lock_guard<std::mutex> lock(_mutex);
       log_debug("Calling DisconnectSession for ", session->get_stream_id());
-      if (_sessions.size() == 0) return;
-      if (_sessions.size() == 1) {
-        DEBUG_ASSERT(session == _session.load());
-        _session.store(nullptr);
-        _sessions.clear();
+      _sessions.DeleteByValue(session);
+      const auto count = _sessions.Load()->size();
+      if (count == 0u) {
         _force_active = false;
         log_debug("Last session disconnected");
-      } else {
-        _sessions.erase(
-            std::remove(_sessions.begin(), _sessions.end(), session),
-            _sessions.end());
-        
-        // set single session if only one
-        if (_sessions.size() == 1)
-          _session.store(_sessions[0]);
-        else
-          _session.store(nullptr);
       }
-      log_debug("Disconnecting multistream sessions:", _sessions.size());
+      log_debug("Disconnecting multistream sessions:", count);
     }
 
     void ClearSessions() final {
-      std::lock_guard<std::mutex> lock(_mutex);
-      for (auto &s : _sessions) {
-        if (s != nullptr) {
-          s->Close();
-        }
+      // A session connected meanwhile is either closed here or kept.
+      const auto sessions = _sessions.Exchange({});
+      for (auto &s : *sessions) {
+        s->Close();
       }
-      _sessions.clear();
       _force_active = false;
-      _session.store(nullptr);
       log_debug("Disconnecting all multistream sessions");
     }
 
   private:
 
-    std::mutex _mutex;
+    client::detail::AtomicList<std::shared_ptr<Session>> _sessions;
+
+    std::atomic_bool _force_active{false};
+
+    std::atomic_size_t _number_of_connections{0u};
 
-    // if there is only one session, then we use atomic
-    AtomicSharedPtr<Session> _session;
-    // if there are more than one session, we use vector of sessions with mutex
-    std::vector<std::shared_ptr<Session>> _sessions;
-    bool _force_active {false};
+    /// Messages dropped by the sessions at the last write.
+    std::atomic_size_t _messages_dropped{0u};
   };
 
 } // namespace detail
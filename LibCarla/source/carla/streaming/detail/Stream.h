@@ -9,6 +9,7 @@
 #include "carla/Buffer.h"
 #include "carla/Debug.h"
 #include "carla/streaming/Token.h"
+#include "carla/streaming/detail/Compression.h"
 
 #include <memory>
 
@@ -46,6 +47,16 @@ namespace detail {
       return _shared_state->MakeBuffer();
     }
 
+    /// Compress the messages sent through this stream. Clients decompress them
+    /// transparently, this trades server CPU time for bandwidth.
+    void SetCompression(CompressionMode mode) {
+      _shared_state->SetCompression(mode);
+    }
+
+    CompressionMode GetCompression() const {
+      return _shared_state->GetCompression();
+    }
+
     /// Flush @a buffers down the stream. No copies are made.
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
@@ -66,6 +77,11 @@ namespace detail {
       return _shared_state ? _shared_state->AreClientsListening() : false;
     }
 
+    /// Number of clients that subscribed to this stream since it was created.
+    size_t GetNumberOfConnections() const {
+      return _shared_state->GetNumberOfConnections();
+    }
+
   private:
 
     friend class detail::Dispatcher;
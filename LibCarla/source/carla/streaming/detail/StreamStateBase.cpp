@@ -22,6 +22,19 @@ namespace detail {
     return _buffer_pool->Pop();
   }
 
+  void StreamStateBase::SetCompression(CompressionMode mode) {
+    // A new compressor also resets the delta reference, the clients resync on
+    // the next key frame.
+    _compressor = (mode == CompressionMode::None) ?
+        nullptr :
+        std::make_shared<Compressor>(mode);
+  }
+
+  CompressionMode StreamStateBase::GetCompression() const {
+    auto compressor = _compressor.load();
+    return compressor != nullptr ? compressor->mode() : CompressionMode::None;
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "carla/AtomicSharedPtr.h"
 #include "carla/NonCopyable.h"
+#include "carla/streaming/detail/Compression.h"
 #include "carla/streaming/detail/Session.h"
 #include "carla/streaming/detail/Token.h"
 
@@ -34,17 +36,52 @@ namespace detail {
 
     Buffer MakeBuffer();
 
+    /// Compress the messages written from now on, see CompressionMode.
+    void SetCompression(CompressionMode mode);
+
+    CompressionMode GetCompression() const;
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void ClearSessions() = 0;
 
+  protected:
+
+    /// Make the next message a key frame, if the stream is compressed.
+    void RequestKeyFrame() {
+      auto compressor = _compressor.load();
+      if (compressor != nullptr) {
+        compressor->RequestKeyFrame();
+      }
+    }
+
+    /// Make the message shared by all the sessions of the stream, compressed
+    /// if compression is enabled and worth it.
+    template <typename... Buffers>
+    std::shared_ptr<const tcp::Message> MakeMessage(Buffers &&... buffers) {
+      auto compressor = _compressor.load();
+      if (compressor != nullptr) {
+        auto compressed = MakeBuffer();
+        auto message = Session::MakeMessage(std::move(buffers)...);
+        if (!compressor->Compress(message->GetBodyBufferSequence(), compressed)) {
+          return message;
+        }
+        auto result = std::make_shared<tcp::Message>(std::move(compressed));
+        result->SetCompressed();
+        return result;
+      }
+      return Session::MakeMessage(std::move(buffers)...);
+    }
+
   private:
 
     const token_type _token;
 
     const std::shared_ptr<BufferPool> _buffer_pool;
+
+    AtomicSharedPtr<Compressor> _compressor;
   };
 
 } // namespace detail
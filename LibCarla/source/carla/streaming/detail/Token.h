@@ -29,7 +29,8 @@ namespace detail {
     enum class protocol : uint8_t {
       not_set,
       tcp,
-      udp
+      udp,
+      shm
     } protocol = protocol::not_set;
 
     enum class address : uint8_t {
@@ -155,6 +156,13 @@ namespace detail {
       return _token.protocol == token_data::protocol::tcp;
     }
 
+    /// Shared memory streams subscribe through a TCP connection, the messages
+    /// are placed in shared memory only if client and server are on the same
+    /// host.
+    bool protocol_is_shm() const {
+      return _token.protocol == token_data::protocol::shm;
+    }
+
     template <typename Protocol>
     bool has_same_protocol(const boost::asio::ip::basic_endpoint<Protocol> &) const {
       return _token.protocol == get_protocol<Protocol>();
@@ -165,7 +173,9 @@ namespace detail {
     }
 
     boost::asio::ip::tcp::endpoint to_tcp_endpoint() const {
-      return get_endpoint<boost::asio::ip::tcp>();
+      DEBUG_ASSERT(is_valid());
+      DEBUG_ASSERT(protocol_is_tcp() || protocol_is_shm());
+      return {get_address(), _token.port};
     }
 
   private:
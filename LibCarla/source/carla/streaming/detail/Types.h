@@ -23,6 +23,10 @@ namespace detail {
       std::is_same<message_size_type, Buffer::size_type>::value,
       "uint type mismatch!");
 
+  /// Bit of the size header that marks a compressed message, the remaining
+  /// bits hold the size of the message as usual.
+  constexpr message_size_type compressed_message_flag = 1u << 31u;
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
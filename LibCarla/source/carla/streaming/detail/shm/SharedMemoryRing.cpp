@@ -0,0 +1,295 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <atomic>
+#include <cstring>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace shm {
+
+  // ===========================================================================
+  // -- Header -----------------------------------------------------------------
+  // ===========================================================================
+
+  static constexpr uint32_t RING_MAGIC = 0x43524e47u; // "CRNG"
+
+  static constexpr uint32_t RING_VERSION = 1u;
+
+  /// Header placed at the beginning of the segment, the data follows aligned
+  /// to a cache line.
+  struct alignas(64) RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    /// Bytes written so far by the producer.
+    alignas(64) std::atomic<uint64_t> head;
+    /// Bytes released so far by the consumer.
+    alignas(64) std::atomic<uint64_t> tail;
+  };
+
+  static_assert(
+      sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+      "Ring counters must be plain 64-bit integers to be shared between processes.");
+
+  // ===========================================================================
+  // -- Segment ----------------------------------------------------------------
+  // ===========================================================================
+
+  /// Platform-specific mapping of a named shared memory segment.
+  struct SharedMemoryRing::Segment : private NonCopyable {
+
+    std::string name;
+
+    bool is_owner = false;
+
+    size_t mapped_size = 0u;
+
+    void *address = nullptr;
+
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+#endif
+
+    RingHeader &header() {
+      return *reinterpret_cast<RingHeader *>(address);
+    }
+
+    unsigned char *data() {
+      return reinterpret_cast<unsigned char *>(address) + sizeof(RingHeader);
+    }
+
+    bool Map(size_t size, bool create);
+
+    ~Segment();
+  };
+
+#ifdef _WIN32
+
+  bool SharedMemoryRing::Segment::Map(size_t size, bool create) {
+    const auto win_name = std::string("Local\\") + name;
+    if (create) {
+      const auto size64 = static_cast<uint64_t>(size);
+      handle = CreateFileMappingA(
+          INVALID_HANDLE_VALUE,
+          nullptr,
+          PAGE_READWRITE,
+          static_cast<DWORD>(size64 >> 32u),
+          static_cast<DWORD>(size64 & 0xffffffffu),
+          win_name.c_str());
+    } else {
+      handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, win_name.c_str());
+    }
+    if (handle == nullptr) {
+      return false;
+    }
+    address = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (address == nullptr) {
+      return false;
+    }
+    if (size == 0u) {
+      MEMORY_BASIC_INFORMATION info;
+      VirtualQuery(address, &info, sizeof(info));
+      size = info.RegionSize;
+    }
+    mapped_size = size;
+    return true;
+  }
+
+  SharedMemoryRing::Segment::~Segment() {
+    if (address != nullptr) {
+      UnmapViewOfFile(address);
+    }
+    if (handle != nullptr) {
+      CloseHandle(handle);
+    }
+  }
+
+#else
+
+  bool SharedMemoryRing::Segment::Map(size_t size, bool create) {
+    const auto posix_name = std::string("/") + name;
+    if (create) {
+      // The names are deterministic, a segment left behind by a server that
+      // crashed would make O_EXCL fail forever.
+      shm_unlink(posix_name.c_str());
+    }
+    const int flags = create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR;
+    const int fd = shm_open(posix_name.c_str(), flags, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      return false;
+    }
+    is_owner = create;
+    bool success = true;
+    if (create) {
+      success = (ftruncate(fd, static_cast<off_t>(size)) == 0);
+#if defined(__linux__)
+      // A truncated segment is sparse, writing past the space available in
+      // /dev/shm would raise SIGBUS. Reserve the pages now so a full /dev/shm
+      // makes the session fall back to the socket instead.
+      if (success) {
+        const int error = posix_fallocate(fd, 0, static_cast<off_t>(size));
+        if (error != 0) {
+          log_warning("shared memory: unable to reserve", size, "bytes for", name, ':', std::strerror(error));
+          success = false;
+        }
+      }
+#endif // __linux__
+    } else {
+      struct stat info;
+      success = (fstat(fd, &info) == 0);
+      size = static_cast<size_t>(info.st_size);
+    }
+    if (success && (size > sizeof(RingHeader))) {
+      address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (address == MAP_FAILED) {
+        address = nullptr;
+      }
+    }
+    close(fd);
+    if (address == nullptr) {
+      return false;
+    }
+    mapped_size = size;
+    return true;
+  }
+
+  SharedMemoryRing::Segment::~Segment() {
+    if (address != nullptr) {
+      munmap(address, mapped_size);
+    }
+    if (is_owner) {
+      shm_unlink((std::string("/") + name).c_str());
+    }
+  }
+
+#endif // _WIN32
+
+  // ===========================================================================
+  // -- SharedMemoryRing -------------------------------------------------------
+  // ===========================================================================
+
+  std::string SharedMemoryRing::MakeName(
+      const uint16_t server_port,
+      const stream_id_type stream_id,
+      const uint16_t client_port) {
+    return
+        "carla-stream-" + std::to_string(server_port) +
+        '-' + std::to_string(stream_id) +
+        '-' + std::to_string(client_port);
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(
+      const std::string &name,
+      const size_t capacity) {
+    DEBUG_ASSERT(capacity > 0u);
+    auto segment = std::make_unique<Segment>();
+    segment->name = name;
+    if (!segment->Map(sizeof(RingHeader) + capacity, true)) {
+      log_warning("shared memory: unable to create segment", name);
+      return nullptr;
+    }
+    auto &header = segment->header();
+    header.magic = RING_MAGIC;
+    header.version = RING_VERSION;
+    header.capacity = capacity;
+    header.head.store(0u, std::memory_order_relaxed);
+    header.tail.store(0u, std::memory_order_release);
+    log_debug("shared memory: created segment", name, "of", capacity, "bytes");
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(std::move(segment)));
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string &name) {
+    auto segment = std::make_unique<Segment>();
+    segment->name = name;
+    if (!segment->Map(0u, false)) {
+      log_error("shared memory: unable to open segment", name);
+      return nullptr;
+    }
+    const auto &header = segment->header();
+    if ((header.magic != RING_MAGIC) ||
+        (header.version != RING_VERSION) ||
+        (sizeof(RingHeader) + header.capacity > segment->mapped_size)) {
+      log_error("shared memory: invalid segment", name);
+      return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(std::move(segment)));
+  }
+
+  SharedMemoryRing::SharedMemoryRing(std::unique_ptr<Segment> segment)
+    : _segment(std::move(segment)) {
+    DEBUG_ASSERT(_segment != nullptr);
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() = default;
+
+  size_t SharedMemoryRing::capacity() const {
+    return static_cast<size_t>(_segment->header().capacity);
+  }
+
+  unsigned char *SharedMemoryRing::Allocate(const size_t size, Descriptor &descriptor) {
+    auto &header = _segment->header();
+    const uint64_t capacity = header.capacity;
+    if ((size == 0u) || (size > capacity) || (size > Buffer::max_size())) {
+      return nullptr;
+    }
+    uint64_t begin = _head;
+    uint64_t offset = begin % capacity;
+    if (offset + size > capacity) {
+      // Skip the tail of the ring, messages are never split.
+      begin += capacity - offset;
+      offset = 0u;
+    }
+    const uint64_t tail = header.tail.load(std::memory_order_acquire);
+    if (begin + size - tail > capacity) {
+      return nullptr;
+    }
+    descriptor.begin = begin;
+    descriptor.size = static_cast<message_size_type>(size);
+    return _segment->data() + offset;
+  }
+
+  void SharedMemoryRing::Commit(const Descriptor &descriptor) {
+    _head = descriptor.begin + descriptor.size;
+    _segment->header().head.store(_head, std::memory_order_release);
+  }
+
+  bool SharedMemoryRing::Read(const Descriptor &descriptor, Buffer &buffer) {
+    auto &header = _segment->header();
+    const uint64_t capacity = header.capacity;
+    const uint64_t offset = descriptor.begin % capacity;
+    if ((descriptor.size == 0u) ||
+        (offset + descriptor.size > capacity) ||
+        (descriptor.begin + descriptor.size > header.head.load(std::memory_order_acquire))) {
+      return false;
+    }
+    buffer.copy_from(_segment->data() + offset, descriptor.size);
+    header.tail.store(descriptor.begin + descriptor.size, std::memory_order_release);
+    return true;
+  }
+
+} // namespace shm
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -0,0 +1,135 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <boost/asio/buffer.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace shm {
+
+#pragma pack(push, 1)
+
+  /// Location of a message inside the ring. This is what travels through the
+  /// socket instead of the message itself.
+  struct Descriptor {
+    /// Absolute position (not wrapped) of the first byte of the message.
+    uint64_t begin = 0u;
+
+    message_size_type size = 0u;
+  };
+
+  /// Notification sent over the socket for each message placed in the ring. A
+  /// zero size header is never sent by a regular TCP session, so the client
+  /// can tell both kinds of messages apart. The header may still carry
+  /// compressed_message_flag.
+  struct Notification {
+    message_size_type header = 0u;
+
+    Descriptor descriptor;
+  };
+
+#pragma pack(pop)
+
+  /// Byte sent by a client that cannot map the segment of its connection. The
+  /// server session drops the ring and sends everything through the socket
+  /// from then on.
+  constexpr uint8_t refuse_shared_memory_request = 0x01u;
+
+  /// Single-producer single-consumer ring buffer living in a named shared
+  /// memory segment. The server session writes the messages into the ring and
+  /// the client copies them out, releasing the space as it goes.
+  ///
+  /// Messages are always stored contiguously; if a message does not fit at the
+  /// end of the ring, the remaining bytes are skipped and the message is
+  /// placed at the beginning.
+  class SharedMemoryRing : private NonCopyable {
+  public:
+
+    /// Default capacity of the rings created by the server sessions, a few
+    /// full HD images. Note that Docker limits /dev/shm to 64MB unless
+    /// --shm-size is specified, the sessions that do not fit use the socket.
+    static constexpr size_t default_capacity() {
+      return 32u * 1024u * 1024u;
+    }
+
+    /// Name of the segment shared by a server session and its client. Both
+    /// ends of the connection know the three values.
+    static std::string MakeName(
+        uint16_t server_port,
+        stream_id_type stream_id,
+        uint16_t client_port);
+
+    /// Create (and own) a new segment, returns nullptr on failure, including
+    /// when there is not enough shared memory to back the whole segment. A
+    /// stale segment with the same name is replaced. The segment is removed
+    /// from the system on destruction.
+    static std::unique_ptr<SharedMemoryRing> Create(
+        const std::string &name,
+        size_t capacity = default_capacity());
+
+    /// Map an existing segment created by a server, returns nullptr on
+    /// failure.
+    static std::unique_ptr<SharedMemoryRing> Open(const std::string &name);
+
+    ~SharedMemoryRing();
+
+    size_t capacity() const;
+
+    /// Copy @a buffers into the ring and fill @a descriptor with its location.
+    /// Returns false, without copying anything, if there is not enough free
+    /// space left.
+    ///
+    /// @warning Only the producer can call this function.
+    template <typename ConstBufferSequence>
+    bool TryWrite(const ConstBufferSequence &buffers, Descriptor &descriptor) {
+      const auto size = boost::asio::buffer_size(buffers);
+      unsigned char *destination = Allocate(size, descriptor);
+      if (destination == nullptr) {
+        return false;
+      }
+      boost::asio::buffer_copy(boost::asio::buffer(destination, size), buffers);
+      Commit(descriptor);
+      return true;
+    }
+
+    /// Copy the message located at @a descriptor into @a buffer and release
+    /// its space in the ring.
+    ///
+    /// @warning Only the consumer can call this function, and descriptors
+    /// must be read in the same order they were written.
+    bool Read(const Descriptor &descriptor, Buffer &buffer);
+
+  private:
+
+    struct Segment;
+
+    explicit SharedMemoryRing(std::unique_ptr<Segment> segment);
+
+    unsigned char *Allocate(size_t size, Descriptor &descriptor);
+
+    void Commit(const Descriptor &descriptor);
+
+    std::unique_ptr<Segment> _segment;
+
+    /// Next write position, only meaningful for the producer.
+    uint64_t _head = 0u;
+  };
+
+} // namespace shm
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -11,6 +11,7 @@
 #include "carla/Exception.h"
 #include "carla/Logging.h"
 #include "carla/Time.h"
+#include "carla/profiler/Tracer.h"
 
 #include <boost/asio/connect.hpp>
 #include <boost/asio/read.hpp>
@@ -30,24 +31,42 @@ namespace tcp {
   // ===========================================================================
 
   /// Helper for reading incoming TCP messages. Allocates the whole message in
-  /// a single buffer.
+  /// a single buffer, taken from @a pool once the size is known.
   class IncomingMessage {
   public:
 
-    explicit IncomingMessage(Buffer &&buffer) : _message(std::move(buffer)) {}
+    explicit IncomingMessage(BufferPool &pool) : _pool(pool) {}
 
     boost::asio::mutable_buffer size_as_buffer() {
       return boost::asio::buffer(&_size, sizeof(_size));
     }
 
     boost::asio::mutable_buffer buffer() {
-      DEBUG_ASSERT(_size > 0u);
-      _message.reset(_size);
+      DEBUG_ASSERT(size() > 0u);
+      _message = _pool.Pop(size());
       return _message.buffer();
     }
 
-    auto size() const {
-      return _size;
+    boost::asio::mutable_buffer descriptor_as_buffer() {
+      return boost::asio::buffer(&_descriptor, sizeof(_descriptor));
+    }
+
+    /// Copy the message announced by the descriptor out of @a ring.
+    bool ReadFrom(shm::SharedMemoryRing &ring) {
+      _message = _pool.Pop(_descriptor.size);
+      if (!ring.Read(_descriptor, _message)) {
+        return false;
+      }
+      _size = (_size & compressed_message_flag) | _descriptor.size;
+      return true;
+    }
+
+    message_size_type size() const {
+      return _size & ~compressed_message_flag;
+    }
+
+    bool is_compressed() const {
+      return (_size & compressed_message_flag) != 0u;
     }
 
     auto pop() {
@@ -56,8 +75,13 @@ namespace tcp {
 
   private:
 
+    BufferPool &_pool;
+
+    /// Size header as received, may carry compressed_message_flag.
     message_size_type _size = 0u;
 
+    shm::Descriptor _descriptor;
+
     Buffer _message;
   };
 
@@ -77,8 +101,8 @@ namespace tcp {
       _strand(io_context),
       _connection_timer(io_context),
       _buffer_pool(std::make_shared<BufferPool>()) {
-    if (!_token.protocol_is_tcp()) {
-      throw_exception(std::invalid_argument("invalid token, only TCP tokens supported"));
+    if (!_token.protocol_is_tcp() && !_token.protocol_is_shm()) {
+      throw_exception(std::invalid_argument("invalid token, only TCP and shared memory tokens supported"));
     }
   }
 
@@ -97,8 +121,11 @@ namespace tcp {
         _socket.close();
       }
 
+      // Each connection gets its own segment.
+      _shm_ring.reset();
+      _decompressor.reset();
+
       DEBUG_ASSERT(_token.is_valid());
-      DEBUG_ASSERT(_token.protocol_is_tcp());
       const auto ep = _token.to_tcp_endpoint();
 
       auto handle_connect = [this, self, ep](error_code ec) {
@@ -123,6 +150,9 @@ namespace tcp {
                 }
                 if (!ec) {
                   DEBUG_ASSERT_EQ(bytes, sizeof(stream_id));
+                  if (_shm_disabled) {
+                    RefuseSharedMemory();
+                  }
                   // If succeeded start reading data.
                   ReadData();
                 } else {
@@ -172,7 +202,7 @@ namespace tcp {
 
       // log_debug("streaming client: Client::ReadData");
 
-      auto message = std::make_shared<IncomingMessage>(_buffer_pool->Pop());
+      auto message = std::make_shared<IncomingMessage>(*_buffer_pool);
 
       auto handle_read_data = [this, self, message](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
         DEBUG_ONLY(log_debug("streaming client: Client::ReadData.handle_read_data", bytes, "bytes"));
@@ -182,7 +212,7 @@ namespace tcp {
           // Move the buffer to the callback function and start reading the next
           // piece of data.
           // log_debug("streaming client: success reading data, calling the callback");
-          boost::asio::post(_strand, [self, message]() { self->_callback(message->pop()); });
+          Deliver(*message);
           ReadData();
         } else {
           // As usual, if anything fails start over from the very top.
@@ -191,11 +221,46 @@ namespace tcp {
         }
       };
 
-      auto handle_read_header = [this, self, message, handle_read_data](
+      auto handle_read_descriptor = [this, self, message](
+          boost::system::error_code ec,
+          size_t DEBUG_ONLY(bytes)) {
+        DEBUG_ONLY(log_debug("streaming client: Client::ReadData.handle_read_descriptor", bytes, "bytes"));
+        if (_done) {
+          return;
+        }
+        if (!ec && _shm_disabled) {
+          // Placed in the ring before the server got our refusal, lost.
+          ReadData();
+        } else if (!ec && !OpenSharedMemory()) {
+          // Reconnecting would only get a new segment we cannot map either,
+          // fall back to the socket for the rest of the session.
+          log_warning("streaming client: unable to map shared memory, falling back to TCP");
+          _shm_disabled = true;
+          RefuseSharedMemory();
+          ReadData();
+        } else if (!ec && message->ReadFrom(*_shm_ring)) {
+          Deliver(*message);
+          ReadData();
+        } else {
+          log_debug("streaming client: failed to read from shared memory:", ec.message());
+          Connect();
+        }
+      };
+
+      auto handle_read_header = [this, self, message, handle_read_data, handle_read_descriptor](
           boost::system::error_code ec,
           size_t DEBUG_ONLY(bytes)) {
         DEBUG_ONLY(log_debug("streaming client: Client::ReadData.handle_read_header", bytes, "bytes"));
-        if (!ec && (message->size() > 0u)) {
+        if (!ec && (message->size() == 0u) && _token.protocol_is_shm()) {
+          // A zero size header announces a message placed in shared memory.
+          if (_done) {
+            return;
+          }
+          boost::asio::async_read(
+              _socket,
+              message->descriptor_as_buffer(),
+              boost::asio::bind_executor(_strand, handle_read_descriptor));
+        } else if (!ec && (message->size() > 0u)) {
           DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type));
           if (_done) {
             return;
@@ -222,6 +287,59 @@ namespace tcp {
     });
   }
 
+  void Client::Deliver(IncomingMessage &message) {
+    auto buffer = message.pop();
+    if (message.is_compressed()) {
+      CARLA_TRACE_SCOPE(streaming, decompress);
+      if (_decompressor == nullptr) {
+        _decompressor = std::make_unique<Decompressor>();
+      }
+      auto decompressed = _buffer_pool->Pop();
+      if (!_decompressor->Decompress(buffer, decompressed)) {
+        // Corrupted or missing its reference frame, skip it until the next key
+        // frame arrives.
+        log_debug("streaming client: discarding compressed message that cannot be decompressed");
+        return;
+      }
+      buffer = std::move(decompressed);
+    }
+    auto self = shared_from_this();
+    auto data = std::make_shared<Buffer>(std::move(buffer));
+    boost::asio::post(_strand, [self, data]() {
+      CARLA_TRACE_SCOPE(streaming, client_callback);
+      self->_callback(std::move(*data));
+    });
+  }
+
+  bool Client::OpenSharedMemory() {
+    if (_shm_ring != nullptr) {
+      return true;
+    }
+    boost::system::error_code local_ec;
+    boost::system::error_code remote_ec;
+    const auto local = _socket.local_endpoint(local_ec);
+    const auto remote = _socket.remote_endpoint(remote_ec);
+    if (local_ec || remote_ec) {
+      return false;
+    }
+    _shm_ring = shm::SharedMemoryRing::Open(
+        shm::SharedMemoryRing::MakeName(remote.port(), _token.get_stream_id(), local.port()));
+    return _shm_ring != nullptr;
+  }
+
+  void Client::RefuseSharedMemory() {
+    static const uint8_t request = shm::refuse_shared_memory_request;
+    boost::asio::async_write(
+        _socket,
+        boost::asio::buffer(&request, sizeof(request)),
+        boost::asio::bind_executor(_strand, [self=shared_from_this()](boost::system::error_code ec, size_t) {
+          if (ec) {
+            // The reads notice the broken connection and reconnect.
+            log_debug("streaming client: failed to refuse shared memory:", ec.message());
+          }
+        }));
+  }
+
 } // namespace tcp
 } // namespace detail
 } // namespace streaming
@@ -9,8 +9,10 @@
 #include "carla/Buffer.h"
 #include "carla/NonCopyable.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/Compression.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/Types.h"
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
 
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_context.hpp>
@@ -29,6 +31,8 @@ namespace streaming {
 namespace detail {
 namespace tcp {
 
+  class IncomingMessage;
+
   /// A client that connects to a single stream.
   ///
   /// @warning This client should be stopped before releasing the shared pointer
@@ -64,6 +68,15 @@ namespace tcp {
 
     void ReadData();
 
+    /// Decompress @a message if needed and pass it to the callback.
+    void Deliver(IncomingMessage &message);
+
+    /// Map the shared memory segment of the current connection.
+    bool OpenSharedMemory();
+
+    /// Ask the server to stop using shared memory for this connection.
+    void RefuseSharedMemory();
+
     const token_type _token;
 
     callback_function_type _callback;
@@ -76,6 +89,14 @@ namespace tcp {
 
     std::shared_ptr<BufferPool> _buffer_pool;
 
+    std::unique_ptr<shm::SharedMemoryRing> _shm_ring;
+
+    /// Set once a segment could not be mapped, later connections use the
+    /// socket only.
+    bool _shm_disabled = false;
+
+    std::unique_ptr<Decompressor> _decompressor;
+
     std::atomic_bool _done{false};
   };
 
@@ -58,7 +58,9 @@ namespace tcp {
     MessageTmpl(Buffer &&buf, Buffers &&... buffers)
       : MessageTmpl(sizeof...(Buffers) + 1u, std::move(buf), std::move(buffers)...) {
       static_assert(sizeof...(Buffers) < max_size(), "Too many buffers!");
-      _buffer_views[0u] = boost::asio::buffer(&_total_size, sizeof(_total_size));
+      DEBUG_ASSERT(_total_size < compressed_message_flag);
+      _header = _total_size;
+      _buffer_views[0u] = boost::asio::buffer(&_header, sizeof(_header));
     }
 
     /// Size in bytes of the message excluding the header.
@@ -70,17 +72,37 @@ namespace tcp {
       return size() == 0u;
     }
 
+    /// Whether the body of the message is compressed.
+    bool is_compressed() const noexcept {
+      return (_header & compressed_message_flag) != 0u;
+    }
+
+    /// Flag the body of the message as compressed in the size header. Must be
+    /// called before the message is shared with any session.
+    void SetCompressed() noexcept {
+      _header = _total_size | compressed_message_flag;
+    }
+
     auto GetBufferSequence() const {
       auto begin = _buffer_views.begin();
       return MakeListView(begin, begin + _number_of_buffers + 1u);
     }
 
+    /// Buffer sequence of the message body, i.e. without the size header.
+    auto GetBodyBufferSequence() const {
+      auto begin = _buffer_views.begin() + 1u;
+      return MakeListView(begin, begin + _number_of_buffers);
+    }
+
   private:
 
     message_size_type _number_of_buffers = 0u;
 
     message_size_type _total_size = 0u;
 
+    /// Size header sent before the body, may carry compressed_message_flag.
+    message_size_type _header = 0u;
+
     std::array<Buffer, MaxNumberOfBuffers> _buffers;
 
     std::array<boost::asio::const_buffer, MaxNumberOfBuffers + 1u> _buffer_views;
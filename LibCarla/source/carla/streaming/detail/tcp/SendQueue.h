@@ -0,0 +1,69 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Time.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace tcp {
+
+  /// What a session does with a new message when its outgoing queue is full.
+  enum class SendPolicy : uint8_t {
+    /// Keep only the most recent message, older pending messages are dropped.
+    KeepLatest,
+    /// Keep the @a max_size most recent messages, the oldest is dropped.
+    KeepN,
+    /// Block the writer until there is room in the queue, the new message is
+    /// dropped if @a timeout expires first.
+    BlockWithTimeout
+  };
+
+  /// Bounded outgoing queue of each server session.
+  struct SendQueueSettings {
+    SendPolicy policy = SendPolicy::KeepLatest;
+
+    /// Maximum number of messages waiting to be sent, ignored by KeepLatest.
+    size_t max_size = 1u;
+
+    /// Maximum time a writer is blocked, only used by BlockWithTimeout.
+    time_duration timeout = time_duration::seconds(10u);
+
+    /// Maximum number of queued messages gathered in a single socket write.
+    size_t max_batch_size = 16u;
+
+    size_t capacity() const {
+      return policy == SendPolicy::KeepLatest ? 1u : (max_size > 0u ? max_size : 1u);
+    }
+  };
+
+  /// Counters shared by all the sessions of a server.
+  struct SendQueueStatistics {
+    /// Messages written to the sockets.
+    size_t messages_sent = 0u;
+
+    /// Messages discarded because of a full queue.
+    size_t messages_dropped = 0u;
+
+    /// Socket writes performed, each may gather several messages.
+    size_t writes = 0u;
+
+    /// Messages currently waiting in the queues of all the sessions.
+    size_t queue_depth = 0u;
+
+    /// Maximum depth reached by a single session queue.
+    size_t max_queue_depth = 0u;
+  };
+
+} // namespace tcp
+} // namespace detail
+} // namespace streaming
+} // namespace carla
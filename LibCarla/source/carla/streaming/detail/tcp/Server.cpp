@@ -21,7 +21,45 @@ namespace tcp {
     : _io_context(io_context),
       _acceptor(_io_context, std::move(ep)),
       _timeout(time_duration::seconds(10u)),
-      _synchronous(false) {}
+      _synchronous(false) {
+    // In synchronous mode the client expects every message, the writers wait
+    // for the slow sessions instead of dropping data.
+    _sync_queue_settings.policy = SendPolicy::BlockWithTimeout;
+    _sync_queue_settings.max_size = 16u;
+  }
+
+  SendQueueStatistics Server::GetSendQueueStatistics() const {
+    SendQueueStatistics statistics;
+    statistics.messages_sent = _messages_sent;
+    statistics.messages_dropped = _messages_dropped;
+    statistics.writes = _writes;
+    statistics.queue_depth = _queue_depth;
+    statistics.max_queue_depth = _max_queue_depth;
+    return statistics;
+  }
+
+  void Server::OnMessageQueued(const size_t session_queue_depth) {
+    ++_queue_depth;
+    auto max_depth = _max_queue_depth.load();
+    while ((session_queue_depth > max_depth) &&
+           !_max_queue_depth.compare_exchange_weak(max_depth, session_queue_depth));
+  }
+
+  void Server::OnMessagesDropped(const size_t count, const bool were_queued) {
+    if (were_queued) {
+      _queue_depth -= count;
+    }
+    _messages_dropped += count;
+  }
+
+  void Server::OnMessagesDequeued(const size_t count) {
+    _queue_depth -= count;
+  }
+
+  void Server::OnMessagesSent(const size_t count) {
+    _messages_sent += count;
+    ++_writes;
+  }
 
   void Server::OpenSession(
       time_duration timeout,
@@ -8,6 +8,7 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/streaming/detail/tcp/SendQueue.h"
 #include "carla/streaming/detail/tcp/ServerSession.h"
 
 #include <boost/asio/io_context.hpp>
@@ -62,8 +63,36 @@ namespace tcp {
       return _synchronous;
     }
 
+    /// Set the outgoing queue of the sessions while the server is in
+    /// synchronous (@a synchronous = true) or asynchronous mode. Should be set
+    /// before the server starts running. By default the asynchronous mode
+    /// keeps the latest message, and the synchronous mode blocks the writers
+    /// up to the timeout while 16 messages are waiting, so no message is lost
+    /// unless a session stalls.
+    void SetSendQueueSettings(bool synchronous, SendQueueSettings settings) {
+      (synchronous ? _sync_queue_settings : _async_queue_settings) = settings;
+    }
+
+    const SendQueueSettings &GetSendQueueSettings() const {
+      return _synchronous ? _sync_queue_settings : _async_queue_settings;
+    }
+
+    SendQueueStatistics GetSendQueueStatistics() const;
+
   private:
 
+    friend class ServerSession;
+
+    void OnMessageQueued(size_t session_queue_depth);
+
+    void OnMessagesDropped(size_t count, bool were_queued);
+
+    /// Messages taken from a session queue to be written to the socket.
+    void OnMessagesDequeued(size_t count);
+
+    /// Messages whose socket write completed successfully.
+    void OnMessagesSent(size_t count);
+
     void OpenSession(
         time_duration timeout,
         ServerSession::callback_function_type on_session_opened,
@@ -76,6 +105,20 @@ namespace tcp {
     std::atomic<time_duration> _timeout;
 
     bool _synchronous;
+
+    SendQueueSettings _async_queue_settings;
+
+    SendQueueSettings _sync_queue_settings;
+
+    std::atomic_size_t _messages_sent{0u};
+
+    std::atomic_size_t _messages_dropped{0u};
+
+    std::atomic_size_t _writes{0u};
+
+    std::atomic_size_t _queue_depth{0u};
+
+    std::atomic_size_t _max_queue_depth{0u};
   };
 
 } // namespace tcp
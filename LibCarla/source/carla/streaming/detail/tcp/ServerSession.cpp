@@ -9,14 +9,16 @@
 
 #include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/profiler/Tracer.h"
 
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/post.hpp>
 
+#include <algorithm>
 #include <atomic>
-#include <thread>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -59,6 +61,7 @@ namespace tcp {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes_received, sizeof(_stream_id));
           log_debug("session", _session_id, "for stream", _stream_id, " started");
+          ReadClientRequests();
           boost::asio::post(_strand.context(), [=]() { callback(self); });
         } else {
           log_error("session", _session_id, ": error retrieving stream id :", ec.message());
@@ -78,43 +81,179 @@ namespace tcp {
   void ServerSession::Write(std::shared_ptr<const Message> message) {
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
-    auto self = shared_from_this();
-    boost::asio::post(_strand, [=]() {
-      if (!_socket.is_open()) {
+    CARLA_TRACE_SCOPE(streaming, queue_message);
+    const auto &settings = _server.GetSendQueueSettings();
+    const auto capacity = settings.capacity();
+    size_t dropped = 0u;
+    bool start_writing = false;
+    {
+      std::unique_lock<std::mutex> lock(_queue_mutex);
+      if (_is_closed) {
         return;
       }
-      if (_is_writing) {
-        if (_server.IsSynchronousMode()) {
-          // wait until previous message has been sent
-          while (_is_writing) {
-            std::this_thread::yield();
+      if (_queue.size() >= capacity) {
+        if (settings.policy == SendPolicy::BlockWithTimeout) {
+          const bool has_room = _queue_cv.wait_for(lock, settings.timeout.to_chrono(), [&]() {
+            return _is_closed || (_queue.size() < capacity);
+          });
+          if (_is_closed) {
+            return;
+          }
+          if (!has_room) {
+            lock.unlock();
+            log_debug("session", _session_id, ": connection too slow: message discarded");
+            OnMessagesDropped(1u, false);
+            return;
           }
         } else {
-          // ignore this message
-          log_debug("session", _session_id, ": connection too slow: message discarded");
-          return;
-        }      
+          // Make room discarding the oldest messages.
+          while (_queue.size() >= capacity) {
+            _queue.pop_front();
+            ++dropped;
+          }
+        }
       }
+      _queue.emplace_back(std::move(message));
+      _server.OnMessageQueued(_queue.size());
+      start_writing = !_is_writing;
       _is_writing = true;
+    }
+    if (dropped > 0u) {
+      log_debug("session", _session_id, ": connection too slow:", dropped, "messages discarded");
+      OnMessagesDropped(dropped, true);
+    }
+    if (start_writing) {
+      boost::asio::post(_strand, [self=shared_from_this()]() { self->WriteQueuedMessages(); });
+    }
+  }
+
+  /// Messages gathered in a single socket write.
+  struct OutgoingBatch {
+    std::vector<std::shared_ptr<const Message>> messages;
+    std::vector<shm::Notification> notifications;
+    std::vector<boost::asio::const_buffer> buffers;
+  };
 
-      auto handle_sent = [this, self, message](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
+  void ServerSession::WriteQueuedMessages() {
+    auto batch = std::make_shared<OutgoingBatch>();
+    {
+      std::lock_guard<std::mutex> lock(_queue_mutex);
+      if (_queue.empty() || !_socket.is_open()) {
+        if (!_queue.empty()) {
+          OnMessagesDropped(_queue.size(), true);
+          _queue.clear();
+        }
         _is_writing = false;
-        if (ec) {
-          log_info("session", _session_id, ": error sending data :", ec.message());
-          CloseNow();
-        } else {
-          DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
-          DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
+        _queue_cv.notify_all();
+        return;
+      }
+      const auto max_batch_size = std::max<size_t>(1u, _server.GetSendQueueSettings().max_batch_size);
+      while (!_queue.empty() && (batch->messages.size() < max_batch_size)) {
+        batch->messages.emplace_back(std::move(_queue.front()));
+        _queue.pop_front();
+      }
+    }
+    _queue_cv.notify_all();
+    _server.OnMessagesDequeued(batch->messages.size());
+
+    // The notifications are referenced by the buffers, the vector must not
+    // reallocate.
+    batch->notifications.reserve(batch->messages.size());
+    for (auto &message : batch->messages) {
+      if (_shm_ring != nullptr) {
+        shm::Notification notification;
+        notification.header = message->is_compressed() ? compressed_message_flag : 0u;
+        if (_shm_ring->TryWrite(message->GetBodyBufferSequence(), notification.descriptor)) {
+          batch->notifications.emplace_back(notification);
+          batch->buffers.emplace_back(boost::asio::buffer(
+              &batch->notifications.back(),
+              sizeof(shm::Notification)));
+          continue;
         }
-      };
+        // The client is not keeping up and the ring is full, this message goes
+        // through the socket.
+        log_debug("session", _session_id, ": shared memory full, sending through the socket");
+      }
+      for (auto &&buffer : message->GetBufferSequence()) {
+        batch->buffers.emplace_back(buffer);
+      }
+    }
 
-      log_debug("session", _session_id, ": sending message of", message->size(), "bytes");
+    log_debug("session", _session_id, ": sending", batch->messages.size(), "messages");
 
-      _deadline.expires_from_now(_timeout);
-      boost::asio::async_write(
-          _socket,
-          message->GetBufferSequence(),
-          handle_sent);
+    // Time from the start of the socket write to its completion.
+    static auto &write_trace_point = profiler::Tracer::GetTracePoint("streaming", "socket_write");
+    const uint64_t write_begin = profiler::Tracer::IsEnabled() ? profiler::Tracer::Now() : 0u;
+
+    auto handle_sent = [this, self=shared_from_this(), batch, write_begin](
+        const boost::system::error_code &ec,
+        size_t DEBUG_ONLY(bytes)) {
+      if (write_begin != 0u) {
+        profiler::Tracer::Record(write_trace_point, write_begin, profiler::Tracer::Now());
+      }
+      if (ec) {
+        log_info("session", _session_id, ": error sending data :", ec.message());
+        OnMessagesDropped(batch->messages.size(), false);
+        CloseNow();
+      } else {
+        DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
+        _server.OnMessagesSent(batch->messages.size());
+      }
+      // Either keep writing or release the writing flag.
+      WriteQueuedMessages();
+    };
+
+    _deadline.expires_from_now(_timeout);
+    boost::asio::async_write(
+        _socket,
+        batch->buffers,
+        boost::asio::bind_executor(_strand, handle_sent));
+  }
+
+  void ServerSession::ReadClientRequests() {
+    auto handle_request = [this, self=shared_from_this()](
+        const boost::system::error_code &ec,
+        size_t) {
+      if (ec) {
+        // Closed, errors are handled by the writes.
+        return;
+      }
+      if (_client_request == shm::refuse_shared_memory_request) {
+        log_info("session", _session_id, ": client cannot map shared memory, using the socket");
+        _shm_refused = true;
+        _shm_ring.reset();
+      }
+      ReadClientRequests();
+    };
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(&_client_request, sizeof(_client_request)),
+        boost::asio::bind_executor(_strand, handle_request));
+  }
+
+  void ServerSession::EnableSharedMemory() {
+    boost::asio::post(_strand, [this, self=shared_from_this()]() {
+      if (!_socket.is_open() || (_shm_ring != nullptr) || _shm_refused) {
+        return;
+      }
+      boost::system::error_code local_ec;
+      boost::system::error_code remote_ec;
+      const auto local = _socket.local_endpoint(local_ec);
+      const auto remote = _socket.remote_endpoint(remote_ec);
+      if (local_ec || remote_ec) {
+        log_debug("session", _session_id, ": unable to query endpoints");
+        return;
+      }
+      // The client applies the same test on its side of the connection.
+      if (local.address() != remote.address()) {
+        log_debug("session", _session_id, ": remote client, shared memory disabled");
+        return;
+      }
+      _shm_ring = shm::SharedMemoryRing::Create(
+          shm::SharedMemoryRing::MakeName(local.port(), _stream_id, remote.port()));
+      if (_shm_ring != nullptr) {
+        log_debug("session", _session_id, ": using shared memory transport");
+      }
     });
   }
 
@@ -137,8 +276,23 @@ namespace tcp {
     }
   }
 
+  void ServerSession::OnMessagesDropped(const size_t count, const bool were_queued) {
+    _messages_dropped += count;
+    _server.OnMessagesDropped(count, were_queued);
+  }
+
   void ServerSession::CloseNow() {
     _deadline.cancel();
+    {
+      std::lock_guard<std::mutex> lock(_queue_mutex);
+      _is_closed = true;
+      if (!_queue.empty()) {
+        OnMessagesDropped(_queue.size(), true);
+        _queue.clear();
+      }
+    }
+    _queue_cv.notify_all();
+    _shm_ring.reset();
     if (_socket.is_open()) {
       boost::system::error_code ec;
       _socket.shutdown(boost::asio::socket_base::shutdown_both, ec);
@@ -11,6 +11,7 @@
 #include "carla/TypeTraits.h"
 #include "carla/profiler/LifetimeProfiled.h"
 #include "carla/streaming/detail/Types.h"
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
 #include <boost/asio/deadline_timer.hpp>
@@ -18,8 +19,12 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace carla {
 namespace streaming {
@@ -65,7 +70,8 @@ namespace tcp {
       return std::make_shared<const Message>(std::move(buffers)...);
     }
 
-    /// Writes some data to the socket.
+    /// Queue a message to be written to the socket. What happens if the
+    /// outgoing queue is full depends on the SendQueueSettings of the server.
     void Write(std::shared_ptr<const Message> message);
 
     /// Writes some data to the socket.
@@ -77,12 +83,32 @@ namespace tcp {
     /// Post a job to close the session.
     void Close();
 
+    /// Messages of this session discarded since it was created, because of a
+    /// full queue or a closed socket.
+    size_t GetNumberOfDroppedMessages() const {
+      return _messages_dropped;
+    }
+
+    /// Post a job to switch this session to the shared memory transport. Only
+    /// takes effect if the client is connected from the same host, otherwise
+    /// the messages keep going through the socket.
+    void EnableSharedMemory();
+
   private:
 
     void StartTimer();
 
+    /// Keep reading the requests the client sends once subscribed.
+    void ReadClientRequests();
+
+    /// Gather the queued messages in a single socket write, keeps writing
+    /// until the queue is empty.
+    void WriteQueuedMessages();
+
     void CloseNow();
 
+    void OnMessagesDropped(size_t count, bool were_queued);
+
     friend class Server;
 
     Server &_server;
@@ -101,7 +127,27 @@ namespace tcp {
 
     callback_function_type _on_closed;
 
+    std::unique_ptr<shm::SharedMemoryRing> _shm_ring;
+
+    /// The client could not map the ring, do not create it again.
+    bool _shm_refused = false;
+
+    uint8_t _client_request = 0u;
+
+    // The outgoing queue is filled by the writers, usually from other threads,
+    // and emptied in the strand.
+
+    std::mutex _queue_mutex;
+
+    std::condition_variable _queue_cv;
+
+    std::deque<std::shared_ptr<const Message>> _queue;
+
     bool _is_writing = false;
+
+    bool _is_closed = false;
+
+    std::atomic_size_t _messages_dropped{0u};
   };
 
 } // namespace tcp
@@ -73,6 +73,21 @@ namespace low_level {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    template <typename SettingsT>
+    void SetSendQueueSettings(bool synchronous, SettingsT settings) {
+      _server.SetSendQueueSettings(synchronous, settings);
+    }
+
+    auto GetSendQueueStatistics() const {
+      return _server.GetSendQueueStatistics();
+    }
+
+    /// Streams created from now on use shared memory to deliver the messages
+    /// to clients running on the same host.
+    void SetSharedMemory(bool enable) {
+      _dispatcher.SetSharedMemory(enable);
+    }
+
     carla::streaming::detail::token_type GetToken(carla::streaming::detail::stream_id_type sensor_id) {
       return _dispatcher.GetToken(sensor_id);
     }
@@ -4,6 +4,7 @@
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
 #include "carla/client/Walker.h"
+#include "carla/client/detail/Simulator.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
@@ -16,6 +17,7 @@ namespace traffic_manager {
 
 ALSM::ALSM(
   AtomicActorSet &registered_vehicles,
+  std::vector<ActorId> &vehicle_id_list,
   BufferMap &buffer_map,
   TrackTraffic &track_traffic,
   std::vector<ActorId>& marked_for_removal,
@@ -29,6 +31,7 @@ ALSM::ALSM(
   MotionPlanStage &motion_plan_stage,
   VehicleLightStage &vehicle_light_stage)
   : registered_vehicles(registered_vehicles),
+    vehicle_id_list(vehicle_id_list),
     buffer_map(buffer_map),
     track_traffic(track_traffic),
     marked_for_removal(marked_for_removal),
@@ -46,45 +49,47 @@ void ALSM::Update() {
 
   bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
 
-  std::set<ActorId> world_vehicle_ids;
-  std::set<ActorId> world_pedestrian_ids;
-  std::vector<ActorId> unregistered_list_to_be_deleted;
+  const cc::WorldSnapshot snapshot = world.GetSnapshot();
+  current_timestamp = snapshot.GetTimestamp();
 
-  current_timestamp = world.GetSnapshot().GetTimestamp();
-  ActorList world_actors = world.GetActors();
-
-  // Find destroyed actors and perform clean up.
-  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
+  // Find actors spawned and destroyed since the last update.
+  ActorLifecycleUpdate changes = IdentifyActorChanges(snapshot);
+  std::vector<ActorId> &new_actor_ids = changes.new_actors;
 
-  const ActorIdSet &destroyed_registered = destroyed_actors.first;
-  for (const auto &deletion_id: destroyed_registered) {
-    RemoveActor(deletion_id, true);
+  // Perform clean up of destroyed actors, and invalidate hero actors not alive anymore.
+  for (const ActorId deletion_id : changes.destroyed_actors) {
+    if (registered_vehicles.Contains(deletion_id)) {
+      RemoveActor(deletion_id, true);
+    }
+    if (unregistered_actors.find(deletion_id) != unregistered_actors.end()) {
+      RemoveActor(deletion_id, false);
+    }
+    hero_actors.erase(deletion_id);
   }
 
-  const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
-  for (auto deletion_id : destroyed_unregistered) {
-    RemoveActor(deletion_id, false);
+  // Registered vehicles destroyed without being reported.
+  for (const ActorId deletion_id : changes.dead_registered_actors) {
+    RemoveActor(deletion_id, true);
+    hero_actors.erase(deletion_id);
   }
 
-  // Invalidate hero actor if it is not alive anymore.
-  if (hero_actors.size() != 0u) {
-    ActorIdSet hero_actors_to_delete;
-    for (auto &hero_actor_info: hero_actors) {
-      if (destroyed_unregistered.find(hero_actor_info.first) != destroyed_unregistered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-      if (destroyed_registered.find(hero_actor_info.first) != destroyed_registered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-    }
-
-    for (auto &deletion_id: hero_actors_to_delete) {
-      hero_actors.erase(deletion_id);
+  // Vehicles registered since the last update are no longer unregistered
+  // actors. They are kept as hero actors, the role name is only checked for
+  // new actors.
+  for (const ActorId actor_id : changes.registered_actors) {
+    if (unregistered_actors.erase(actor_id) > 0u) {
+      track_traffic.DeleteActor(actor_id);
+      simulation_state.RemoveActor(actor_id);
+      state_layout_changed = true;
     }
   }
 
-  // Scan for new unregistered actors.
-  IdentifyNewActors(world_actors);
+  // Scan new actors for hero vehicles and unregistered actors.
+  if (!new_actor_ids.empty()) {
+    std::sort(new_actor_ids.begin(), new_actor_ids.end());
+    new_actor_ids.erase(std::unique(new_actor_ids.begin(), new_actor_ids.end()), new_actor_ids.end());
+    IdentifyNewActors(world.GetActors(new_actor_ids));
+  }
 
   // Update dynamic state and static attributes for all registered vehicles.
   ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
@@ -110,14 +115,38 @@ void ALSM::Update() {
 
   // Update dynamic state and static attributes for unregistered actors.
   UpdateUnregisteredActorsData();
+
+  // Refresh the list of registered vehicles and move them to the first
+  // indices of the simulation state, in the same order.
+  const int current_registered_vehicles_state = registered_vehicles.GetState();
+  if (state_layout_changed
+      || registered_vehicles_state != current_registered_vehicles_state
+      || vehicle_id_list.size() != registered_vehicles.Size()) {
+    vehicle_id_list = registered_vehicles.GetIDList();
+    simulation_state.ArrangeActors(vehicle_id_list);
+    registered_vehicles_state = current_registered_vehicles_state;
+    state_layout_changed = false;
+  }
+}
+
+ActorLifecycleUpdate ALSM::IdentifyActorChanges(const cc::WorldSnapshot &snapshot) {
+  client::detail::ActorLifecycleChanges changes;
+  uint64_t tracked_episode_id;
+  uint64_t tracked_frame;
+  if (actor_tracker.GetTrackedFrame(tracked_episode_id, tracked_frame)) {
+    changes = world.GetEpisode().Lock()->GetActorLifecycleChanges(
+        tracked_episode_id, tracked_frame, snapshot.GetFrame());
+  }
+  return actor_tracker.Update(snapshot, std::move(changes), registered_vehicles);
 }
 
 void ALSM::IdentifyNewActors(const ActorList &actor_list) {
   for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
     ActorPtr actor = *iter;
     ActorId actor_id = actor->GetId();
+    const char type = actor->GetTypeId().front();
     // Identify any new hero vehicle
-    if (actor->GetTypeId().front() == 'v') {
+    if (type == 'v') {
      if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end()) {
       for (auto&& attribute: actor->GetAttributes()) {
         if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
@@ -126,7 +155,9 @@ void ALSM::IdentifyNewActors(const ActorList &actor_list) {
       }
     }
   }
-    if (!registered_vehicles.Contains(actor_id)
+    // Only vehicles and walkers take part in the simulation state.
+    if ((type == 'v' || type == 'w')
+        && !registered_vehicles.Contains(actor_id)
         && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
 
       unregistered_actors.insert({actor_id, actor});
@@ -134,38 +165,6 @@ void ALSM::IdentifyNewActors(const ActorList &actor_list) {
   }
 }
 
-ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list) {
-
-  ALSM::DestroyeddActors destroyed_actors;
-  ActorIdSet &deleted_registered = destroyed_actors.first;
-  ActorIdSet &deleted_unregistered = destroyed_actors.second;
-
-  // Building hash set of actors present in current frame.
-  ActorIdSet current_actors;
-  for  (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    current_actors.insert((*iter)->GetId());
-  }
-
-  // Searching for destroyed registered actors.
-  std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
-  for (const ActorId &actor_id : registered_ids) {
-    if (current_actors.find(actor_id) == current_actors.end()) {
-      deleted_registered.insert(actor_id);
-    }
-  }
-
-  // Searching for destroyed unregistered actors.
-  for (const auto &actor_info: unregistered_actors) {
-    const ActorId &actor_id = actor_info.first;
-     if (current_actors.find(actor_id) == current_actors.end()
-         || registered_vehicles.Contains(actor_id)) {
-      deleted_unregistered.insert(actor_id);
-    }
-  }
-
-  return destroyed_actors;
-}
-
 void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::IdleInfo &max_idle_time) {
 
   std::vector<ActorPtr> vehicle_list = registered_vehicles.GetList();
@@ -202,6 +201,7 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
   cg::Rotation vehicle_rotation = vehicle_transform.rotation;
   cg::Vector3D vehicle_velocity = vehicle->GetVelocity();
   bool state_entry_present = simulation_state.ContainsActor(actor_id);
+  const unsigned long state_index = state_entry_present ? simulation_state.GetIndex(actor_id) : 0u;
 
   // Initializing idle times.
   if (idle_time.find(actor_id) == idle_time.end() && current_timestamp.elapsed_seconds != 0.0) {
@@ -214,7 +214,7 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
     for (auto &hero_actor_info: hero_actors) {
       const ActorId &hero_actor_id =  hero_actor_info.first;
       if (simulation_state.ContainsActor(hero_actor_id)) {
-        const cg::Location &hero_location = simulation_state.GetLocation(hero_actor_id);
+        const cg::Location hero_location = simulation_state.GetLocation(simulation_state.GetIndex(hero_actor_id));
         if (cg::Math::DistanceSquared(vehicle_location, hero_location) < physics_radius_square) {
           in_range_of_hero_actor = true;
           break;
@@ -229,7 +229,7 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
       vehicle->SetSimulatePhysics(enable_physics);
       has_physics_enabled[actor_id] = enable_physics;
       if (enable_physics == true && state_entry_present) {
-        vehicle->SetTargetVelocity(simulation_state.GetVelocity(actor_id));
+        vehicle->SetTargetVelocity(simulation_state.GetVelocity(state_index));
       }
     }
   }
@@ -237,9 +237,9 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
   // If physics are disabled, calculate velocity based on change in position.
   // Do not use 'enable_physics' as turning off the physics in this tick doesn't remove the velocity.
   // To avoid issues with other clients teleporting the actors, use the previous outpout location.
-  if (state_entry_present && !simulation_state.IsPhysicsEnabled(actor_id)){
-    cg::Location previous_location = simulation_state.GetLocation(actor_id);
-    cg::Location previous_end_location = simulation_state.GetHybridEndLocation(actor_id);
+  if (state_entry_present && !simulation_state.IsPhysicsEnabled(state_index)){
+    cg::Location previous_location = simulation_state.GetLocation(state_index);
+    cg::Location previous_end_location = simulation_state.GetHybridEndLocation(state_index);
     cg::Vector3D displacement = (previous_end_location - previous_location);
     vehicle_velocity = displacement * INV_HYBRID_DT;
   }
@@ -255,14 +255,15 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
 
   // Update simulation state.
   if (state_entry_present) {
-    simulation_state.UpdateKinematicState(actor_id, kinematic_state);
-    simulation_state.UpdateTrafficLightState(actor_id, tl_state);
+    simulation_state.UpdateKinematicState(state_index, kinematic_state);
+    simulation_state.UpdateTrafficLightState(state_index, tl_state);
   }
   else {
     cg::Vector3D dimensions = vehicle_ptr->GetBoundingBox().extent;
     StaticAttributes attributes{ActorType::Vehicle, dimensions.x, dimensions.y, dimensions.z};
 
     simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
+    state_layout_changed = true;
   }
 
   // Updating idle time when necessary.
@@ -302,9 +303,11 @@ void ALSM::UpdateUnregisteredActorsData() {
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
+        state_layout_changed = true;
       } else {
-        simulation_state.UpdateKinematicState(actor_id, kinematic_state);
-        simulation_state.UpdateTrafficLightState(actor_id, tl_state);
+        const unsigned long state_index = simulation_state.GetIndex(actor_id);
+        simulation_state.UpdateKinematicState(state_index, kinematic_state);
+        simulation_state.UpdateTrafficLightState(state_index, tl_state);
       }
 
       // Identify occupied waypoints.
@@ -327,8 +330,9 @@ void ALSM::UpdateUnregisteredActorsData() {
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
+        state_layout_changed = true;
       } else {
-        simulation_state.UpdateKinematicState(actor_id, kinematic_state);
+        simulation_state.UpdateKinematicState(simulation_state.GetIndex(actor_id), kinematic_state);
       }
 
       // Identify occupied waypoints.
@@ -343,7 +347,7 @@ void ALSM::UpdateUnregisteredActorsData() {
 void ALSM::UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const ActorId& actor_id) {
   if (idle_time.find(actor_id) != idle_time.end()) {
     double &idle_duration = idle_time.at(actor_id);
-    if (simulation_state.GetVelocity(actor_id).SquaredLength() > SQUARE(STOPPED_VELOCITY_THRESHOLD)) {
+    if (simulation_state.GetVelocity(simulation_state.GetIndex(actor_id)).SquaredLength() > SQUARE(STOPPED_VELOCITY_THRESHOLD)) {
       idle_duration = current_timestamp.elapsed_seconds;
     }
 
@@ -357,7 +361,7 @@ void ALSM::UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const Actor
 bool ALSM::IsVehicleStuck(const ActorId& actor_id) {
   if (idle_time.find(actor_id) != idle_time.end()) {
     double delta_idle_time = current_timestamp.elapsed_seconds - idle_time.at(actor_id);
-    TrafficLightState tl_state = simulation_state.GetTLS(actor_id);
+    TrafficLightState tl_state = simulation_state.GetTLS(simulation_state.GetIndex(actor_id));
     if ((!tl_state.at_traffic_light && tl_state.tl_state != TLS::Red && delta_idle_time >= BLOCKED_TIME_THRESHOLD)
     || (delta_idle_time >= RED_TL_BLOCKED_TIME_THRESHOLD)) {
       return true;
@@ -384,13 +388,17 @@ void ALSM::RemoveActor(const ActorId actor_id, const bool registered_actor) {
 
   track_traffic.DeleteActor(actor_id);
   simulation_state.RemoveActor(actor_id);
+  state_layout_changed = true;
 }
 
 void ALSM::Reset() {
   unregistered_actors.clear();
+  actor_tracker.Reset();
   idle_time.clear();
   hero_actors.clear();
   elapsed_last_actor_destruction = 0.0;
+  registered_vehicles_state = -1;
+  state_layout_changed = true;
   current_timestamp = world.GetSnapshot().GetTimestamp();
 }
 
@@ -6,8 +6,10 @@
 #include "carla/client/ActorList.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/World.h"
+#include "carla/client/WorldSnapshot.h"
 #include "carla/Memory.h"
 
+#include "carla/trafficmanager/ActorLifecycleTracker.h"
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/CollisionStage.h"
 #include "carla/trafficmanager/DataStructures.h"
@@ -42,8 +44,18 @@ class ALSM {
 
 private:
   AtomicActorSet &registered_vehicles;
-  // Structure containing vehicles in the simulator not registered with the traffic manager.
+  // List of registered vehicles used by the stages, refreshed along with the
+  // layout of the simulation state.
+  std::vector<ActorId> &vehicle_id_list;
+  // State counter of the registered vehicles when the list was refreshed.
+  int registered_vehicles_state {-1};
+  // Flag set when actors are added to or removed from the simulation state.
+  bool state_layout_changed {true};
+  // Structure containing vehicles and walkers in the simulator not registered with the traffic manager.
   ActorMap unregistered_actors;
+  // Actors and registered vehicles seen at the last update, the actors added
+  // and removed after it are requested to the episode.
+  ActorLifecycleTracker actor_tracker;
   BufferMap &buffer_map;
   // Structure keeping track of duration of vehicles stuck in a location.
   IdleTimeMap idle_time;
@@ -72,13 +84,15 @@ private:
   // Method to determine if a vehicle is stuck at a place for too long.
   bool IsVehicleStuck(const ActorId& actor_id);
 
-  // Method to identify actors newly spawned in the simulation since last tick.
-  void IdentifyNewActors(const ActorList &actor_list);
+  // Method to identify the actors spawned and destroyed in the simulation,
+  // and the vehicles registered and unregistered, since the last update. Only
+  // the changes are processed, the actors of the snapshot are compared with
+  // the tracked ones only when the episode cannot provide the changes (first
+  // update, new episode or too many frames missed).
+  ActorLifecycleUpdate IdentifyActorChanges(const cc::WorldSnapshot &snapshot);
 
-  using DestroyeddActors = std::pair<ActorIdSet, ActorIdSet>;
-  // Method to identify actors deleted in the last frame.
-  // Arrays of registered and unregistered actors are returned separately.
-  DestroyeddActors IdentifyDestroyedActors(const ActorList &actor_list);
+  // Method to add actors newly spawned in the simulation.
+  void IdentifyNewActors(const ActorList &actor_list);
 
   using IdleInfo = std::pair<ActorId, double>;
   void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
@@ -91,6 +105,7 @@ private:
 
 public:
   ALSM(AtomicActorSet &registered_vehicles,
+       std::vector<ActorId> &vehicle_id_list,
        BufferMap &buffer_map,
        TrackTraffic &track_traffic,
        std::vector<ActorId>& marked_for_removal,
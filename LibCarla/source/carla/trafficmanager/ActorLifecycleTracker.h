@@ -0,0 +1,165 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#include "carla/client/detail/ActorLifecycleLog.h"
+#include "carla/rpc/ActorId.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using ActorId = carla::ActorId;
+
+/// Actors whose lifecycle changed since the last update of the ALSM.
+struct ActorLifecycleUpdate {
+  /// Actors spawned, or unregistered while still alive, to be identified.
+  std::vector<ActorId> new_actors;
+  /// Actors destroyed in the simulation.
+  std::vector<ActorId> destroyed_actors;
+  /// Vehicles registered while alive, they are no longer unregistered actors.
+  std::vector<ActorId> registered_actors;
+  /// Registered vehicles not alive and not reported as destroyed, e.g.,
+  /// vehicles registered and destroyed between two updates.
+  std::vector<ActorId> dead_registered_actors;
+};
+
+/// Keeps the actors and the registered vehicles seen by the ALSM, and works
+/// out what changed since the last update from the changes logged by the
+/// episode, or comparing with the snapshot if the log does not cover them.
+class ActorLifecycleTracker {
+public:
+  using ActorLifecycleChanges = client::detail::ActorLifecycleChanges;
+
+  /// Whether the changes since the last update can be requested, i.e. the
+  /// frame of the last update of @a episode_id.
+  bool GetTrackedFrame(uint64_t &episode_id, uint64_t &frame) const {
+    episode_id = tracked_episode_id;
+    frame = tracked_frame;
+    return is_tracking_actors;
+  }
+
+  /// @a snapshot is the world snapshot of this update, @a changes are the
+  /// changes logged since GetTrackedFrame (incomplete if not available), and
+  /// @a registered_vehicles the registered vehicles of the traffic manager.
+  template <typename SnapshotT, typename RegisteredT>
+  ActorLifecycleUpdate Update(const SnapshotT &snapshot,
+                              ActorLifecycleChanges changes,
+                              const RegisteredT &registered_vehicles);
+
+  void Reset() {
+    tracked_actors.clear();
+    is_tracking_actors = false;
+    tracked_registered_ids.clear();
+    tracked_registered_state = -1;
+  }
+
+private:
+  // Actors present in the simulation at the last update.
+  std::unordered_set<ActorId> tracked_actors;
+  // Episode and frame of the snapshot of the last update.
+  bool is_tracking_actors {false};
+  uint64_t tracked_episode_id {0u};
+  uint64_t tracked_frame {0u};
+  // Registered vehicles, sorted by id, and their state counter when the
+  // registrations were last checked.
+  std::vector<ActorId> tracked_registered_ids;
+  int tracked_registered_state {-1};
+};
+
+template <typename SnapshotT, typename RegisteredT>
+ActorLifecycleUpdate ActorLifecycleTracker::Update(const SnapshotT &snapshot,
+                                                   ActorLifecycleChanges changes,
+                                                   const RegisteredT &registered_vehicles) {
+  ActorLifecycleUpdate update;
+  const bool changes_complete = is_tracking_actors && changes.complete;
+  if (changes_complete) {
+    update.new_actors = std::move(changes.added);
+    update.destroyed_actors = std::move(changes.removed);
+  } else {
+    for (const auto &actor : snapshot) {
+      if (tracked_actors.find(actor.id) == tracked_actors.end()) {
+        update.new_actors.push_back(actor.id);
+      }
+    }
+    for (const ActorId actor_id : tracked_actors) {
+      if (!snapshot.Contains(actor_id)) {
+        update.destroyed_actors.push_back(actor_id);
+      }
+    }
+    std::sort(update.destroyed_actors.begin(), update.destroyed_actors.end());
+  }
+
+  for (const ActorId actor_id : update.new_actors) {
+    tracked_actors.insert(actor_id);
+  }
+  for (const ActorId actor_id : update.destroyed_actors) {
+    tracked_actors.erase(actor_id);
+  }
+  is_tracking_actors = true;
+  tracked_episode_id = snapshot.GetId();
+  tracked_frame = snapshot.GetFrame();
+
+  // Registered vehicles are known from their registration, not from the
+  // snapshots, so a vehicle registered and destroyed between two updates is
+  // not reported as destroyed by the changes. Without the log, any registered
+  // vehicle may have been missed.
+  const int current_registered_state = registered_vehicles.GetState();
+  if (changes_complete && tracked_registered_state == current_registered_state) {
+    return update;
+  }
+  std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
+  std::sort(registered_ids.begin(), registered_ids.end());
+
+  auto is_dead = [&](ActorId actor_id) {
+    return !snapshot.Contains(actor_id) && !std::binary_search(
+        update.destroyed_actors.begin(), update.destroyed_actors.end(), actor_id);
+  };
+
+  if (!changes_complete) {
+    for (const ActorId actor_id : registered_ids) {
+      if (is_dead(actor_id)) {
+        update.dead_registered_actors.push_back(actor_id);
+      }
+    }
+  }
+
+  std::vector<ActorId> changed_ids;
+  std::set_difference(registered_ids.begin(), registered_ids.end(),
+                      tracked_registered_ids.begin(), tracked_registered_ids.end(),
+                      std::back_inserter(changed_ids));
+  for (const ActorId actor_id : changed_ids) {
+    if (snapshot.Contains(actor_id)) {
+      update.registered_actors.push_back(actor_id);
+    } else if (changes_complete && is_dead(actor_id)) {
+      update.dead_registered_actors.push_back(actor_id);
+    }
+  }
+
+  // Vehicles unregistered while still alive become unregistered actors.
+  changed_ids.clear();
+  std::set_difference(tracked_registered_ids.begin(), tracked_registered_ids.end(),
+                      registered_ids.begin(), registered_ids.end(),
+                      std::back_inserter(changed_ids));
+  for (const ActorId actor_id : changed_ids) {
+    if (snapshot.Contains(actor_id)) {
+      update.new_actors.push_back(actor_id);
+    }
+  }
+
+  tracked_registered_ids = std::move(registered_ids);
+  tracked_registered_state = current_registered_state;
+  return update;
+}
+
+} // namespace traffic_manager
+} // namespace carla
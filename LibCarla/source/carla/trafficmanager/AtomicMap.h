@@ -8,6 +8,7 @@
 
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace traffic_manager {
@@ -53,6 +54,50 @@ namespace traffic_manager {
       map.erase(key);
     }
 
+    /// Value of each of the @a keys, or @a default_value if not present,
+    /// locking the map once.
+    std::vector<Value> GetValues(const std::vector<Key> &keys, const Value &default_value) const {
+
+      std::lock_guard<std::mutex> lock(map_mutex);
+      std::vector<Value> values;
+      values.reserve(keys.size());
+      for (const Key &key : keys) {
+        auto it = map.find(key);
+        values.emplace_back(it != map.end() ? it->second : default_value);
+      }
+      return values;
+    }
+
+    /// Same as GetValues, also removing the keys from the map.
+    std::vector<Value> TakeValues(const std::vector<Key> &keys, const Value &default_value) {
+
+      std::lock_guard<std::mutex> lock(map_mutex);
+      std::vector<Value> values;
+      values.reserve(keys.size());
+      for (const Key &key : keys) {
+        auto it = map.find(key);
+        if (it != map.end()) {
+          values.emplace_back(it->second);
+          map.erase(it);
+        } else {
+          values.emplace_back(default_value);
+        }
+      }
+      return values;
+    }
+
+    /// Whether each of the @a keys is present, locking the map once.
+    std::vector<bool> ContainsKeys(const std::vector<Key> &keys) const {
+
+      std::lock_guard<std::mutex> lock(map_mutex);
+      std::vector<bool> result;
+      result.reserve(keys.size());
+      for (const Key &key : keys) {
+        result.emplace_back(map.find(key) != map.end());
+      }
+      return result;
+    }
+
   };
 
 } // namespace traffic_manager
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "carla/geom/Location.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Uniform grid of actor locations in the horizontal plane, to find the
+/// actors near a location without checking every actor.
+class BroadphaseGrid {
+public:
+
+  explicit BroadphaseGrid(const float cell_size) : cell_size(cell_size) {}
+
+  void Insert(const cg::Location &location, const unsigned long index) {
+    cells[GetKey(GetCell(location.x), GetCell(location.y))].push_back(index);
+  }
+
+  void Clear() {
+    cells.clear();
+  }
+
+  /// Calls @a func with the index of every actor in the cells touched by the
+  /// square around @a location of side 2 * @a radius. This is a superset of
+  /// the actors within @a radius of @a location, the caller filters them by
+  /// their actual distance.
+  template <typename FuncT>
+  void ForEachNear(const cg::Location &location, const float radius, FuncT &&func) const {
+    auto visit = [&](const std::vector<unsigned long> &indices) {
+      for (const unsigned long index : indices) {
+        func(index);
+      }
+    };
+    // Only the cells touched by the radius are visited, unless there are more
+    // of them than occupied cells in the grid.
+    const int32_t min_x = GetCell(location.x - radius);
+    const int32_t max_x = GetCell(location.x + radius);
+    const int32_t min_y = GetCell(location.y - radius);
+    const int32_t max_y = GetCell(location.y + radius);
+    const uint64_t number_of_cells = static_cast<uint64_t>(max_x - min_x + 1) * static_cast<uint64_t>(max_y - min_y + 1);
+    if (number_of_cells > cells.size()) {
+      for (const auto &cell : cells) {
+        visit(cell.second);
+      }
+    } else {
+      for (int32_t cell_x = min_x; cell_x <= max_x; ++cell_x) {
+        for (int32_t cell_y = min_y; cell_y <= max_y; ++cell_y) {
+          const auto cell = cells.find(GetKey(cell_x, cell_y));
+          if (cell != cells.end()) {
+            visit(cell->second);
+          }
+        }
+      }
+    }
+  }
+
+private:
+
+  int32_t GetCell(const float coordinate) const {
+    return static_cast<int32_t>(std::floor(coordinate / cell_size));
+  }
+
+  static uint64_t GetKey(const int32_t cell_x, const int32_t cell_y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32u) | static_cast<uint32_t>(cell_y);
+  }
+
+  const float cell_size;
+  // Indices of the actors in each occupied cell.
+  std::unordered_map<uint64_t, std::vector<unsigned long>> cells;
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -15,6 +15,10 @@ using TLS = carla::rpc::TrafficLightState;
 using namespace constants::Collision;
 using constants::WaypointSelection::JUNCTION_LOOK_AHEAD;
 
+// Side of the cells of the broadphase grid, a vehicle at low speed only
+// checks the neighbouring cells.
+static const float BROADPHASE_CELL_SIZE = COLLISION_RADIUS_MIN;
+
 CollisionStage::CollisionStage(
   const std::vector<ActorId> &vehicle_id_list,
   const SimulationState &simulation_state,
@@ -29,6 +33,7 @@ CollisionStage::CollisionStage(
     track_traffic(track_traffic),
     parameters(parameters),
     output_array(output_array),
+    broadphase_grid(BROADPHASE_CELL_SIZE),
     random_device(random_device) {}
 
 void CollisionStage::Update(const unsigned long index) {
@@ -38,18 +43,18 @@ void CollisionStage::Update(const unsigned long index) {
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
   if (simulation_state.ContainsActor(ego_actor_id)) {
-    const cg::Location ego_location = simulation_state.GetLocation(ego_actor_id);
+    CollisionLockState ego_lock = GetCollisionLock(ego_actor_id);
+    const cg::Location ego_location = simulation_state.GetLocation(index);
     const Buffer &ego_buffer = buffer_map.at(ego_actor_id);
     const unsigned long look_ahead_index = GetTargetWaypoint(ego_buffer, JUNCTION_LOOK_AHEAD).second;
-    const float velocity = simulation_state.GetVelocity(ego_actor_id).Length();
+    const float velocity = simulation_state.GetVelocity(index).Length();
 
-    ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
-    std::vector<ActorId> collision_candidate_ids;
     // Run through vehicles with overlapping paths and filter them;
-    const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
+    const VehicleParameters &ego_parameters = parameters.GetSnapshot().vehicles.at(index);
+    const float distance_to_leading = ego_parameters.distance_to_leading_vehicle;
     float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
     if (velocity < 2.0f) {
-      const float length = simulation_state.GetDimensions(ego_actor_id).x;
+      const float length = simulation_state.GetDimensions(index).x;
       const float collision_radius_stop = COLLISION_RADIUS_STOP + length;
       collision_radius_square = SQUARE(collision_radius_stop);
     }
@@ -57,43 +62,34 @@ void CollisionStage::Update(const unsigned long index) {
         collision_radius_square = SQUARE(distance_to_leading);
     }
 
-    for (ActorId overlapping_actor_id : overlapping_actors) {
-      // If actor is within maximum collision avoidance and vertical overlap range.
-      const cg::Location &overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
-      if (overlapping_actor_id != ego_actor_id
-          && cg::Math::DistanceSquared(overlapping_actor_location, ego_location) < collision_radius_square
-          && std::abs(ego_location.z - overlapping_actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
-        collision_candidate_ids.push_back(overlapping_actor_id);
-      }
-    }
-
-    // Sorting collision candidates in accending order of distance to current vehicle.
-    std::sort(collision_candidate_ids.begin(), collision_candidate_ids.end(),
-              [this, &ego_location](const ActorId &a_id_1, const ActorId &a_id_2) {
-                const cg::Location &e_loc = ego_location;
-                const cg::Location &loc_1 = simulation_state.GetLocation(a_id_1);
-                const cg::Location &loc_2 = simulation_state.GetLocation(a_id_2);
-                return (cg::Math::DistanceSquared(e_loc, loc_1) < cg::Math::DistanceSquared(e_loc, loc_2));
-              });
+    const std::vector<unsigned long> collision_candidates = GetCollisionCandidates(index,
+                                                                                    ego_location,
+                                                                                    collision_radius_square);
 
     // Check every actor in the vicinity if it poses a collision hazard.
-    for (auto iter = collision_candidate_ids.begin();
-         iter != collision_candidate_ids.end() && !collision_hazard;
+    for (auto iter = collision_candidates.begin();
+         iter != collision_candidates.end() && !collision_hazard;
          ++iter) {
-      const ActorId other_actor_id = *iter;
-      const ActorType other_actor_type = simulation_state.GetType(other_actor_id);
-
-      if (parameters.GetCollisionDetection(ego_actor_id, other_actor_id)
-          && buffer_map.find(ego_actor_id) != buffer_map.end()
-          && simulation_state.ContainsActor(other_actor_id)) {
-        std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
-                                                                       other_actor_id,
-                                                                       look_ahead_index);
+      const unsigned long other_index = *iter;
+      const ActorId other_actor_id = simulation_state.GetActorId(other_index);
+      const ActorType other_actor_type = simulation_state.GetType(other_index);
+
+      if (ego_parameters.GetCollisionDetection(other_actor_id)
+          && buffer_map.find(ego_actor_id) != buffer_map.end()) {
+        std::pair<bool, float> negotiation_result = NegotiateCollision(index,
+                                                                       other_index,
+                                                                       look_ahead_index,
+                                                                       ego_lock);
         if (negotiation_result.first) {
+          // Concurrent updates draw from the stream of the vehicle, so the
+          // result does not depend on the order of the updates.
+          auto draw = [this, ego_actor_id]() {
+            return parallel_update ? random_device.next(ego_actor_id) : random_device.next();
+          };
           if ((other_actor_type == ActorType::Vehicle
-               && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_device.next())
+               && ego_parameters.perc_ignore_vehicles <= draw())
               || (other_actor_type == ActorType::Pedestrian
-                  && parameters.GetPercentageIgnoreWalkers(ego_actor_id) <= random_device.next())) {
+                  && ego_parameters.perc_ignore_walkers <= draw())) {
             collision_hazard = true;
             obstacle_id = other_actor_id;
             available_distance_margin = negotiation_result.second;
@@ -101,6 +97,12 @@ void CollisionStage::Update(const unsigned long index) {
         }
       }
     }
+
+    if (parallel_update) {
+      lock_frame.at(index) = ego_lock;
+    } else {
+      StoreCollisionLock(ego_actor_id, ego_lock);
+    }
   }
 
   CollisionHazardData &output_element = output_array.at(index);
@@ -111,22 +113,39 @@ void CollisionStage::Update(const unsigned long index) {
 
 void CollisionStage::RemoveActor(const ActorId actor_id) {
   collision_locks.erase(actor_id);
+  random_device.RemoveActorStream(actor_id);
 }
 
 void CollisionStage::Reset() {
   collision_locks.clear();
 }
 
-float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
+CollisionLockState CollisionStage::GetCollisionLock(const ActorId actor_id) const {
+  const auto it = collision_locks.find(actor_id);
+  if (it != collision_locks.end()) {
+    return {true, it->second};
+  }
+  return {false, CollisionLock{0.0, 0.0, 0u}};
+}
+
+void CollisionStage::StoreCollisionLock(const ActorId actor_id, const CollisionLockState &lock_state) {
+  if (lock_state.locked) {
+    collision_locks[actor_id] = lock_state.lock;
+  } else {
+    collision_locks.erase(actor_id);
+  }
+}
+
+float CollisionStage::GetBoundingBoxExtention(const unsigned long state_index, const CollisionLockState &lock_state) {
 
-  const float velocity = cg::Math::Dot(simulation_state.GetVelocity(actor_id), simulation_state.GetHeading(actor_id));
+  const float velocity = cg::Math::Dot(simulation_state.GetVelocity(state_index), simulation_state.GetHeading(state_index));
   float bbox_extension;
   // Using a function to calculate boundary length.
   float velocity_extension = VEL_EXT_FACTOR * velocity;
   bbox_extension = BOUNDARY_EXTENSION_MINIMUM + velocity_extension * velocity_extension;
   // If a valid collision lock present, change boundary length to maintain lock.
-  if (collision_locks.find(actor_id) != collision_locks.end()) {
-    const CollisionLock &lock = collision_locks.at(actor_id);
+  if (lock_state.locked) {
+    const CollisionLock &lock = lock_state.lock;
     float lock_boundary_length = static_cast<float>(lock.distance_to_lead_vehicle + LOCKING_DISTANCE_PADDING);
     // Only extend boundary track vehicle if the leading vehicle
     // if it is not further than velocity dependent extension by MAX_LOCKING_EXTENSION.
@@ -138,17 +157,17 @@ float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
   return bbox_extension;
 }
 
-LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
-  const ActorType actor_type = simulation_state.GetType(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
+LocationVector CollisionStage::GetBoundary(const unsigned long state_index) {
+  const ActorType actor_type = simulation_state.GetType(state_index);
+  const cg::Vector3D heading_vector = simulation_state.GetHeading(state_index);
 
   float forward_extension = 0.0f;
   if (actor_type == ActorType::Pedestrian) {
     // Extend the pedestrians bbox to "predict" where they'll be and avoid collisions.
-    forward_extension = simulation_state.GetVelocity(actor_id).Length() * WALKER_TIME_EXTENSION;
+    forward_extension = simulation_state.GetVelocity(state_index).Length() * WALKER_TIME_EXTENSION;
   }
 
-  cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
+  cg::Vector3D dimensions = simulation_state.GetDimensions(state_index);
 
   float bbox_x = dimensions.x;
   float bbox_y = dimensions.y;
@@ -158,7 +177,7 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   const cg::Vector3D y_boundary_vector = perpendicular_vector * (bbox_y + forward_extension);
 
   // Four corners of the vehicle in top view clockwise order (left-handed system).
-  const cg::Location location = simulation_state.GetLocation(actor_id);
+  const cg::Location location = simulation_state.GetLocation(state_index);
   LocationVector bbox_boundary = {
       location + cg::Location(x_boundary_vector - y_boundary_vector),
       location + cg::Location(-1.0f * x_boundary_vector - y_boundary_vector),
@@ -169,74 +188,70 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   return bbox_boundary;
 }
 
-LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
+LocationVector CollisionStage::GetGeodesicBoundary(const unsigned long state_index, const CollisionLockState &lock_state) {
   LocationVector geodesic_boundary;
 
-  if (geodesic_boundary_map.find(actor_id) != geodesic_boundary_map.end()) {
-    geodesic_boundary = geodesic_boundary_map.at(actor_id);
-  } else {
-    const LocationVector bbox = GetBoundary(actor_id);
-
-    if (buffer_map.find(actor_id) != buffer_map.end()) {
-      float bbox_extension = GetBoundingBoxExtention(actor_id);
-      const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
-      bbox_extension = std::max(specific_lead_distance, bbox_extension);
-      const float bbox_extension_square = SQUARE(bbox_extension);
-
-      LocationVector left_boundary;
-      LocationVector right_boundary;
-      cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
-      const float width = dimensions.y;
-      const float length = dimensions.x;
-
-      const Buffer &waypoint_buffer = buffer_map.at(actor_id);
-      const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_buffer, length);
-      const SimpleWaypointPtr boundary_start = target_wp_info.first;
-      const uint64_t boundary_start_index = target_wp_info.second;
-
-      // At non-signalized junctions, we extend the boundary across the junction
-      // and in all other situations, boundary length is velocity-dependent.
-      SimpleWaypointPtr boundary_end = nullptr;
-      SimpleWaypointPtr current_point = waypoint_buffer.at(boundary_start_index);
-      bool reached_distance = false;
-      for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
-        if (boundary_start->DistanceSquared(current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
-          reached_distance = true;
-        }
-        if (boundary_end == nullptr
-            || cg::Math::Dot(boundary_end->GetForwardVector(), current_point->GetForwardVector()) < COS_10_DEGREES
-            || reached_distance) {
-
-          const cg::Vector3D heading_vector = current_point->GetForwardVector();
-          const cg::Location location = current_point->GetLocation();
-          cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
-          perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
-          // Direction determined for the left-handed system.
-          const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
-          left_boundary.push_back(location + cg::Location(scaled_perpendicular));
-          right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
-
-          boundary_end = current_point;
-        }
-
-        current_point = waypoint_buffer.at(j);
+  const ActorId actor_id = simulation_state.GetActorId(state_index);
+  const LocationVector bbox = GetBoundary(state_index);
+
+  if (buffer_map.find(actor_id) != buffer_map.end()) {
+    float bbox_extension = GetBoundingBoxExtention(state_index, lock_state);
+    // Only registered vehicles have a buffer, they are the first in the state.
+    const float specific_lead_distance = parameters.GetSnapshot().vehicles.at(state_index).distance_to_leading_vehicle;
+    bbox_extension = std::max(specific_lead_distance, bbox_extension);
+    const float bbox_extension_square = SQUARE(bbox_extension);
+
+    LocationVector left_boundary;
+    LocationVector right_boundary;
+    cg::Vector3D dimensions = simulation_state.GetDimensions(state_index);
+    const float width = dimensions.y;
+    const float length = dimensions.x;
+
+    const Buffer &waypoint_buffer = buffer_map.at(actor_id);
+    const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_buffer, length);
+    const SimpleWaypointPtr boundary_start = target_wp_info.first;
+    const uint64_t boundary_start_index = target_wp_info.second;
+
+    // At non-signalized junctions, we extend the boundary across the junction
+    // and in all other situations, boundary length is velocity-dependent.
+    SimpleWaypointPtr boundary_end = nullptr;
+    SimpleWaypointPtr current_point = waypoint_buffer.at(boundary_start_index);
+    bool reached_distance = false;
+    for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
+      if (boundary_start->DistanceSquared(current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
+        reached_distance = true;
+      }
+      if (boundary_end == nullptr
+          || cg::Math::Dot(boundary_end->GetForwardVector(), current_point->GetForwardVector()) < COS_10_DEGREES
+          || reached_distance) {
+
+        const cg::Vector3D heading_vector = current_point->GetForwardVector();
+        const cg::Location location = current_point->GetLocation();
+        cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
+        perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
+        // Direction determined for the left-handed system.
+        const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
+        left_boundary.push_back(location + cg::Location(scaled_perpendicular));
+        right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
+
+        boundary_end = current_point;
       }
 
-      // Reversing right boundary to construct clockwise (left-hand system)
-      // boundary. This is so because both left and right boundary vectors have
-      // the closest point to the vehicle at their starting index for the right
-      // boundary,
-      // we want to begin at the farthest point to have a clockwise trace.
-      std::reverse(right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
-    } else {
-
-      geodesic_boundary = bbox;
+      current_point = waypoint_buffer.at(j);
     }
 
-    geodesic_boundary_map.insert({actor_id, geodesic_boundary});
+    // Reversing right boundary to construct clockwise (left-hand system)
+    // boundary. This is so because both left and right boundary vectors have
+    // the closest point to the vehicle at their starting index for the right
+    // boundary,
+    // we want to begin at the farthest point to have a clockwise trace.
+    std::reverse(right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
+  } else {
+
+    geodesic_boundary = bbox;
   }
 
   return geodesic_boundary;
@@ -253,9 +268,55 @@ Polygon CollisionStage::GetPolygon(const LocationVector &boundary) {
   return boundary_polygon;
 }
 
-GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId reference_vehicle_id,
-                                                            const ActorId other_actor_id) {
+const Polygon &CollisionStage::GetGeodesicPolygon(const unsigned long state_index, const CollisionLockState &lock_state) {
+  // Built by whichever update needs it first. Concurrent updates always use
+  // the lock from the beginning of the cycle.
+  std::call_once(geodesic_polygon_flags[state_index], [this, state_index, &lock_state]() {
+    const CollisionLockState boundary_lock = parallel_update
+        ? GetCollisionLock(simulation_state.GetActorId(state_index))
+        : lock_state;
+    geodesic_polygons.at(state_index) = GetPolygon(GetGeodesicBoundary(state_index, boundary_lock));
+  });
+  return geodesic_polygons.at(state_index);
+}
+
+std::vector<unsigned long> CollisionStage::GetCollisionCandidates(const unsigned long state_index,
+                                                                  const cg::Location &location,
+                                                                  const float collision_radius_square) {
+  const ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(simulation_state.GetActorId(state_index));
+  std::vector<std::pair<float, unsigned long>> candidates;
+
+  broadphase_grid.ForEachNear(location, std::sqrt(collision_radius_square), [&](const unsigned long geometry_index) {
+    if (geometry_index == state_index) {
+      return;
+    }
+    // If actor is within maximum collision avoidance and vertical overlap range.
+    const ActorGeometry &geometry = actor_geometry[geometry_index];
+    const float distance_square = cg::Math::DistanceSquared(geometry.location, location);
+    if (distance_square < collision_radius_square
+        && std::abs(location.z - geometry.location.z) < VERTICAL_OVERLAP_THRESHOLD
+        && overlapping_actors.find(geometry.actor_id) != overlapping_actors.end()) {
+      candidates.push_back({distance_square, geometry_index});
+    }
+  });
+
+  // Sorting collision candidates in accending order of distance to current vehicle.
+  std::sort(candidates.begin(), candidates.end());
+
+  std::vector<unsigned long> collision_candidates;
+  collision_candidates.reserve(candidates.size());
+  for (const auto &candidate : candidates) {
+    collision_candidates.push_back(candidate.second);
+  }
+  return collision_candidates;
+}
+
+GeometryComparison CollisionStage::GetGeometryBetweenActors(const unsigned long reference_index,
+                                                            const unsigned long other_index,
+                                                            const CollisionLockState &reference_lock) {
 
+  const ActorId reference_vehicle_id = simulation_state.GetActorId(reference_index);
+  const ActorId other_actor_id = simulation_state.GetActorId(other_index);
 
   std::pair<ActorId, ActorId> key_parts;
   if (reference_vehicle_id < other_actor_id) {
@@ -271,7 +332,8 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
 
   GeometryComparison comparision_result{-1.0, -1.0, -1.0, -1.0};
 
-  if (geometry_cache.find(actor_id_key) != geometry_cache.end()) {
+  // The cache is shared between vehicles, concurrent updates don't use it.
+  if (!parallel_update && geometry_cache.find(actor_id_key) != geometry_cache.end()) {
 
     comparision_result = geometry_cache.at(actor_id_key);
     double mref_veh_other = comparision_result.reference_vehicle_to_other_geodesic;
@@ -279,12 +341,12 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
     comparision_result.other_vehicle_to_reference_geodesic = mref_veh_other;
   } else {
 
-    const Polygon reference_polygon = GetPolygon(GetBoundary(reference_vehicle_id));
-    const Polygon other_polygon = GetPolygon(GetBoundary(other_actor_id));
+    const Polygon &reference_polygon = actor_geometry.at(reference_index).boundary;
+    const Polygon &other_polygon = actor_geometry.at(other_index).boundary;
 
-    const Polygon reference_geodesic_polygon = GetPolygon(GetGeodesicBoundary(reference_vehicle_id));
+    const Polygon &reference_geodesic_polygon = GetGeodesicPolygon(reference_index, reference_lock);
 
-    const Polygon other_geodesic_polygon = GetPolygon(GetGeodesicBoundary(other_actor_id));
+    const Polygon &other_geodesic_polygon = GetGeodesicPolygon(other_index, GetCollisionLock(other_actor_id));
 
     const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
     const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
@@ -296,40 +358,46 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
               inter_geodesic_distance,
               inter_bbox_distance};
 
-    geometry_cache.insert({actor_id_key, comparision_result});
+    if (!parallel_update) {
+      geometry_cache.insert({actor_id_key, comparision_result});
+    }
   }
 
   return comparision_result;
 }
 
-std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId reference_vehicle_id,
-                                                          const ActorId other_actor_id,
-                                                          const uint64_t reference_junction_look_ahead_index) {
+std::pair<bool, float> CollisionStage::NegotiateCollision(const unsigned long reference_index,
+                                                          const unsigned long other_index,
+                                                          const uint64_t reference_junction_look_ahead_index,
+                                                          CollisionLockState &reference_lock) {
   // Output variables for the method.
   bool hazard = false;
   float available_distance_margin = std::numeric_limits<float>::infinity();
 
-  const cg::Location reference_location = simulation_state.GetLocation(reference_vehicle_id);
-  const cg::Location other_location = simulation_state.GetLocation(other_actor_id);
+  const ActorId reference_vehicle_id = simulation_state.GetActorId(reference_index);
+  const ActorId other_actor_id = simulation_state.GetActorId(other_index);
+
+  const cg::Location reference_location = simulation_state.GetLocation(reference_index);
+  const cg::Location other_location = simulation_state.GetLocation(other_index);
 
   // Ego and other vehicle heading.
-  const cg::Vector3D reference_heading = simulation_state.GetHeading(reference_vehicle_id);
+  const cg::Vector3D reference_heading = simulation_state.GetHeading(reference_index);
   // Vector from ego position to position of the other vehicle.
   cg::Vector3D reference_to_other = other_location - reference_location;
   reference_to_other = reference_to_other.MakeSafeUnitVector(EPSILON);
 
   // Other vehicle heading.
-  const cg::Vector3D other_heading = simulation_state.GetHeading(other_actor_id);
+  const cg::Vector3D other_heading = simulation_state.GetHeading(other_index);
   // Vector from other vehicle position to ego position.
   cg::Vector3D other_to_reference = reference_location - other_location;
   other_to_reference = other_to_reference.MakeSafeUnitVector(EPSILON);
 
-  float reference_vehicle_length = simulation_state.GetDimensions(reference_vehicle_id).x * SQUARE_ROOT_OF_TWO;
-  float other_vehicle_length = simulation_state.GetDimensions(other_actor_id).x * SQUARE_ROOT_OF_TWO;
+  float reference_vehicle_length = simulation_state.GetDimensions(reference_index).x * SQUARE_ROOT_OF_TWO;
+  float other_vehicle_length = simulation_state.GetDimensions(other_index).x * SQUARE_ROOT_OF_TWO;
 
   float inter_vehicle_distance = cg::Math::DistanceSquared(reference_location, other_location);
-  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_vehicle_id);
-  float other_bounding_box_extension = GetBoundingBoxExtention(other_actor_id);
+  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_index, reference_lock);
+  float other_bounding_box_extension = GetBoundingBoxExtention(other_index, GetCollisionLock(other_actor_id));
   // Calculate minimum distance between vehicle to consider collision negotiation.
   float inter_vehicle_length = reference_vehicle_length + other_vehicle_length;
   float ego_detection_range = SQUARE(ego_bounding_box_extension + inter_vehicle_length);
@@ -343,7 +411,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   const Buffer &reference_vehicle_buffer = buffer_map.at(reference_vehicle_id);
   SimpleWaypointPtr closest_point = reference_vehicle_buffer.front();
   bool ego_inside_junction = closest_point->CheckJunction();
-  TrafficLightState reference_tl_state = simulation_state.GetTLS(reference_vehicle_id);
+  TrafficLightState reference_tl_state = simulation_state.GetTLS(reference_index);
   bool ego_at_traffic_light = reference_tl_state.at_traffic_light;
   bool ego_stopped_by_light = reference_tl_state.tl_state != TLS::Green && reference_tl_state.tl_state != TLS::Off;
   SimpleWaypointPtr look_ahead_point = reference_vehicle_buffer.at(reference_junction_look_ahead_index);
@@ -353,7 +421,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   if (!(ego_at_junction_entrance && ego_at_traffic_light && ego_stopped_by_light)
       && ((ego_inside_junction && other_vehicles_in_cross_detection_range)
           || (!ego_inside_junction && other_vehicle_in_front && other_vehicle_in_ego_range))) {
-    GeometryComparison geometry_comparison = GetGeometryBetweenActors(reference_vehicle_id, other_actor_id);
+    GeometryComparison geometry_comparison = GetGeometryBetweenActors(reference_index, other_index, reference_lock);
 
     // Conditions for collision negotiation.
     bool geodesic_path_bbox_touching = geometry_comparison.inter_geodesic_distance < OVERLAP_THRESHOLD;
@@ -374,7 +442,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
 
       hazard = true;
 
-      const float reference_lead_distance = parameters.GetDistanceToLeadingVehicle(reference_vehicle_id);
+      const float reference_lead_distance = parameters.GetSnapshot().vehicles.at(reference_index).distance_to_leading_vehicle;
       const float specific_distance_margin = std::max(reference_lead_distance, MIN_REFERENCE_DISTANCE);
       available_distance_margin = static_cast<float>(std::max(geometry_comparison.reference_vehicle_to_other_geodesic
                                                               - static_cast<double>(specific_distance_margin), 0.0));
@@ -385,8 +453,8 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
       // This enables us to smoothly approach the lead vehicle.
 
       // When possible collision found, check if an entry for collision lock present.
-      if (collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-        CollisionLock &lock = collision_locks.at(reference_vehicle_id);
+      if (reference_lock.locked) {
+        CollisionLock &lock = reference_lock.lock;
         // Check if the same vehicle is under lock.
         if (other_actor_id == lock.lead_vehicle_id) {
           // If the body of the lead vehicle is touching the reference vehicle bounding box.
@@ -403,25 +471,62 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
         }
       } else {
         // Insert and initialize lock entry if not present.
-        collision_locks.insert({reference_vehicle_id,
-                                {geometry_comparison.inter_bbox_distance,
-                                 geometry_comparison.inter_bbox_distance,
-                                 other_actor_id}});
+        reference_lock = {true,
+                          {geometry_comparison.inter_bbox_distance,
+                           geometry_comparison.inter_bbox_distance,
+                           other_actor_id}};
       }
     }
   }
 
   // If no collision hazard detected, then flush collision lock held by the vehicle.
-  if (!hazard && collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-    collision_locks.erase(reference_vehicle_id);
+  if (!hazard) {
+    reference_lock.locked = false;
   }
 
   return {hazard, available_distance_margin};
 }
 
+void CollisionStage::BuildCycleCache() {
+  const unsigned long number_of_actors = simulation_state.Size();
+  actor_geometry.clear();
+  actor_geometry.reserve(number_of_actors);
+  broadphase_grid.Clear();
+  for (unsigned long state_index = 0u; state_index < number_of_actors; ++state_index) {
+    const cg::Location location = simulation_state.GetLocation(state_index);
+    actor_geometry.push_back({simulation_state.GetActorId(state_index), location, GetPolygon(GetBoundary(state_index))});
+    broadphase_grid.Insert(location, state_index);
+  }
+  geodesic_polygons.clear();
+  geodesic_polygons.resize(actor_geometry.size());
+  geodesic_polygon_flags.reset(new std::once_flag[actor_geometry.size()]);
+}
+
 void CollisionStage::ClearCycleCache() {
-  geodesic_boundary_map.clear();
   geometry_cache.clear();
+  actor_geometry.clear();
+  broadphase_grid.Clear();
+  geodesic_polygons.clear();
+  geodesic_polygon_flags.reset();
+}
+
+void CollisionStage::PrepareParallelUpdate() {
+  const unsigned long number_of_vehicles = vehicle_id_list.size();
+  lock_frame.clear();
+  lock_frame.reserve(number_of_vehicles);
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    const ActorId actor_id = vehicle_id_list.at(index);
+    lock_frame.push_back(GetCollisionLock(actor_id));
+  }
+  random_device.AddActorStreams(vehicle_id_list);
+  parallel_update = true;
+}
+
+void CollisionStage::FinishParallelUpdate() {
+  for (unsigned long index = 0u; index < lock_frame.size(); ++index) {
+    StoreCollisionLock(vehicle_id_list.at(index), lock_frame.at(index));
+  }
+  parallel_update = false;
 }
 
 } // namespace traffic_manager
@@ -2,12 +2,14 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include "boost/geometry.hpp"
 #include "boost/geometry/geometries/geometries.hpp"
 #include "boost/geometry/geometries/point_xy.hpp"
 #include "boost/geometry/geometries/polygon.hpp"
 
+#include "carla/trafficmanager/BroadphaseGrid.h"
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
@@ -31,16 +33,28 @@ struct CollisionLock {
 };
 using CollisionLockMap = std::unordered_map<ActorId, CollisionLock>;
 
+// Collision lock of a vehicle while it is being updated.
+struct CollisionLockState {
+  bool locked;
+  CollisionLock lock;
+};
+
 namespace cc = carla::client;
 namespace bg = boost::geometry;
 
 using Buffer = std::deque<std::shared_ptr<SimpleWaypoint>>;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
 using LocationVector = std::vector<cg::Location>;
-using GeodesicBoundaryMap = std::unordered_map<ActorId, LocationVector>;
 using GeometryComparisonMap = std::unordered_map<uint64_t, GeometryComparison>;
 using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
 
+// Geometry of an actor, computed once per update cycle.
+struct ActorGeometry {
+  ActorId actor_id;
+  cg::Location location;
+  Polygon boundary;
+};
+
 /// This class has functionality to detect potential collision with a nearby actor.
 class CollisionStage : Stage {
 private:
@@ -52,33 +66,59 @@ private:
   CollisionFrame &output_array;
   // Structure keeping track of blocking lead vehicles.
   CollisionLockMap collision_locks;
-  // Structures to cache geodesic boundaries of vehicle and
-  // comparision between vehicle boundaries
+  // Structure to cache comparision between vehicle boundaries
   // to avoid repeated computation within a cycle.
   GeometryComparisonMap geometry_cache;
-  GeodesicBoundaryMap geodesic_boundary_map;
+  // Structures built once per cycle, indexed like the simulation state: the
+  // boundary of every actor, a grid of their locations to find the actors near
+  // a vehicle, and the geodesic boundaries, built on first use.
+  std::vector<ActorGeometry> actor_geometry;
+  BroadphaseGrid broadphase_grid;
+  std::vector<Polygon> geodesic_polygons;
+  std::unique_ptr<std::once_flag[]> geodesic_polygon_flags;
   RandomGenerator &random_device;
+  // Structures used while the vehicles are updated concurrently. The vehicles
+  // read the collision locks and the boundaries of the others as they were at
+  // the beginning of the cycle, and store their own lock per index.
+  bool parallel_update {false};
+  std::vector<CollisionLockState> lock_frame;
 
   // Method to determine if a vehicle is on a collision path to another.
-  std::pair<bool, float> NegotiateCollision(const ActorId reference_vehicle_id,
-                                            const ActorId other_actor_id,
-                                            const uint64_t reference_junction_look_ahead_index);
+  std::pair<bool, float> NegotiateCollision(const unsigned long reference_index,
+                                            const unsigned long other_index,
+                                            const uint64_t reference_junction_look_ahead_index,
+                                            CollisionLockState &reference_lock);
+
+  // Method to retrieve the collision lock currently stored for the actor.
+  CollisionLockState GetCollisionLock(const ActorId actor_id) const;
+
+  void StoreCollisionLock(const ActorId actor_id, const CollisionLockState &lock_state);
 
   // Method to calculate bounding box extention length ahead of the vehicle.
-  float GetBoundingBoxExtention(const ActorId actor_id);
+  float GetBoundingBoxExtention(const unsigned long state_index, const CollisionLockState &lock_state);
 
   // Method to calculate polygon points around the vehicle's bounding box.
-  LocationVector GetBoundary(const ActorId actor_id);
+  LocationVector GetBoundary(const unsigned long state_index);
 
   // Method to construct polygon points around the path boundary of the vehicle.
-  LocationVector GetGeodesicBoundary(const ActorId actor_id);
+  LocationVector GetGeodesicBoundary(const unsigned long state_index, const CollisionLockState &lock_state);
+
+  // Method to retrieve the path boundary polygon of the actor, built once per cycle.
+  const Polygon &GetGeodesicPolygon(const unsigned long state_index, const CollisionLockState &lock_state);
 
   Polygon GetPolygon(const LocationVector &boundary);
 
+  // Method to find the actors with overlapping paths within the collision
+  // radius of the vehicle, sorted by distance, as simulation state indices.
+  std::vector<unsigned long> GetCollisionCandidates(const unsigned long state_index,
+                                                    const cg::Location &location,
+                                                    const float collision_radius_square);
+
   // Method to compare path boundaries, bounding boxes of vehicles
   // and cache the results for reuse in current update cycle.
-  GeometryComparison GetGeometryBetweenActors(const ActorId reference_vehicle_id,
-                                              const ActorId other_actor_id);
+  GeometryComparison GetGeometryBetweenActors(const unsigned long reference_index,
+                                              const unsigned long other_index,
+                                              const CollisionLockState &reference_lock);
 
   // Method to draw path boundary.
   void DrawBoundary(const LocationVector &boundary);
@@ -98,8 +138,19 @@ public:
 
   void Reset() override;
 
+  // Method to build the actor boundaries and the broadphase grid for the
+  // current update cycle, before updating any vehicle.
+  void BuildCycleCache();
+
   // Method to flush cache for current update cycle.
   void ClearCycleCache();
+
+  // Method to make Update safe to call concurrently for different indices,
+  // until FinishParallelUpdate is called.
+  void PrepareParallelUpdate();
+
+  // Method to store the collision locks computed by the concurrent updates.
+  void FinishParallelUpdate();
 };
 
 } // namespace traffic_manager
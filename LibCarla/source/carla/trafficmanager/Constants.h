@@ -105,6 +105,12 @@ static const float MAX_WPT_RADIANS = 0.087f;  // 5º
 static float const DELTA = 25.0f;
 static float const Z_DELTA = 500.0f;
 static float const STRAIGHT_DEG = 19.0f;
+// Header of the cooked files storing the waypoint graph ("TMWG").
+static const uint32_t COOKED_MAP_MAGIC = 0x47574D54u;
+static const uint32_t COOKED_MAP_VERSION = 2u;
+// Uniform grid indexing the waypoint locations.
+static const float SPATIAL_INDEX_CELL_SIZE = 10.0f;
+static const uint64_t SPATIAL_INDEX_MAX_CELLS = 1u << 22;
 } // namespace Map
 
 namespace TrafficLight {
@@ -35,8 +35,8 @@ using TimeInstance = chr::time_point<chr::system_clock, chr::nanoseconds>;
 using TLS = carla::rpc::TrafficLightState;
 
 struct LocalizationData {
-  SimpleWaypointPtr junction_end_point;
-  SimpleWaypointPtr safe_point;
+  WaypointIndex junction_end_point;
+  WaypointIndex safe_point;
   bool is_at_junction_entrance;
 };
 using LocalizationFrame = std::vector<LocalizationData>;
@@ -8,7 +8,7 @@
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/InMemoryMap.h"
-#include <boost/geometry/geometries/box.hpp>
+#include "carla/trafficmanager/MappedFile.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -89,27 +89,116 @@ namespace traffic_manager {
       return;
     }
 
-    // write total records
-    uint32_t total = static_cast<uint32_t>(dense_topology.size());
-    out_file.write(reinterpret_cast<const char *>(&total), sizeof(uint32_t));
-
-    // write simple waypoints
     std::unordered_set<uint64_t> used_ids;
     for (auto& wp: dense_topology) {
       if (used_ids.find(wp->GetId()) != used_ids.end()) {
         log_error("Could not generate the binary file. There are repeated waypoints");
       }
-      CachedSimpleWaypoint cached_wp(wp);
-      cached_wp.Write(out_file);
-
       used_ids.insert(wp->GetId());
     }
 
+    // write the waypoint graph, including the spatial index, in its cooked layout
+    waypoint_graph.Write(out_file, GetOpenDriveChecksum());
+
     out_file.close();
     return;
   }
 
+  bool InMemoryMap::Load(const std::string& filename) {
+    std::shared_ptr<MappedFile> file = MappedFile::Open(filename);
+    if (file == nullptr) {
+      return false;
+    }
+
+    // files without header were cooked as a list of CachedSimpleWaypoint
+    if (!WaypointGraph::HasCookedHeader(file->data(), file->size())) {
+      return LoadLegacy(std::vector<uint8_t>(file->data(), file->data() + file->size()));
+    }
+
+    if (!waypoint_graph.View(file, file->data(), file->size(), GetOpenDriveChecksum())) {
+      log_warning("InMemoryMap cache is corrupted, outdated or belongs to another map:", filename);
+      return false;
+    }
+    SetUpFromWaypointGraph();
+    return true;
+  }
+
   bool InMemoryMap::Load(const std::vector<uint8_t>& content) {
+    if (content.size() < sizeof(uint32_t)) {
+      return false;
+    }
+
+    // files without header were cooked as a list of CachedSimpleWaypoint
+    if (!WaypointGraph::HasCookedHeader(content.data(), content.size())) {
+      return LoadLegacy(content);
+    }
+
+    // keep a copy of the content alive while the graph points into it
+    auto storage = std::make_shared<std::vector<uint8_t>>(content);
+    if (!waypoint_graph.View(storage, storage->data(), storage->size(), GetOpenDriveChecksum())) {
+      log_warning("InMemoryMap cache is corrupted, outdated or belongs to another map");
+      return false;
+    }
+    SetUpFromWaypointGraph();
+    return true;
+  }
+
+  void InMemoryMap::SetUpFromWaypointGraph() {
+    const WaypointIndex total = waypoint_graph.Size();
+
+    // create the simple waypoints without querying the road map
+    dense_topology.clear();
+    dense_topology.reserve(total);
+    for (WaypointIndex i = 0; i < total; i++) {
+      SimpleWaypointPtr wp = std::make_shared<SimpleWaypoint>(
+          _world_map,
+          waypoint_graph.GetRoadId(i),
+          waypoint_graph.GetLaneId(i),
+          waypoint_graph.GetDistance(i),
+          waypoint_graph.GetId(i),
+          waypoint_graph.GetTransform(i),
+          waypoint_graph.GetGeodesicGridId(i));
+      wp->SetIndex(i);
+      dense_topology.push_back(wp);
+    }
+
+    // connect waypoints, the links are stored as indices
+    for (WaypointIndex i = 0; i < total; i++) {
+      auto &wp = dense_topology[i];
+
+      std::vector<SimpleWaypointPtr> next_waypoints;
+      for (WaypointIndex next_index : waypoint_graph.GetNext(i)) {
+        next_waypoints.push_back(dense_topology.at(next_index));
+      }
+      std::vector<SimpleWaypointPtr> previous_waypoints;
+      for (WaypointIndex previous_index : waypoint_graph.GetPrevious(i)) {
+        previous_waypoints.push_back(dense_topology.at(previous_index));
+      }
+      wp->SetNextWaypoint(next_waypoints);
+      wp->SetPreviousWaypoint(previous_waypoints);
+      if (waypoint_graph.GetLeft(i) != INVALID_WAYPOINT_INDEX) {
+        wp->SetLeftWaypoint(dense_topology.at(waypoint_graph.GetLeft(i)));
+      }
+      if (waypoint_graph.GetRight(i) != INVALID_WAYPOINT_INDEX) {
+        wp->SetRightWaypoint(dense_topology.at(waypoint_graph.GetRight(i)));
+      }
+      wp->SetIsJunction(waypoint_graph.CheckJunction(i));
+      wp->SetRoadOption(waypoint_graph.GetRoadOption(i));
+    }
+  }
+
+  uint64_t InMemoryMap::GetOpenDriveChecksum() const {
+    // FNV-1a hash of the OpenDRIVE content.
+    assert(_world_map != nullptr && "No map reference found.");
+    uint64_t checksum = 14695981039346656037ull;
+    for (const char c : _world_map->GetOpenDrive()) {
+      checksum ^= static_cast<uint8_t>(c);
+      checksum *= 1099511628211ull;
+    }
+    return checksum;
+  }
+
+  bool InMemoryMap::LoadLegacy(const std::vector<uint8_t>& content) {
     unsigned long pos = 0;
     std::vector<CachedSimpleWaypoint> cached_waypoints;
     std::unordered_map<uint64_t, uint32_t> id2index;
@@ -157,8 +246,10 @@ namespace traffic_manager {
       }
     }
 
-    // create spatial tree
-    SetUpSpatialTree();
+    // create spatial index
+    SetUpSpatialIndex();
+
+    SetUpWaypointGraph();
 
     return true;
   }
@@ -315,7 +406,7 @@ namespace traffic_manager {
       }
     }
 
-    SetUpSpatialTree();
+    SetUpSpatialIndex();
 
     // Placing inter-segment connections.
     for (auto &segment : segment_map) {
@@ -355,16 +446,19 @@ namespace traffic_manager {
 
     // Specifying a RoadOption for each SimpleWaypoint
     SetUpRoadOption();
+
+    SetUpWaypointGraph();
   }
 
-  void InMemoryMap::SetUpSpatialTree() {
-    for (auto &simple_waypoint: dense_topology) {
-      if (simple_waypoint != nullptr) {
-        const cg::Location loc = simple_waypoint->GetLocation();
-        Point3D point(loc.x, loc.y, loc.z);
-        rtree.insert(std::make_pair(point, simple_waypoint));
-      }
+  void InMemoryMap::SetUpWaypointGraph() {
+    waypoint_graph.SetUpTopology(dense_topology);
+  }
+
+  void InMemoryMap::SetUpSpatialIndex() {
+    for (std::size_t i = 0; i < dense_topology.size(); ++i) {
+      dense_topology.at(i)->SetIndex(static_cast<WaypointIndex>(i));
     }
+    waypoint_graph.SetUpSpatialIndex(dense_topology);
   }
 
   void InMemoryMap::SetUpRoadOption() {
@@ -457,42 +551,32 @@ namespace traffic_manager {
   }
 
   SimpleWaypointPtr InMemoryMap::GetWaypoint(const cg::Location loc) const {
-
-    Point3D query_point(loc.x, loc.y, loc.z);
-    std::vector<SpatialTreeEntry> result_1;
-
-    rtree.query(bgi::nearest(query_point, 1), std::back_inserter(result_1));
-
-    SpatialTreeEntry &closest_entry = result_1.front();
-    SimpleWaypointPtr &closest_point = closest_entry.second;
-
-    return closest_point;
+    const WaypointIndex closest_index = waypoint_graph.GetClosestWaypoint(loc);
+    if (closest_index == INVALID_WAYPOINT_INDEX) {
+      return nullptr;
+    }
+    return dense_topology.at(closest_index);
   }
 
   NodeList InMemoryMap::GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const {
-    Point3D query_point(loc.x, loc.y, loc.z);
-
-    Point3D lower_p1(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
-    Point3D lower_p2(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
-    Point3D upper_p1(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
-    Point3D upper_p2(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
-
-    Box lower_query_box(lower_p2, lower_p1);
-    Box upper_query_box(upper_p2, upper_p1);
+    const cg::Location lower_p1(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
+    const cg::Location lower_p2(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
+    const cg::Location upper_p1(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
+    const cg::Location upper_p2(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
 
     NodeList result;
-    uint8_t x = 0;
-    for (Rtree::const_query_iterator
-        it = rtree.qbegin(bgi::within(upper_query_box)
-        && !bgi::within(lower_query_box)
-        && bgi::satisfies([&](SpatialTreeEntry const& v) { return !v.second->CheckJunction();}));
-        it != rtree.qend();
-        ++it) {
-    x++;
-    result.push_back(it->second);
-    if (x >= n_points)
-        break;
+    if (n_points == 0u) {
+      return result;
     }
+    waypoint_graph.ForEachWaypointInBox(upper_p2, upper_p1, [&](const WaypointIndex index) {
+      const cg::Location &location = waypoint_graph.GetLocation(index);
+      const bool in_lower_box = location.x > lower_p2.x && location.x < lower_p1.x &&
+                                location.y > lower_p2.y && location.y < lower_p1.y;
+      if (!in_lower_box && !waypoint_graph.CheckJunction(index)) {
+        result.push_back(dense_topology.at(index));
+      }
+      return result.size() < n_points;
+    });
 
     return result;
   }
@@ -501,6 +585,14 @@ namespace traffic_manager {
     return dense_topology;
   }
 
+  const WaypointGraph &InMemoryMap::GetWaypointGraph() const {
+    return waypoint_graph;
+  }
+
+  const SimpleWaypointPtr &InMemoryMap::GetWaypointByIndex(const WaypointIndex index) const {
+    return dense_topology.at(index);
+  }
+
   void InMemoryMap::FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint) {
 
     const WaypointPtr raw_waypoint = reference_waypoint->GetWaypoint();
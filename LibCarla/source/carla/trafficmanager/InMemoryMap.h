@@ -7,13 +7,13 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <memory>
+#include <set>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
-
-#include "boost/geometry.hpp"
-#include "boost/geometry/geometries/point.hpp"
-#include "boost/geometry/index/rtree.hpp"
+#include <vector>
 
 #include "carla/client/Map.h"
 #include "carla/client/Waypoint.h"
@@ -25,6 +25,7 @@
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 #include "carla/trafficmanager/CachedSimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointGraph.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -32,8 +33,6 @@ namespace traffic_manager {
 namespace cg = carla::geom;
 namespace cc = carla::client;
 namespace crd = carla::road;
-namespace bg = boost::geometry;
-namespace bgi = boost::geometry::index;
 
   using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
   using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
@@ -41,14 +40,9 @@ namespace bgi = boost::geometry::index;
   using GeoGridId = crd::JuncId;
   using WorldMap = carla::SharedPtr<const cc::Map>;
 
-  using Point3D = bg::model::point<float, 3, bg::cs::cartesian>;
-  using Box = bg::model::box<Point3D>;
-  using SpatialTreeEntry = std::pair<Point3D, SimpleWaypointPtr>;
-
   using SegmentId = std::tuple<crd::RoadId, crd::LaneId, crd::SectionId>;
   using SegmentTopology = std::map<SegmentId, std::pair<std::vector<SegmentId>, std::vector<SegmentId>>>;
   using SegmentMap = std::map<SegmentId, std::vector<SimpleWaypointPtr>>;
-  using Rtree = bgi::rtree<SpatialTreeEntry, bgi::rstar<16>>;
 
   /// This class builds a discretized local map-cache.
   /// Instantiate the class with the world and run SetUp() to construct the
@@ -62,8 +56,9 @@ namespace bgi = boost::geometry::index;
     /// Structure to hold all custom waypoint objects after interpolation of
     /// sparse topology.
     NodeList dense_topology;
-    /// Spatial quadratic R-tree for indexing and querying waypoints.
-    Rtree rtree;
+    /// Compact graph of the dense topology, indexed like dense_topology. It
+    /// also indexes the waypoint locations for spatial queries.
+    WaypointGraph waypoint_graph;
 
   public:
 
@@ -72,7 +67,9 @@ namespace bgi = boost::geometry::index;
 
     static void Cook(WorldMap world_map, const std::string& path);
 
-    //bool Load(const std::string& filename);
+    /// Loads a cooked map, memory-mapping the file so the waypoint graph is
+    /// used in place.
+    bool Load(const std::string& filename);
     bool Load(const std::vector<uint8_t>& content);
 
     /// This method constructs the local map with a resolution of sampling_resolution.
@@ -87,6 +84,12 @@ namespace bgi = boost::geometry::index;
     /// This method returns the full list of discrete samples of the map in the local cache.
     NodeList GetDenseTopology() const;
 
+    /// This method returns the compact graph of the discrete samples of the map.
+    const WaypointGraph &GetWaypointGraph() const;
+
+    /// This method returns the waypoint at the given position of the dense topology.
+    const SimpleWaypointPtr &GetWaypointByIndex(const WaypointIndex index) const;
+
     std::string GetMapName();
 
     const cc::Map& GetMap() const;
@@ -95,8 +98,19 @@ namespace bgi = boost::geometry::index;
     void Save(const std::string& path);
 
     void SetUpDenseTopology();
-    void SetUpSpatialTree();
+    void SetUpSpatialIndex();
     void SetUpRoadOption();
+    void SetUpWaypointGraph();
+
+    /// Creates the SimpleWaypoints of a cooked waypoint graph that is in use.
+    /// Their carla waypoints are only retrieved when needed.
+    void SetUpFromWaypointGraph();
+
+    /// Loads a cooked file written before the waypoint graph was stored.
+    bool LoadLegacy(const std::vector<uint8_t>& content);
+
+    /// Identifies the OpenDRIVE map a cooked file was built from.
+    uint64_t GetOpenDriveChecksum() const;
 
     /// This method is used to find and place lane change links.
     void FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint);
@@ -36,10 +36,12 @@ LocalizationStage::LocalizationStage(
 void LocalizationStage::Update(const unsigned long index) {
 
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(actor_id);
+  const VehicleParameters &vehicle_parameters = parameters.GetSnapshot().vehicles.at(index);
+  const cg::Location vehicle_location = simulation_state.GetLocation(index);
+  const cg::Vector3D heading_vector = simulation_state.GetHeading(index);
+  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(index);
   const float vehicle_speed = vehicle_velocity_vector.Length();
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
 
   // Speed dependent waypoint horizon length.
   float horizon_length = std::max(vehicle_speed * HORIZON_RATE, MINIMUM_HORIZON_LENGTH);
@@ -55,8 +57,8 @@ void LocalizationStage::Update(const unsigned long index) {
 
   // Clear buffer if vehicle is too far from the first waypoint in the buffer.
   if (!waypoint_buffer.empty() &&
-      cg::Math::DistanceSquared(waypoint_buffer.front()->GetLocation(),
-                                vehicle_location) > SQUARE(MAX_START_DISTANCE)) {
+      waypoint_graph.DistanceSquared(waypoint_buffer.front()->GetIndex(),
+                                     vehicle_location) > SQUARE(MAX_START_DISTANCE)) {
 
     auto number_of_pops = waypoint_buffer.size();
     for (uint64_t j = 0u; j < number_of_pops; ++j) {
@@ -67,24 +69,24 @@ void LocalizationStage::Update(const unsigned long index) {
   bool is_at_junction_entrance = false;
   if (!waypoint_buffer.empty()) {
     // Purge passed waypoints.
-    float dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_buffer.front()->GetLocation());
+    float dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_graph.GetLocation(waypoint_buffer.front()->GetIndex()));
     while (dot_product <= 0.0f && !waypoint_buffer.empty()) {
       PopWaypoint(actor_id, track_traffic, waypoint_buffer);
       if (!waypoint_buffer.empty()) {
-        dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_buffer.front()->GetLocation());
+        dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_graph.GetLocation(waypoint_buffer.front()->GetIndex()));
       }
     }
 
     if (!waypoint_buffer.empty()) {
       // Determine if the vehicle is at the entrance of a junction.
-      SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
-      SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
-      bool front_waypoint_junction = front_waypoint->CheckJunction();
-      is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
+      const WaypointIndex look_ahead_index = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first->GetIndex();
+      const WaypointIndex front_index = waypoint_buffer.front()->GetIndex();
+      bool front_waypoint_junction = waypoint_graph.CheckJunction(front_index);
+      is_at_junction_entrance = !front_waypoint_junction && waypoint_graph.CheckJunction(look_ahead_index);
       if (!is_at_junction_entrance) {
-        std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
+        const WaypointGraph::IndexRange last_passed_waypoints = waypoint_graph.GetPrevious(front_index);
         if (last_passed_waypoints.size() == 1) {
-          is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
+          is_at_junction_entrance = !waypoint_graph.CheckJunction(last_passed_waypoints.front()) && front_waypoint_junction;
         }
       }
       if (is_at_junction_entrance
@@ -98,28 +100,28 @@ void LocalizationStage::Update(const unsigned long index) {
     // Purge waypoints too far from the front of the buffer, but not if it has reached a junction.
     while (!is_at_junction_entrance
            && !waypoint_buffer.empty()
-           && waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) > horizon_square + horizon_square
-           && !waypoint_buffer.back()->CheckJunction()) {
+           && waypoint_graph.DistanceSquared(waypoint_buffer.back()->GetIndex(),
+                                             waypoint_buffer.front()->GetIndex()) > horizon_square + horizon_square
+           && !waypoint_graph.CheckJunction(waypoint_buffer.back()->GetIndex())) {
       PopWaypoint(actor_id, track_traffic, waypoint_buffer, false);
     }
   }
 
   // Initializing buffer if it is empty.
   if (waypoint_buffer.empty()) {
-    SimpleWaypointPtr closest_waypoint = local_map->GetWaypoint(vehicle_location);
-    PushWaypoint(actor_id, track_traffic, waypoint_buffer, closest_waypoint);
+    PushWaypoint(actor_id, track_traffic, waypoint_buffer, local_map->GetWaypoint(vehicle_location));
   }
 
   // Assign a lane change.
-  const ChangeLaneInfo lane_change_info = parameters.GetForceLaneChange(actor_id);
+  const ChangeLaneInfo lane_change_info = vehicle_parameters.force_lane_change;
   bool force_lane_change = lane_change_info.change_lane;
   bool lane_change_direction = lane_change_info.direction;
 
   // Apply parameters for keep right rule and random lane changes.
   if (!force_lane_change && vehicle_speed > MIN_LANE_CHANGE_SPEED){
-    const float perc_keep_right = parameters.GetKeepRightPercentage(actor_id);
-    const float perc_random_leftlanechange = parameters.GetRandomLeftLaneChangePercentage(actor_id);
-    const float perc_random_rightlanechange = parameters.GetRandomRightLaneChangePercentage(actor_id);
+    const float perc_keep_right = vehicle_parameters.perc_keep_right;
+    const float perc_random_leftlanechange = vehicle_parameters.perc_random_left;
+    const float perc_random_rightlanechange = vehicle_parameters.perc_random_right;
     const bool is_keep_right = perc_keep_right > random_device.next();
     const bool is_random_left_change = perc_random_leftlanechange >= random_device.next();
     const bool is_random_right_change = perc_random_rightlanechange >= random_device.next();
@@ -140,27 +142,27 @@ void LocalizationStage::Update(const unsigned long index) {
     }
   }
 
-  const SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
+  const WaypointIndex front_index = waypoint_buffer.front()->GetIndex();
   const float lane_change_distance = SQUARE(std::max(10.0f * vehicle_speed, INTER_LANE_CHANGE_DISTANCE));
 
   bool recently_not_executed_lane_change = last_lane_change_swpt.find(actor_id) == last_lane_change_swpt.end();
   bool done_with_previous_lane_change = true;
   if (!recently_not_executed_lane_change) {
-    float distance_frm_previous = cg::Math::DistanceSquared(last_lane_change_swpt.at(actor_id)->GetLocation(), vehicle_location);
+    float distance_frm_previous = waypoint_graph.DistanceSquared(last_lane_change_swpt.at(actor_id), vehicle_location);
     done_with_previous_lane_change = distance_frm_previous > lane_change_distance;
     if (done_with_previous_lane_change) last_lane_change_swpt.erase(actor_id);
   }
-  bool auto_or_force_lane_change = parameters.GetAutoLaneChange(actor_id) || force_lane_change;
-  bool front_waypoint_not_junction = !front_waypoint->CheckJunction();
+  bool auto_or_force_lane_change = vehicle_parameters.auto_lane_change || force_lane_change;
+  bool front_waypoint_not_junction = !waypoint_graph.CheckJunction(front_index);
 
   if (auto_or_force_lane_change
       && front_waypoint_not_junction
       && (recently_not_executed_lane_change || done_with_previous_lane_change)) {
 
-    SimpleWaypointPtr change_over_point = AssignLaneChange(actor_id, vehicle_location, vehicle_speed,
-                                                           force_lane_change, lane_change_direction);
+    WaypointIndex change_over_point = AssignLaneChange(actor_id, vehicle_location, vehicle_speed,
+                                                       force_lane_change, lane_change_direction);
 
-    if (change_over_point != nullptr) {
+    if (change_over_point != INVALID_WAYPOINT_INDEX) {
       if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
         last_lane_change_swpt.at(actor_id) = change_over_point;
       } else {
@@ -170,12 +172,18 @@ void LocalizationStage::Update(const unsigned long index) {
       for (uint64_t j = 0u; j < number_of_pops; ++j) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer);
       }
-      PushWaypoint(actor_id, track_traffic, waypoint_buffer, change_over_point);
+      PushWaypoint(actor_id, track_traffic, waypoint_buffer, local_map->GetWaypointByIndex(change_over_point));
     }
   }
 
-  Path imported_path = parameters.GetCustomPath(actor_id);
-  Route imported_actions = parameters.GetImportedRoute(actor_id);
+  Path imported_path;
+  Route imported_actions;
+  if (vehicle_parameters.has_custom_path) {
+    imported_path = parameters.GetCustomPath(actor_id);
+  }
+  if (imported_path.empty() && vehicle_parameters.has_imported_route) {
+    imported_actions = parameters.GetImportedRoute(actor_id);
+  }
   // We are effectively importing a path.
   if (!imported_path.empty()) {
 
@@ -189,24 +197,24 @@ void LocalizationStage::Update(const unsigned long index) {
 
   // Populating the buffer through randomly chosen waypoints.
   else {
-    while (waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
-      SimpleWaypointPtr furthest_waypoint = waypoint_buffer.back();
-      std::vector<SimpleWaypointPtr> next_waypoints = furthest_waypoint->GetNextWaypoint();
+    const WaypointIndex buffer_front_index = waypoint_buffer.front()->GetIndex();
+    while (waypoint_graph.DistanceSquared(waypoint_buffer.back()->GetIndex(), buffer_front_index) <= horizon_square) {
+      const WaypointGraph::IndexRange next_waypoints = waypoint_graph.GetNext(waypoint_buffer.back()->GetIndex());
       uint64_t selection_index = 0u;
       // Pseudo-randomized path selection if found more than one choice.
       if (next_waypoints.size() > 1) {
         double r_sample = random_device.next();
         selection_index = static_cast<uint64_t>(r_sample*next_waypoints.size()*0.01);
       } else if (next_waypoints.size() == 0) {
-        if (!parameters.GetOSMMode()) {
+        if (!parameters.GetSnapshot().osm_mode) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
         marked_for_removal.push_back(actor_id);
         break;
       }
-      SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
-      PushWaypoint(actor_id, track_traffic, waypoint_buffer, next_wp_selection);
-      if (next_wp_selection->GetId() == waypoint_buffer.front()->GetId()){
+      const WaypointIndex next_wp_selection = next_waypoints[selection_index];
+      PushWaypoint(actor_id, track_traffic, waypoint_buffer, local_map->GetWaypointByIndex(next_wp_selection));
+      if (waypoint_graph.GetId(next_wp_selection) == waypoint_graph.GetId(buffer_front_index)){
         // Found a loop, stop. Don't use zero distance as there can be two waypoints at the same location
         break;
       }
@@ -219,24 +227,25 @@ void LocalizationStage::Update(const unsigned long index) {
   output.is_at_junction_entrance = is_at_junction_entrance;
 
   if (is_at_junction_entrance) {
-    const SimpleWaypointPair &safe_space_end_points = vehicles_at_junction_entrance.at(actor_id);
+    const WaypointIndexPair &safe_space_end_points = vehicles_at_junction_entrance.at(actor_id);
     output.junction_end_point = safe_space_end_points.first;
     output.safe_point = safe_space_end_points.second;
   } else {
-    output.junction_end_point = nullptr;
-    output.safe_point = nullptr;
+    output.junction_end_point = INVALID_WAYPOINT_INDEX;
+    output.safe_point = INVALID_WAYPOINT_INDEX;
   }
 
   // Updating geodesic grid position for actor.
-  track_traffic.UpdateGridPosition(actor_id, waypoint_buffer);
+  track_traffic.UpdateGridPosition(actor_id, waypoint_buffer, waypoint_graph);
 }
 
 void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
                                                const bool is_at_junction_entrance,
                                                Buffer &waypoint_buffer) {
 
-  SimpleWaypointPtr junction_end_point = nullptr;
-  SimpleWaypointPtr safe_point_after_junction = nullptr;
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+  WaypointIndex junction_end_point = INVALID_WAYPOINT_INDEX;
+  WaypointIndex safe_point_after_junction = INVALID_WAYPOINT_INDEX;
 
   if (is_at_junction_entrance
       && vehicles_at_junction_entrance.find(actor_id) == vehicles_at_junction_entrance.end()) {
@@ -244,22 +253,22 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
     bool entered_junction = false;
     bool past_junction = false;
     bool safe_point_found = false;
-    SimpleWaypointPtr current_waypoint = nullptr;
-    SimpleWaypointPtr junction_begin_point = nullptr;
+    WaypointIndex current_waypoint = INVALID_WAYPOINT_INDEX;
+    WaypointIndex junction_begin_point = INVALID_WAYPOINT_INDEX;
     float safe_distance_squared = SQUARE(SAFE_DISTANCE_AFTER_JUNCTION);
 
     // Scanning existing buffer points.
     for (unsigned long i = 0u; i < waypoint_buffer.size() && !safe_point_found; ++i) {
-      current_waypoint = waypoint_buffer.at(i);
-      if (!entered_junction && current_waypoint->CheckJunction()) {
+      current_waypoint = waypoint_buffer.at(i)->GetIndex();
+      if (!entered_junction && waypoint_graph.CheckJunction(current_waypoint)) {
         entered_junction = true;
         junction_begin_point = current_waypoint;
       }
-      if (entered_junction && !past_junction && !current_waypoint->CheckJunction()) {
+      if (entered_junction && !past_junction && !waypoint_graph.CheckJunction(current_waypoint)) {
         past_junction = true;
         junction_end_point = current_waypoint;
       }
-      if (past_junction && junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared) {
+      if (past_junction && waypoint_graph.DistanceSquared(junction_end_point, current_waypoint) > safe_distance_squared) {
         safe_point_found = true;
         safe_point_after_junction = current_waypoint;
       }
@@ -270,11 +279,11 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       bool abort = false;
 
       while (!past_junction && !abort) {
-        NodeList next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointGraph::IndexRange next_waypoints = waypoint_graph.GetNext(current_waypoint);
         if (!next_waypoints.empty()) {
           current_waypoint = next_waypoints.front();
-          PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
-          if (!current_waypoint->CheckJunction()) {
+          PushWaypoint(actor_id, track_traffic, waypoint_buffer, local_map->GetWaypointByIndex(current_waypoint));
+          if (!waypoint_graph.CheckJunction(current_waypoint)) {
             past_junction = true;
             junction_end_point = current_waypoint;
           }
@@ -284,17 +293,17 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
 
       while (!safe_point_found && !abort) {
-        std::vector<SimpleWaypointPtr> next_waypoints = current_waypoint->GetNextWaypoint();
-        if ((junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared)
+        const WaypointGraph::IndexRange next_waypoints = waypoint_graph.GetNext(current_waypoint);
+        if ((waypoint_graph.DistanceSquared(junction_end_point, current_waypoint) > safe_distance_squared)
             || next_waypoints.size() > 1
-            || current_waypoint->CheckJunction()) {
+            || waypoint_graph.CheckJunction(current_waypoint)) {
 
           safe_point_found = true;
           safe_point_after_junction = current_waypoint;
         } else {
           if (!next_waypoints.empty()) {
             current_waypoint = next_waypoints.front();
-            PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
+            PushWaypoint(actor_id, track_traffic, waypoint_buffer, local_map->GetWaypointByIndex(current_waypoint));
           } else {
             abort = true;
           }
@@ -302,12 +311,12 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
     }
 
-    if (junction_end_point != nullptr &&
-        safe_point_after_junction != nullptr &&
-        junction_begin_point->DistanceSquared(junction_end_point) < SQUARE(MIN_JUNCTION_LENGTH)) {
+    if (junction_end_point != INVALID_WAYPOINT_INDEX &&
+        safe_point_after_junction != INVALID_WAYPOINT_INDEX &&
+        waypoint_graph.DistanceSquared(junction_begin_point, junction_end_point) < SQUARE(MIN_JUNCTION_LENGTH)) {
 
-      junction_end_point = nullptr;
-      safe_point_after_junction = nullptr;
+      junction_end_point = INVALID_WAYPOINT_INDEX;
+      safe_point_after_junction = INVALID_WAYPOINT_INDEX;
     }
 
     vehicles_at_junction_entrance.insert({actor_id, {junction_end_point, safe_point_after_junction}});
@@ -322,21 +331,25 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
 void LocalizationStage::RemoveActor(ActorId actor_id) {
     last_lane_change_swpt.erase(actor_id);
     vehicles_at_junction.erase(actor_id);
+    vehicles_at_junction_entrance.erase(actor_id);
 }
 
 void LocalizationStage::Reset() {
   last_lane_change_swpt.clear();
   vehicles_at_junction.clear();
+  vehicles_at_junction_entrance.clear();
 }
 
-SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
-                                                      const cg::Location vehicle_location,
-                                                      const float vehicle_speed,
-                                                      bool force, bool direction) {
+WaypointIndex LocalizationStage::AssignLaneChange(const ActorId actor_id,
+                                                  const cg::Location vehicle_location,
+                                                  const float vehicle_speed,
+                                                  bool force, bool direction) {
+
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
 
   // Waypoint representing the new starting point for the waypoint buffer
-  // due to lane change. Remains nullptr if lane change not viable.
-  SimpleWaypointPtr change_over_point = nullptr;
+  // due to lane change. Remains invalid if lane change not viable.
+  WaypointIndex change_over_point = INVALID_WAYPOINT_INDEX;
 
   // Retrieve waypoint buffer for current vehicle.
   const Buffer &waypoint_buffer = buffer_map.at(actor_id);
@@ -345,8 +358,9 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
   if (!waypoint_buffer.empty()) {
     // Get the left and right waypoints for the current closest waypoint.
     const SimpleWaypointPtr &current_waypoint = waypoint_buffer.front();
-    const SimpleWaypointPtr left_waypoint = current_waypoint->GetLeftWaypoint();
-    const SimpleWaypointPtr right_waypoint = current_waypoint->GetRightWaypoint();
+    const WaypointIndex current_index = current_waypoint->GetIndex();
+    const WaypointIndex left_waypoint = waypoint_graph.GetLeft(current_index);
+    const WaypointIndex right_waypoint = waypoint_graph.GetRight(current_index);
 
     // Retrieve vehicles with overlapping waypoint buffers with current vehicle.
     const auto blocking_vehicles = track_traffic.GetOverlappingVehicles(actor_id);
@@ -363,21 +377,20 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
       if (buffer_map.find(other_actor_id) != buffer_map.end() && !buffer_map.at(other_actor_id).empty()) {
         const Buffer &other_buffer = buffer_map.at(other_actor_id);
         const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
-        const cg::Location other_location = other_current_waypoint->GetLocation();
+        const WaypointIndex other_current_index = other_current_waypoint->GetIndex();
+        const cg::Location &other_location = waypoint_graph.GetLocation(other_current_index);
 
-        const cg::Vector3D reference_heading = current_waypoint->GetForwardVector();
-        cg::Vector3D reference_to_other = other_location - current_waypoint->GetLocation();
-        const cg::Vector3D other_heading = other_current_waypoint->GetForwardVector();
+        const cg::Vector3D &reference_heading = waypoint_graph.GetForwardVector(current_index);
+        cg::Vector3D reference_to_other = other_location - waypoint_graph.GetLocation(current_index);
+        const cg::Vector3D &other_heading = waypoint_graph.GetForwardVector(other_current_index);
 
-        WaypointPtr current_raw_waypoint = current_waypoint->GetWaypoint();
-        WaypointPtr other_current_raw_waypoint = other_current_waypoint->GetWaypoint();
         // Check both vehicles are not in junction,
         // Check if the other vehicle is in front of the current vehicle,
         // Check if the two vehicles have acceptable angular deviation between their headings.
-        if (!current_waypoint->CheckJunction()
-            && !other_current_waypoint->CheckJunction()
-            && other_current_raw_waypoint->GetRoadId() == current_raw_waypoint->GetRoadId()
-            && other_current_raw_waypoint->GetLaneId() == current_raw_waypoint->GetLaneId()
+        if (!waypoint_graph.CheckJunction(current_index)
+            && !waypoint_graph.CheckJunction(other_current_index)
+            && waypoint_graph.GetRoadId(other_current_index) == waypoint_graph.GetRoadId(current_index)
+            && waypoint_graph.GetLaneId(other_current_index) == waypoint_graph.GetLaneId(current_index)
             && cg::Math::Dot(reference_heading, reference_to_other) > 0.0f
             && cg::Math::Dot(reference_heading, other_heading) > MAXIMUM_LANE_OBSTACLE_CURVATURE) {
           float squared_distance = cg::Math::DistanceSquared(vehicle_location, other_location);
@@ -398,9 +411,9 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
     // If a valid immediate obstacle found.
     if (!obstacle_too_close && obstacle_actor_id != 0u && !force) {
       const Buffer &other_buffer = buffer_map.at(obstacle_actor_id);
-      const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
-      const auto other_neighbouring_lanes = {other_current_waypoint->GetLeftWaypoint(),
-                                             other_current_waypoint->GetRightWaypoint()};
+      const WaypointIndex other_current_index = other_buffer.front()->GetIndex();
+      const auto other_neighbouring_lanes = {waypoint_graph.GetLeft(other_current_index),
+                                             waypoint_graph.GetRight(other_current_index)};
 
       // Flags reflecting whether adjacent lanes are free near the obstacle.
       bool distant_left_lane_free = false;
@@ -409,8 +422,8 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
       // Check if the neighbouring lanes near the obstructing vehicle are free of other vehicles.
       bool left_right = true;
       for (auto &candidate_lane_wp : other_neighbouring_lanes) {
-        if (candidate_lane_wp != nullptr &&
-            track_traffic.GetPassingVehicles(candidate_lane_wp->GetId()).size() == 0) {
+        if (candidate_lane_wp != INVALID_WAYPOINT_INDEX &&
+            track_traffic.GetPassingVehicles(waypoint_graph.GetId(candidate_lane_wp)).size() == 0) {
 
           if (left_right)
             distant_left_lane_free = true;
@@ -422,27 +435,27 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
 
       // Based on what lanes are free near the obstacle,
       // find the change over point with no vehicles passing through them.
-      if (distant_right_lane_free && right_waypoint != nullptr
-          && track_traffic.GetPassingVehicles(right_waypoint->GetId()).size() == 0) {
+      if (distant_right_lane_free && right_waypoint != INVALID_WAYPOINT_INDEX
+          && track_traffic.GetPassingVehicles(waypoint_graph.GetId(right_waypoint)).size() == 0) {
         change_over_point = right_waypoint;
-      } else if (distant_left_lane_free && left_waypoint != nullptr
-               && track_traffic.GetPassingVehicles(left_waypoint->GetId()).size() == 0) {
+      } else if (distant_left_lane_free && left_waypoint != INVALID_WAYPOINT_INDEX
+               && track_traffic.GetPassingVehicles(waypoint_graph.GetId(left_waypoint)).size() == 0) {
         change_over_point = left_waypoint;
       }
     } else if (force) {
-      if (direction && right_waypoint != nullptr) {
+      if (direction && right_waypoint != INVALID_WAYPOINT_INDEX) {
         change_over_point = right_waypoint;
-      } else if (!direction && left_waypoint != nullptr) {
+      } else if (!direction && left_waypoint != INVALID_WAYPOINT_INDEX) {
         change_over_point = left_waypoint;
       }
     }
 
-    if (change_over_point != nullptr) {
+    if (change_over_point != INVALID_WAYPOINT_INDEX) {
       const float change_over_distance = cg::Math::Clamp(1.5f * vehicle_speed, MIN_WPT_DISTANCE, MAX_WPT_DISTANCE);
-      const SimpleWaypointPtr starting_point = change_over_point;
-      while (change_over_point->DistanceSquared(starting_point) < SQUARE(change_over_distance) &&
-             !change_over_point->CheckJunction()) {
-        change_over_point = change_over_point->GetNextWaypoint().front();
+      const WaypointIndex starting_point = change_over_point;
+      while (waypoint_graph.DistanceSquared(change_over_point, starting_point) < SQUARE(change_over_distance) &&
+             !waypoint_graph.CheckJunction(change_over_point)) {
+        change_over_point = waypoint_graph.GetNext(change_over_point).front();
       }
     }
   }
@@ -476,7 +489,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
 
       // Choose correct path.
       if (next_waypoints.size() > 1) {
-        const float imported_road_id = imported->GetWaypoint()->GetRoadId();
+        const float imported_road_id = imported->GetRoadId();
         float min_distance = std::numeric_limits<float>::infinity();
         for (uint64_t k = 0u; k < next_waypoints.size(); ++k) {
           SimpleWaypointPtr junction_end_point = next_waypoints.at(k);
@@ -489,7 +502,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
           while (next_waypoints.at(k)->DistanceSquared(junction_end_point) < 50.0f) {
             junction_end_point = junction_end_point->GetNextWaypoint().front();
           }
-          float jep_road_id = junction_end_point->GetWaypoint()->GetRoadId();
+          float jep_road_id = junction_end_point->GetRoadId();
           if (jep_road_id == imported_road_id) {
             selection_index = k;
             break;
@@ -501,7 +514,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
           }
         }
       } else if (next_waypoints.size() == 0) {
-        if (!parameters.GetOSMMode()) {
+        if (!parameters.GetSnapshot().osm_mode) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
         marked_for_removal.push_back(actor_id);
@@ -564,7 +577,7 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
           }
         }
       } else if (next_waypoints.size() == 0) {
-        if (!parameters.GetOSMMode()) {
+        if (!parameters.GetSnapshot().osm_mode) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
         marked_for_removal.push_back(actor_id);
@@ -596,11 +609,12 @@ Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
   if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
     // A lane change is happening.
     is_lane_change = true;
-    const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - last_lane_change_swpt.at(actor_id)->GetLocation();
+    const unsigned long state_index = simulation_state.GetIndex(actor_id);
+    const cg::Vector3D heading_vector = simulation_state.GetHeading(state_index);
+    const cg::Vector3D relative_vector = simulation_state.GetLocation(state_index) - local_map->GetWaypointGraph().GetLocation(last_lane_change_swpt.at(actor_id));
     bool left_heading = (heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f;
-    if (left_heading) next_action = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
-    else next_action = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
+    if (left_heading) next_action = std::make_pair(RoadOption::ChangeLaneLeft, local_map->GetWaypointByIndex(last_lane_change_swpt.at(actor_id))->GetWaypoint());
+    else next_action = std::make_pair(RoadOption::ChangeLaneRight, local_map->GetWaypointByIndex(last_lane_change_swpt.at(actor_id))->GetWaypoint());
   }
   for (auto &swpt : waypoint_buffer) {
     RoadOption road_opt = swpt->GetRoadOption();
@@ -610,8 +624,8 @@ Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
         return std::make_pair(road_opt, swpt->GetWaypoint());
       } else {
         // A lane change will happen as well as another action, we need to figure out which one will happen first.
-        cg::Location lane_change = last_lane_change_swpt.at(actor_id)->GetLocation();
-        cg::Location actual_location = simulation_state.GetLocation(actor_id);
+        cg::Location lane_change = local_map->GetWaypointGraph().GetLocation(last_lane_change_swpt.at(actor_id));
+        cg::Location actual_location = simulation_state.GetLocation(simulation_state.GetIndex(actor_id));
         auto distance_lane_change = cg::Math::DistanceSquared(actual_location, lane_change);
         auto distance_other_action = cg::Math::DistanceSquared(actual_location, swpt->GetLocation());
         if (distance_lane_change < distance_other_action) return next_action;
@@ -634,11 +648,12 @@ ActionBuffer LocalizationStage::ComputeActionBuffer(const ActorId& actor_id) {
   if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
     // A lane change is happening.
     is_lane_change = true;
-    const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - last_lane_change_swpt.at(actor_id)->GetLocation();
+    const unsigned long state_index = simulation_state.GetIndex(actor_id);
+    const cg::Vector3D heading_vector = simulation_state.GetHeading(state_index);
+    const cg::Vector3D relative_vector = simulation_state.GetLocation(state_index) - local_map->GetWaypointGraph().GetLocation(last_lane_change_swpt.at(actor_id));
     bool left_heading = (heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f;
-    if (left_heading) lane_change = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
-    else lane_change = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
+    if (left_heading) lane_change = std::make_pair(RoadOption::ChangeLaneLeft, local_map->GetWaypointByIndex(last_lane_change_swpt.at(actor_id))->GetWaypoint());
+    else lane_change = std::make_pair(RoadOption::ChangeLaneRight, local_map->GetWaypointByIndex(last_lane_change_swpt.at(actor_id))->GetWaypoint());
   }
   for (auto &wpt : waypoint_buffer) {
     RoadOption current_road_opt = wpt->GetRoadOption();
@@ -0,0 +1,101 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/trafficmanager/MappedFile.h"
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace carla {
+namespace traffic_manager {
+
+#ifdef _WIN32
+
+  std::shared_ptr<MappedFile> MappedFile::Open(const std::string &path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    HANDLE handle = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+      return nullptr;
+    }
+    file->_file = handle;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+      return nullptr;
+    }
+    file->_mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (file->_mapping == nullptr) {
+      return nullptr;
+    }
+    file->_address = MapViewOfFile(file->_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (file->_address == nullptr) {
+      return nullptr;
+    }
+    file->_size = static_cast<size_t>(size.QuadPart);
+    return file;
+  }
+
+  MappedFile::~MappedFile() {
+    if (_address != nullptr) {
+      UnmapViewOfFile(_address);
+    }
+    if (_mapping != nullptr) {
+      CloseHandle(_mapping);
+    }
+    if (_file != nullptr) {
+      CloseHandle(_file);
+    }
+  }
+
+#else
+
+  std::shared_ptr<MappedFile> MappedFile::Open(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    struct stat info;
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+      const size_t size = static_cast<size_t>(info.st_size);
+      void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED) {
+        file->_address = address;
+        file->_size = size;
+      }
+    }
+    close(fd);
+    if (file->_address == nullptr) {
+      return nullptr;
+    }
+    return file;
+  }
+
+  MappedFile::~MappedFile() {
+    if (_address != nullptr) {
+      munmap(_address, _size);
+    }
+  }
+
+#endif // _WIN32
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,52 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace traffic_manager {
+
+  /// Read-only memory mapping of a whole file, unmapped on destruction.
+  class MappedFile : private NonCopyable {
+  public:
+
+    /// Maps the file at @a path, returns nullptr if it cannot be opened or
+    /// is empty.
+    static std::shared_ptr<MappedFile> Open(const std::string &path);
+
+    ~MappedFile();
+
+    const uint8_t *data() const {
+      return reinterpret_cast<const uint8_t *>(_address);
+    }
+
+    size_t size() const {
+      return _size;
+    }
+
+  private:
+
+    MappedFile() = default;
+
+    void *_address = nullptr;
+
+    size_t _size = 0u;
+
+#ifdef _WIN32
+    void *_file = nullptr;
+
+    void *_mapping = nullptr;
+#endif
+  };
+
+} // namespace traffic_manager
+} // namespace carla
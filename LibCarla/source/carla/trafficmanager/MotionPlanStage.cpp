@@ -62,18 +62,24 @@ MotionPlanStage::MotionPlanStage(
 
 void MotionPlanStage::Update(const unsigned long index) {
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(actor_id);
-  const cg::Rotation vehicle_rotation = simulation_state.GetRotation(actor_id);
+  const ParameterSnapshot &parameter_snapshot = parameters.GetSnapshot();
+  const VehicleParameters &vehicle_parameters = parameter_snapshot.vehicles.at(index);
+  const cg::Location vehicle_location = simulation_state.GetLocation(index);
+  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(index);
+  const cg::Rotation vehicle_rotation = simulation_state.GetRotation(index);
   const float vehicle_speed = vehicle_velocity.Length();
-  const cg::Vector3D vehicle_heading = simulation_state.GetHeading(actor_id);
-  const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(actor_id);
-  const float vehicle_speed_limit = simulation_state.GetSpeedLimit(actor_id);
+  const cg::Vector3D vehicle_heading = simulation_state.GetHeading(index);
+  const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(index);
+  const bool vehicle_dormant = simulation_state.IsDormant(index);
+  const float vehicle_speed_limit = simulation_state.GetSpeedLimit(index);
   const Buffer &waypoint_buffer = buffer_map.at(actor_id);
   const LocalizationData &localization = localization_frame.at(index);
   const CollisionHazardData &collision_hazard = collision_frame.at(index);
   const bool &tl_hazard = tl_frame.at(index);
-  current_timestamp = world.GetSnapshot().GetTimestamp();
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+  if (!parallel_update) {
+    current_timestamp = world.GetSnapshot().GetTimestamp();
+  }
   StateEntry current_state;
 
   // Instanciating teleportation transform as current vehicle transform.
@@ -83,58 +89,21 @@ void MotionPlanStage::Update(const unsigned long index) {
   cg::Location hero_location = track_traffic.GetHeroLocation();
   bool is_hero_alive = hero_location != cg::Location(0, 0, 0);
 
-  if (simulation_state.IsDormant(actor_id) && parameters.GetRespawnDormantVehicles() && is_hero_alive) {
-    // Flushing controller state for vehicle.
-    current_state = {current_timestamp,
-                    0.0f, 0.0f,
-                    0.0f};
-
-    // Add entry to teleportation duration clock table if not present.
-    if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-      teleportation_instance.insert({actor_id, current_timestamp});
-    }
-
-    // Get lower and upper bound for teleporting vehicle.
-    float lower_bound = parameters.GetLowerBoundaryRespawnDormantVehicles();
-    float upper_bound = parameters.GetUpperBoundaryRespawnDormantVehicles();
-    float dilate_factor = (upper_bound-lower_bound)/100.0f;
-
-    // Measuring time elapsed since last teleportation for the vehicle.
-    double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
-
-    if (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT) {
-      float random_sample = (static_cast<float>(random_device.next())*dilate_factor) + lower_bound;
-      NodeList teleport_waypoint_list = local_map->GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
-      if (!teleport_waypoint_list.empty()) {
-        for (auto &teleport_waypoint : teleport_waypoint_list) {
-          GeoGridId geogrid_id = teleport_waypoint->GetGeodesicGridId();
-          if (track_traffic.IsGeoGridFree(geogrid_id)) {
-            teleportation_transform = teleport_waypoint->GetTransform();
-            teleportation_transform.location.z += 0.5f;
-            track_traffic.AddTakenGrid(geogrid_id, actor_id);
-            break;
-          }
-        }
-      }
+  if (vehicle_dormant && parameter_snapshot.respawn_dormant_vehicles && is_hero_alive) {
+    if (parallel_update) {
+      parallel_results.at(index).respawn = true;
+    } else {
+      RespawnDormantVehicle(index);
     }
-    output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
-
-    // Update the simulation state with the new transform of the vehicle after teleporting it.
-    KinematicState kinematic_state{teleportation_transform.location,
-                                   teleportation_transform.rotation,
-                                   vehicle_velocity, vehicle_speed_limit,
-                                   vehicle_physics_enabled, simulation_state.IsDormant(actor_id),
-                                   teleportation_transform.location};
-    simulation_state.UpdateKinematicState(actor_id, kinematic_state);
   }
 
   else {
 
     // Target velocity for vehicle.
-    float max_target_velocity = parameters.GetVehicleTargetVelocity(actor_id, vehicle_speed_limit) / 3.6f;
+    float max_target_velocity = vehicle_parameters.GetTargetVelocity(vehicle_speed_limit) / 3.6f;
 
     // Algorithm to reduce speed near landmarks
-    float max_landmark_target_velocity = GetLandmarkTargetVelocity(*(waypoint_buffer.at(0)), vehicle_location, actor_id, max_target_velocity);
+    float max_landmark_target_velocity = GetLandmarkTargetVelocity(*(waypoint_buffer.at(0)), vehicle_location, vehicle_parameters, max_target_velocity);
 
     // Algorithm to reduce speed near turns
     float max_turn_target_velocity = GetTurnTargetVelocity(waypoint_buffer, max_target_velocity);
@@ -152,16 +121,16 @@ void MotionPlanStage::Update(const unsigned long index) {
     // In case of collision or traffic light hazard.
     bool emergency_stop = tl_hazard || collision_emergency_stop || !safe_after_junction;
 
-    if (vehicle_physics_enabled && !simulation_state.IsDormant(actor_id)) {
+    if (vehicle_physics_enabled && !vehicle_dormant) {
       ActuationSignal actuation_signal{0.0f, 0.0f, 0.0f};
 
       const float target_point_distance = std::max(vehicle_speed * TARGET_WAYPOINT_TIME_HORIZON,
                                                   MIN_TARGET_WAYPOINT_DISTANCE);
-      const SimpleWaypointPtr &target_waypoint = GetTargetWaypoint(waypoint_buffer, target_point_distance).first;
-      cg::Location target_location = target_waypoint->GetLocation();
+      const WaypointIndex target_waypoint = GetTargetWaypoint(waypoint_buffer, target_point_distance).first->GetIndex();
+      cg::Location target_location = waypoint_graph.GetLocation(target_waypoint);
 
-      float offset = parameters.GetLaneOffset(actor_id);
-      auto right_vector = target_waypoint->GetTransform().GetRightVector();
+      float offset = vehicle_parameters.lane_offset;
+      auto right_vector = waypoint_graph.GetTransform(target_waypoint).GetRightVector();
       auto offset_location = cg::Location(cg::Vector3D(offset*right_vector.x, offset*right_vector.y, 0.0f));
       target_location = target_location + offset_location;
 
@@ -173,16 +142,13 @@ void MotionPlanStage::Update(const unsigned long index) {
       }
       const float angular_deviation = dot_product;
       const float velocity_deviation = (dynamic_target_velocity - vehicle_speed) / dynamic_target_velocity;
-      // If previous state for vehicle not found, initialize state entry.
-      if (pid_state_map.find(actor_id) == pid_state_map.end()) {
-        const auto initial_state = StateEntry{current_timestamp, 0.0f, 0.0f, 0.0f};
-        pid_state_map.insert({actor_id, initial_state});
+      // Retrieving the previous state, initial state if not found.
+      traffic_manager::StateEntry previous_state{current_timestamp, 0.0f, 0.0f, 0.0f};
+      const auto pid_state = pid_state_map.find(actor_id);
+      if (pid_state != pid_state_map.end()) {
+        previous_state = pid_state->second;
       }
 
-      // Retrieving the previous state.
-      traffic_manager::StateEntry previous_state;
-      previous_state = pid_state_map.at(actor_id);
-
       // Select PID parameters.
       std::vector<float> longitudinal_parameters;
       std::vector<float> lateral_parameters;
@@ -218,8 +184,7 @@ void MotionPlanStage::Update(const unsigned long index) {
 
       // Updating PID state.
       current_state.steer = actuation_signal.steer;
-      StateEntry &state = pid_state_map.at(actor_id);
-      state = current_state;
+      SetPIDState(index, actor_id, current_state);
     }
     // For physics-less vehicles, determine position and orientation for teleportation.
     else {
@@ -228,23 +193,18 @@ void MotionPlanStage::Update(const unsigned long index) {
                       0.0f, 0.0f,
                       0.0f};
 
-      // Add entry to teleportation duration clock table if not present.
-      if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-        teleportation_instance.insert({actor_id, current_timestamp});
-      }
-
       // Measuring time elapsed since last teleportation for the vehicle.
-      double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
+      double elapsed_time = current_timestamp.elapsed_seconds - GetTeleportationInstance(index, actor_id).elapsed_seconds;
 
       // Find a location ahead of the vehicle for teleportation to achieve intended velocity.
-      if (!emergency_stop && (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT)) {
+      if (!emergency_stop && (parameter_snapshot.synchronous_mode || elapsed_time > HYBRID_MODE_DT)) {
 
         // Target displacement magnitude to achieve target velocity.
         const float target_displacement = dynamic_target_velocity * HYBRID_MODE_DT_FL;
-        SimpleWaypointPtr teleport_target = waypoint_buffer.front();
-        cg::Transform target_base_transform = teleport_target->GetTransform();
+        const WaypointIndex teleport_target = waypoint_buffer.front()->GetIndex();
+        cg::Transform target_base_transform = waypoint_graph.GetTransform(teleport_target);
         cg::Location target_base_location = target_base_transform.location;
-        cg::Vector3D target_heading = target_base_transform.GetForwardVector();
+        cg::Vector3D target_heading = waypoint_graph.GetForwardVector(teleport_target);
         cg::Vector3D correct_heading = (target_base_location - vehicle_location).MakeSafeUnitVector(EPSILON);
 
         if (vehicle_location.Distance(target_base_location) < target_displacement) {
@@ -258,31 +218,102 @@ void MotionPlanStage::Update(const unsigned long index) {
       // In case of an emergency stop, stay in the same location.
       // Also, teleport only once every dt in asynchronous mode.
       } else {
-        teleportation_transform = cg::Transform(vehicle_location, simulation_state.GetRotation(actor_id));
+        teleportation_transform = cg::Transform(vehicle_location, vehicle_rotation);
       }
       // Constructing the actuation signal.
       output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
-      simulation_state.UpdateKinematicHybridEndLocation(actor_id, teleportation_transform.location);
+      simulation_state.UpdateKinematicHybridEndLocation(index, teleportation_transform.location);
+    }
+  }
+}
+
+void MotionPlanStage::RespawnDormantVehicle(const unsigned long index) {
+  const ActorId actor_id = vehicle_id_list.at(index);
+  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(index);
+  const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(index);
+  const float vehicle_speed_limit = simulation_state.GetSpeedLimit(index);
+  const cg::Location hero_location = track_traffic.GetHeroLocation();
+
+  // Instanciating teleportation transform as current vehicle transform.
+  cg::Transform teleportation_transform = cg::Transform(simulation_state.GetLocation(index),
+                                                        simulation_state.GetRotation(index));
+
+  // Get lower and upper bound for teleporting vehicle.
+  const ParameterSnapshot &parameter_snapshot = parameters.GetSnapshot();
+  float lower_bound = parameter_snapshot.respawn_lower_bound;
+  float upper_bound = parameter_snapshot.respawn_upper_bound;
+  float dilate_factor = (upper_bound-lower_bound)/100.0f;
+
+  // Measuring time elapsed since last teleportation for the vehicle.
+  double elapsed_time = current_timestamp.elapsed_seconds - GetTeleportationInstance(index, actor_id).elapsed_seconds;
+
+  if (parameter_snapshot.synchronous_mode || elapsed_time > HYBRID_MODE_DT) {
+    float random_sample = (static_cast<float>(random_device.next())*dilate_factor) + lower_bound;
+    NodeList teleport_waypoint_list = local_map->GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
+    if (!teleport_waypoint_list.empty()) {
+      for (auto &teleport_waypoint : teleport_waypoint_list) {
+        GeoGridId geogrid_id = teleport_waypoint->GetGeodesicGridId();
+        if (track_traffic.IsGeoGridFree(geogrid_id)) {
+          teleportation_transform = teleport_waypoint->GetTransform();
+          teleportation_transform.location.z += 0.5f;
+          track_traffic.AddTakenGrid(geogrid_id, actor_id);
+          break;
+        }
+      }
     }
   }
+  output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
+
+  // Update the simulation state with the new transform of the vehicle after teleporting it.
+  KinematicState kinematic_state{teleportation_transform.location,
+                                 teleportation_transform.rotation,
+                                 vehicle_velocity, vehicle_speed_limit,
+                                 vehicle_physics_enabled, simulation_state.IsDormant(index),
+                                 teleportation_transform.location};
+  simulation_state.UpdateKinematicState(index, kinematic_state);
+}
+
+cc::Timestamp MotionPlanStage::GetTeleportationInstance(const unsigned long index, const ActorId actor_id) {
+  const auto instance = teleportation_instance.find(actor_id);
+  if (instance != teleportation_instance.end()) {
+    return instance->second;
+  }
+  // Add entry to teleportation duration clock table if not present.
+  if (parallel_update) {
+    parallel_results.at(index).start_teleportation = true;
+  } else {
+    teleportation_instance.insert({actor_id, current_timestamp});
+  }
+  return current_timestamp;
+}
+
+void MotionPlanStage::SetPIDState(const unsigned long index, const ActorId actor_id, const StateEntry &state) {
+  if (parallel_update) {
+    ParallelUpdateResult &result = parallel_results.at(index);
+    result.update_pid_state = true;
+    result.pid_state = state;
+  } else {
+    pid_state_map[actor_id] = state;
+  }
 }
 
 bool MotionPlanStage::SafeAfterJunction(const LocalizationData &localization,
                                         const bool tl_hazard,
                                         const bool collision_emergency_stop) {
 
-  SimpleWaypointPtr junction_end_point = localization.junction_end_point;
-  SimpleWaypointPtr safe_point = localization.safe_point;
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+  const WaypointIndex junction_end_point = localization.junction_end_point;
+  const WaypointIndex safe_point = localization.safe_point;
 
   bool safe_after_junction = true;
   if (!tl_hazard && !collision_emergency_stop
       && localization.is_at_junction_entrance
-      && junction_end_point != nullptr && safe_point != nullptr
-      && junction_end_point->DistanceSquared(safe_point) > SQUARE(MIN_SAFE_INTERVAL_LENGTH)) {
+      && junction_end_point != INVALID_WAYPOINT_INDEX && safe_point != INVALID_WAYPOINT_INDEX
+      && waypoint_graph.DistanceSquared(junction_end_point, safe_point) > SQUARE(MIN_SAFE_INTERVAL_LENGTH)) {
 
-    ActorIdSet passing_safe_point = track_traffic.GetPassingVehicles(safe_point->GetId());
-    ActorIdSet passing_junction_end_point = track_traffic.GetPassingVehicles(junction_end_point->GetId());
-    cg::Location mid_point = (junction_end_point->GetLocation() + safe_point->GetLocation())/2.0f;
+    ActorIdSet passing_safe_point = track_traffic.GetPassingVehicles(waypoint_graph.GetId(safe_point));
+    ActorIdSet passing_junction_end_point = track_traffic.GetPassingVehicles(waypoint_graph.GetId(junction_end_point));
+    cg::Location mid_point = (waypoint_graph.GetLocation(junction_end_point) + waypoint_graph.GetLocation(safe_point))/2.0f;
 
     // Only check for vehicles that have the safe point in their passing waypoint, but not
     // the junction end point.
@@ -292,9 +323,10 @@ bool MotionPlanStage::SafeAfterJunction(const LocalizationData &localization,
                         std::inserter(difference, difference.begin()));
     if (difference.size() > 0) {
       for (const ActorId &blocking_id: difference) {
-        cg::Location blocking_actor_location = simulation_state.GetLocation(blocking_id);
+        const unsigned long blocking_index = simulation_state.GetIndex(blocking_id);
+        cg::Location blocking_actor_location = simulation_state.GetLocation(blocking_index);
         if (cg::Math::DistanceSquared(blocking_actor_location, mid_point) < SQUARE(MAX_JUNCTION_BLOCK_DISTANCE)
-            && simulation_state.GetVelocity(blocking_id).SquaredLength() < SQUARE(AFTER_JUNCTION_MIN_SPEED)) {
+            && simulation_state.GetVelocity(blocking_index).SquaredLength() < SQUARE(AFTER_JUNCTION_MIN_SPEED)) {
           safe_after_junction = false;
           break;
         }
@@ -316,7 +348,7 @@ std::pair<bool, float> MotionPlanStage::CollisionHandling(const CollisionHazardD
 
   if (collision_hazard.hazard && !tl_hazard) {
     const ActorId other_actor_id = collision_hazard.hazard_actor_id;
-    const cg::Vector3D other_velocity = simulation_state.GetVelocity(other_actor_id);
+    const cg::Vector3D other_velocity = simulation_state.GetVelocity(simulation_state.GetIndex(other_actor_id));
     const float vehicle_relative_speed = (vehicle_velocity - other_velocity).Length();
     const float available_distance_margin = collision_hazard.available_distance_margin;
 
@@ -360,7 +392,7 @@ std::pair<bool, float> MotionPlanStage::CollisionHandling(const CollisionHazardD
 
 float MotionPlanStage::GetLandmarkTargetVelocity(const SimpleWaypoint& waypoint,
                                                  const cg::Location vehicle_location,
-                                                 const ActorId actor_id,
+                                                 const VehicleParameters &vehicle_parameters,
                                                  float max_target_velocity) {
 
     auto const max_distance = LANDMARK_DETECTION_TIME * max_target_velocity;
@@ -388,7 +420,7 @@ float MotionPlanStage::GetLandmarkTargetVelocity(const SimpleWaypoint& waypoint,
         minimum_velocity = YIELD_TARGET_VELOCITY;
       } else if (landmark_type == "274") {  // Speed limit
         float value = static_cast<float>(landmark->GetValue()) / 3.6f;
-        value = parameters.GetVehicleTargetVelocity(actor_id, value);
+        value = vehicle_parameters.GetTargetVelocity(value);
         minimum_velocity = (value < max_target_velocity) ? value : max_target_velocity;
       } else {
         continue;
@@ -408,13 +440,14 @@ float MotionPlanStage::GetTurnTargetVelocity(const Buffer &waypoint_buffer,
     return max_target_velocity;
   }
   else {
-    const SimpleWaypointPtr first_waypoint = waypoint_buffer.front();
-    const SimpleWaypointPtr last_waypoint = waypoint_buffer.back();
-    const SimpleWaypointPtr middle_waypoint = waypoint_buffer.at(static_cast<uint16_t>(waypoint_buffer.size() / 2));
+    const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+    const WaypointIndex first_waypoint = waypoint_buffer.front()->GetIndex();
+    const WaypointIndex last_waypoint = waypoint_buffer.back()->GetIndex();
+    const WaypointIndex middle_waypoint = waypoint_buffer.at(static_cast<uint16_t>(waypoint_buffer.size() / 2))->GetIndex();
 
-    float radius = GetThreePointCircleRadius(first_waypoint->GetLocation(),
-                                             middle_waypoint->GetLocation(),
-                                             last_waypoint->GetLocation());
+    float radius = GetThreePointCircleRadius(waypoint_graph.GetLocation(first_waypoint),
+                                             waypoint_graph.GetLocation(middle_waypoint),
+                                             waypoint_graph.GetLocation(last_waypoint));
 
     // Return the max velocity at the turn
     return std::sqrt(radius * FRICTION * GRAVITY);
@@ -465,6 +498,30 @@ float MotionPlanStage::GetThreePointCircleRadius(cg::Location first_location,
   return std::sqrt(h * h + k * k - c);
 }
 
+void MotionPlanStage::PrepareParallelUpdate() {
+  current_timestamp = world.GetSnapshot().GetTimestamp();
+  parallel_results.clear();
+  parallel_results.resize(vehicle_id_list.size(), ParallelUpdateResult{false, StateEntry{}, false, false});
+  parallel_update = true;
+}
+
+void MotionPlanStage::FinishParallelUpdate() {
+  parallel_update = false;
+  for (unsigned long index = 0u; index < parallel_results.size(); ++index) {
+    const ActorId actor_id = vehicle_id_list.at(index);
+    const ParallelUpdateResult &result = parallel_results.at(index);
+    if (result.update_pid_state) {
+      pid_state_map[actor_id] = result.pid_state;
+    }
+    if (result.start_teleportation) {
+      teleportation_instance.insert({actor_id, current_timestamp});
+    }
+    if (result.respawn) {
+      RespawnDormantVehicle(index);
+    }
+  }
+}
+
 void MotionPlanStage::RemoveActor(const ActorId actor_id) {
   pid_state_map.erase(actor_id);
   teleportation_instance.erase(actor_id);
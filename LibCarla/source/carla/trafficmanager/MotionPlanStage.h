@@ -44,6 +44,24 @@ private:
   cc::Timestamp current_timestamp;
   RandomGenerator &random_device;
   const LocalMapPtr &local_map;
+  // State produced by the concurrent updates of the vehicles, stored into the
+  // maps above in index order by FinishParallelUpdate.
+  struct ParallelUpdateResult {
+    bool update_pid_state;
+    StateEntry pid_state;
+    bool start_teleportation;
+    bool respawn;
+  };
+  bool parallel_update {false};
+  std::vector<ParallelUpdateResult> parallel_results;
+
+  // Method to teleport a dormant vehicle close to the hero vehicle.
+  void RespawnDormantVehicle(const unsigned long index);
+
+  // Method to retrieve the time of the last teleportation of the vehicle.
+  cc::Timestamp GetTeleportationInstance(const unsigned long index, const ActorId actor_id);
+
+  void SetPIDState(const unsigned long index, const ActorId actor_id, const StateEntry &state);
 
   std::pair<bool, float> CollisionHandling(const CollisionHazardData &collision_hazard,
                                            const bool tl_hazard,
@@ -57,7 +75,7 @@ private:
 
   float GetLandmarkTargetVelocity(const SimpleWaypoint& waypoint,
                                   const cg::Location vehicle_location,
-                                  const ActorId actor_id,
+                                  const VehicleParameters &vehicle_parameters,
                                   float max_target_velocity);
 
   float GetTurnTargetVelocity(const Buffer &waypoint_buffer,
@@ -87,6 +105,14 @@ public:
 
   void Update(const unsigned long index);
 
+  // Method to make Update safe to call concurrently for different indices,
+  // until FinishParallelUpdate is called.
+  void PrepareParallelUpdate();
+
+  // Method to store the state computed by the concurrent updates and respawn
+  // the dormant vehicles, which take free grids from the shared track traffic.
+  void FinishParallelUpdate();
+
   void RemoveActor(const ActorId actor_id);
 
   void Reset();
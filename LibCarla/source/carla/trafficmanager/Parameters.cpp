@@ -14,10 +14,17 @@ Parameters::Parameters() {
 
   /// Set default synchronous mode time out.
   synchronous_time_out = std::chrono::duration<int, std::milli>(10);
+
+  /// Out of date until the first cycle.
+  snapshot = std::make_unique<const ParameterSnapshot>();
 }
 
 Parameters::~Parameters() {}
 
+void Parameters::MarkChanged() {
+  version.fetch_add(1u);
+}
+
 //////////////////////////////////// SETTERS //////////////////////////////////
 
 void Parameters::SetHybridPhysicsMode(const bool mode_switch) {
@@ -28,6 +35,7 @@ void Parameters::SetHybridPhysicsMode(const bool mode_switch) {
 void Parameters::SetRespawnDormantVehicles(const bool mode_switch) {
 
   respawn_dormant_vehicles.store(mode_switch);
+  MarkChanged();
 }
 
 void Parameters::SetMaxBoundaries(const float lower, const float upper) {
@@ -38,6 +46,7 @@ void Parameters::SetMaxBoundaries(const float lower, const float upper) {
 void Parameters::SetBoundariesRespawnDormantVehicles(const float lower_bound, const float upper_bound) {
   respawn_lower_bound = min_lower_bound > lower_bound ? min_lower_bound : lower_bound;
   respawn_upper_bound = max_upper_bound < upper_bound ? max_upper_bound : upper_bound;
+  MarkChanged();
 }
 
 void Parameters::SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage) {
@@ -47,11 +56,13 @@ void Parameters::SetPercentageSpeedDifference(const ActorPtr &actor, const float
   if (exact_desired_speed.Contains(actor->GetId())) {
     exact_desired_speed.RemoveEntry(actor->GetId());
   }
+  MarkChanged();
 }
 
 void Parameters::SetLaneOffset(const ActorPtr &actor, const float offset) {
   const auto entry = std::make_pair(actor->GetId(), offset);
   lane_offset.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetDesiredSpeed(const ActorPtr &actor, const float value) {
@@ -61,15 +72,18 @@ void Parameters::SetDesiredSpeed(const ActorPtr &actor, const float value) {
   if (percentage_difference_from_speed_limit.Contains(actor->GetId())) {
     percentage_difference_from_speed_limit.RemoveEntry(actor->GetId());
   }
+  MarkChanged();
 }
 
 void Parameters::SetGlobalPercentageSpeedDifference(const float percentage) {
   float new_percentage = std::min(100.0f, percentage);
   global_percentage_difference_from_limit = new_percentage;
+  MarkChanged();
 }
 
 void Parameters::SetGlobalLaneOffset(const float offset) {
   global_lane_offset = offset;
+  MarkChanged();
 }
 
 void Parameters::SetCollisionDetection(const ActorPtr &reference_actor, const ActorPtr &other_actor, const bool detect_collision) {
@@ -96,6 +110,7 @@ void Parameters::SetCollisionDetection(const ActorPtr &reference_actor, const Ac
       ignore_collision.AddEntry(entry);
     }
   }
+  MarkChanged();
 }
 
 void Parameters::SetForceLaneChange(const ActorPtr &actor, const bool direction) {
@@ -103,37 +118,42 @@ void Parameters::SetForceLaneChange(const ActorPtr &actor, const bool direction)
   const ChangeLaneInfo lane_change_info = {true, direction};
   const auto entry = std::make_pair(actor->GetId(), lane_change_info);
   force_lane_change.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetKeepRightPercentage(const ActorPtr &actor, const float percentage) {
 
   const auto entry = std::make_pair(actor->GetId(), percentage);
   perc_keep_right.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetRandomLeftLaneChangePercentage(const ActorPtr &actor, const float percentage) {
 
   const auto entry = std::make_pair(actor->GetId(), percentage);
   perc_random_left.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetRandomRightLaneChangePercentage(const ActorPtr &actor, const float percentage) {
 
   const auto entry = std::make_pair(actor->GetId(), percentage);
   perc_random_right.AddEntry(entry);
-
+  MarkChanged();
 }
 
 void Parameters::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
 
   const auto entry = std::make_pair(actor->GetId(), do_update);
   auto_update_vehicle_lights.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetAutoLaneChange(const ActorPtr &actor, const bool enable) {
 
   const auto entry = std::make_pair(actor->GetId(), enable);
   auto_lane_change.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetDistanceToLeadingVehicle(const ActorPtr &actor, const float distance) {
@@ -141,10 +161,12 @@ void Parameters::SetDistanceToLeadingVehicle(const ActorPtr &actor, const float
   float new_distance = std::max(0.0f, distance);
   const auto entry = std::make_pair(actor->GetId(), new_distance);
   distance_to_leading_vehicle.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetSynchronousMode(const bool mode_switch) {
   synchronous_mode.store(mode_switch);
+  MarkChanged();
 }
 
 void Parameters::SetSynchronousModeTimeOutInMiliSecond(const double time) {
@@ -154,6 +176,7 @@ void Parameters::SetSynchronousModeTimeOutInMiliSecond(const double time) {
 void Parameters::SetGlobalDistanceToLeadingVehicle(const float dist) {
 
   distance_margin.store(dist);
+  MarkChanged();
 }
 
 void Parameters::SetPercentageRunningLight(const ActorPtr &actor, const float perc) {
@@ -161,6 +184,7 @@ void Parameters::SetPercentageRunningLight(const ActorPtr &actor, const float pe
   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
   const auto entry = std::make_pair(actor->GetId(), new_perc);
   perc_run_traffic_light.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetPercentageRunningSign(const ActorPtr &actor, const float perc) {
@@ -168,6 +192,7 @@ void Parameters::SetPercentageRunningSign(const ActorPtr &actor, const float per
   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
   const auto entry = std::make_pair(actor->GetId(), new_perc);
   perc_run_traffic_sign.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetPercentageIgnoreVehicles(const ActorPtr &actor, const float perc) {
@@ -175,6 +200,7 @@ void Parameters::SetPercentageIgnoreVehicles(const ActorPtr &actor, const float
   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
   const auto entry = std::make_pair(actor->GetId(), new_perc);
   perc_ignore_vehicles.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetPercentageIgnoreWalkers(const ActorPtr &actor, const float perc) {
@@ -182,6 +208,7 @@ void Parameters::SetPercentageIgnoreWalkers(const ActorPtr &actor, const float p
   float new_perc = cg::Math::Clamp(perc,0.0f,100.0f);
   const auto entry = std::make_pair(actor->GetId(), new_perc);
   perc_ignore_walkers.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetHybridPhysicsRadius(const float radius) {
@@ -191,6 +218,11 @@ void Parameters::SetHybridPhysicsRadius(const float radius) {
 
 void Parameters::SetOSMMode(const bool mode_switch) {
   osm_mode.store(mode_switch);
+  MarkChanged();
+}
+
+void Parameters::SetNumberOfThreads(const uint32_t threads) {
+  number_of_threads.store(threads);
 }
 
 void Parameters::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
@@ -198,6 +230,7 @@ void Parameters::SetCustomPath(const ActorPtr &actor, const Path path, const boo
   custom_path.AddEntry(entry);
   const auto entry2 = std::make_pair(actor->GetId(), empty_buffer);
   upload_path.AddEntry(entry2);
+  MarkChanged();
 }
 
 void Parameters::RemoveUploadPath(const ActorId &actor_id, const bool remove_path) {
@@ -206,12 +239,14 @@ void Parameters::RemoveUploadPath(const ActorId &actor_id, const bool remove_pat
   } else {
     custom_path.RemoveEntry(actor_id);
   }
+  MarkChanged();
 }
 
 void Parameters::UpdateUploadPath(const ActorId &actor_id, const Path path) {
   custom_path.RemoveEntry(actor_id);
   const auto entry = std::make_pair(actor_id, path);
   custom_path.AddEntry(entry);
+  MarkChanged();
 }
 
 void Parameters::SetImportedRoute(const ActorPtr &actor, const Route route, const bool empty_buffer) {
@@ -219,6 +254,7 @@ void Parameters::SetImportedRoute(const ActorPtr &actor, const Route route, cons
   custom_route.AddEntry(entry);
   const auto entry2 = std::make_pair(actor->GetId(), empty_buffer);
   upload_route.AddEntry(entry2);
+  MarkChanged();
 }
 
 void Parameters::RemoveImportedRoute(const ActorId &actor_id, const bool remove_path) {
@@ -227,12 +263,14 @@ void Parameters::RemoveImportedRoute(const ActorId &actor_id, const bool remove_
   } else {
     custom_route.RemoveEntry(actor_id);
   }
+  MarkChanged();
 }
 
 void Parameters::UpdateImportedRoute(const ActorId &actor_id, const Route route) {
   custom_route.RemoveEntry(actor_id);
   const auto entry = std::make_pair(actor_id, route);
   custom_route.AddEntry(entry);
+  MarkChanged();
 }
 
 //////////////////////////////////// GETTERS //////////////////////////////////
@@ -434,6 +472,11 @@ bool Parameters::GetOSMMode() const {
   return osm_mode.load();
 }
 
+uint32_t Parameters::GetNumberOfThreads() const {
+
+  return number_of_threads.load();
+}
+
 bool Parameters::GetUploadPath(const ActorId &actor_id) const {
 
   bool custom_path_bool = false;
@@ -479,6 +522,80 @@ Route Parameters::GetImportedRoute(const ActorId &actor_id) const {
   return custom_route_import;
 }
 
+//////////////////////////////////// SNAPSHOT /////////////////////////////////
+
+void Parameters::PublishSnapshot(const std::vector<ActorId> &vehicle_id_list) {
+
+  // Read before copying, a change made while copying is copied in the next
+  // cycle.
+  const uint64_t current_version = version.load();
+  if (snapshot->version == current_version
+      && !snapshot->has_force_lane_change
+      && snapshot->vehicle_ids == vehicle_id_list) {
+    return;
+  }
+
+  auto new_snapshot = std::make_unique<ParameterSnapshot>();
+  new_snapshot->version = current_version;
+  new_snapshot->vehicle_ids = vehicle_id_list;
+  new_snapshot->synchronous_mode = synchronous_mode.load();
+  new_snapshot->osm_mode = osm_mode.load();
+  new_snapshot->respawn_dormant_vehicles = respawn_dormant_vehicles.load();
+  new_snapshot->respawn_lower_bound = respawn_lower_bound.load();
+  new_snapshot->respawn_upper_bound = respawn_upper_bound.load();
+
+  // Each map is locked once for all the vehicles.
+  const auto &ids = vehicle_id_list;
+  const auto has_percentage_differences = percentage_difference_from_speed_limit.ContainsKeys(ids);
+  const auto percentage_differences = percentage_difference_from_speed_limit.GetValues(ids, global_percentage_difference_from_limit);
+  const auto has_desired_speeds = exact_desired_speed.ContainsKeys(ids);
+  const auto desired_speeds = exact_desired_speed.GetValues(ids, 0.0f);
+  const auto lane_offsets = lane_offset.GetValues(ids, global_lane_offset);
+  const auto distances = distance_to_leading_vehicle.GetValues(ids, distance_margin.load());
+  const auto force_lane_changes = force_lane_change.TakeValues(ids, ChangeLaneInfo{false, false});
+  const auto auto_lane_changes = auto_lane_change.GetValues(ids, true);
+  const auto keep_right = perc_keep_right.GetValues(ids, -1.0f);
+  const auto random_left = perc_random_left.GetValues(ids, -1.0f);
+  const auto random_right = perc_random_right.GetValues(ids, -1.0f);
+  const auto run_traffic_light = perc_run_traffic_light.GetValues(ids, 0.0f);
+  const auto run_traffic_sign = perc_run_traffic_sign.GetValues(ids, 0.0f);
+  const auto ignore_walkers = perc_ignore_walkers.GetValues(ids, 0.0f);
+  const auto ignore_vehicles = perc_ignore_vehicles.GetValues(ids, 0.0f);
+  const auto update_lights = auto_update_vehicle_lights.GetValues(ids, false);
+  const auto has_custom_paths = custom_path.ContainsKeys(ids);
+  const auto has_imported_routes = custom_route.ContainsKeys(ids);
+  const auto ignored_sets = ignore_collision.GetValues(ids, nullptr);
+
+  new_snapshot->vehicles.resize(ids.size());
+  for (size_t i = 0u; i < ids.size(); ++i) {
+    VehicleParameters &vehicle = new_snapshot->vehicles[i];
+    // As GetVehicleTargetVelocity, the % difference has priority.
+    vehicle.has_desired_speed = !has_percentage_differences[i] && has_desired_speeds[i];
+    vehicle.desired_speed = desired_speeds[i];
+    vehicle.percentage_speed_difference = percentage_differences[i];
+    vehicle.lane_offset = lane_offsets[i];
+    vehicle.distance_to_leading_vehicle = distances[i];
+    vehicle.force_lane_change = force_lane_changes[i];
+    vehicle.auto_lane_change = auto_lane_changes[i];
+    vehicle.perc_keep_right = keep_right[i];
+    vehicle.perc_random_left = random_left[i];
+    vehicle.perc_random_right = random_right[i];
+    vehicle.perc_run_traffic_light = run_traffic_light[i];
+    vehicle.perc_run_traffic_sign = run_traffic_sign[i];
+    vehicle.perc_ignore_walkers = ignore_walkers[i];
+    vehicle.perc_ignore_vehicles = ignore_vehicles[i];
+    vehicle.update_vehicle_lights = update_lights[i];
+    vehicle.has_custom_path = has_custom_paths[i];
+    vehicle.has_imported_route = has_imported_routes[i];
+    if (ignored_sets[i] != nullptr) {
+      vehicle.ignored_collisions = ignored_sets[i]->GetIDList();
+      std::sort(vehicle.ignored_collisions.begin(), vehicle.ignored_collisions.end());
+    }
+    new_snapshot->has_force_lane_change |= vehicle.force_lane_change.change_lane;
+  }
+
+  snapshot = std::move(new_snapshot);
+}
 
 } // namespace traffic_manager
 } // namespace carla
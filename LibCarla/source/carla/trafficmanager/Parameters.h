@@ -6,10 +6,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <random>
 #include <unordered_map>
+#include <vector>
 
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
@@ -34,6 +37,65 @@ struct ChangeLaneInfo {
   bool direction = false;
 };
 
+/// Parameters of a registered vehicle, with the global parameters applied.
+struct VehicleParameters {
+  /// Exact desired speed if set, otherwise the % difference from the speed limit.
+  bool has_desired_speed = false;
+  float desired_speed = 0.0f;
+  float percentage_speed_difference = 0.0f;
+  float lane_offset = 0.0f;
+  float distance_to_leading_vehicle = 0.0f;
+  /// Force lane change command, given to a single snapshot.
+  ChangeLaneInfo force_lane_change;
+  bool auto_lane_change = true;
+  float perc_keep_right = -1.0f;
+  float perc_random_left = -1.0f;
+  float perc_random_right = -1.0f;
+  float perc_run_traffic_light = 0.0f;
+  float perc_run_traffic_sign = 0.0f;
+  float perc_ignore_walkers = 0.0f;
+  float perc_ignore_vehicles = 0.0f;
+  bool update_vehicle_lights = false;
+  /// Whether the vehicle may have a custom path or route, they are consumed
+  /// by the localization stage and queried to Parameters.
+  bool has_custom_path = false;
+  bool has_imported_route = false;
+  /// Sorted ids of the actors ignored during collision detection.
+  std::vector<ActorId> ignored_collisions;
+
+  float GetTargetVelocity(const float speed_limit) const {
+    if (has_desired_speed) {
+      return desired_speed;
+    }
+    return speed_limit * (1.0f - percentage_speed_difference / 100.0f);
+  }
+
+  bool GetCollisionDetection(const ActorId other_actor_id) const {
+    return !std::binary_search(ignored_collisions.begin(), ignored_collisions.end(), other_actor_id);
+  }
+};
+
+/// Immutable copy of the parameters used by the stages during a cycle of the
+/// traffic manager. Setters keep writing to Parameters while the stages run,
+/// and their changes are copied to a new snapshot at the beginning of the
+/// next cycle, so the stages read the parameters without locking.
+struct ParameterSnapshot {
+  /// Version of the parameters it was copied from.
+  uint64_t version = 0u;
+  /// Registered vehicles, in the order of the vehicle id list.
+  std::vector<ActorId> vehicle_ids;
+  /// Parameters of each vehicle, by its index in the vehicle id list.
+  std::vector<VehicleParameters> vehicles;
+  bool synchronous_mode = false;
+  bool osm_mode = true;
+  bool respawn_dormant_vehicles = false;
+  float respawn_lower_bound = 100.0f;
+  float respawn_upper_bound = 1000.0f;
+  /// Any vehicle has a force lane change, the next cycle needs a new snapshot
+  /// without it.
+  bool has_force_lane_change = false;
+};
+
 class Parameters {
 
 private:
@@ -91,6 +153,8 @@ private:
   std::atomic<float> hybrid_physics_radius {70.0};
   /// Parameter specifying Open Street Map mode.
   std::atomic<bool> osm_mode {true};
+  /// Number of threads updating the vehicles, zero runs the stages sequentially.
+  std::atomic<uint32_t> number_of_threads {0u};
   /// Parameter specifying if importing a custom path.
   AtomicMap<ActorId, bool> upload_path;
   /// Structure to hold all custom paths.
@@ -99,6 +163,13 @@ private:
   AtomicMap<ActorId, bool> upload_route;
   /// Structure to hold all custom routes.
   AtomicMap<ActorId, Route> custom_route;
+  /// Incremented by every setter, tells when the snapshot is out of date.
+  std::atomic<uint64_t> version {1u};
+  /// Snapshot of the current cycle of the traffic manager.
+  std::unique_ptr<const ParameterSnapshot> snapshot;
+
+  /// Method to invalidate the snapshot after changing a parameter.
+  void MarkChanged();
 
 public:
   Parameters();
@@ -184,6 +255,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads updating the vehicles.
+  void SetNumberOfThreads(const uint32_t threads);
+
   /// Method to set if we are automatically respawning vehicles.
   void SetRespawnDormantVehicles(const bool mode_switch);
 
@@ -279,6 +353,9 @@ public:
   /// Method to get Open Street Map mode.
   bool GetOSMMode() const;
 
+  /// Method to get the number of threads updating the vehicles.
+  uint32_t GetNumberOfThreads() const;
+
   /// Method to get if we are uploading a path.
   bool GetUploadPath(const ActorId &actor_id) const;
 
@@ -291,6 +368,19 @@ public:
   /// Method to get a custom route.
   Route GetImportedRoute(const ActorId &actor_id) const;
 
+  //////////////////////////////// SNAPSHOT ///////////////////////////////////
+
+  /// Method to copy the parameters of the registered vehicles, in the order
+  /// of @a vehicle_id_list, to a new snapshot if they changed since the last
+  /// one. Called by the traffic manager loop before running the stages.
+  void PublishSnapshot(const std::vector<ActorId> &vehicle_id_list);
+
+  /// Method to get the snapshot of the current cycle. It is valid until the
+  /// next call to PublishSnapshot, only the traffic manager loop may use it.
+  const ParameterSnapshot &GetSnapshot() const {
+    return *snapshot;
+  }
+
   /// Synchronous mode time out variable.
   std::chrono::duration<double, std::milli> synchronous_time_out;
 };
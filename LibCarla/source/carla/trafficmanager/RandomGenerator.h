@@ -1,8 +1,8 @@
-
 #pragma once
 
 #include <random>
 #include <unordered_map>
+#include <vector>
 
 #include "carla/rpc/ActorId.h"
 
@@ -11,11 +11,36 @@ namespace traffic_manager {
 
 class RandomGenerator {
 public:
-    RandomGenerator(const uint64_t seed): mt(std::mt19937(seed)), dist(0.0, 100.0) {}
+    RandomGenerator(const uint64_t seed): seed(seed), mt(std::mt19937(seed)), dist(0.0, 100.0) {}
     double next() { return dist(mt); }
+
+    /// Create a random stream for each actor in @a actor_ids that does not
+    /// have one yet. A stream only depends on the seed and the actor id, so
+    /// the numbers drawn for a vehicle do not depend on the order in which
+    /// the vehicles are updated.
+    void AddActorStreams(const std::vector<ActorId> &actor_ids) {
+        for (const ActorId actor_id : actor_ids) {
+            if (actor_streams.find(actor_id) == actor_streams.end()) {
+                std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32u), actor_id};
+                actor_streams.emplace(actor_id, std::minstd_rand(sequence));
+            }
+        }
+    }
+
+    /// Draw from the stream of @a actor_id. Streams of different actors can
+    /// be drawn from concurrently.
+    double next(const ActorId actor_id) {
+        return std::uniform_real_distribution<double>(0.0, 100.0)(actor_streams.at(actor_id));
+    }
+
+    void RemoveActorStream(const ActorId actor_id) { actor_streams.erase(actor_id); }
+
 private:
+    uint64_t seed;
     std::mt19937 mt;
     std::uniform_real_distribution<double> dist;
+    /// Small engines, there is one per vehicle.
+    std::unordered_map<ActorId, std::minstd_rand> actor_streams;
 };
 
 } // namespace traffic_manager
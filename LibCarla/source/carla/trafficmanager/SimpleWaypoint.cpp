@@ -15,6 +15,29 @@ namespace traffic_manager {
 
   SimpleWaypoint::SimpleWaypoint(WaypointPtr _waypoint) {
     waypoint = _waypoint;
+    road_id = waypoint->GetRoadId();
+    lane_id = waypoint->GetLaneId();
+    s = static_cast<float>(waypoint->GetDistance());
+    waypoint_id = waypoint->GetId();
+    transform = waypoint->GetTransform();
+    next_left_waypoint = nullptr;
+    next_right_waypoint = nullptr;
+  }
+
+  SimpleWaypoint::SimpleWaypoint(WorldMap _world_map,
+                                 crd::RoadId _road_id,
+                                 crd::LaneId _lane_id,
+                                 float _s,
+                                 uint64_t _waypoint_id,
+                                 const cg::Transform &_transform,
+                                 GeoGridId _geodesic_grid_id)
+    : world_map(std::move(_world_map)),
+      road_id(_road_id),
+      lane_id(_lane_id),
+      s(_s),
+      waypoint_id(_waypoint_id),
+      transform(_transform),
+      geodesic_grid_id(_geodesic_grid_id) {
     next_left_waypoint = nullptr;
     next_right_waypoint = nullptr;
   }
@@ -29,11 +52,28 @@ namespace traffic_manager {
   }
 
   WaypointPtr SimpleWaypoint::GetWaypoint() const {
+    if (world_map != nullptr) {
+      std::call_once(waypoint_flag, [this]() {
+        waypoint = world_map->GetWaypointXODR(road_id, lane_id, s);
+      });
+    }
     return waypoint;
   }
 
   uint64_t SimpleWaypoint::GetId() const {
-    return waypoint->GetId();
+    return waypoint_id;
+  }
+
+  crd::RoadId SimpleWaypoint::GetRoadId() const {
+    return road_id;
+  }
+
+  crd::LaneId SimpleWaypoint::GetLaneId() const {
+    return lane_id;
+  }
+
+  float SimpleWaypoint::GetDistance() const {
+    return s;
   }
 
   SimpleWaypointPtr SimpleWaypoint::GetLeftWaypoint() {
@@ -45,11 +85,11 @@ namespace traffic_manager {
   }
 
   cg::Location SimpleWaypoint::GetLocation() const {
-    return waypoint->GetTransform().location;
+    return transform.location;
   }
 
   cg::Vector3D SimpleWaypoint::GetForwardVector() const {
-    return waypoint->GetTransform().rotation.GetForwardVector();
+    return transform.rotation.GetForwardVector();
   }
 
   uint64_t SimpleWaypoint::SetNextWaypoint(const std::vector<SimpleWaypointPtr> &waypoints) {
@@ -68,7 +108,7 @@ namespace traffic_manager {
 
   void SimpleWaypoint::SetLeftWaypoint(SimpleWaypointPtr &_waypoint) {
 
-    const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
+    const cg::Vector3D heading_vector = transform.GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
     if ((heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f) {
       next_left_waypoint = _waypoint;
@@ -77,7 +117,7 @@ namespace traffic_manager {
 
   void SimpleWaypoint::SetRightWaypoint(SimpleWaypointPtr &_waypoint) {
 
-    const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
+    const cg::Vector3D heading_vector = transform.GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
     if ((heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) < 0.0f) {
       next_right_waypoint = _waypoint;
@@ -117,6 +157,10 @@ namespace traffic_manager {
   }
 
   GeoGridId SimpleWaypoint::GetGeodesicGridId() {
+    // The grid id of lazily created waypoints already accounts for junctions.
+    if (waypoint == nullptr) {
+      return geodesic_grid_id;
+    }
     GeoGridId grid_id;
     if (waypoint->IsJunction()) {
       grid_id = waypoint->GetJunctionId();
@@ -127,11 +171,11 @@ namespace traffic_manager {
   }
 
   GeoGridId SimpleWaypoint::GetJunctionId() const {
-    return waypoint->GetJunctionId();
+    return GetWaypoint()->GetJunctionId();
   }
 
   cg::Transform SimpleWaypoint::GetTransform() const {
-    return waypoint->GetTransform();
+    return transform;
   }
 
   void SimpleWaypoint::SetRoadOption(RoadOption _road_option) {
@@ -142,5 +186,13 @@ namespace traffic_manager {
     return road_option;
   }
 
+  void SimpleWaypoint::SetIndex(WaypointIndex _index) {
+    index = _index;
+  }
+
+  WaypointIndex SimpleWaypoint::GetIndex() const {
+    return index;
+  }
+
 } // namespace traffic_manager
 } // namespace carla
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <limits>
 #include <memory.h>
+#include <mutex>
 
+#include "carla/client/Map.h"
 #include "carla/client/Waypoint.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
@@ -20,8 +23,13 @@ namespace traffic_manager {
 
   namespace cc = carla::client;
   namespace cg = carla::geom;
+  namespace crd = carla::road;
   using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
+  using WorldMap = carla::SharedPtr<const cc::Map>;
   using GeoGridId = carla::road::JuncId;
+  /// Position of a waypoint in the dense topology of the local map.
+  using WaypointIndex = uint32_t;
+  static constexpr WaypointIndex INVALID_WAYPOINT_INDEX = std::numeric_limits<WaypointIndex>::max();
   enum class RoadOption : uint8_t {
     Void = 0,
     Left = 1,
@@ -35,6 +43,8 @@ namespace traffic_manager {
 
   /// This is a simple wrapper class on Carla's waypoint object.
   /// The class is used to represent discrete samples of the world map.
+  /// The waypoints loaded from a cooked map only retrieve Carla's waypoint
+  /// object from the map the first time it is requested.
   class SimpleWaypoint {
 
     using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
@@ -42,7 +52,16 @@ namespace traffic_manager {
   private:
 
     /// Pointer to Carla's waypoint object around which this class wraps around.
-    WaypointPtr waypoint;
+    mutable WaypointPtr waypoint;
+    /// Map used to retrieve the waypoint object of a lazily created waypoint.
+    WorldMap world_map;
+    mutable std::once_flag waypoint_flag;
+    /// OpenDRIVE position, id and transform of the waypoint.
+    crd::RoadId road_id = 0u;
+    crd::LaneId lane_id = 0;
+    float s = 0.0f;
+    uint64_t waypoint_id = 0u;
+    cg::Transform transform;
     /// List of pointers to next connecting waypoints.
     std::vector<SimpleWaypointPtr> next_waypoints;
     /// List of pointers to previous connecting waypoints.
@@ -57,10 +76,22 @@ namespace traffic_manager {
     GeoGridId geodesic_grid_id = 0;
     // Boolean to hold if the waypoint belongs to a junction
     bool _is_junction = false;
+    /// Position of the waypoint in the dense topology.
+    WaypointIndex index = INVALID_WAYPOINT_INDEX;
 
   public:
 
     SimpleWaypoint(WaypointPtr _waypoint);
+    /// Creates a waypoint whose Carla's waypoint object is retrieved from
+    /// @a _world_map on first use. @a _geodesic_grid_id is the final grid id,
+    /// already replaced by the junction id inside junctions.
+    SimpleWaypoint(WorldMap _world_map,
+                   crd::RoadId _road_id,
+                   crd::LaneId _lane_id,
+                   float _s,
+                   uint64_t _waypoint_id,
+                   const cg::Transform &_transform,
+                   GeoGridId _geodesic_grid_id);
     ~SimpleWaypoint();
 
     /// Returns the location object for this waypoint.
@@ -81,6 +112,11 @@ namespace traffic_manager {
     /// Returns the unique id for the waypoint.
     uint64_t GetId() const;
 
+    /// Returns the OpenDRIVE position of the waypoint.
+    crd::RoadId GetRoadId() const;
+    crd::LaneId GetLaneId() const;
+    float GetDistance() const;
+
     /// This method is used to set the next waypoints.
     uint64_t SetNextWaypoint(const std::vector<SimpleWaypointPtr> &next_waypoints);
 
@@ -134,6 +170,10 @@ namespace traffic_manager {
     // Accessor methods for road option.
     void SetRoadOption(RoadOption _road_option);
     RoadOption GetRoadOption();
+
+    /// Accessor methods for the position of the waypoint in the dense topology.
+    void SetIndex(WaypointIndex _index);
+    WaypointIndex GetIndex() const;
   };
 
 } // namespace traffic_manager
@@ -1,4 +1,6 @@
 
+#include <utility>
+
 #include "carla/trafficmanager/SimulationState.h"
 
 namespace carla {
@@ -10,93 +12,179 @@ void SimulationState::AddActor(ActorId actor_id,
                                KinematicState kinematic_state,
                                StaticAttributes attributes,
                                TrafficLightState tl_state) {
-  actor_set.insert(actor_id);
-  kinematic_state_map.insert({actor_id, kinematic_state});
-  static_attribute_map.insert({actor_id, attributes});
-  tl_state_map.insert({actor_id, tl_state});
+  if (ContainsActor(actor_id)) {
+    return;
+  }
+  actor_index.insert({actor_id, actor_ids.size()});
+  actor_ids.push_back(actor_id);
+  locations.push_back(kinematic_state.location);
+  rotations.push_back(kinematic_state.rotation);
+  headings.push_back(kinematic_state.rotation.GetForwardVector());
+  velocities.push_back(kinematic_state.velocity);
+  speed_limits.push_back(kinematic_state.speed_limit);
+  physics_enabled.push_back(kinematic_state.physics_enabled);
+  dormant.push_back(kinematic_state.is_dormant);
+  hybrid_end_locations.push_back(kinematic_state.hybrid_end_location);
+  actor_types.push_back(attributes.actor_type);
+  dimensions.push_back(cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height));
+  tl_states.push_back(tl_state);
 }
 
 bool SimulationState::ContainsActor(ActorId actor_id) const {
-  return actor_set.find(actor_id) != actor_set.end();
+  return actor_index.find(actor_id) != actor_index.end();
 }
 
-void SimulationState::RemoveActor(ActorId actor_id) {
-  actor_set.erase(actor_id);
-  kinematic_state_map.erase(actor_id);
-  static_attribute_map.erase(actor_id);
-  tl_state_map.erase(actor_id);
+unsigned long SimulationState::GetIndex(ActorId actor_id) const {
+  return actor_index.at(actor_id);
 }
 
-void SimulationState::Reset() {
-  actor_set.clear();
-  kinematic_state_map.clear();
-  static_attribute_map.clear();
-  tl_state_map.clear();
+ActorId SimulationState::GetActorId(const unsigned long index) const {
+  return actor_ids.at(index);
 }
 
-void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
-  kinematic_state_map.at(actor_id) = state;
+unsigned long SimulationState::Size() const {
+  return actor_ids.size();
 }
 
-void SimulationState::UpdateKinematicHybridEndLocation(ActorId actor_id, cg::Location location) {
-  kinematic_state_map.at(actor_id).hybrid_end_location = location;
+void SimulationState::SwapActors(const unsigned long first, const unsigned long second) {
+  std::swap(actor_ids[first], actor_ids[second]);
+  std::swap(locations[first], locations[second]);
+  std::swap(rotations[first], rotations[second]);
+  std::swap(headings[first], headings[second]);
+  std::swap(velocities[first], velocities[second]);
+  std::swap(speed_limits[first], speed_limits[second]);
+  std::swap(physics_enabled[first], physics_enabled[second]);
+  std::swap(dormant[first], dormant[second]);
+  std::swap(hybrid_end_locations[first], hybrid_end_locations[second]);
+  std::swap(actor_types[first], actor_types[second]);
+  std::swap(dimensions[first], dimensions[second]);
+  std::swap(tl_states[first], tl_states[second]);
+  actor_index[actor_ids[first]] = first;
+  actor_index[actor_ids[second]] = second;
 }
 
-void SimulationState::UpdateTrafficLightState(ActorId actor_id, TrafficLightState state) {
+void SimulationState::RemoveActor(ActorId actor_id) {
+  const auto entry = actor_index.find(actor_id);
+  if (entry == actor_index.end()) {
+    return;
+  }
+
+  // Fill the gap with the last actor to keep the arrays dense.
+  const unsigned long index = entry->second;
+  const unsigned long last_index = actor_ids.size() - 1u;
+  if (index != last_index) {
+    SwapActors(index, last_index);
+  }
+
+  actor_index.erase(actor_id);
+  actor_ids.pop_back();
+  locations.pop_back();
+  rotations.pop_back();
+  headings.pop_back();
+  velocities.pop_back();
+  speed_limits.pop_back();
+  physics_enabled.pop_back();
+  dormant.pop_back();
+  hybrid_end_locations.pop_back();
+  actor_types.pop_back();
+  dimensions.pop_back();
+  tl_states.pop_back();
+}
+
+void SimulationState::ArrangeActors(const std::vector<ActorId> &actor_id_list) {
+  for (unsigned long index = 0u; index < actor_id_list.size(); ++index) {
+    const unsigned long current_index = actor_index.at(actor_id_list.at(index));
+    if (current_index != index) {
+      SwapActors(index, current_index);
+    }
+  }
+}
+
+void SimulationState::Reset() {
+  actor_index.clear();
+  actor_ids.clear();
+  locations.clear();
+  rotations.clear();
+  headings.clear();
+  velocities.clear();
+  speed_limits.clear();
+  physics_enabled.clear();
+  dormant.clear();
+  hybrid_end_locations.clear();
+  actor_types.clear();
+  dimensions.clear();
+  tl_states.clear();
+}
+
+void SimulationState::UpdateKinematicState(const unsigned long index, KinematicState state) {
+  locations.at(index) = state.location;
+  rotations.at(index) = state.rotation;
+  headings.at(index) = state.rotation.GetForwardVector();
+  velocities.at(index) = state.velocity;
+  speed_limits.at(index) = state.speed_limit;
+  physics_enabled.at(index) = state.physics_enabled;
+  dormant.at(index) = state.is_dormant;
+  hybrid_end_locations.at(index) = state.hybrid_end_location;
+}
+
+void SimulationState::UpdateKinematicHybridEndLocation(const unsigned long index, cg::Location location) {
+  hybrid_end_locations.at(index) = location;
+}
+
+void SimulationState::UpdateTrafficLightState(const unsigned long index, TrafficLightState state) {
   // The green-yellow state transition is not notified to the vehicle. This is done to avoid
   // having vehicles stopped very near the intersection when only the rear part of the vehicle
   // is colliding with the trigger volume of the traffic light.
-  auto previous_tl_state = GetTLS(actor_id);
+  TrafficLightState &previous_tl_state = tl_states.at(index);
   if (previous_tl_state.at_traffic_light && previous_tl_state.tl_state == TLS::Green) {
     state.tl_state = TLS::Green;
   }
 
-  tl_state_map.at(actor_id) = state;
+  previous_tl_state = state;
 }
 
-cg::Location SimulationState::GetLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).location;
+cg::Location SimulationState::GetLocation(const unsigned long index) const {
+  return locations.at(index);
 }
 
-cg::Location SimulationState::GetHybridEndLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).hybrid_end_location;
+cg::Location SimulationState::GetHybridEndLocation(const unsigned long index) const {
+  return hybrid_end_locations.at(index);
 }
 
-cg::Rotation SimulationState::GetRotation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation;
+cg::Rotation SimulationState::GetRotation(const unsigned long index) const {
+  return rotations.at(index);
 }
 
-cg::Vector3D SimulationState::GetHeading(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation.GetForwardVector();
+cg::Vector3D SimulationState::GetHeading(const unsigned long index) const {
+  return headings.at(index);
 }
 
-cg::Vector3D SimulationState::GetVelocity(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).velocity;
+cg::Vector3D SimulationState::GetVelocity(const unsigned long index) const {
+  return velocities.at(index);
 }
 
-float SimulationState::GetSpeedLimit(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).speed_limit;
+float SimulationState::GetSpeedLimit(const unsigned long index) const {
+  return speed_limits.at(index);
 }
 
-bool SimulationState::IsPhysicsEnabled(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).physics_enabled;
+bool SimulationState::IsPhysicsEnabled(const unsigned long index) const {
+  return physics_enabled.at(index) != 0u;
 }
 
-bool SimulationState::IsDormant(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).is_dormant;
+bool SimulationState::IsDormant(const unsigned long index) const {
+  return dormant.at(index) != 0u;
 }
 
-TrafficLightState SimulationState::GetTLS(ActorId actor_id) const {
-  return tl_state_map.at(actor_id);
+TrafficLightState SimulationState::GetTLS(const unsigned long index) const {
+  return tl_states.at(index);
 }
 
-ActorType SimulationState::GetType(ActorId actor_id) const {
-  return static_attribute_map.at(actor_id).actor_type;
+ActorType SimulationState::GetType(const unsigned long index) const {
+  return actor_types.at(index);
 }
 
-cg::Vector3D SimulationState::GetDimensions(ActorId actor_id) const {
-  const StaticAttributes &attributes = static_attribute_map.at(actor_id);
-  return cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
+cg::Vector3D SimulationState::GetDimensions(const unsigned long index) const {
+  return dimensions.at(index);
 }
 
 } // namespace  traffic_manager
@@ -1,7 +1,9 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include "carla/trafficmanager/DataStructures.h"
 
@@ -23,13 +25,11 @@ struct KinematicState {
   bool is_dormant;
   cg::Location hybrid_end_location;
 };
-using KinematicStateMap = std::unordered_map<ActorId, KinematicState>;
 
 struct TrafficLightState {
   TLS tl_state;
   bool at_traffic_light;
 };
-using TrafficLightStateMap = std::unordered_map<ActorId, TrafficLightState>;
 
 struct StaticAttributes {
   ActorType actor_type;
@@ -37,20 +37,39 @@ struct StaticAttributes {
   float half_width;
   float half_height;
 };
-using StaticAttributeMap = std::unordered_map<ActorId, StaticAttributes>;
 
-/// This class holds the state of all the vehicles in the simlation.
+/// This class holds the state of all the actors in the simulation.
+/// The state is stored in structure-of-arrays layout, every actor has an index
+/// into the arrays. ALSM keeps the vehicles registered with the traffic manager
+/// in the first indices, in the order of the vehicle id list used by the stages,
+/// so the stages can address the state of a vehicle by its position in that list.
 class SimulationState {
 
 private:
-  // Structure to hold ids of all actors in the simulation.
-  std::unordered_set<ActorId> actor_set;
-  // Structure containing dynamic motion related state of actors.
-  KinematicStateMap kinematic_state_map;
-  // Structure containing static attributes of actors.
-  StaticAttributeMap static_attribute_map;
+  // Structure mapping the ids of all actors in the simulation to their index.
+  std::unordered_map<ActorId, unsigned long> actor_index;
+  // Id of the actor stored at each index.
+  std::vector<ActorId> actor_ids;
+  // Structures containing dynamic motion related state of actors.
+  std::vector<cg::Location> locations;
+  std::vector<cg::Rotation> rotations;
+  // Forward vectors of the rotations, computed when the state is updated.
+  std::vector<cg::Vector3D> headings;
+  std::vector<cg::Vector3D> velocities;
+  std::vector<float> speed_limits;
+  // Flags are not stored in std::vector<bool>, concurrent updates of
+  // different vehicles must not share memory locations.
+  std::vector<uint8_t> physics_enabled;
+  std::vector<uint8_t> dormant;
+  std::vector<cg::Location> hybrid_end_locations;
+  // Structures containing static attributes of actors.
+  std::vector<ActorType> actor_types;
+  std::vector<cg::Vector3D> dimensions;
   // Structure containing dynamic traffic light related state of actors.
-  TrafficLightStateMap tl_state_map;
+  std::vector<TrafficLightState> tl_states;
+
+  // Method to exchange the positions of two actors in the arrays.
+  void SwapActors(const unsigned long first, const unsigned long second);
 
 public :
   SimulationState();
@@ -64,41 +83,52 @@ public :
   // Method to verify if an actor is present currently present in the simulation state.
   bool ContainsActor(ActorId actor_id) const;
 
+  // Method to retrieve the index of an actor in the simulation state.
+  unsigned long GetIndex(ActorId actor_id) const;
+
+  // Method to retrieve the id of the actor at an index.
+  ActorId GetActorId(const unsigned long index) const;
+
+  // Method to retrieve the number of actors in the simulation state.
+  unsigned long Size() const;
+
   // Method to remove an actor from simulation state.
+  // The index of the last actor changes to the index of the removed one.
   void RemoveActor(ActorId actor_id);
 
+  // Method to move the given actors to the first indices, in the same order.
+  void ArrangeActors(const std::vector<ActorId> &actor_id_list);
+
   // Method to flush all states and actors.
   void Reset();
 
-  void UpdateKinematicState(ActorId actor_id, KinematicState state);
-
-  void UpdateKinematicHybridEndLocation(ActorId actor_id, cg::Location location);
+  void UpdateKinematicState(const unsigned long index, KinematicState state);
 
-  void UpdateTrafficLightState(ActorId actor_id, TrafficLightState state);
+  void UpdateKinematicHybridEndLocation(const unsigned long index, cg::Location location);
 
-  cg::Location GetLocation(const ActorId actor_id) const;
+  void UpdateTrafficLightState(const unsigned long index, TrafficLightState state);
 
-  cg::Location GetHybridEndLocation(const ActorId actor_id) const;
+  cg::Location GetLocation(const unsigned long index) const;
 
-  cg::Rotation GetRotation(const ActorId actor_id) const;
+  cg::Location GetHybridEndLocation(const unsigned long index) const;
 
-  cg::Vector3D GetHeading(const ActorId actor_id) const;
+  cg::Rotation GetRotation(const unsigned long index) const;
 
-  cg::Vector3D GetVelocity(const ActorId actor_id) const;
+  cg::Vector3D GetHeading(const unsigned long index) const;
 
-  float GetSpeedLimit(const ActorId actor_id) const;
+  cg::Vector3D GetVelocity(const unsigned long index) const;
 
-  bool IsPhysicsEnabled(const ActorId actor_id) const;
+  float GetSpeedLimit(const unsigned long index) const;
 
-  bool IsDormant(const ActorId actor_id) const;
+  bool IsPhysicsEnabled(const unsigned long index) const;
 
-  cg::Location GetHeroLocation(const ActorId actor_id) const;
+  bool IsDormant(const unsigned long index) const;
 
-  TrafficLightState GetTLS(const ActorId actor_id) const;
+  TrafficLightState GetTLS(const unsigned long index) const;
 
-  ActorType GetType(const ActorId actor_id) const;
+  ActorType GetType(const unsigned long index) const;
 
-  cg::Vector3D GetDimensions(const ActorId actor_id) const;
+  cg::Vector3D GetDimensions(const unsigned long index) const;
 
 };
 
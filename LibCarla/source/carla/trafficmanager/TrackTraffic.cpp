@@ -37,7 +37,8 @@ void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
     actor_to_grids.insert({actor_id, current_grids});
 }
 
-void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer) {
+void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer,
+                                      const WaypointGraph &waypoint_graph) {
     if (!buffer.empty()) {
 
         // Clear current actor from all grids containing itself.
@@ -55,10 +56,8 @@ void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buff
 
         // Step through buffer and update grid list for actor and actor list for grids.
         std::unordered_set<GeoGridId> current_grids;
-        uint64_t buffer_size = buffer.size();
-        for (uint64_t i = 0u; i <= buffer_size - 1u; ++i) {
-            auto waypoint = buffer.at(i);
-            GeoGridId ggid = waypoint->GetGeodesicGridId();
+        for (const SimpleWaypointPtr &waypoint : buffer) {
+            GeoGridId ggid = waypoint_graph.GetGeodesicGridId(waypoint->GetIndex());
             current_grids.insert(ggid);
             // Add grid entry if not present.
             if (grid_to_actors.find(ggid) == grid_to_actors.end()) {
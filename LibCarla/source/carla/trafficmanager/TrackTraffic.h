@@ -5,6 +5,7 @@
 #include "carla/rpc/ActorId.h"
 
 #include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointGraph.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -44,7 +45,7 @@ public:
     void RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id);
     ActorIdSet GetPassingVehicles(uint64_t waypoint_id) const;
 
-    void UpdateGridPosition(const ActorId actor_id, const Buffer &buffer);
+    void UpdateGridPosition(const ActorId actor_id, const Buffer &buffer, const WaypointGraph &waypoint_graph);
     void UpdateUnregisteredGridPosition(const ActorId actor_id,
                                         const std::vector<SimpleWaypointPtr> waypoints);
 
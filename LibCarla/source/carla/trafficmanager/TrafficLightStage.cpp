@@ -32,7 +32,7 @@ void TrafficLightStage::Update(const unsigned long index) {
   bool traffic_light_hazard = false;
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
-  if (!simulation_state.IsDormant(ego_actor_id)) {
+  if (!simulation_state.IsDormant(index)) {
 
     JunctionID current_junction_id = -1;
     if (vehicle_last_junction.find(ego_actor_id) != vehicle_last_junction.end()) {
@@ -42,7 +42,7 @@ void TrafficLightStage::Update(const unsigned long index) {
 
     current_timestamp = world.GetSnapshot().GetTimestamp();
 
-    const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
+    const TrafficLightState tl_state = simulation_state.GetTLS(index);
     const TLS traffic_light_state = tl_state.tl_state;
     const bool is_at_traffic_light = tl_state.at_traffic_light;
 
@@ -50,7 +50,7 @@ void TrafficLightStage::Update(const unsigned long index) {
     if (is_at_traffic_light &&
         traffic_light_state != TLS::Green &&
         traffic_light_state != TLS::Off &&
-        parameters.GetPercentageRunningLight(ego_actor_id) <= random_device.next()) {
+        parameters.GetSnapshot().vehicles.at(index).perc_run_traffic_light <= random_device.next()) {
       // Remove actor from non-signalized junction if it is affected by a traffic light.
       if (current_junction_id != -1) {
         RemoveActor(ego_actor_id);
@@ -65,13 +65,13 @@ void TrafficLightStage::Update(const unsigned long index) {
         RemoveActor(ego_actor_id);
       }
       else {
-        traffic_light_hazard = HandleNonSignalisedJunction(ego_actor_id, affected_junction_id, current_timestamp);
+        traffic_light_hazard = HandleNonSignalisedJunction(index, ego_actor_id, affected_junction_id, current_timestamp);
       }
     }
     else if (affected_junction_id != -1 &&
             !is_at_traffic_light &&
             traffic_light_state != TLS::Green &&
-            parameters.GetPercentageRunningSign(ego_actor_id) <= random_device.next()) {
+            parameters.GetSnapshot().vehicles.at(index).perc_run_traffic_sign <= random_device.next()) {
 
       AddActorToNonSignalisedJunction(ego_actor_id, affected_junction_id);
       traffic_light_hazard = true;
@@ -101,8 +101,8 @@ void TrafficLightStage::AddActorToNonSignalisedJunction(const ActorId ego_actor_
 }
 
 
-bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id,
-                                                    cc::Timestamp timestamp) {
+bool TrafficLightStage::HandleNonSignalisedJunction(const unsigned long index, const ActorId ego_actor_id,
+                                                    const JunctionID junction_id, cc::Timestamp timestamp) {
 
   bool traffic_light_hazard = false;
 
@@ -110,7 +110,7 @@ bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id,
 
   if (vehicle_stop_time.find(ego_actor_id) == vehicle_stop_time.end()) {
     // Ensure the vehicle stops before doing anything else
-    if (simulation_state.GetVelocity(ego_actor_id).Length() < EPSILON_RELATIVE_SPEED) {
+    if (simulation_state.GetVelocity(index).Length() < EPSILON_RELATIVE_SPEED) {
       vehicle_stop_time.insert({ego_actor_id, timestamp});
     }
     traffic_light_hazard = true;
@@ -35,8 +35,8 @@ private:
   /// This controls all vehicle's interactions at non signalized junctions. Priorities are done by order of arrival
   /// and no two vehicle will enter the junction at the same time. Only once it is exiting can the next one enter.
   /// Additionally, all vehicles will always brake at the stop sign for a set amount of time.
-  bool HandleNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id,
-                                   cc::Timestamp timestamp);
+  bool HandleNonSignalisedJunction(const unsigned long index, const ActorId ego_actor_id,
+                                   const JunctionID junction_id, cc::Timestamp timestamp);
 
   /// Initialized the vehicle to the non-signalized junction maps
   void AddActorToNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id);
@@ -65,6 +65,15 @@ public:
     }
   }
 
+  /// Method to set the number of threads updating the vehicles, zero runs
+  /// the stages sequentially.
+  void SetNumberOfThreads(const uint32_t number_of_threads) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetNumberOfThreads(number_of_threads);
+    }
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -134,6 +134,9 @@ public:
   /// Method to set Open Street Map mode.
   virtual void SetOSMMode(const bool mode_switch) = 0;
 
+  /// Method to set the number of threads updating the vehicles.
+  virtual void SetNumberOfThreads(const uint32_t number_of_threads) = 0;
+
   /// Method to set our own imported path.
   virtual void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) = 0;
 
@@ -237,6 +237,12 @@ public:
     _client->call("set_osm_mode", mode_switch);
   }
 
+  /// Method to set the number of threads updating the vehicles.
+  void SetNumberOfThreads(const uint32_t number_of_threads) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_number_of_threads", number_of_threads);
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const carla::rpc::Actor &actor, const Path path, const bool empty_buffer) {
     DEBUG_ASSERT(_client != nullptr);
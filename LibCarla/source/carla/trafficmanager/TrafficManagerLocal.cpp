@@ -7,7 +7,9 @@
 #include <algorithm>
 
 #include "carla/Logging.h"
+#include "carla/profiler/Tracer.h"
 
+#include "carla/client/FileTransfer.h"
 #include "carla/client/detail/Simulator.h"
 
 #include "carla/trafficmanager/TrafficManagerLocal.h"
@@ -84,6 +86,7 @@ TrafficManagerLocal::TrafficManagerLocal(
                                           control_frame)),
 
     alsm(ALSM(registered_vehicles,
+              vehicle_id_list,
               buffer_map,
               track_traffic,
               marked_for_removal,
@@ -119,9 +122,13 @@ void TrafficManagerLocal::SetupLocalMap() {
 
   auto files = episode_proxy.Lock()->GetRequiredFiles("TM");
   if (!files.empty()) {
-    auto content = episode_proxy.Lock()->GetCacheFile(files[0], true);
-    if (content.size() != 0) {
-      local_map->Load(content);
+    // Make sure the cooked map is in the cache, then map it in place.
+    if (cc::FileTransfer::FileExists(files[0]) ||
+        !episode_proxy.Lock()->GetCacheFile(files[0], true).empty()) {
+      if (!local_map->Load(cc::FileTransfer::GetFilePath(files[0]))) {
+        log_warning("Invalid InMemoryMap cache found. Setting up local map. This may take a while...");
+        local_map->SetUp();
+      }
     } else {
       log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
       local_map->SetUp();
@@ -181,15 +188,21 @@ void TrafficManagerLocal::Run() {
 
     std::unique_lock<std::mutex> registration_lock(registration_mutex);
     // Updating simulation state, actor life cycle and performing necessary cleanup.
-    alsm.Update();
+    // This also refreshes the vehicle id list, whose indices address the simulation state.
+    CARLA_TRACE_INTERVAL(traffic_manager, cycle);
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, alsm_update);
+      alsm.Update();
+    }
+
+    // Copying the parameters changed since the last cycle, the stages read
+    // them from the snapshot without locking.
+    parameters.PublishSnapshot(vehicle_id_list);
 
     // Re-allocating inter-stage communication frames based on changed number of registered vehicles.
     int current_registered_vehicles_state = registered_vehicles.GetState();
     unsigned long number_of_vehicles = vehicle_id_list.size();
-    if (registered_vehicles_state != current_registered_vehicles_state || number_of_vehicles != registered_vehicles.Size()) {
-      vehicle_id_list = registered_vehicles.GetIDList();
-      number_of_vehicles = vehicle_id_list.size();
-
+    if (registered_vehicles_state != current_registered_vehicles_state) {
       // Reserve more space if needed.
       uint64_t growth_factor = static_cast<uint64_t>(static_cast<float>(number_of_vehicles) * INV_GROWTH_STEP_SIZE);
       uint64_t new_frame_capacity = INITIAL_SIZE + GROWTH_STEP_SIZE * growth_factor;
@@ -219,33 +232,93 @@ void TrafficManagerLocal::Run() {
     control_frame.resize(number_of_vehicles);
 
     // Run core operation stages.
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      localization_stage.Update(index);
-    }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      collision_stage.Update(index);
-    }
-    collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    const uint32_t number_of_threads = parameters.GetNumberOfThreads();
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, stages);
+      if (number_of_threads == 0u) {
+        for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+          localization_stage.Update(index);
+        }
+        collision_stage.BuildCycleCache();
+        for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+          collision_stage.Update(index);
+        }
+        collision_stage.ClearCycleCache();
+        vehicle_light_stage.UpdateWorldInfo();
+        for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+          traffic_light_stage.Update(index);
+          motion_plan_stage.Update(index);
+          vehicle_light_stage.Update(index);
+        }
+      } else {
+        // Localization and traffic lights keep running in order, they update
+        // the shared track traffic and junction queues vehicle by vehicle. The
+        // other stages only read the shared state and update each vehicle with
+        // the state of the others at the beginning of the stage, so the result
+        // does not depend on the number of threads.
+        worker_pool.SetNumberOfThreads(number_of_threads);
+        for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+          localization_stage.Update(index);
+        }
+        collision_stage.BuildCycleCache();
+        collision_stage.PrepareParallelUpdate();
+        worker_pool.ParallelFor(vehicle_id_list.size(), [this](const unsigned long index) {
+          collision_stage.Update(index);
+        });
+        collision_stage.FinishParallelUpdate();
+        collision_stage.ClearCycleCache();
+        vehicle_light_stage.UpdateWorldInfo();
+        for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+          traffic_light_stage.Update(index);
+        }
+        motion_plan_stage.PrepareParallelUpdate();
+        worker_pool.ParallelFor(vehicle_id_list.size(), [this](const unsigned long index) {
+          motion_plan_stage.Update(index);
+        });
+        motion_plan_stage.FinishParallelUpdate();
+        worker_pool.ParallelFor(vehicle_id_list.size(), [this](const unsigned long index) {
+          vehicle_light_stage.Update(index);
+        });
+      }
+      vehicle_light_stage.PushLightStateCommands();
     }
 
     registration_lock.unlock();
 
     // Sending the current cycle's batch command to the simulator.
+    CARLA_TRACE_SCOPE(traffic_manager, apply_batch);
+    ApplyControlFrame(synchronous_mode);
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
       step_end.store(true);
       step_end_trigger.notify_one();
+    }
+  }
+}
+
+void TrafficManagerLocal::ApplyControlFrame(const bool synchronous_mode) {
+  namespace cr = carla::rpc;
+  control_batch.Clear();
+  control_batch.Reserve(control_frame.size());
+  other_commands.clear();
+  for (const cr::Command &command : control_frame) {
+    if (const auto *control = boost::variant2::get_if<cr::Command::ApplyVehicleControl>(&command.command)) {
+      control_batch.Add(control->actor, control->control);
+    } else if (const auto *light = boost::variant2::get_if<cr::Command::SetVehicleLightState>(&command.command)) {
+      control_batch.AddLightState(light->actor, light->light_state);
     } else {
-      if (control_frame.size() > 0){
-        episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
-      }
+      other_commands.emplace_back(command);
     }
   }
+
+  auto episode = episode_proxy.Lock();
+  // In synchronous mode the batch is sent even if empty, the step ends when
+  // the simulator has received it.
+  if (synchronous_mode || !control_batch.empty()) {
+    episode->ApplyVehicleControlBatchSync(control_batch, false);
+  }
+  if (!other_commands.empty()) {
+    episode->ApplyBatchSync(other_commands, false);
+  }
 }
 
 bool TrafficManagerLocal::SynchronousTick() {
@@ -411,6 +484,10 @@ void TrafficManagerLocal::SetOSMMode(const bool mode_switch) {
   parameters.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerLocal::SetNumberOfThreads(const uint32_t number_of_threads) {
+  parameters.SetNumberOfThreads(number_of_threads);
+}
+
 void TrafficManagerLocal::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   parameters.SetCustomPath(actor, path, empty_buffer);
 }
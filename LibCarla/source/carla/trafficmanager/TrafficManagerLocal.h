@@ -17,6 +17,7 @@
 #include "carla/client/World.h"
 #include "carla/Memory.h"
 #include "carla/rpc/Command.h"
+#include "carla/rpc/VehicleControlBatch.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/InMemoryMap.h"
@@ -26,6 +27,7 @@
 #include "carla/trafficmanager/TrackTraffic.h"
 #include "carla/trafficmanager/TrafficManagerBase.h"
 #include "carla/trafficmanager/TrafficManagerServer.h"
+#include "carla/trafficmanager/WorkerPool.h"
 
 #include "carla/trafficmanager/ALSM.h"
 #include "carla/trafficmanager/LocalizationStage.h"
@@ -86,6 +88,10 @@ private:
   TLFrame tl_frame;
   /// Array to hold output data of motion planning.
   ControlFrame control_frame;
+  /// Vehicle controls and light states of the control frame, sent packed.
+  carla::rpc::VehicleControlBatch control_batch;
+  /// Rest of the commands of the control frame.
+  ControlFrame other_commands;
   /// Variable to keep track of currently reserved array space for frames.
   uint64_t current_reserved_capacity {0u};
   /// Various stages representing core operations of traffic manager.
@@ -109,6 +115,9 @@ private:
   std::condition_variable step_end_trigger;
   /// Single worker thread for sequential execution of sub-components.
   std::unique_ptr<std::thread> worker_thread;
+  /// Threads updating the vehicles of a stage concurrently, driven by the
+  /// worker thread.
+  WorkerPool worker_pool;
   /// Randomization seed.
   uint64_t seed {static_cast<uint64_t>(time(NULL))};
   /// Structure holding random devices per vehicle.
@@ -120,6 +129,11 @@ private:
   /// Method to check if all traffic lights are frozen in a group.
   bool CheckAllFrozen(TLGroup tl_to_freeze);
 
+  /// Method to send the commands of the control frame to the simulator.
+  /// Vehicle controls and light states are sent in a packed batch, the other
+  /// commands, as the teleports of the hybrid mode, in a batch of commands.
+  void ApplyControlFrame(const bool synchronous_mode);
+
 public:
   /// Private constructor for singleton lifecycle management.
   TrafficManagerLocal(std::vector<float> longitudinal_PID_parameters,
@@ -245,6 +259,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads updating the vehicles.
+  void SetNumberOfThreads(const uint32_t number_of_threads);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
@@ -221,6 +221,10 @@ void TrafficManagerRemote::SetOSMMode(const bool mode_switch) {
   client.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerRemote::SetNumberOfThreads(const uint32_t number_of_threads) {
+  client.SetNumberOfThreads(number_of_threads);
+}
+
 void TrafficManagerRemote::SetCustomPath(const ActorPtr &_actor, const Path path, const bool empty_buffer) {
   carla::rpc::Actor actor(_actor->Serialize());
 
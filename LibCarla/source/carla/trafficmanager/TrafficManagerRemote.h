@@ -128,6 +128,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads updating the vehicles.
+  void SetNumberOfThreads(const uint32_t number_of_threads);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
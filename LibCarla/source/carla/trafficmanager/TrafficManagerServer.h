@@ -203,6 +203,11 @@ public:
         tm->SetOSMMode(mode_switch);
       });
 
+      /// Method to set the number of threads updating the vehicles.
+      server->bind("set_number_of_threads", [=](const uint32_t number_of_threads) {
+        tm->SetNumberOfThreads(number_of_threads);
+      });
+
       /// Method to set our own imported path.
       server->bind("set_path", [=](carla::rpc::Actor actor, const Path path, const bool empty_buffer) {
         tm->SetCustomPath(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), path, empty_buffer);
@@ -23,14 +23,19 @@ VehicleLightStage::VehicleLightStage(
 
 void VehicleLightStage::UpdateWorldInfo() {
   // Get the global weather and all the vehicle light states at once
-  all_light_states = world.GetVehiclesLightStates();
+  all_light_states.clear();
+  for (auto &&vls : world.GetVehiclesLightStates()) {
+    all_light_states.insert(vls);
+  }
   weather = world.GetWeather();
+  light_state_frame.clear();
+  light_state_frame.resize(vehicle_id_list.size(), {false, 0u});
 }
 
 void VehicleLightStage::Update(const unsigned long index) {
   ActorId actor_id = vehicle_id_list.at(index);
 
-  if (!parameters.GetUpdateVehicleLights(actor_id))
+  if (!parameters.GetSnapshot().vehicles.at(index).update_vehicle_lights)
     return; // this vehicle is not set to have automatic lights update
 
   rpc::VehicleLightState::flag_type light_states = uint32_t(-1);
@@ -43,11 +48,9 @@ void VehicleLightStage::Update(const unsigned long index) {
   bool fog_lights = false;
 
   // search the current light state of the vehicle
-  for (auto&& vls : all_light_states) {
-    if (vls.first == actor_id) {
-      light_states = vls.second;
-      break;
-    }
+  const auto current_light_states = all_light_states.find(actor_id);
+  if (current_light_states != all_light_states.end()) {
+    light_states = current_light_states->second;
   }
 
   // Determine if the vehicle is truning left or right by checking the close waypoints
@@ -67,14 +70,11 @@ void VehicleLightStage::Update(const unsigned long index) {
     }
   }
 
-  // Determine brake light state
-  for (size_t cc = 0; cc < control_frame.size(); cc++) {
-    if (auto* maybe_ctrl = boost::variant2::get_if<carla::rpc::Command::ApplyVehicleControl>(&control_frame[cc].command)) {
-      carla::rpc::Command::ApplyVehicleControl& ctrl = *maybe_ctrl;
-      if (ctrl.actor == actor_id) {
-        brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
-        break;
-      }
+  // Determine brake light state from the command of the motion planner
+  if (auto* maybe_ctrl = boost::variant2::get_if<carla::rpc::Command::ApplyVehicleControl>(&control_frame.at(index).command)) {
+    carla::rpc::Command::ApplyVehicleControl& ctrl = *maybe_ctrl;
+    if (ctrl.actor == actor_id) {
+      brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
     }
   }
 
@@ -143,7 +143,15 @@ void VehicleLightStage::Update(const unsigned long index) {
 
   // Update the vehicle light state if it has changed
   if (new_light_states != light_states)
-    control_frame.push_back(carla::rpc::Command::SetVehicleLightState(actor_id, new_light_states));
+    light_state_frame.at(index) = {true, new_light_states};
+}
+
+void VehicleLightStage::PushLightStateCommands() {
+  for (unsigned long index = 0u; index < light_state_frame.size(); ++index) {
+    if (light_state_frame[index].first) {
+      control_frame.push_back(carla::rpc::Command::SetVehicleLightState(vehicle_id_list.at(index), light_state_frame[index].second));
+    }
+  }
 }
 
 void VehicleLightStage::RemoveActor(const ActorId) {
@@ -20,9 +20,11 @@ private:
   const cc::World &world;
   ControlFrame& control_frame;
   /// All vehicle light states
-  rpc::VehicleLightStateList all_light_states;
+  std::unordered_map<ActorId, rpc::VehicleLightState::flag_type> all_light_states;
   /// Current weather parameters
   rpc::WeatherParameters weather;
+  /// New light state of each vehicle, if it changed during the current cycle.
+  std::vector<std::pair<bool, rpc::VehicleLightState::flag_type>> light_state_frame;
 
 public:
   VehicleLightStage(const std::vector<ActorId> &vehicle_id_list,
@@ -35,6 +37,10 @@ public:
 
   void Update(const unsigned long index) override;
 
+  /// Appends the commands for the light states that changed to the control
+  /// frame, in the order of the vehicles.
+  void PushLightStateCommands();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
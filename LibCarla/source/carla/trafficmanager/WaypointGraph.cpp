@@ -0,0 +1,607 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "carla/geom/Math.h"
+
+#include "carla/trafficmanager/Constants.h"
+#include "carla/trafficmanager/WaypointGraph.h"
+
+namespace carla {
+namespace traffic_manager {
+
+  using namespace constants::Map;
+
+namespace {
+
+  /// Arrays of the cooked layout, in file order.
+  enum Section : uint32_t {
+    Locations,
+    Rotations,
+    ForwardVectors,
+    RoadIds,
+    LaneIds,
+    Distances,
+    WaypointIds,
+    GeodesicGridIds,
+    IsJunction,
+    RoadOptions,
+    NextOffsets,
+    NextIndices,
+    PreviousOffsets,
+    PreviousIndices,
+    LeftIndices,
+    RightIndices,
+    CellOffsets,
+    CellIndices,
+    SectionCount
+  };
+
+  struct CookedSection {
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  /// Header at the beginning of a cooked file. The sections follow, each one
+  /// aligned to SECTION_ALIGNMENT bytes from the beginning of the file.
+  struct CookedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t checksum;
+    uint32_t waypoint_count;
+    uint32_t grid_cells_x;
+    uint32_t grid_cells_y;
+    float grid_origin_x;
+    float grid_origin_y;
+    float grid_cell_size;
+    CookedSection sections[SectionCount];
+  };
+
+  static constexpr uint64_t SECTION_ALIGNMENT = 16u;
+
+  uint64_t AlignSection(const uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1u) & ~(SECTION_ALIGNMENT - 1u);
+  }
+
+  template <typename T>
+  void WriteSection(std::ofstream &out_file, uint64_t &position, const GraphArray<T> &array) {
+    static const char padding[SECTION_ALIGNMENT] = {};
+    const uint64_t offset = AlignSection(position);
+    out_file.write(padding, static_cast<std::streamsize>(offset - position));
+    out_file.write(reinterpret_cast<const char *>(array.data()),
+                   static_cast<std::streamsize>(sizeof(T) * array.size()));
+    position = offset + sizeof(T) * array.size();
+  }
+
+  template <typename T>
+  bool ViewSection(const CookedHeader &header,
+                   const Section section,
+                   const uint8_t *data,
+                   const size_t size,
+                   const size_t count,
+                   GraphArray<T> &array) {
+    const CookedSection &cooked_section = header.sections[section];
+    if ((cooked_section.offset % SECTION_ALIGNMENT) != 0u ||
+        cooked_section.offset > size ||
+        cooked_section.size > size - cooked_section.offset ||
+        count > size / sizeof(T) ||
+        cooked_section.size != sizeof(T) * count) {
+      return false;
+    }
+    array.View(reinterpret_cast<const T *>(data + cooked_section.offset), count);
+    return true;
+  }
+
+  /// Whether @a offsets start at zero and never decrease, so every range they
+  /// delimit is valid.
+  bool AreValidOffsets(const GraphArray<uint32_t> &offsets) {
+    if (offsets.size() == 0u || offsets[0u] != 0u) {
+      return false;
+    }
+    for (size_t i = 1u; i < offsets.size(); ++i) {
+      if (offsets[i] < offsets[i - 1u]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Whether every index refers to one of the @a count waypoints, or is
+  /// INVALID_WAYPOINT_INDEX if @a allow_invalid.
+  bool AreValidIndices(const GraphArray<WaypointIndex> &indices,
+                       const size_t count,
+                       const bool allow_invalid) {
+    for (size_t i = 0u; i < indices.size(); ++i) {
+      if (indices[i] >= count && !(allow_invalid && indices[i] == INVALID_WAYPOINT_INDEX)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool AreValidRoadOptions(const GraphArray<RoadOption> &road_options) {
+    for (size_t i = 0u; i < road_options.size(); ++i) {
+      if (static_cast<uint8_t>(road_options[i]) > static_cast<uint8_t>(RoadOption::RoadEnd)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+} // namespace
+
+  void WaypointGraph::SetUpSpatialIndex(const NodeList &dense_topology) {
+    cooked_storage.reset();
+
+    const size_t size = dense_topology.size();
+    std::vector<cg::Location> new_locations;
+    std::vector<cg::Rotation> new_rotations;
+    std::vector<cg::Vector3D> new_forward_vectors;
+    new_locations.reserve(size);
+    new_rotations.reserve(size);
+    new_forward_vectors.reserve(size);
+    for (const SimpleWaypointPtr &swp : dense_topology) {
+      const cg::Transform transform = swp->GetTransform();
+      new_locations.push_back(transform.location);
+      new_rotations.push_back(transform.rotation);
+      new_forward_vectors.push_back(transform.GetForwardVector());
+    }
+
+    // Bounds of the grid.
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    for (const cg::Location &location : new_locations) {
+      min_x = std::min(min_x, location.x);
+      min_y = std::min(min_y, location.y);
+      max_x = std::max(max_x, location.x);
+      max_y = std::max(max_y, location.y);
+    }
+    if (new_locations.empty()) {
+      min_x = min_y = max_x = max_y = 0.0f;
+    }
+    grid_origin_x = min_x;
+    grid_origin_y = min_y;
+    grid_cell_size = SPATIAL_INDEX_CELL_SIZE;
+    auto cells_along = [this](const float extent) {
+      return static_cast<uint64_t>(extent / grid_cell_size) + 1u;
+    };
+    while (cells_along(max_x - min_x) * cells_along(max_y - min_y) > SPATIAL_INDEX_MAX_CELLS) {
+      grid_cell_size *= 2.0f;
+    }
+    grid_cells_x = static_cast<uint32_t>(cells_along(max_x - min_x));
+    grid_cells_y = static_cast<uint32_t>(cells_along(max_y - min_y));
+
+    locations.Assign(std::move(new_locations));
+    rotations.Assign(std::move(new_rotations));
+    forward_vectors.Assign(std::move(new_forward_vectors));
+
+    // Counting sort of the waypoints by cell.
+    const size_t number_of_cells = static_cast<size_t>(grid_cells_x) * grid_cells_y;
+    std::vector<uint32_t> new_cell_offsets(number_of_cells + 1u, 0u);
+    for (size_t i = 0u; i < size; ++i) {
+      ++new_cell_offsets[GetCell(locations[i].x, locations[i].y) + 1u];
+    }
+    for (size_t cell = 0u; cell < number_of_cells; ++cell) {
+      new_cell_offsets[cell + 1u] += new_cell_offsets[cell];
+    }
+    std::vector<uint32_t> cursor(new_cell_offsets.begin(), new_cell_offsets.end() - 1);
+    std::vector<WaypointIndex> new_cell_indices(size);
+    for (size_t i = 0u; i < size; ++i) {
+      new_cell_indices[cursor[GetCell(locations[i].x, locations[i].y)]++] = static_cast<WaypointIndex>(i);
+    }
+    cell_offsets.Assign(std::move(new_cell_offsets));
+    cell_indices.Assign(std::move(new_cell_indices));
+  }
+
+  void WaypointGraph::SetUpTopology(const NodeList &dense_topology) {
+    const size_t size = dense_topology.size();
+    std::vector<crd::RoadId> new_road_ids;
+    std::vector<crd::LaneId> new_lane_ids;
+    std::vector<float> new_distances;
+    std::vector<uint64_t> new_waypoint_ids;
+    std::vector<GeoGridId> new_geodesic_grid_ids;
+    std::vector<uint8_t> new_is_junction;
+    std::vector<RoadOption> new_road_options;
+    std::vector<uint32_t> new_next_offsets;
+    std::vector<WaypointIndex> new_next_indices;
+    std::vector<uint32_t> new_previous_offsets;
+    std::vector<WaypointIndex> new_previous_indices;
+    std::vector<WaypointIndex> new_left_indices;
+    std::vector<WaypointIndex> new_right_indices;
+    new_road_ids.reserve(size);
+    new_lane_ids.reserve(size);
+    new_distances.reserve(size);
+    new_waypoint_ids.reserve(size);
+    new_geodesic_grid_ids.reserve(size);
+    new_is_junction.reserve(size);
+    new_road_options.reserve(size);
+    new_next_offsets.reserve(size + 1u);
+    new_previous_offsets.reserve(size + 1u);
+    new_left_indices.reserve(size);
+    new_right_indices.reserve(size);
+
+    auto index_of = [](const SimpleWaypointPtr &swp) {
+      return swp != nullptr ? swp->GetIndex() : INVALID_WAYPOINT_INDEX;
+    };
+
+    new_next_offsets.push_back(0u);
+    new_previous_offsets.push_back(0u);
+    for (const SimpleWaypointPtr &swp : dense_topology) {
+      new_road_ids.push_back(swp->GetRoadId());
+      new_lane_ids.push_back(swp->GetLaneId());
+      new_distances.push_back(swp->GetDistance());
+      new_waypoint_ids.push_back(swp->GetId());
+      new_geodesic_grid_ids.push_back(swp->GetGeodesicGridId());
+      new_is_junction.push_back(swp->CheckJunction() ? uint8_t(1u) : uint8_t(0u));
+      new_road_options.push_back(swp->GetRoadOption());
+
+      for (const SimpleWaypointPtr &next : swp->GetNextWaypoint()) {
+        new_next_indices.push_back(index_of(next));
+      }
+      new_next_offsets.push_back(static_cast<uint32_t>(new_next_indices.size()));
+      for (const SimpleWaypointPtr &previous : swp->GetPreviousWaypoint()) {
+        new_previous_indices.push_back(index_of(previous));
+      }
+      new_previous_offsets.push_back(static_cast<uint32_t>(new_previous_indices.size()));
+
+      new_left_indices.push_back(index_of(swp->GetLeftWaypoint()));
+      new_right_indices.push_back(index_of(swp->GetRightWaypoint()));
+    }
+
+    road_ids.Assign(std::move(new_road_ids));
+    lane_ids.Assign(std::move(new_lane_ids));
+    distances.Assign(std::move(new_distances));
+    waypoint_ids.Assign(std::move(new_waypoint_ids));
+    geodesic_grid_ids.Assign(std::move(new_geodesic_grid_ids));
+    is_junction.Assign(std::move(new_is_junction));
+    road_options.Assign(std::move(new_road_options));
+    next_offsets.Assign(std::move(new_next_offsets));
+    next_indices.Assign(std::move(new_next_indices));
+    previous_offsets.Assign(std::move(new_previous_offsets));
+    previous_indices.Assign(std::move(new_previous_indices));
+    left_indices.Assign(std::move(new_left_indices));
+    right_indices.Assign(std::move(new_right_indices));
+  }
+
+  void WaypointGraph::Clear() {
+    locations.Clear();
+    rotations.Clear();
+    forward_vectors.Clear();
+    road_ids.Clear();
+    lane_ids.Clear();
+    distances.Clear();
+    waypoint_ids.Clear();
+    geodesic_grid_ids.Clear();
+    is_junction.Clear();
+    road_options.Clear();
+    next_offsets.Clear();
+    next_indices.Clear();
+    previous_offsets.Clear();
+    previous_indices.Clear();
+    left_indices.Clear();
+    right_indices.Clear();
+    cell_offsets.Clear();
+    cell_indices.Clear();
+    grid_cells_x = 0u;
+    grid_cells_y = 0u;
+    cooked_storage.reset();
+  }
+
+  WaypointIndex WaypointGraph::Size() const {
+    return static_cast<WaypointIndex>(locations.size());
+  }
+
+  size_t WaypointGraph::GetMemoryUsage() const {
+    return locations.GetMemoryUsage() + rotations.GetMemoryUsage() + forward_vectors.GetMemoryUsage() +
+           road_ids.GetMemoryUsage() + lane_ids.GetMemoryUsage() + distances.GetMemoryUsage() +
+           waypoint_ids.GetMemoryUsage() + geodesic_grid_ids.GetMemoryUsage() + is_junction.GetMemoryUsage() +
+           road_options.GetMemoryUsage() + next_offsets.GetMemoryUsage() + next_indices.GetMemoryUsage() +
+           previous_offsets.GetMemoryUsage() + previous_indices.GetMemoryUsage() +
+           left_indices.GetMemoryUsage() + right_indices.GetMemoryUsage() +
+           cell_offsets.GetMemoryUsage() + cell_indices.GetMemoryUsage();
+  }
+
+  const cg::Location &WaypointGraph::GetLocation(const WaypointIndex index) const {
+    return locations[index];
+  }
+
+  const cg::Rotation &WaypointGraph::GetRotation(const WaypointIndex index) const {
+    return rotations[index];
+  }
+
+  const cg::Vector3D &WaypointGraph::GetForwardVector(const WaypointIndex index) const {
+    return forward_vectors[index];
+  }
+
+  cg::Transform WaypointGraph::GetTransform(const WaypointIndex index) const {
+    return cg::Transform(locations[index], rotations[index]);
+  }
+
+  crd::RoadId WaypointGraph::GetRoadId(const WaypointIndex index) const {
+    return road_ids[index];
+  }
+
+  crd::LaneId WaypointGraph::GetLaneId(const WaypointIndex index) const {
+    return lane_ids[index];
+  }
+
+  float WaypointGraph::GetDistance(const WaypointIndex index) const {
+    return distances[index];
+  }
+
+  uint64_t WaypointGraph::GetId(const WaypointIndex index) const {
+    return waypoint_ids[index];
+  }
+
+  GeoGridId WaypointGraph::GetGeodesicGridId(const WaypointIndex index) const {
+    return geodesic_grid_ids[index];
+  }
+
+  bool WaypointGraph::CheckJunction(const WaypointIndex index) const {
+    return is_junction[index] != 0u;
+  }
+
+  RoadOption WaypointGraph::GetRoadOption(const WaypointIndex index) const {
+    return road_options[index];
+  }
+
+  WaypointGraph::IndexRange WaypointGraph::GetNext(const WaypointIndex index) const {
+    const WaypointIndex *data = next_indices.data();
+    return IndexRange(data + next_offsets[index], data + next_offsets[index + 1u]);
+  }
+
+  WaypointGraph::IndexRange WaypointGraph::GetPrevious(const WaypointIndex index) const {
+    const WaypointIndex *data = previous_indices.data();
+    return IndexRange(data + previous_offsets[index], data + previous_offsets[index + 1u]);
+  }
+
+  WaypointIndex WaypointGraph::GetLeft(const WaypointIndex index) const {
+    return left_indices[index];
+  }
+
+  WaypointIndex WaypointGraph::GetRight(const WaypointIndex index) const {
+    return right_indices[index];
+  }
+
+  float WaypointGraph::DistanceSquared(const WaypointIndex first, const WaypointIndex second) const {
+    return cg::Math::DistanceSquared(locations[first], locations[second]);
+  }
+
+  float WaypointGraph::DistanceSquared(const WaypointIndex index, const cg::Location &location) const {
+    return cg::Math::DistanceSquared(locations[index], location);
+  }
+
+  size_t WaypointGraph::GetCellX(const float x) const {
+    const float cell = (x - grid_origin_x) / grid_cell_size;
+    if (!(cell > 0.0f)) {
+      return 0u;
+    }
+    if (cell >= static_cast<float>(grid_cells_x)) {
+      return grid_cells_x - 1u;
+    }
+    return static_cast<size_t>(cell);
+  }
+
+  size_t WaypointGraph::GetCellY(const float y) const {
+    const float cell = (y - grid_origin_y) / grid_cell_size;
+    if (!(cell > 0.0f)) {
+      return 0u;
+    }
+    if (cell >= static_cast<float>(grid_cells_y)) {
+      return grid_cells_y - 1u;
+    }
+    return static_cast<size_t>(cell);
+  }
+
+  size_t WaypointGraph::GetCell(const float x, const float y) const {
+    return GetCellY(y) * grid_cells_x + GetCellX(x);
+  }
+
+  WaypointIndex WaypointGraph::GetClosestWaypoint(const cg::Location &location) const {
+    if (Size() == 0u) {
+      return INVALID_WAYPOINT_INDEX;
+    }
+
+    // Search from the projection of the location onto the grid. After
+    // visiting ring r around it, no waypoint left is closer than the distance
+    // to the projection plus r cells.
+    const float max_x = grid_origin_x + grid_cell_size * static_cast<float>(grid_cells_x);
+    const float max_y = grid_origin_y + grid_cell_size * static_cast<float>(grid_cells_y);
+    const float projected_x = cg::Math::Clamp(location.x, grid_origin_x, max_x);
+    const float projected_y = cg::Math::Clamp(location.y, grid_origin_y, max_y);
+    const float outside_distance_squared =
+        (location.x - projected_x) * (location.x - projected_x) +
+        (location.y - projected_y) * (location.y - projected_y);
+    const long center_x = static_cast<long>(GetCellX(projected_x));
+    const long center_y = static_cast<long>(GetCellY(projected_y));
+
+    WaypointIndex closest = INVALID_WAYPOINT_INDEX;
+    float closest_distance_squared = std::numeric_limits<float>::max();
+    auto visit_cell = [&](const long x, const long y) {
+      if (x < 0 || y < 0 || x >= static_cast<long>(grid_cells_x) || y >= static_cast<long>(grid_cells_y)) {
+        return;
+      }
+      const size_t cell = static_cast<size_t>(y) * grid_cells_x + static_cast<size_t>(x);
+      for (uint32_t i = cell_offsets[cell]; i < cell_offsets[cell + 1u]; ++i) {
+        const WaypointIndex index = cell_indices[i];
+        const float distance_squared = cg::Math::DistanceSquared(locations[index], location);
+        if (distance_squared < closest_distance_squared) {
+          closest_distance_squared = distance_squared;
+          closest = index;
+        }
+      }
+    };
+
+    // Visit the cells in rings of growing size around the projection.
+    const long max_ring = static_cast<long>(std::max(grid_cells_x, grid_cells_y));
+    for (long ring = 0; ring <= max_ring; ++ring) {
+      for (long y = center_y - ring; y <= center_y + ring; ++y) {
+        if (y == center_y - ring || y == center_y + ring) {
+          for (long x = center_x - ring; x <= center_x + ring; ++x) {
+            visit_cell(x, y);
+          }
+        } else {
+          visit_cell(center_x - ring, y);
+          visit_cell(center_x + ring, y);
+        }
+      }
+      const float ring_distance = static_cast<float>(ring) * grid_cell_size;
+      if (closest != INVALID_WAYPOINT_INDEX &&
+          closest_distance_squared <= outside_distance_squared + ring_distance * ring_distance) {
+        break;
+      }
+    }
+    return closest;
+  }
+
+  void WaypointGraph::Write(std::ofstream &out_file, const uint64_t checksum) const {
+    CookedHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = COOKED_MAP_MAGIC;
+    header.version = COOKED_MAP_VERSION;
+    header.checksum = checksum;
+    header.waypoint_count = Size();
+    header.grid_cells_x = grid_cells_x;
+    header.grid_cells_y = grid_cells_y;
+    header.grid_origin_x = grid_origin_x;
+    header.grid_origin_y = grid_origin_y;
+    header.grid_cell_size = grid_cell_size;
+
+    uint64_t offset = sizeof(CookedHeader);
+    auto add_section = [&](const Section section, const uint64_t size) {
+      offset = AlignSection(offset);
+      header.sections[section] = {offset, size};
+      offset += size;
+    };
+    add_section(Locations, sizeof(cg::Location) * locations.size());
+    add_section(Rotations, sizeof(cg::Rotation) * rotations.size());
+    add_section(ForwardVectors, sizeof(cg::Vector3D) * forward_vectors.size());
+    add_section(RoadIds, sizeof(crd::RoadId) * road_ids.size());
+    add_section(LaneIds, sizeof(crd::LaneId) * lane_ids.size());
+    add_section(Distances, sizeof(float) * distances.size());
+    add_section(WaypointIds, sizeof(uint64_t) * waypoint_ids.size());
+    add_section(GeodesicGridIds, sizeof(GeoGridId) * geodesic_grid_ids.size());
+    add_section(IsJunction, sizeof(uint8_t) * is_junction.size());
+    add_section(RoadOptions, sizeof(RoadOption) * road_options.size());
+    add_section(NextOffsets, sizeof(uint32_t) * next_offsets.size());
+    add_section(NextIndices, sizeof(WaypointIndex) * next_indices.size());
+    add_section(PreviousOffsets, sizeof(uint32_t) * previous_offsets.size());
+    add_section(PreviousIndices, sizeof(WaypointIndex) * previous_indices.size());
+    add_section(LeftIndices, sizeof(WaypointIndex) * left_indices.size());
+    add_section(RightIndices, sizeof(WaypointIndex) * right_indices.size());
+    add_section(CellOffsets, sizeof(uint32_t) * cell_offsets.size());
+    add_section(CellIndices, sizeof(WaypointIndex) * cell_indices.size());
+
+    out_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t position = sizeof(CookedHeader);
+    WriteSection(out_file, position, locations);
+    WriteSection(out_file, position, rotations);
+    WriteSection(out_file, position, forward_vectors);
+    WriteSection(out_file, position, road_ids);
+    WriteSection(out_file, position, lane_ids);
+    WriteSection(out_file, position, distances);
+    WriteSection(out_file, position, waypoint_ids);
+    WriteSection(out_file, position, geodesic_grid_ids);
+    WriteSection(out_file, position, is_junction);
+    WriteSection(out_file, position, road_options);
+    WriteSection(out_file, position, next_offsets);
+    WriteSection(out_file, position, next_indices);
+    WriteSection(out_file, position, previous_offsets);
+    WriteSection(out_file, position, previous_indices);
+    WriteSection(out_file, position, left_indices);
+    WriteSection(out_file, position, right_indices);
+    WriteSection(out_file, position, cell_offsets);
+    WriteSection(out_file, position, cell_indices);
+  }
+
+  bool WaypointGraph::HasCookedHeader(const uint8_t *data, size_t size) {
+    uint32_t magic = 0u;
+    if (size < sizeof(magic)) {
+      return false;
+    }
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == COOKED_MAP_MAGIC;
+  }
+
+  bool WaypointGraph::View(std::shared_ptr<const void> storage,
+                           const uint8_t *data,
+                           size_t size,
+                           const uint64_t checksum) {
+    Clear();
+    if (size < sizeof(CookedHeader) ||
+        (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t)) != 0u) {
+      return false;
+    }
+    CookedHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != COOKED_MAP_MAGIC ||
+        header.version != COOKED_MAP_VERSION ||
+        header.checksum != checksum) {
+      return false;
+    }
+
+    const size_t n = header.waypoint_count;
+    const size_t number_of_cells = static_cast<size_t>(header.grid_cells_x) * header.grid_cells_y;
+    bool valid =
+        ViewSection(header, Locations, data, size, n, locations) &&
+        ViewSection(header, Rotations, data, size, n, rotations) &&
+        ViewSection(header, ForwardVectors, data, size, n, forward_vectors) &&
+        ViewSection(header, RoadIds, data, size, n, road_ids) &&
+        ViewSection(header, LaneIds, data, size, n, lane_ids) &&
+        ViewSection(header, Distances, data, size, n, distances) &&
+        ViewSection(header, WaypointIds, data, size, n, waypoint_ids) &&
+        ViewSection(header, GeodesicGridIds, data, size, n, geodesic_grid_ids) &&
+        ViewSection(header, IsJunction, data, size, n, is_junction) &&
+        ViewSection(header, RoadOptions, data, size, n, road_options) &&
+        ViewSection(header, NextOffsets, data, size, n + 1u, next_offsets) &&
+        ViewSection(header, PreviousOffsets, data, size, n + 1u, previous_offsets) &&
+        ViewSection(header, LeftIndices, data, size, n, left_indices) &&
+        ViewSection(header, RightIndices, data, size, n, right_indices) &&
+        ViewSection(header, CellOffsets, data, size, number_of_cells + 1u, cell_offsets);
+    valid = valid &&
+        ViewSection(header, NextIndices, data, size, next_offsets[n], next_indices) &&
+        ViewSection(header, PreviousIndices, data, size, previous_offsets[n], previous_indices) &&
+        ViewSection(header, CellIndices, data, size, n, cell_indices) &&
+        number_of_cells > 0u &&
+        cell_offsets[number_of_cells] == n &&
+        std::isfinite(header.grid_origin_x) &&
+        std::isfinite(header.grid_origin_y) &&
+        std::isfinite(header.grid_cell_size) &&
+        header.grid_cell_size > 0.0f;
+    // The arrays are used without bounds checks, a corrupted file must not
+    // make the graph read outside of them.
+    valid = valid &&
+        AreValidOffsets(next_offsets) &&
+        AreValidOffsets(previous_offsets) &&
+        AreValidOffsets(cell_offsets) &&
+        AreValidIndices(next_indices, n, false) &&
+        AreValidIndices(previous_indices, n, false) &&
+        AreValidIndices(cell_indices, n, false) &&
+        AreValidIndices(left_indices, n, true) &&
+        AreValidIndices(right_indices, n, true) &&
+        AreValidRoadOptions(road_options);
+    if (!valid) {
+      Clear();
+      return false;
+    }
+
+    grid_origin_x = header.grid_origin_x;
+    grid_origin_y = header.grid_origin_y;
+    grid_cell_size = header.grid_cell_size;
+    grid_cells_x = header.grid_cells_x;
+    grid_cells_y = header.grid_cells_y;
+    cooked_storage = std::move(storage);
+    return true;
+  }
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,236 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/Location.h"
+#include "carla/geom/Rotation.h"
+#include "carla/geom/Transform.h"
+#include "carla/geom/Vector3D.h"
+
+#include "carla/trafficmanager/SimpleWaypoint.h"
+
+namespace carla {
+namespace traffic_manager {
+
+  namespace cg = carla::geom;
+
+  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
+  using NodeList = std::vector<SimpleWaypointPtr>;
+
+  /// Contiguous array either owned by the graph or pointing into the memory
+  /// of a cooked file.
+  template <typename T>
+  class GraphArray {
+  public:
+
+    void Assign(std::vector<T> &&values) {
+      owned = std::move(values);
+      view = owned.data();
+      count = owned.size();
+    }
+
+    void View(const T *data, size_t size) {
+      owned = std::vector<T>();
+      view = data;
+      count = size;
+    }
+
+    void Clear() {
+      owned = std::vector<T>();
+      view = nullptr;
+      count = 0u;
+    }
+
+    const T &operator[](size_t i) const { return view[i]; }
+    const T *data() const { return view; }
+    size_t size() const { return count; }
+    /// Heap memory owned by the array, zero for views.
+    size_t GetMemoryUsage() const { return sizeof(T) * owned.capacity(); }
+
+  private:
+
+    std::vector<T> owned;
+    const T *view = nullptr;
+    size_t count = 0u;
+  };
+
+  /// Compact, index-based representation of the discretized local map.
+  /// Waypoints are identified by their position in the dense topology of the
+  /// InMemoryMap. Their attributes are stored in contiguous arrays and the
+  /// connections between them in compressed sparse row form, so traversing
+  /// the graph does not copy shared pointers nor query the road map.
+  /// The graph also holds a uniform grid of the waypoint locations to find
+  /// the waypoints near a location.
+  ///
+  /// The cooked layout written by Write is the in-memory layout of the arrays,
+  /// so View can use a loaded or memory-mapped file in place.
+  class WaypointGraph : private NonCopyable {
+  public:
+
+    /// Contiguous range of waypoint indices, e.g. the successors of a waypoint.
+    class IndexRange {
+    public:
+      IndexRange(const WaypointIndex *begin, const WaypointIndex *end)
+        : _begin(begin), _end(end) {}
+
+      const WaypointIndex *begin() const { return _begin; }
+      const WaypointIndex *end() const { return _end; }
+      size_t size() const { return static_cast<size_t>(_end - _begin); }
+      bool empty() const { return _begin == _end; }
+      WaypointIndex front() const { return *_begin; }
+      WaypointIndex operator[](size_t i) const { return _begin[i]; }
+
+    private:
+      const WaypointIndex *_begin;
+      const WaypointIndex *_end;
+    };
+
+    WaypointGraph() = default;
+
+    /// Fills the transforms of the waypoints and builds the spatial index.
+    /// The index of every SimpleWaypoint must match its position in the list.
+    void SetUpSpatialIndex(const NodeList &dense_topology);
+
+    /// Fills the OpenDRIVE positions, attributes and connections of the
+    /// waypoints, once they are linked.
+    void SetUpTopology(const NodeList &dense_topology);
+
+    void Clear();
+
+    /// Number of waypoints in the graph.
+    WaypointIndex Size() const;
+
+    /// Approximate number of bytes of heap memory used by the graph. The
+    /// arrays pointing into a cooked file are not accounted.
+    size_t GetMemoryUsage() const;
+
+    const cg::Location &GetLocation(const WaypointIndex index) const;
+    const cg::Rotation &GetRotation(const WaypointIndex index) const;
+    const cg::Vector3D &GetForwardVector(const WaypointIndex index) const;
+    cg::Transform GetTransform(const WaypointIndex index) const;
+
+    /// OpenDRIVE position of the waypoint.
+    crd::RoadId GetRoadId(const WaypointIndex index) const;
+    crd::LaneId GetLaneId(const WaypointIndex index) const;
+    float GetDistance(const WaypointIndex index) const;
+
+    /// Unique id of the waypoint, as given by carla::client::Waypoint.
+    uint64_t GetId(const WaypointIndex index) const;
+    /// Geodesic grid of the waypoint, the junction id inside junctions.
+    GeoGridId GetGeodesicGridId(const WaypointIndex index) const;
+    bool CheckJunction(const WaypointIndex index) const;
+    RoadOption GetRoadOption(const WaypointIndex index) const;
+
+    IndexRange GetNext(const WaypointIndex index) const;
+    IndexRange GetPrevious(const WaypointIndex index) const;
+    /// Lane change links, INVALID_WAYPOINT_INDEX if there is none.
+    WaypointIndex GetLeft(const WaypointIndex index) const;
+    WaypointIndex GetRight(const WaypointIndex index) const;
+
+    float DistanceSquared(const WaypointIndex first, const WaypointIndex second) const;
+    float DistanceSquared(const WaypointIndex index, const cg::Location &location) const;
+
+    /// Returns the waypoint closest to @a location, INVALID_WAYPOINT_INDEX if
+    /// the graph is empty.
+    WaypointIndex GetClosestWaypoint(const cg::Location &location) const;
+
+    /// Calls @a functor with the index of every waypoint strictly inside the
+    /// box between @a min_corner and @a max_corner, until it returns false.
+    template <typename Functor>
+    void ForEachWaypointInBox(const cg::Location &min_corner,
+                              const cg::Location &max_corner,
+                              Functor &&functor) const;
+
+    /// Writes the cooked layout of the graph. @a checksum identifies the
+    /// OpenDRIVE map the graph was built from.
+    void Write(std::ofstream &out_file, const uint64_t checksum) const;
+
+    /// Uses the cooked layout at @a data in place, keeping @a storage alive
+    /// while the graph points into it. Returns false if the layout is not
+    /// valid or was cooked for a different map than @a checksum.
+    bool View(std::shared_ptr<const void> storage,
+              const uint8_t *data,
+              size_t size,
+              const uint64_t checksum);
+
+    /// Returns true if @a data starts with the header of a cooked layout.
+    static bool HasCookedHeader(const uint8_t *data, size_t size);
+
+  private:
+
+    size_t GetCell(const float x, const float y) const;
+    size_t GetCellX(const float x) const;
+    size_t GetCellY(const float y) const;
+
+    /// Memory of the cooked file the arrays point into.
+    std::shared_ptr<const void> cooked_storage;
+
+    GraphArray<cg::Location> locations;
+    GraphArray<cg::Rotation> rotations;
+    GraphArray<cg::Vector3D> forward_vectors;
+    GraphArray<crd::RoadId> road_ids;
+    GraphArray<crd::LaneId> lane_ids;
+    GraphArray<float> distances;
+    GraphArray<uint64_t> waypoint_ids;
+    GraphArray<GeoGridId> geodesic_grid_ids;
+    GraphArray<uint8_t> is_junction;
+    GraphArray<RoadOption> road_options;
+    /// Successors of waypoint i are next_indices[next_offsets[i], next_offsets[i + 1]).
+    GraphArray<uint32_t> next_offsets;
+    GraphArray<WaypointIndex> next_indices;
+    GraphArray<uint32_t> previous_offsets;
+    GraphArray<WaypointIndex> previous_indices;
+    GraphArray<WaypointIndex> left_indices;
+    GraphArray<WaypointIndex> right_indices;
+
+    /// Uniform grid of the waypoint locations on the XY plane. The waypoints
+    /// of cell c are cell_indices[cell_offsets[c], cell_offsets[c + 1]).
+    float grid_origin_x = 0.0f;
+    float grid_origin_y = 0.0f;
+    float grid_cell_size = 1.0f;
+    uint32_t grid_cells_x = 0u;
+    uint32_t grid_cells_y = 0u;
+    GraphArray<uint32_t> cell_offsets;
+    GraphArray<WaypointIndex> cell_indices;
+  };
+
+  template <typename Functor>
+  void WaypointGraph::ForEachWaypointInBox(const cg::Location &min_corner,
+                                           const cg::Location &max_corner,
+                                           Functor &&functor) const {
+    if (Size() == 0u || min_corner.x >= max_corner.x || min_corner.y >= max_corner.y) {
+      return;
+    }
+    const size_t min_x = GetCellX(min_corner.x);
+    const size_t max_x = GetCellX(max_corner.x);
+    const size_t min_y = GetCellY(min_corner.y);
+    const size_t max_y = GetCellY(max_corner.y);
+    for (size_t y = min_y; y <= max_y; ++y) {
+      for (size_t x = min_x; x <= max_x; ++x) {
+        const size_t cell = y * grid_cells_x + x;
+        for (uint32_t i = cell_offsets[cell]; i < cell_offsets[cell + 1u]; ++i) {
+          const WaypointIndex index = cell_indices[i];
+          const cg::Location &location = locations[index];
+          if (location.x > min_corner.x && location.x < max_corner.x &&
+              location.y > min_corner.y && location.y < max_corner.y &&
+              location.z > min_corner.z && location.z < max_corner.z) {
+            if (!functor(index)) {
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "carla/Debug.h"
+
+#include "carla/trafficmanager/WorkerPool.h"
+
+namespace carla {
+namespace traffic_manager {
+
+static uint64_t PackRange(const uint64_t begin, const uint64_t end) {
+  return (begin << 32u) | end;
+}
+
+static uint64_t RangeBegin(const uint64_t bounds) {
+  return bounds >> 32u;
+}
+
+static uint64_t RangeEnd(const uint64_t bounds) {
+  return bounds & 0xffffffffu;
+}
+
+WorkerPool::WorkerPool()
+  : ranges(new Range[1u]) {}
+
+WorkerPool::~WorkerPool() {
+  StopWorkers();
+}
+
+void WorkerPool::SetNumberOfThreads(const size_t number_of_threads) {
+  const size_t participants = std::max<size_t>(number_of_threads, 1u);
+  if (participants == number_of_participants) {
+    return;
+  }
+  StopWorkers();
+  number_of_participants = participants;
+  ranges.reset(new Range[participants]);
+  for (size_t participant = 1u; participant < participants; ++participant) {
+    workers.emplace_back(&WorkerPool::WorkerLoop, this, participant, job_id);
+  }
+}
+
+void WorkerPool::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  job_begin.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  stop = false;
+}
+
+void WorkerPool::ParallelFor(const unsigned long size, const Task &task) {
+  if (number_of_participants == 1u || size <= 1u) {
+    for (unsigned long index = 0u; index < size; ++index) {
+      task(index);
+    }
+    return;
+  }
+  DEBUG_ASSERT(size <= 0xffffffffu);
+
+  // Split the indices evenly, stealing balances the load afterwards.
+  for (size_t participant = 0u; participant < number_of_participants; ++participant) {
+    const uint64_t begin = size * participant / number_of_participants;
+    const uint64_t end = size * (participant + 1u) / number_of_participants;
+    ranges[participant].bounds.store(PackRange(begin, end));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    current_task = &task;
+    failed.store(false);
+    exception = nullptr;
+    active_workers = workers.size();
+    ++job_id;
+  }
+  job_begin.notify_all();
+
+  Participate(0u);
+
+  std::exception_ptr task_exception;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    job_end.wait(lock, [this]() { return active_workers == 0u; });
+    current_task = nullptr;
+    std::swap(task_exception, exception);
+  }
+  if (task_exception) {
+    std::rethrow_exception(task_exception);
+  }
+}
+
+void WorkerPool::WorkerLoop(const size_t participant, uint64_t last_job) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_begin.wait(lock, [&]() { return stop || job_id != last_job; });
+      if (stop) {
+        return;
+      }
+      last_job = job_id;
+    }
+
+    Participate(participant);
+
+    bool done = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --active_workers;
+      done = active_workers == 0u;
+    }
+    if (done) {
+      job_end.notify_one();
+    }
+  }
+}
+
+void WorkerPool::Participate(const size_t participant) {
+  unsigned long index = 0u;
+  while (true) {
+    if (!PopIndex(participant, index)) {
+      if (Steal(participant)) {
+        continue;
+      }
+      return;
+    }
+    if (failed.load(std::memory_order_relaxed)) {
+      // Drain the remaining indices without running them.
+      continue;
+    }
+    try {
+      (*current_task)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!exception) {
+        exception = std::current_exception();
+      }
+      failed.store(true);
+    }
+  }
+}
+
+bool WorkerPool::PopIndex(const size_t participant, unsigned long &index) {
+  auto &bounds = ranges[participant].bounds;
+  uint64_t value = bounds.load();
+  while (RangeBegin(value) < RangeEnd(value)) {
+    const uint64_t begin = RangeBegin(value);
+    if (bounds.compare_exchange_weak(value, PackRange(begin + 1u, RangeEnd(value)))) {
+      index = static_cast<unsigned long>(begin);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WorkerPool::Steal(const size_t participant) {
+  // Take the upper half of the first range with work left. Our own range is
+  // empty, so no other thread can be modifying it when we refill it.
+  for (size_t offset = 1u; offset < number_of_participants; ++offset) {
+    auto &victim = ranges[(participant + offset) % number_of_participants].bounds;
+    uint64_t value = victim.load();
+    while (RangeBegin(value) < RangeEnd(value)) {
+      const uint64_t begin = RangeBegin(value);
+      const uint64_t end = RangeEnd(value);
+      const uint64_t middle = end - (end - begin + 1u) / 2u;
+      if (victim.compare_exchange_weak(value, PackRange(begin, middle))) {
+        ranges[participant].bounds.store(PackRange(middle, end));
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace traffic_manager {
+
+/// Pool of threads used to update the vehicles of a stage concurrently.
+///
+/// Every thread starts with a contiguous block of indices and, once it runs
+/// out of work, steals half of the remaining indices of another thread, so a
+/// few vehicles with expensive updates do not leave the rest of the threads
+/// idle.
+class WorkerPool {
+public:
+  using Task = std::function<void(const unsigned long index)>;
+
+  WorkerPool();
+
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  /// Set the number of threads running the tasks, the calling thread
+  /// included. Must not be called while running ParallelFor.
+  void SetNumberOfThreads(const size_t number_of_threads);
+
+  size_t GetNumberOfThreads() const {
+    return number_of_participants;
+  }
+
+  /// Call @a task for every index in [0, size) and wait until all of them are
+  /// done. The calling thread takes part in the work. If a task throws, the
+  /// remaining indices are skipped and the exception is rethrown here.
+  void ParallelFor(const unsigned long size, const Task &task);
+
+private:
+  /// Range of indices [begin, end) owned by a thread, packed in a single word
+  /// so the owner and the thieves can shrink it with compare-and-swap. Padded
+  /// to avoid false sharing between threads.
+  struct Range {
+    std::atomic<uint64_t> bounds{0u};
+    char padding[64u - sizeof(std::atomic<uint64_t>)];
+  };
+
+  void StopWorkers();
+
+  void WorkerLoop(const size_t participant, uint64_t last_job);
+
+  void Participate(const size_t participant);
+
+  bool PopIndex(const size_t participant, unsigned long &index);
+
+  bool Steal(const size_t participant);
+
+  size_t number_of_participants {1u};
+  std::unique_ptr<Range[]> ranges;
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable job_begin;
+  std::condition_variable job_end;
+  uint64_t job_id {0u};
+  size_t active_workers {0u};
+  bool stop {false};
+  const Task *current_task {nullptr};
+  std::atomic<bool> failed {false};
+  std::exception_ptr exception;
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/ActorLifecycleLog.h>
+
+#include <vector>
+
+using carla::client::detail::ActorLifecycleLog;
+using Ids = std::vector<carla::ActorId>;
+
+TEST(actor_lifecycle_log, net_changes) {
+  ActorLifecycleLog log;
+  log.Reset(1u, 10u);
+  log.Record(11u, {5u, 3u}, {});
+  log.Record(12u, {7u}, {1u});
+  log.Record(14u, {}, {3u, 2u});
+
+  auto changes = log.GetChanges(1u, 10u, 14u);
+  ASSERT_TRUE(changes.complete);
+  // Actor 3 was added and removed in these frames.
+  ASSERT_EQ(changes.added, (Ids{5u, 7u}));
+  ASSERT_EQ(changes.removed, (Ids{1u, 2u}));
+
+  changes = log.GetChanges(1u, 11u, 13u);
+  ASSERT_TRUE(changes.complete);
+  ASSERT_EQ(changes.added, (Ids{7u}));
+  ASSERT_EQ(changes.removed, (Ids{1u}));
+
+  changes = log.GetChanges(1u, 14u, 20u);
+  ASSERT_TRUE(changes.complete);
+  ASSERT_TRUE(changes.added.empty());
+  ASSERT_TRUE(changes.removed.empty());
+}
+
+TEST(actor_lifecycle_log, incomplete_changes) {
+  ActorLifecycleLog log(2u);
+  log.Reset(1u, 10u);
+  ASSERT_FALSE(log.GetChanges(1u, 9u, 12u).complete);
+  ASSERT_FALSE(log.GetChanges(2u, 10u, 12u).complete);
+
+  log.Record(11u, {1u}, {});
+  log.Record(12u, {2u}, {});
+  ASSERT_TRUE(log.GetChanges(1u, 10u, 12u).complete);
+  // The changes of frame 11 are dropped.
+  log.Record(13u, {3u}, {});
+  ASSERT_FALSE(log.GetChanges(1u, 10u, 13u).complete);
+  const auto changes = log.GetChanges(1u, 11u, 13u);
+  ASSERT_TRUE(changes.complete);
+  ASSERT_EQ(changes.added, (Ids{2u, 3u}));
+
+  log.Reset(2u, 20u);
+  ASSERT_FALSE(log.GetChanges(1u, 13u, 21u).complete);
+  ASSERT_TRUE(log.GetChanges(2u, 20u, 21u).complete);
+}
@@ -0,0 +1,176 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/Buffer.h>
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/data/RawEpisodeState.h>
+#include <carla/sensor/s11n/EpisodeStateSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using carla::ActorId;
+using carla::client::detail::EpisodeState;
+using carla::sensor::data::ActorDynamicState;
+using carla::sensor::data::RawEpisodeState;
+using carla::sensor::s11n::EpisodeStateSerializer;
+using carla::sensor::s11n::SensorHeaderSerializer;
+using Ids = std::vector<ActorId>;
+
+namespace {
+
+  class FakeWorldObserver;
+
+  /// Deserializes the messages of sensor type 0 as episode states.
+  using Serializer = carla::sensor::CompositeSerializer<
+      std::pair<FakeWorldObserver *, EpisodeStateSerializer>>;
+
+  struct Actor {
+    ActorId id;
+    float x;
+  };
+
+  template <typename T>
+  void Append(std::vector<unsigned char> &data, const T &value) {
+    const auto *begin = reinterpret_cast<const unsigned char *>(&value);
+    data.insert(data.end(), begin, begin + sizeof(T));
+  }
+
+  /// Message of the world observer as sent by the server.
+  carla::SharedPtr<RawEpisodeState> MakeState(
+      uint64_t episode_id,
+      uint64_t frame,
+      bool is_delta,
+      uint64_t base_frame,
+      const Ids &removed,
+      const std::vector<Actor> &actors) {
+    std::vector<unsigned char> data;
+    SensorHeaderSerializer::Header sensor_header{};
+    sensor_header.sensor_type = 0u;
+    sensor_header.frame = frame;
+    Append(data, sensor_header);
+    EpisodeStateSerializer::Header header{};
+    header.episode_id = episode_id;
+    header.encoding = is_delta ?
+        EpisodeStateSerializer::Encoding::Delta :
+        EpisodeStateSerializer::Encoding::Keyframe;
+    header.base_frame = base_frame;
+    header.number_of_removed_actors = static_cast<uint32_t>(removed.size());
+    Append(data, header);
+    for (auto id : removed) {
+      Append(data, id);
+    }
+    for (auto &actor : actors) {
+      ActorDynamicState state;
+      std::memset(&state, 0, sizeof(state));
+      state.id = actor.id;
+      state.transform.location.x = actor.x;
+      Append(data, state);
+    }
+    auto state = Serializer::Deserialize(carla::Buffer(data));
+    return boost::static_pointer_cast<RawEpisodeState>(state);
+  }
+
+  Ids GetIds(const EpisodeState &state) {
+    Ids ids;
+    for (auto &actor : state) {
+      ids.emplace_back(actor.id);
+    }
+    return ids;
+  }
+
+} // namespace
+
+TEST(episode_state, removed_actors_layout) {
+  auto raw = MakeState(1u, 12u, true, 10u, {7u, 3u}, {{5u, 1.0f}, {2u, 2.0f}});
+  ASSERT_TRUE(raw->IsDelta());
+  ASSERT_EQ(raw->GetEpisodeId(), 1u);
+  ASSERT_EQ(raw->GetFrame(), 12u);
+  ASSERT_EQ(raw->GetBaseFrame(), 10u);
+  const auto removed = raw->GetRemovedActorIds();
+  ASSERT_EQ(Ids(removed.begin(), removed.end()), (Ids{7u, 3u}));
+  // The actors start after the removed ids.
+  ASSERT_EQ(raw->size(), 2u);
+  ASSERT_EQ(raw->begin()[0u].id, 5u);
+  ASSERT_EQ(raw->begin()[1u].id, 2u);
+  ASSERT_EQ(raw->begin()[1u].transform.location.x, 2.0f);
+
+  auto keyframe = MakeState(1u, 10u, false, 0u, {}, {{1u, 0.0f}});
+  ASSERT_FALSE(keyframe->IsDelta());
+  ASSERT_EQ(keyframe->GetRemovedActorIds().size(), 0u);
+  ASSERT_EQ(keyframe->size(), 1u);
+  ASSERT_EQ(keyframe->begin()->id, 1u);
+}
+
+TEST(episode_state, delta_updates_adds_and_removes_actors) {
+  const EpisodeState empty{0u};
+  auto raw_keyframe = MakeState(1u, 10u, false, 0u, {}, {{3u, 0.0f}, {1u, 0.0f}, {2u, 0.0f}});
+  const EpisodeState keyframe{*raw_keyframe, empty};
+  ASSERT_EQ(GetIds(keyframe), (Ids{1u, 2u, 3u}));
+  ASSERT_EQ(keyframe.GetAddedActorIds(), (Ids{1u, 2u, 3u}));
+
+  // Actor 2 moves, 4 is spawned and 3 is destroyed.
+  auto raw_delta = MakeState(1u, 11u, true, 10u, {3u}, {{4u, 4.0f}, {2u, 2.0f}});
+  ASSERT_TRUE(keyframe.CanApply(*raw_delta));
+  const EpisodeState delta{*raw_delta, keyframe};
+  ASSERT_EQ(delta.GetFrame(), 11u);
+  ASSERT_EQ(GetIds(delta), (Ids{1u, 2u, 4u}));
+  ASSERT_EQ(delta.GetAddedActorIds(), (Ids{4u}));
+  ASSERT_EQ(delta.GetRemovedActorIds(), (Ids{3u}));
+  ASSERT_EQ(delta.GetActorSnapshot(1u).transform.location.x, 0.0f);
+  ASSERT_EQ(delta.GetActorSnapshot(2u).transform.location.x, 2.0f);
+  ASSERT_EQ(delta.GetActorSnapshot(4u).transform.location.x, 4.0f);
+
+  // The next delta is relative to the keyframe too, it repeats the changes of
+  // the previous one.
+  auto raw_next = MakeState(1u, 12u, true, 10u, {3u, 1u}, {{4u, 5.0f}, {2u, 2.0f}});
+  ASSERT_TRUE(delta.CanApply(*raw_next));
+  const EpisodeState next{*raw_next, delta};
+  ASSERT_EQ(GetIds(next), (Ids{2u, 4u}));
+  ASSERT_TRUE(next.GetAddedActorIds().empty());
+  ASSERT_EQ(next.GetRemovedActorIds(), (Ids{1u}));
+  ASSERT_EQ(next.GetActorSnapshot(4u).transform.location.x, 5.0f);
+
+  // Applied on the keyframe directly, e.g. if the first delta was lost, it
+  // gives the same actors.
+  const EpisodeState skipped{*raw_next, keyframe};
+  ASSERT_EQ(GetIds(skipped), GetIds(next));
+  ASSERT_EQ(skipped.GetAddedActorIds(), (Ids{4u}));
+  ASSERT_EQ(skipped.GetRemovedActorIds(), (Ids{1u, 3u}));
+}
+
+TEST(episode_state, delta_on_mismatched_base_frame) {
+  const EpisodeState empty{0u};
+  auto raw_keyframe = MakeState(1u, 10u, false, 0u, {}, {{1u, 0.0f}});
+  const EpisodeState keyframe{*raw_keyframe, empty};
+
+  // A keyframe can always be applied, even from another episode.
+  ASSERT_TRUE(empty.CanApply(*raw_keyframe));
+  auto other_keyframe = MakeState(2u, 30u, false, 0u, {}, {{1u, 0.0f}});
+  ASSERT_TRUE(keyframe.CanApply(*other_keyframe));
+
+  // The keyframe of frame 20 was lost, the client is still at frame 10.
+  auto raw_delta = MakeState(1u, 21u, true, 20u, {}, {{1u, 1.0f}});
+  ASSERT_FALSE(keyframe.CanApply(*raw_delta));
+  ASSERT_FALSE(empty.CanApply(*raw_delta));
+
+  // A delta of another episode, even if the frames match.
+  auto other_delta = MakeState(2u, 11u, true, 10u, {}, {{1u, 1.0f}});
+  ASSERT_FALSE(keyframe.CanApply(*other_delta));
+
+  // Once the new keyframe arrives the deltas apply again.
+  auto raw_new_keyframe = MakeState(1u, 22u, false, 0u, {}, {{1u, 2.0f}});
+  ASSERT_TRUE(keyframe.CanApply(*raw_new_keyframe));
+  const EpisodeState new_keyframe{*raw_new_keyframe, keyframe};
+  auto raw_new_delta = MakeState(1u, 23u, true, 22u, {}, {{1u, 3.0f}});
+  ASSERT_TRUE(new_keyframe.CanApply(*raw_new_delta));
+  ASSERT_FALSE(keyframe.CanApply(*raw_new_delta));
+}
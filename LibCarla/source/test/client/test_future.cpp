@@ -0,0 +1,94 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/Future.h>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+using carla::client::Future;
+using carla::time_duration;
+
+template <typename T>
+static Future<T> make_future(std::promise<T> &promise, int &number_of_gets) {
+  auto future = std::make_shared<std::shared_future<T>>(promise.get_future().share());
+  return Future<T>(
+      [future](time_duration timeout) {
+        return future->wait_for(timeout.to_chrono()) == std::future_status::ready;
+      },
+      [future, &number_of_gets]() {
+        ++number_of_gets;
+        return future->get();
+      });
+}
+
+TEST(future, result_is_shared_by_copies) {
+  std::promise<int> promise;
+  int number_of_gets = 0;
+  const auto future = make_future(promise, number_of_gets);
+  const auto copy = future;
+  ASSERT_TRUE(future.IsValid());
+  ASSERT_FALSE(future.IsReady());
+  ASSERT_FALSE(copy.WaitFor(time_duration::milliseconds(1u)));
+  promise.set_value(42);
+  ASSERT_TRUE(future.IsReady());
+  ASSERT_EQ(future.Get(), 42);
+  ASSERT_EQ(copy.Get(), 42);
+  ASSERT_TRUE(copy.IsReady());
+  ASSERT_EQ(number_of_gets, 1);
+  ASSERT_FALSE(Future<int>().IsValid());
+}
+
+TEST(future, then_converts_the_result) {
+  std::promise<int> promise;
+  int number_of_gets = 0;
+  const auto future = make_future(promise, number_of_gets);
+  const auto converted = future.Then([](int value) { return std::to_string(value); });
+  ASSERT_FALSE(converted.IsReady());
+  promise.set_value(7);
+  ASSERT_TRUE(converted.IsReady());
+  ASSERT_EQ(converted.Get(), "7");
+  ASSERT_EQ(future.Get(), 7);
+  ASSERT_EQ(number_of_gets, 1);
+}
+
+TEST(future, exception_is_rethrown) {
+  std::promise<int> promise;
+  int number_of_gets = 0;
+  const auto future = make_future(promise, number_of_gets);
+  const auto converted = future.Then([](int value) { return 2 * value; });
+  promise.set_exception(std::make_exception_ptr(std::runtime_error("failed")));
+  ASSERT_TRUE(future.IsReady());
+  ASSERT_THROW(converted.Get(), std::runtime_error);
+  ASSERT_THROW(future.Get(), std::runtime_error);
+  ASSERT_EQ(number_of_gets, 1);
+}
+
+TEST(future, waiting_does_not_wait_for_get) {
+  std::promise<int> promise;
+  int number_of_gets = 0;
+  const auto future = make_future(promise, number_of_gets);
+  std::thread getter([&]() { ASSERT_EQ(future.Get(), 3); });
+  // Let the other thread block in Get.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  carla::StopWatch stop_watch;
+  const bool is_ready = future.IsReady();
+  const bool arrived = future.WaitFor(time_duration::milliseconds(10u));
+  stop_watch.Stop();
+  promise.set_value(3);
+  getter.join();
+  ASSERT_FALSE(is_ready);
+  ASSERT_FALSE(arrived);
+  ASSERT_LT(stop_watch.GetElapsedTime(), 1000u);
+  ASSERT_TRUE(future.IsReady());
+  ASSERT_EQ(future.Get(), 3);
+  ASSERT_EQ(number_of_gets, 1);
+}
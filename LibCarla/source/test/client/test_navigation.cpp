@@ -0,0 +1,357 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/Buffer.h>
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/nav/Navigation.h>
+#include <carla/nav/PathCache.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/data/RawEpisodeState.h>
+#include <carla/sensor/s11n/EpisodeStateSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <recast/DetourAlloc.h>
+#include <recast/DetourNavMesh.h>
+#include <recast/DetourNavMeshBuilder.h>
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using carla::client::detail::EpisodeState;
+using carla::geom::Location;
+using carla::nav::AgentRoute;
+using carla::nav::AgentRouteRequest;
+using carla::nav::Navigation;
+using carla::nav::PathCache;
+
+// =============================================================================
+// -- PathCache ----------------------------------------------------------------
+// =============================================================================
+
+static PathCache::Key MakeKey(dtPolyRef start, dtPolyRef end, unsigned short include_flags = 1u) {
+  return PathCache::Key{start, end, include_flags, 0u};
+}
+
+TEST(navigation, path_cache_get_and_put) {
+  PathCache cache(4u);
+  std::vector<dtPolyRef> polys;
+  ASSERT_FALSE(cache.Get(MakeKey(1u, 2u), polys));
+
+  cache.Put(MakeKey(1u, 2u), {1u, 5u, 2u});
+  ASSERT_TRUE(cache.Get(MakeKey(1u, 2u), polys));
+  ASSERT_EQ(polys, (std::vector<dtPolyRef>{1u, 5u, 2u}));
+
+  // The direction and the filter flags are part of the key.
+  ASSERT_FALSE(cache.Get(MakeKey(2u, 1u), polys));
+  ASSERT_FALSE(cache.Get(MakeKey(1u, 2u, 2u), polys));
+
+  // Putting an existing key replaces its path.
+  cache.Put(MakeKey(1u, 2u), {1u, 2u});
+  ASSERT_EQ(cache.Size(), 1u);
+  ASSERT_TRUE(cache.Get(MakeKey(1u, 2u), polys));
+  ASSERT_EQ(polys, (std::vector<dtPolyRef>{1u, 2u}));
+
+  cache.Clear();
+  ASSERT_EQ(cache.Size(), 0u);
+  ASSERT_FALSE(cache.Get(MakeKey(1u, 2u), polys));
+}
+
+TEST(navigation, path_cache_evicts_least_recently_used) {
+  PathCache cache(3u);
+  std::vector<dtPolyRef> polys;
+  cache.Put(MakeKey(1u, 10u), {1u});
+  cache.Put(MakeKey(2u, 10u), {2u});
+  cache.Put(MakeKey(3u, 10u), {3u});
+  ASSERT_EQ(cache.Size(), 3u);
+
+  // Using the oldest path makes the second one the least recently used.
+  ASSERT_TRUE(cache.Get(MakeKey(1u, 10u), polys));
+  cache.Put(MakeKey(4u, 10u), {4u});
+  ASSERT_EQ(cache.Size(), 3u);
+  ASSERT_FALSE(cache.Get(MakeKey(2u, 10u), polys));
+  ASSERT_TRUE(cache.Get(MakeKey(1u, 10u), polys));
+  ASSERT_TRUE(cache.Get(MakeKey(3u, 10u), polys));
+  ASSERT_TRUE(cache.Get(MakeKey(4u, 10u), polys));
+
+  // Replacing a path also makes it the most recently used, now 1 is the
+  // least recently used.
+  cache.Put(MakeKey(3u, 10u), {3u, 10u});
+  ASSERT_TRUE(cache.Get(MakeKey(4u, 10u), polys));
+  cache.Put(MakeKey(5u, 10u), {5u});
+  ASSERT_FALSE(cache.Get(MakeKey(1u, 10u), polys));
+  ASSERT_TRUE(cache.Get(MakeKey(3u, 10u), polys));
+  ASSERT_EQ(polys, (std::vector<dtPolyRef>{3u, 10u}));
+  ASSERT_TRUE(cache.Get(MakeKey(4u, 10u), polys));
+  ASSERT_TRUE(cache.Get(MakeKey(5u, 10u), polys));
+}
+
+TEST(navigation, path_cache_without_capacity) {
+  PathCache cache(0u);
+  std::vector<dtPolyRef> polys;
+  cache.Put(MakeKey(1u, 2u), {1u, 2u});
+  ASSERT_EQ(cache.Size(), 0u);
+  ASSERT_FALSE(cache.Get(MakeKey(1u, 2u), polys));
+}
+
+// =============================================================================
+// -- Routes -------------------------------------------------------------------
+// =============================================================================
+
+/// Side of the square navigation mesh, in cells.
+static constexpr int GRID_SIZE = 16;
+
+/// Navigation mesh of a single tile with a square polygon for each cell of
+/// the grid, in the binary format read by Navigation::Load.
+static std::vector<uint8_t> MakeGridNavMesh(float cell_size) {
+  constexpr unsigned short NULL_INDEX = 0xffff;
+  constexpr int nvp = 6;
+  auto vertex = [](int x, int z) {
+    return static_cast<unsigned short>(z * (GRID_SIZE + 1) + x);
+  };
+  auto poly = [](int x, int z) {
+    return static_cast<unsigned short>(z * GRID_SIZE + x);
+  };
+  auto neighbour = [&](int x, int z) {
+    return (x < 0 || z < 0 || x >= GRID_SIZE || z >= GRID_SIZE) ? NULL_INDEX : poly(x, z);
+  };
+
+  std::vector<unsigned short> verts;
+  for (int z = 0; z <= GRID_SIZE; ++z) {
+    for (int x = 0; x <= GRID_SIZE; ++x) {
+      verts.insert(verts.end(), {
+          static_cast<unsigned short>(x), 0u, static_cast<unsigned short>(z)});
+    }
+  }
+  std::vector<unsigned short> polys;
+  for (int z = 0; z < GRID_SIZE; ++z) {
+    for (int x = 0; x < GRID_SIZE; ++x) {
+      polys.insert(polys.end(), {
+          vertex(x, z), vertex(x, z + 1), vertex(x + 1, z + 1), vertex(x + 1, z),
+          NULL_INDEX, NULL_INDEX});
+      polys.insert(polys.end(), {
+          neighbour(x - 1, z), neighbour(x, z + 1), neighbour(x + 1, z), neighbour(x, z - 1),
+          NULL_INDEX, NULL_INDEX});
+    }
+  }
+  const size_t poly_count = GRID_SIZE * GRID_SIZE;
+  std::vector<unsigned short> poly_flags(poly_count, carla::nav::CARLA_TYPE_SIDEWALK);
+  std::vector<unsigned char> poly_areas(poly_count, carla::nav::CARLA_AREA_SIDEWALK);
+
+  dtNavMeshCreateParams params;
+  std::memset(&params, 0, sizeof(params));
+  params.verts = verts.data();
+  params.vertCount = static_cast<int>(verts.size() / 3u);
+  params.polys = polys.data();
+  params.polyFlags = poly_flags.data();
+  params.polyAreas = poly_areas.data();
+  params.polyCount = static_cast<int>(poly_count);
+  params.nvp = nvp;
+  params.walkableHeight = 2.0f;
+  params.walkableRadius = 0.3f;
+  params.walkableClimb = 0.9f;
+  params.bmin[0] = 0.0f;
+  params.bmin[1] = 0.0f;
+  params.bmin[2] = 0.0f;
+  params.bmax[0] = static_cast<float>(GRID_SIZE) * cell_size;
+  params.bmax[1] = 1.0f;
+  params.bmax[2] = static_cast<float>(GRID_SIZE) * cell_size;
+  params.cs = cell_size;
+  params.ch = 1.0f;
+  params.buildBvTree = true;
+
+  unsigned char *tile_data = nullptr;
+  int tile_data_size = 0;
+  EXPECT_TRUE(dtCreateNavMeshData(&params, &tile_data, &tile_data_size));
+
+  dtNavMeshParams mesh_params;
+  std::memset(&mesh_params, 0, sizeof(mesh_params));
+  mesh_params.tileWidth = static_cast<float>(GRID_SIZE) * cell_size;
+  mesh_params.tileHeight = static_cast<float>(GRID_SIZE) * cell_size;
+  mesh_params.maxTiles = 1;
+  mesh_params.maxPolys = 1024;
+
+  // Add the tile to a mesh only to get its reference.
+  dtTileRef tile_ref = 0;
+  dtNavMesh *mesh = dtAllocNavMesh();
+  EXPECT_TRUE(dtStatusSucceed(mesh->init(&mesh_params)));
+  EXPECT_TRUE(dtStatusSucceed(mesh->addTile(tile_data, tile_data_size, 0, 0, &tile_ref)));
+  dtFreeNavMesh(mesh);
+
+#pragma pack(push, 1)
+  struct NavMeshSetHeader {
+    int magic;
+    int version;
+    int num_tiles;
+    dtNavMeshParams params;
+  } header;
+  struct NavMeshTileHeader {
+    dtTileRef tile_ref;
+    int data_size;
+  } tile_header;
+#pragma pack(pop)
+  header.magic = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';
+  header.version = 1;
+  header.num_tiles = 1;
+  header.params = mesh_params;
+  tile_header.tile_ref = tile_ref;
+  tile_header.data_size = tile_data_size;
+
+  std::vector<uint8_t> content;
+  auto append = [&](const void *data, size_t size) {
+    const auto *begin = static_cast<const uint8_t *>(data);
+    content.insert(content.end(), begin, begin + size);
+  };
+  append(&header, sizeof(header));
+  append(&tile_header, sizeof(tile_header));
+  append(tile_data, static_cast<size_t>(tile_data_size));
+  dtFree(tile_data);
+  return content;
+}
+
+/// Unreal location of the center of a cell of the grid.
+static Location CellCenter(int x, int z, float cell_size = 1.0f) {
+  return {(static_cast<float>(x) + 0.5f) * cell_size, (static_cast<float>(z) + 0.5f) * cell_size, 0.9f};
+}
+
+/// Loads the grid and adds @a number_of_walkers walkers along its diagonal,
+/// and along diagonals shifted by 5 cells after the first @a GRID_SIZE.
+static void SetUpNavigation(
+    Navigation &nav,
+    size_t number_of_threads,
+    size_t number_of_walkers,
+    float cell_size = 1.0f) {
+  ASSERT_TRUE(nav.Load(MakeGridNavMesh(cell_size)));
+  nav.SetSeed(42u);
+  nav.SetNumberOfThreads(number_of_threads);
+  nav.CreateCrowd();
+  for (size_t i = 0u; i < number_of_walkers; ++i) {
+    const int x = static_cast<int>(i) % GRID_SIZE;
+    const int z = (x + 5 * (static_cast<int>(i) / GRID_SIZE)) % GRID_SIZE;
+    ASSERT_TRUE(nav.AddWalker(static_cast<carla::ActorId>(i + 1u), CellCenter(x, z, cell_size)));
+  }
+}
+
+TEST(navigation, batched_routes_match_single_routes) {
+  constexpr size_t number_of_walkers = 8u;
+  std::vector<AgentRouteRequest> requests;
+  for (int i = 0; i < 64; ++i) {
+    const auto id = static_cast<carla::ActorId>(1 + i % static_cast<int>(number_of_walkers));
+    // Some requests repeat, so the batch uses the cached paths.
+    const int from = i % 11;
+    const int to = (i * 7) % GRID_SIZE;
+    requests.push_back({id, CellCenter(from, 0), CellCenter(to, GRID_SIZE - 1)});
+  }
+  // A walker that does not exist.
+  requests.push_back({1000u, CellCenter(0, 0), CellCenter(1, 1)});
+
+  Navigation single;
+  SetUpNavigation(single, 0u, number_of_walkers);
+  Navigation batched;
+  SetUpNavigation(batched, 4u, number_of_walkers);
+
+  const std::vector<AgentRoute> routes = batched.GetAgentRoutes(requests);
+  ASSERT_EQ(routes.size(), requests.size());
+  for (size_t i = 0u; i < requests.size(); ++i) {
+    std::vector<Location> path;
+    std::vector<unsigned char> area;
+    const bool found = single.GetAgentRoute(
+        requests[i].id, requests[i].from, requests[i].to, path, area);
+    ASSERT_EQ(routes[i].found, found) << "request " << i;
+    ASSERT_EQ(routes[i].path, path) << "request " << i;
+    ASSERT_EQ(routes[i].area, area) << "request " << i;
+    ASSERT_EQ(found, requests[i].id != 1000u) << "request " << i;
+  }
+
+  // The second time the paths come from the cache.
+  const std::vector<AgentRoute> cached_routes = batched.GetAgentRoutes(requests);
+  for (size_t i = 0u; i < requests.size(); ++i) {
+    ASSERT_EQ(cached_routes[i].found, routes[i].found);
+    ASSERT_EQ(cached_routes[i].path, routes[i].path);
+    ASSERT_EQ(cached_routes[i].area, routes[i].area);
+  }
+}
+
+// =============================================================================
+// -- Crowd --------------------------------------------------------------------
+// =============================================================================
+
+namespace {
+
+  class FakeWorldObserver;
+
+  /// Deserializes the messages of sensor type 0 as episode states.
+  using Serializer = carla::sensor::CompositeSerializer<
+      std::pair<FakeWorldObserver *, carla::sensor::s11n::EpisodeStateSerializer>>;
+
+  template <typename T>
+  void Append(std::vector<unsigned char> &data, const T &value) {
+    const auto *begin = reinterpret_cast<const unsigned char *>(&value);
+    data.insert(data.end(), begin, begin + sizeof(T));
+  }
+
+  /// State of an episode without actors, as sent by the server on a tick of
+  /// @a delta_seconds.
+  std::shared_ptr<const EpisodeState> MakeTickState(float delta_seconds) {
+    using carla::sensor::data::RawEpisodeState;
+    std::vector<unsigned char> data;
+    carla::sensor::s11n::SensorHeaderSerializer::Header sensor_header{};
+    sensor_header.sensor_type = 0u;
+    sensor_header.frame = 1u;
+    Append(data, sensor_header);
+    carla::sensor::s11n::EpisodeStateSerializer::Header header{};
+    header.episode_id = 1u;
+    header.delta_seconds = delta_seconds;
+    Append(data, header);
+    auto state = Serializer::Deserialize(carla::Buffer(data));
+    return std::make_shared<EpisodeState>(*boost::static_pointer_cast<RawEpisodeState>(state));
+  }
+
+} // namespace
+
+/// Cell size of the grid in the crowd tests, so it spans 3x3 crowd tiles.
+static constexpr float CROWD_CELL_SIZE = 30.0f;
+
+/// Walks the walkers to the other side of the grid for a few seconds,
+/// updating the crowd tiles with @a number_of_threads, and returns their
+/// locations.
+static std::vector<Location> SimulateCrowd(size_t number_of_threads) {
+  constexpr size_t number_of_walkers = 48u;
+  std::vector<Location> locations;
+  Navigation nav;
+  SetUpNavigation(nav, number_of_threads, number_of_walkers, CROWD_CELL_SIZE);
+  for (size_t i = 0u; i < number_of_walkers; ++i) {
+    const int cell = static_cast<int>(i) % GRID_SIZE;
+    EXPECT_TRUE(nav.SetWalkerTarget(
+        static_cast<carla::ActorId>(i + 1u),
+        CellCenter(GRID_SIZE - 1 - cell, cell, CROWD_CELL_SIZE)));
+  }
+  const auto state = MakeTickState(0.05f);
+  for (int tick = 0; tick < 200; ++tick) {
+    nav.UpdateCrowd(*state);
+  }
+  for (size_t i = 0u; i < number_of_walkers; ++i) {
+    Location location;
+    EXPECT_TRUE(nav.GetWalkerPosition(static_cast<carla::ActorId>(i + 1u), location));
+    locations.emplace_back(location);
+  }
+  EXPECT_GT(nav.GetCrowds().size(), 1u);
+  return locations;
+}
+
+TEST(navigation, parallel_crowd_update_matches_sequential) {
+  const std::vector<Location> sequential = SimulateCrowd(1u);
+  const std::vector<Location> parallel = SimulateCrowd(4u);
+  ASSERT_EQ(parallel.size(), sequential.size());
+  for (size_t i = 0u; i < sequential.size(); ++i) {
+    ASSERT_EQ(parallel[i].x, sequential[i].x) << "walker " << i;
+    ASSERT_EQ(parallel[i].y, sequential[i].y) << "walker " << i;
+    ASSERT_EQ(parallel[i].z, sequential[i].z) << "walker " << i;
+  }
+}
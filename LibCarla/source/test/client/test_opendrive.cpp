@@ -13,10 +13,14 @@
 #include <carla/geom/Location.h>
 #include <carla/geom/Math.h>
 #include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/InformationSet.h>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/MapSnapshot.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
+#include <carla/road/element/RoadInfoLaneWidth.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
+#include <carla/road/element/RoadInfoSpeed.h>
 #include <carla/road/element/RoadInfoVisitor.h>
 
 #include <pugixml/pugixml.hpp>
@@ -222,6 +226,35 @@ static void test_road_links(boost::optional<Map>& map) {
   }
 }
 
+TEST(road, information_set_lookups) {
+  std::vector<std::unique_ptr<RoadInfo>> infos;
+  for (auto s : {30.0, 0.0, 10.0, 20.0}) {
+    infos.emplace_back(std::make_unique<RoadInfoSpeed>(s, s));
+    infos.emplace_back(std::make_unique<RoadInfoLaneWidth>(s + 5.0, s, 0.0, 0.0, 0.0));
+  }
+  InformationSet set(std::move(infos));
+
+  ASSERT_EQ(set.GetInfos<RoadInfoSpeed>().size(), 4u);
+  ASSERT_EQ(set.GetInfos<RoadInfoLaneWidth>().size(), 4u);
+  ASSERT_TRUE(set.GetInfos<RoadInfoElevation>().empty());
+  ASSERT_EQ(set.GetInfo<RoadInfoElevation>(10.0), nullptr);
+
+  ASSERT_EQ(set.GetInfo<RoadInfoSpeed>(15.0)->GetSpeed(), 10.0);
+  ASSERT_EQ(set.GetInfo<RoadInfoSpeed>(20.0)->GetSpeed(), 20.0);
+  ASSERT_EQ(set.GetInfo<RoadInfoSpeed>(100.0)->GetSpeed(), 30.0);
+  ASSERT_EQ(set.GetInfo<RoadInfoLaneWidth>(4.0), nullptr);
+  ASSERT_EQ(set.GetInfo<RoadInfoLaneWidth>(5.0)->GetDistance(), 5.0);
+
+  auto forward = set.GetInfos<RoadInfoSpeed>(5.0, 20.0);
+  ASSERT_EQ(forward.size(), 2u);
+  ASSERT_EQ(forward[0]->GetSpeed(), 10.0);
+  ASSERT_EQ(forward[1]->GetSpeed(), 20.0);
+  auto backward = set.GetInfos<RoadInfoSpeed>(20.0, 5.0);
+  ASSERT_EQ(backward.size(), 2u);
+  ASSERT_EQ(backward[0]->GetSpeed(), 20.0);
+  ASSERT_EQ(backward[1]->GetSpeed(), 10.0);
+}
+
 TEST(road, parse_files) {
   for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
     // std::cerr << file << std::endl;
@@ -378,6 +411,110 @@ TEST(road, iterate_waypoints) {
   }
 }
 
+TEST(road, parallel_load) {
+  constexpr size_t number_of_threads = 4u;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    const auto xodr = util::OpenDrive::Load(file);
+
+    carla::StopWatch sequential_watch;
+    auto sequential = OpenDriveParser::Load(xodr, 0u);
+    sequential_watch.Stop();
+    carla::StopWatch parallel_watch;
+    auto parallel = OpenDriveParser::Load(xodr, number_of_threads);
+    parallel_watch.Stop();
+    carla::logging::log(file, "loaded in", sequential_watch.GetElapsedTime(),
+        "ms sequentially and in", parallel_watch.GetElapsedTime(), "ms with",
+        number_of_threads, "threads.");
+
+    ASSERT_TRUE(sequential.has_value());
+    ASSERT_TRUE(parallel.has_value());
+    for (auto &junction_pair : sequential->GetMap().GetJunctions()) {
+      const auto &expected = junction_pair.second;
+      const auto *junction = parallel->GetJunction(junction_pair.first);
+      ASSERT_NE(junction, nullptr);
+      ASSERT_EQ(junction->GetBoundingBox(), expected.GetBoundingBox());
+      for (auto &road_pair : sequential->GetMap().GetRoads()) {
+        const auto road_id = road_pair.first;
+        ASSERT_EQ(junction->RoadHasConflicts(road_id), expected.RoadHasConflicts(road_id));
+        if (expected.RoadHasConflicts(road_id)) {
+          ASSERT_EQ(junction->GetConflictsOfRoad(road_id), expected.GetConflictsOfRoad(road_id));
+        }
+      }
+    }
+    for (auto i = 0u; i < 1'000u; ++i) {
+      const auto location = Random::Location(-500.0f, 500.0f);
+      const auto expected = sequential->GetClosestWaypointOnRoad(location);
+      const auto waypoint = parallel->GetClosestWaypointOnRoad(location);
+      ASSERT_EQ(waypoint.has_value(), expected.has_value());
+      if (expected.has_value()) {
+        ASSERT_EQ(*waypoint, *expected);
+      }
+    }
+  }
+}
+
+TEST(road, map_snapshot) {
+  using carla::road::MapSnapshot;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    const auto xodr = util::OpenDrive::Load(file);
+    const auto checksum = MapSnapshot::ComputeChecksum(xodr);
+
+    auto expected_map = OpenDriveParser::Load(xodr);
+    ASSERT_TRUE(expected_map.has_value());
+    const auto snapshot = MapSnapshot::Write(*expected_map, checksum);
+    ASSERT_TRUE(MapSnapshot::GetChecksum(snapshot).has_value());
+    ASSERT_EQ(*MapSnapshot::GetChecksum(snapshot), checksum);
+    ASSERT_FALSE(MapSnapshot::Read(snapshot, checksum + 1u).has_value());
+
+    auto corrupted = snapshot;
+    corrupted.back() ^= 0xFFu;
+    ASSERT_FALSE(MapSnapshot::GetChecksum(corrupted).has_value());
+    auto truncated = snapshot;
+    truncated.pop_back();
+    ASSERT_FALSE(MapSnapshot::GetChecksum(truncated).has_value());
+
+    carla::StopWatch full_watch;
+    auto full = OpenDriveParser::Load(xodr, 0u);
+    full_watch.Stop();
+    carla::StopWatch snapshot_watch;
+    auto map = OpenDriveParser::Load(xodr, snapshot);
+    snapshot_watch.Stop();
+    carla::logging::log(file, "loaded in", full_watch.GetElapsedTime(),
+        "ms and in", snapshot_watch.GetElapsedTime(), "ms with a snapshot of",
+        snapshot.size(), "bytes.");
+
+    ASSERT_TRUE(map.has_value());
+    for (auto &junction_pair : expected_map->GetMap().GetJunctions()) {
+      const auto &expected = junction_pair.second;
+      const auto *junction = map->GetJunction(junction_pair.first);
+      ASSERT_NE(junction, nullptr);
+      ASSERT_EQ(junction->GetBoundingBox(), expected.GetBoundingBox());
+      ASSERT_EQ(junction->GetRoadConflicts(), expected.GetRoadConflicts());
+    }
+    for (auto i = 0u; i < 1'000u; ++i) {
+      const auto location = Random::Location(-500.0f, 500.0f);
+      const auto expected = expected_map->GetClosestWaypointOnRoad(location);
+      const auto waypoint = map->GetClosestWaypointOnRoad(location);
+      ASSERT_EQ(waypoint.has_value(), expected.has_value());
+      if (expected.has_value()) {
+        // The rtree is restored in a different order, so segments at the
+        // same distance may be picked in a different order. Their
+        // projections differ by less than the length of a segment (1m).
+        const auto expected_location = expected_map->ComputeTransform(*expected).location;
+        const auto waypoint_location = map->ComputeTransform(*waypoint).location;
+        ASSERT_NEAR(
+            carla::geom::Math::Distance(location, waypoint_location),
+            carla::geom::Math::Distance(location, expected_location),
+            1.0f);
+      }
+    }
+
+    // A snapshot of another map is ignored.
+    auto other = OpenDriveParser::Load(xodr + " ", snapshot);
+    ASSERT_TRUE(other.has_value());
+  }
+}
+
 TEST(road, get_waypoint) {
   carla::ThreadPool pool;
   pool.AsyncRun();
@@ -424,3 +561,86 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, get_waypoints_batched) {
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    std::vector<Location> locations;
+    for (auto i = 0u; i < 2'000u; ++i) {
+      locations.emplace_back(Random::Location(-500.0f, 500.0f));
+    }
+    for (auto number_of_threads : {0u, 4u}) {
+      auto closest = map.GetClosestWaypointsOnRoad(locations, static_cast<int32_t>(Lane::LaneType::Driving), number_of_threads);
+      auto inside = map.GetWaypoints(locations, static_cast<int32_t>(Lane::LaneType::Driving), number_of_threads);
+      ASSERT_EQ(closest.size(), locations.size());
+      ASSERT_EQ(inside.size(), locations.size());
+      for (auto i = 0u; i < locations.size(); ++i) {
+        auto expected = map.GetClosestWaypointOnRoad(locations[i]);
+        ASSERT_EQ(closest[i].has_value(), expected.has_value());
+        if (expected.has_value()) {
+          // Segments at the same distance, e.g. sharing the closest end point,
+          // may be picked in a different order. Their projections differ by
+          // less than the length of a segment in curves (1m).
+          const auto dist_expected = Math::Distance(map.ComputeTransform(*expected).location, locations[i]);
+          const auto dist = Math::Distance(map.ComputeTransform(*closest[i]).location, locations[i]);
+          ASSERT_NEAR(dist, dist_expected, 1.0f);
+          if (*closest[i] == *expected) {
+            ASSERT_EQ(inside[i].has_value(), map.GetWaypoint(locations[i]).has_value());
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(road, lane_transform_tables) {
+  constexpr double max_error = 0.001;
+  constexpr float max_angle_error = 0.05f;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    std::vector<Waypoint> waypoints;
+    std::vector<carla::geom::Transform> exact;
+    for (auto &waypoint : map.GenerateWaypoints(0.1)) {
+      // The tables are only built on request, the transforms of a loaded map
+      // are exact.
+      const auto &lane = map.GetLane(waypoint);
+      ASSERT_EQ(lane.GetTransformTable(), nullptr);
+      waypoints.emplace_back(waypoint);
+      exact.emplace_back(lane.ComputeTransformExact(waypoint.s));
+      ASSERT_EQ(map.ComputeTransform(waypoint), exact.back());
+    }
+
+    map.BuildLaneTransformTables(max_error);
+    for (auto &waypoint : waypoints) {
+      ASSERT_NE(map.GetLane(waypoint).GetTransformTable(), nullptr);
+    }
+
+    double location_error = 0.0;
+    float angle_error = 0.0f;
+    auto angle_difference = [](float a, float b) {
+      const float diff = std::fmod(std::abs(a - b), 360.0f);
+      return std::min(diff, 360.0f - diff);
+    };
+    for (auto i = 0u; i < waypoints.size(); ++i) {
+      const auto sampled = map.ComputeTransform(waypoints[i]);
+      location_error = std::max<double>(location_error,
+          Math::Distance(exact[i].location, sampled.location));
+      angle_error = std::max(angle_error,
+          angle_difference(exact[i].rotation.yaw, sampled.rotation.yaw));
+      angle_error = std::max(angle_error,
+          angle_difference(exact[i].rotation.pitch, sampled.rotation.pitch));
+    }
+    ASSERT_LE(location_error, max_error) << file;
+    ASSERT_LE(angle_error, max_angle_error) << file;
+
+    map.ClearLaneTransformTables();
+    for (auto i = 0u; i < waypoints.size(); ++i) {
+      ASSERT_EQ(map.ComputeTransform(waypoints[i]), exact[i]);
+    }
+  }
+}
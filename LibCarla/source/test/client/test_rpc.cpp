@@ -13,7 +13,9 @@
 #include <carla/rpc/Response.h>
 #include <carla/rpc/Server.h>
 
+#include <future>
 #include <thread>
+#include <vector>
 
 using namespace carla::rpc;
 using namespace std::chrono_literals;
@@ -62,3 +64,91 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, server_bind_read_only_run_without_game_thread) {
+  const auto main_thread_id = std::this_thread::get_id();
+
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindSync("sync_call", []() -> int { return 0; });
+
+  std::atomic_int calls_running{0};
+  std::atomic_int max_calls_running{0};
+  server.BindReadOnly("read_only_call", [&](int x) -> int {
+    EXPECT_NE(std::this_thread::get_id(), main_thread_id);
+    const auto running = ++calls_running;
+    auto max_running = max_calls_running.load();
+    while (running > max_running && !max_calls_running.compare_exchange_weak(max_running, running)) {}
+    std::this_thread::sleep_for(1ms);
+    --calls_running;
+    return 2 * x;
+  });
+
+  server.AsyncRun(4u, 2u);
+
+  // The game thread never runs, read-only calls are served anyway.
+  constexpr auto number_of_clients = 4;
+  constexpr auto number_of_calls = 50;
+  std::atomic_int done{0};
+  {
+    carla::ThreadGroup threads;
+    threads.CreateThreads(number_of_clients, [&]() {
+      Client client("localhost", port);
+      for (auto i = 0; i < number_of_calls; ++i) {
+        auto result = client.call("read_only_call", i).as<int>();
+        EXPECT_EQ(result, 2 * i);
+      }
+      ++done;
+    });
+  }
+  ASSERT_EQ(done, number_of_clients);
+  ASSERT_LE(max_calls_running, 2);
+
+  const auto stats = server.GetEndpointStats();
+  ASSERT_EQ(stats.size(), 2u);
+  ASSERT_EQ(stats[0u].name, "sync_call");
+  ASSERT_EQ(stats[0u].binding, BindingType::Sync);
+  ASSERT_EQ(stats[0u].calls, 0u);
+  ASSERT_EQ(stats[1u].name, "read_only_call");
+  ASSERT_EQ(stats[1u].binding, BindingType::ReadOnly);
+  ASSERT_EQ(stats[1u].calls, static_cast<uint64_t>(number_of_clients * number_of_calls));
+  ASSERT_GE(stats[1u].p50, 1.0);
+  ASSERT_LE(stats[1u].p50, stats[1u].p99);
+  ASSERT_LE(stats[1u].p99, stats[1u].maximum);
+
+  server.ResetEndpointStats();
+  ASSERT_EQ(server.GetEndpointStats()[1u].calls, 0u);
+}
+
+TEST(rpc, client_future_call_pipelined) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindSync("do_the_thing", [](int x, int y) -> int { return x + y; });
+
+  server.AsyncRun(1u);
+
+  // All the requests are sent before the game thread serves any of them.
+  constexpr auto number_of_calls = 300;
+  Client client("localhost", port);
+  std::vector<std::future<clmdep_msgpack::object_handle>> futures;
+  for (auto i = 0; i < number_of_calls; ++i) {
+    futures.emplace_back(client.future_call("do_the_thing", i, 1));
+  }
+
+  auto slices = 0u;
+  for (; slices < 1'000'000u; ++slices) {
+    server.SyncRunFor(2ms);
+    if (futures.back().wait_for(0ms) == std::future_status::ready) {
+      break;
+    }
+  }
+  std::cout << "game thread: run " << slices << " slices.\n";
+  for (auto i = 0; i < number_of_calls; ++i) {
+    ASSERT_EQ(futures[i].wait_for(0ms), std::future_status::ready);
+    ASSERT_EQ(futures[i].get().as<int>(), i + 1);
+  }
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/ActorLifecycleLog.h>
+#include <carla/trafficmanager/ActorLifecycleTracker.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace carla::traffic_manager;
+using carla::client::detail::ActorLifecycleChanges;
+using carla::client::detail::ActorLifecycleLog;
+using Ids = std::vector<ActorId>;
+
+namespace {
+
+  /// Actors of a world snapshot, as used by the tracker.
+  struct TestSnapshot {
+    struct Actor {
+      ActorId id;
+    };
+
+    uint64_t episode_id;
+    uint64_t frame;
+    std::vector<Actor> actors;
+
+    uint64_t GetId() const { return episode_id; }
+    uint64_t GetFrame() const { return frame; }
+    bool Contains(ActorId id) const {
+      return std::any_of(actors.begin(), actors.end(), [=](const Actor &a) { return a.id == id; });
+    }
+    auto begin() const { return actors.begin(); }
+    auto end() const { return actors.end(); }
+  };
+
+  /// Registered vehicles, as used by the tracker.
+  struct TestRegisteredVehicles {
+    int state = 0;
+    Ids ids;
+
+    void Set(Ids new_ids) {
+      ids = std::move(new_ids);
+      ++state;
+    }
+    int GetState() const { return state; }
+    Ids GetIDList() const { return ids; }
+  };
+
+  ActorLifecycleChanges GetChanges(
+      const ActorLifecycleTracker &tracker,
+      const ActorLifecycleLog &log,
+      uint64_t to_frame) {
+    uint64_t episode_id;
+    uint64_t frame;
+    ActorLifecycleChanges changes;
+    if (tracker.GetTrackedFrame(episode_id, frame)) {
+      changes = log.GetChanges(episode_id, frame, to_frame);
+    }
+    return changes;
+  }
+
+} // namespace
+
+TEST(traffic_manager_actor_lifecycle, registered_and_destroyed_between_updates) {
+  ActorLifecycleLog log;
+  log.Reset(1u, 10u);
+  ActorLifecycleTracker tracker;
+  TestRegisteredVehicles registered;
+
+  // First update compares with the snapshot.
+  auto update = tracker.Update(TestSnapshot{1u, 10u, {{1u}, {2u}}}, {}, registered);
+  ASSERT_EQ(update.new_actors, (Ids{1u, 2u}));
+
+  // Vehicle 3 is spawned, registered and destroyed in frames the traffic
+  // manager skipped, the log nets it out.
+  log.Record(11u, {3u}, {});
+  log.Record(13u, {}, {3u});
+  registered.Set({2u, 3u});
+  const TestSnapshot snapshot{1u, 14u, {{1u}, {2u}}};
+  update = tracker.Update(snapshot, GetChanges(tracker, log, 14u), registered);
+  ASSERT_TRUE(update.new_actors.empty());
+  ASSERT_TRUE(update.destroyed_actors.empty());
+  ASSERT_EQ(update.registered_actors, (Ids{2u}));
+  ASSERT_EQ(update.dead_registered_actors, (Ids{3u}));
+
+  // Once the ALSM removes it, nothing else is reported.
+  registered.Set({2u});
+  update = tracker.Update(snapshot, GetChanges(tracker, log, 14u), registered);
+  ASSERT_TRUE(update.new_actors.empty());
+  ASSERT_TRUE(update.registered_actors.empty());
+  ASSERT_TRUE(update.dead_registered_actors.empty());
+}
+
+TEST(traffic_manager_actor_lifecycle, registered_and_destroyed_without_log) {
+  ActorLifecycleTracker tracker;
+  TestRegisteredVehicles registered;
+
+  auto update = tracker.Update(TestSnapshot{1u, 10u, {{1u}, {2u}}}, {}, registered);
+  ASSERT_EQ(update.new_actors, (Ids{1u, 2u}));
+  registered.Set({1u, 2u});
+  tracker.Update(TestSnapshot{1u, 11u, {{1u}, {2u}}}, {}, registered);
+
+  // The log does not cover the frames, vehicle 3 was registered and destroyed
+  // and vehicle 1 was destroyed.
+  registered.Set({1u, 2u, 3u});
+  update = tracker.Update(TestSnapshot{1u, 100u, {{2u}, {4u}}}, {}, registered);
+  ASSERT_EQ(update.new_actors, (Ids{4u}));
+  ASSERT_EQ(update.destroyed_actors, (Ids{1u}));
+  ASSERT_EQ(update.dead_registered_actors, (Ids{3u}));
+
+  // The ALSM removes them, destroyed registered vehicles are reported once.
+  registered.Set({2u});
+  update = tracker.Update(TestSnapshot{1u, 200u, {{4u}}}, {}, registered);
+  ASSERT_EQ(update.destroyed_actors, (Ids{2u}));
+  ASSERT_TRUE(update.dead_registered_actors.empty());
+}
+
+TEST(traffic_manager_actor_lifecycle, unregistered_while_alive) {
+  ActorLifecycleLog log;
+  log.Reset(1u, 10u);
+  ActorLifecycleTracker tracker;
+  TestRegisteredVehicles registered;
+  registered.Set({1u, 2u});
+
+  auto update = tracker.Update(TestSnapshot{1u, 10u, {{1u}, {2u}}}, {}, registered);
+  ASSERT_EQ(update.new_actors, (Ids{1u, 2u}));
+  ASSERT_EQ(update.registered_actors, (Ids{1u, 2u}));
+
+  registered.Set({2u});
+  update = tracker.Update(TestSnapshot{1u, 11u, {{1u}, {2u}}}, GetChanges(tracker, log, 11u), registered);
+  ASSERT_EQ(update.new_actors, (Ids{1u}));
+  ASSERT_TRUE(update.dead_registered_actors.empty());
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/geom/Math.h>
+#include <carla/trafficmanager/BroadphaseGrid.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace carla::traffic_manager;
+
+static constexpr float CELL_SIZE = 20.0f;
+
+/// Checks that the grid finds every location closer than @a radius to
+/// @a location, as a brute-force search over all of them does.
+static void CheckSuperset(
+    const BroadphaseGrid &grid,
+    const std::vector<cg::Location> &locations,
+    const cg::Location &location,
+    const float radius) {
+  std::set<unsigned long> near;
+  grid.ForEachNear(location, radius, [&](const unsigned long index) {
+    // Every index is visited once.
+    ASSERT_TRUE(near.insert(index).second);
+  });
+  for (unsigned long index = 0u; index < locations.size(); ++index) {
+    if (carla::geom::Math::DistanceSquared(locations[index], location) < radius * radius) {
+      ASSERT_EQ(near.count(index), 1u)
+          << "missing actor " << index << " radius " << radius;
+    }
+  }
+}
+
+TEST(traffic_manager_broadphase_grid, superset_of_brute_force) {
+  std::mt19937 generator(42u);
+  std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+  std::uniform_real_distribution<float> height(-5.0f, 5.0f);
+  // Radii of a stopped vehicle up to a vehicle at high speed, and one larger
+  // than the map.
+  const std::vector<float> radii = {0.5f, 8.0f, 20.0f, 35.0f, 60.0f, 2000.0f};
+
+  std::vector<cg::Location> locations;
+  BroadphaseGrid grid(CELL_SIZE);
+  for (unsigned long index = 0u; index < 2000u; ++index) {
+    locations.emplace_back(coordinate(generator), coordinate(generator), height(generator));
+    grid.Insert(locations.back(), index);
+  }
+  for (int i = 0; i < 200; ++i) {
+    const cg::Location location(coordinate(generator), coordinate(generator), height(generator));
+    for (const float radius : radii) {
+      CheckSuperset(grid, locations, location, radius);
+    }
+  }
+  // Around the actors themselves, and on the borders of the cells.
+  for (unsigned long index = 0u; index < locations.size(); index += 50u) {
+    for (const float radius : radii) {
+      CheckSuperset(grid, locations, locations[index], radius);
+    }
+  }
+  for (const float x : {-CELL_SIZE, 0.0f, CELL_SIZE}) {
+    for (const float radius : radii) {
+      CheckSuperset(grid, locations, cg::Location(x, x, 0.0f), radius);
+    }
+  }
+}
+
+TEST(traffic_manager_broadphase_grid, locations_on_cell_borders) {
+  std::vector<cg::Location> locations;
+  BroadphaseGrid grid(CELL_SIZE);
+  for (int x = -3; x <= 3; ++x) {
+    for (int y = -3; y <= 3; ++y) {
+      locations.emplace_back(x * CELL_SIZE, y * CELL_SIZE, 0.0f);
+      grid.Insert(locations.back(), locations.size() - 1u);
+      locations.emplace_back(x * CELL_SIZE - 0.001f, y * CELL_SIZE - 0.001f, 0.0f);
+      grid.Insert(locations.back(), locations.size() - 1u);
+    }
+  }
+  for (const auto &location : locations) {
+    CheckSuperset(grid, locations, location, 0.01f);
+    CheckSuperset(grid, locations, location, CELL_SIZE);
+  }
+}
+
+TEST(traffic_manager_broadphase_grid, clear) {
+  BroadphaseGrid grid(CELL_SIZE);
+  grid.Insert(cg::Location(1.0f, 1.0f, 0.0f), 0u);
+  grid.Clear();
+  size_t count = 0u;
+  grid.ForEachNear(cg::Location(), 100.0f, [&](unsigned long) { ++count; });
+  ASSERT_EQ(count, 0u);
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/trafficmanager/Parameters.h>
+
+#include <vector>
+
+using namespace carla::traffic_manager;
+
+TEST(traffic_manager_parameters, snapshot_applies_global_parameters) {
+  Parameters parameters;
+  parameters.SetGlobalDistanceToLeadingVehicle(5.0f);
+  parameters.SetGlobalPercentageSpeedDifference(50.0f);
+  parameters.SetGlobalLaneOffset(0.5f);
+  parameters.SetSynchronousMode(true);
+
+  const std::vector<ActorId> vehicle_ids = {7u, 3u, 11u};
+  parameters.PublishSnapshot(vehicle_ids);
+  const ParameterSnapshot &snapshot = parameters.GetSnapshot();
+  ASSERT_EQ(snapshot.vehicle_ids, vehicle_ids);
+  ASSERT_EQ(snapshot.vehicles.size(), vehicle_ids.size());
+  ASSERT_TRUE(snapshot.synchronous_mode);
+  for (const auto &vehicle : snapshot.vehicles) {
+    ASSERT_EQ(vehicle.distance_to_leading_vehicle, 5.0f);
+    ASSERT_EQ(vehicle.GetTargetVelocity(60.0f), 30.0f);
+    ASSERT_EQ(vehicle.lane_offset, 0.5f);
+    ASSERT_TRUE(vehicle.auto_lane_change);
+    ASSERT_FALSE(vehicle.force_lane_change.change_lane);
+    ASSERT_TRUE(vehicle.GetCollisionDetection(1u));
+    ASSERT_FALSE(vehicle.has_custom_path);
+  }
+}
+
+TEST(traffic_manager_parameters, snapshot_is_copied_on_change) {
+  Parameters parameters;
+  std::vector<ActorId> vehicle_ids = {1u, 2u};
+  parameters.PublishSnapshot(vehicle_ids);
+  const ParameterSnapshot *first = &parameters.GetSnapshot();
+
+  // Nothing changed, the stages keep the same snapshot.
+  parameters.PublishSnapshot(vehicle_ids);
+  ASSERT_EQ(&parameters.GetSnapshot(), first);
+
+  // A setter changes the staged parameters, not the published snapshot.
+  parameters.UpdateUploadPath(2u, Path{cg::Location(1.0f, 2.0f, 3.0f)});
+  ASSERT_FALSE(first->vehicles.at(1u).has_custom_path);
+  parameters.PublishSnapshot(vehicle_ids);
+  ASSERT_FALSE(parameters.GetSnapshot().vehicles.at(0u).has_custom_path);
+  ASSERT_TRUE(parameters.GetSnapshot().vehicles.at(1u).has_custom_path);
+
+  // The vehicles are indexed as the vehicle id list.
+  vehicle_ids = {2u, 1u, 3u};
+  parameters.PublishSnapshot(vehicle_ids);
+  ASSERT_EQ(parameters.GetSnapshot().vehicles.size(), 3u);
+  ASSERT_TRUE(parameters.GetSnapshot().vehicles.at(0u).has_custom_path);
+  ASSERT_FALSE(parameters.GetSnapshot().vehicles.at(1u).has_custom_path);
+}
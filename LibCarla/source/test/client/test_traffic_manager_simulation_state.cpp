@@ -0,0 +1,83 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/trafficmanager/SimulationState.h>
+
+#include <vector>
+
+using namespace carla::traffic_manager;
+
+static void AddTestActor(SimulationState &state, ActorId actor_id) {
+  const float value = static_cast<float>(actor_id);
+  KinematicState kinematic_state{cg::Location(value, 0.0f, 0.0f), cg::Rotation(),
+                                 cg::Vector3D(0.0f, value, 0.0f), value,
+                                 true, false, cg::Location()};
+  StaticAttributes attributes{ActorType::Vehicle, value, 1.0f, 1.0f};
+  TrafficLightState tl_state{TLS::Green, false};
+  state.AddActor(actor_id, kinematic_state, attributes, tl_state);
+}
+
+static void CheckConsistent(const SimulationState &state) {
+  for (unsigned long index = 0u; index < state.Size(); ++index) {
+    const ActorId actor_id = state.GetActorId(index);
+    const float value = static_cast<float>(actor_id);
+    ASSERT_EQ(state.GetIndex(actor_id), index);
+    ASSERT_EQ(state.GetLocation(index).x, value);
+    ASSERT_EQ(state.GetVelocity(index).y, value);
+    ASSERT_EQ(state.GetSpeedLimit(index), value);
+    ASSERT_EQ(state.GetDimensions(index).x, value);
+  }
+}
+
+TEST(traffic_manager_simulation_state, remove_keeps_arrays_dense) {
+  SimulationState state;
+  for (ActorId actor_id = 1u; actor_id <= 10u; ++actor_id) {
+    AddTestActor(state, actor_id);
+  }
+  state.RemoveActor(3u);
+  state.RemoveActor(10u);
+  state.RemoveActor(42u);
+  ASSERT_EQ(state.Size(), 8u);
+  ASSERT_FALSE(state.ContainsActor(3u));
+  ASSERT_FALSE(state.ContainsActor(10u));
+  CheckConsistent(state);
+}
+
+TEST(traffic_manager_simulation_state, arrange_follows_vehicle_list) {
+  SimulationState state;
+  for (ActorId actor_id = 1u; actor_id <= 10u; ++actor_id) {
+    AddTestActor(state, actor_id);
+  }
+  const std::vector<ActorId> vehicle_id_list = {7u, 2u, 9u, 1u};
+  state.ArrangeActors(vehicle_id_list);
+  for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+    ASSERT_EQ(state.GetActorId(index), vehicle_id_list[index]);
+  }
+  ASSERT_EQ(state.Size(), 10u);
+  CheckConsistent(state);
+}
+
+TEST(traffic_manager_simulation_state, update_by_index) {
+  SimulationState state;
+  AddTestActor(state, 1u);
+  AddTestActor(state, 2u);
+  const unsigned long index = state.GetIndex(2u);
+  KinematicState kinematic_state{cg::Location(5.0f, 6.0f, 7.0f), cg::Rotation(0.0f, 90.0f, 0.0f),
+                                 cg::Vector3D(), 30.0f, false, true, cg::Location()};
+  state.UpdateKinematicState(index, kinematic_state);
+  ASSERT_EQ(state.GetLocation(index), cg::Location(5.0f, 6.0f, 7.0f));
+  ASSERT_FALSE(state.IsPhysicsEnabled(index));
+  ASSERT_TRUE(state.IsDormant(index));
+  ASSERT_NEAR(state.GetHeading(index).y, 1.0f, 1e-5f);
+  ASSERT_EQ(state.GetLocation(state.GetIndex(1u)).x, 1.0f);
+
+  // The green-yellow transition is not notified to the vehicle.
+  state.UpdateTrafficLightState(index, {TLS::Green, true});
+  state.UpdateTrafficLightState(index, {TLS::Yellow, true});
+  ASSERT_EQ(state.GetTLS(index).tl_state, TLS::Green);
+}
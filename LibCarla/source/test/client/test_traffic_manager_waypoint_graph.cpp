@@ -0,0 +1,233 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/geom/Math.h>
+#include <carla/trafficmanager/MappedFile.h>
+#include <carla/trafficmanager/WaypointGraph.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace carla::traffic_manager;
+
+static constexpr uint64_t CHECKSUM = 0x1234u;
+
+/// Builds lanes of waypoints scattered over a few hundred meters, each one
+/// linked to the next waypoint of its lane.
+static NodeList MakeTopology() {
+  std::mt19937 rng(42u);
+  std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+  NodeList topology;
+  for (int lane = 0; lane < 8; ++lane) {
+    for (int i = 0; i < 60; ++i) {
+      const cg::Location location(
+          static_cast<float>(i) * 5.0f + noise(rng),
+          static_cast<float>(lane) * 40.0f + noise(rng),
+          noise(rng));
+      const cg::Transform transform(location, cg::Rotation(0.0f, static_cast<float>(lane * 10), 0.0f));
+      const uint64_t id = static_cast<uint64_t>(topology.size()) + 100u;
+      topology.push_back(std::make_shared<SimpleWaypoint>(
+          nullptr, 1u, lane + 1, static_cast<float>(i), id, transform, lane));
+    }
+  }
+  for (size_t i = 0u; i < topology.size(); ++i) {
+    topology[i]->SetIndex(static_cast<WaypointIndex>(i));
+    if ((i + 1u) % 60u != 0u) {
+      topology[i]->SetNextWaypoint({topology[i + 1u]});
+      topology[i + 1u]->SetPreviousWaypoint({topology[i]});
+    }
+  }
+  topology[5]->SetRightWaypoint(topology[65]);
+  topology[70]->SetIsJunction(true);
+  return topology;
+}
+
+static WaypointIndex BruteForceClosest(const NodeList &topology, const cg::Location &location) {
+  WaypointIndex closest = INVALID_WAYPOINT_INDEX;
+  float closest_distance = std::numeric_limits<float>::max();
+  for (const auto &swp : topology) {
+    const float distance = cg::Math::DistanceSquared(swp->GetLocation(), location);
+    if (distance < closest_distance) {
+      closest_distance = distance;
+      closest = swp->GetIndex();
+    }
+  }
+  return closest;
+}
+
+static void CheckClosest(const WaypointGraph &graph, const NodeList &topology) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> coordinate(-150.0f, 450.0f);
+  for (int i = 0; i < 500; ++i) {
+    const cg::Location location(coordinate(rng), coordinate(rng), coordinate(rng) * 0.01f);
+    const WaypointIndex expected = BruteForceClosest(topology, location);
+    const WaypointIndex closest = graph.GetClosestWaypoint(location);
+    ASSERT_NE(closest, INVALID_WAYPOINT_INDEX);
+    ASSERT_FLOAT_EQ(graph.DistanceSquared(closest, location), graph.DistanceSquared(expected, location));
+  }
+}
+
+static void CheckTopology(const WaypointGraph &graph, const NodeList &topology) {
+  ASSERT_EQ(graph.Size(), topology.size());
+  for (const auto &swp : topology) {
+    const WaypointIndex index = swp->GetIndex();
+    ASSERT_EQ(graph.GetLocation(index), swp->GetLocation());
+    ASSERT_EQ(graph.GetId(index), swp->GetId());
+    ASSERT_EQ(graph.GetLaneId(index), swp->GetLaneId());
+    ASSERT_EQ(graph.GetDistance(index), swp->GetDistance());
+    ASSERT_EQ(graph.GetGeodesicGridId(index), swp->GetGeodesicGridId());
+    ASSERT_EQ(graph.CheckJunction(index), swp->CheckJunction());
+    ASSERT_EQ(graph.GetNext(index).size(), swp->GetNextWaypoint().size());
+    ASSERT_EQ(graph.GetPrevious(index).size(), swp->GetPreviousWaypoint().size());
+  }
+  ASSERT_EQ(graph.GetRight(5u), 65u);
+  ASSERT_EQ(graph.GetLeft(5u), INVALID_WAYPOINT_INDEX);
+  ASSERT_EQ(graph.GetNext(0u).front(), 1u);
+}
+
+static std::vector<uint8_t> Cook(const WaypointGraph &graph, const std::string &path) {
+  {
+    std::ofstream out_file(path, std::ios::binary);
+    graph.Write(out_file, CHECKSUM);
+  }
+  std::ifstream in_file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in_file), {});
+}
+
+TEST(traffic_manager_waypoint_graph, closest_waypoint) {
+  const NodeList topology = MakeTopology();
+  WaypointGraph graph;
+  graph.SetUpSpatialIndex(topology);
+  graph.SetUpTopology(topology);
+  CheckClosest(graph, topology);
+}
+
+TEST(traffic_manager_waypoint_graph, waypoints_in_box) {
+  const NodeList topology = MakeTopology();
+  WaypointGraph graph;
+  graph.SetUpSpatialIndex(topology);
+  const cg::Location min_corner(40.0f, 30.0f, -10.0f);
+  const cg::Location max_corner(120.0f, 130.0f, 10.0f);
+  size_t found = 0u;
+  graph.ForEachWaypointInBox(min_corner, max_corner, [&](const WaypointIndex) {
+    ++found;
+    return true;
+  });
+  size_t expected = 0u;
+  for (const auto &swp : topology) {
+    const cg::Location location = swp->GetLocation();
+    if (location.x > min_corner.x && location.x < max_corner.x &&
+        location.y > min_corner.y && location.y < max_corner.y) {
+      ++expected;
+    }
+  }
+  ASSERT_EQ(found, expected);
+}
+
+TEST(traffic_manager_waypoint_graph, cooked_layout_in_place) {
+  const NodeList topology = MakeTopology();
+  WaypointGraph graph;
+  graph.SetUpSpatialIndex(topology);
+  graph.SetUpTopology(topology);
+
+  const std::string path = "test_traffic_manager_waypoint_graph.bin";
+  const std::vector<uint8_t> content = Cook(graph, path);
+  ASSERT_TRUE(WaypointGraph::HasCookedHeader(content.data(), content.size()));
+
+  auto file = MappedFile::Open(path);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->size(), content.size());
+  WaypointGraph cooked;
+  ASSERT_TRUE(cooked.View(file, file->data(), file->size(), CHECKSUM));
+  ASSERT_EQ(cooked.GetMemoryUsage(), 0u);
+  CheckTopology(cooked, topology);
+  CheckClosest(cooked, topology);
+
+  file.reset();
+  std::remove(path.c_str());
+}
+
+TEST(traffic_manager_waypoint_graph, cooked_layout_rejected) {
+  const NodeList topology = MakeTopology();
+  WaypointGraph graph;
+  graph.SetUpSpatialIndex(topology);
+  graph.SetUpTopology(topology);
+
+  const std::string path = "test_traffic_manager_waypoint_graph_rejected.bin";
+  auto content = std::make_shared<std::vector<uint8_t>>(Cook(graph, path));
+  std::remove(path.c_str());
+
+  WaypointGraph cooked;
+  // Cooked for another OpenDRIVE map.
+  ASSERT_FALSE(cooked.View(content, content->data(), content->size(), CHECKSUM + 1u));
+  // Truncated.
+  ASSERT_FALSE(cooked.View(content, content->data(), content->size() / 2u, CHECKSUM));
+  ASSERT_EQ(cooked.Size(), 0u);
+  // Outdated version.
+  std::vector<uint8_t> outdated = *content;
+  outdated[sizeof(uint32_t)] = 1u;
+  ASSERT_FALSE(cooked.View(nullptr, outdated.data(), outdated.size(), CHECKSUM));
+  ASSERT_TRUE(cooked.View(content, content->data(), content->size(), CHECKSUM));
+}
+
+TEST(traffic_manager_waypoint_graph, cooked_layout_corrupted) {
+  const NodeList topology = MakeTopology();
+  WaypointGraph graph;
+  graph.SetUpSpatialIndex(topology);
+  graph.SetUpTopology(topology);
+
+  const std::string path = "test_traffic_manager_waypoint_graph_corrupted.bin";
+  const std::vector<uint8_t> content = Cook(graph, path);
+  std::remove(path.c_str());
+
+  // The spatial index is the last section, an index out of range is rejected.
+  std::vector<uint8_t> corrupted = content;
+  std::fill(corrupted.end() - sizeof(WaypointIndex), corrupted.end(), uint8_t(0xFFu));
+  WaypointGraph cooked;
+  ASSERT_FALSE(cooked.View(nullptr, corrupted.data(), corrupted.size(), CHECKSUM));
+  ASSERT_EQ(cooked.Size(), 0u);
+
+  // Whatever word is corrupted, a graph accepted must stay within its arrays.
+  size_t rejected = 0u;
+  for (size_t i = 0u; i + sizeof(uint32_t) <= content.size(); i += sizeof(uint32_t)) {
+    corrupted = content;
+    std::fill(corrupted.begin() + i, corrupted.begin() + i + sizeof(uint32_t), uint8_t(0xFFu));
+    if (!cooked.View(nullptr, corrupted.data(), corrupted.size(), CHECKSUM)) {
+      ASSERT_EQ(cooked.Size(), 0u);
+      ++rejected;
+      continue;
+    }
+    const WaypointIndex size = cooked.Size();
+    ASSERT_EQ(size, topology.size());
+    for (WaypointIndex index = 0u; index < size; ++index) {
+      for (const WaypointIndex next : cooked.GetNext(index)) {
+        ASSERT_LT(next, size);
+      }
+      for (const WaypointIndex previous : cooked.GetPrevious(index)) {
+        ASSERT_LT(previous, size);
+      }
+      const WaypointIndex left = cooked.GetLeft(index);
+      const WaypointIndex right = cooked.GetRight(index);
+      ASSERT_TRUE(left == INVALID_WAYPOINT_INDEX || left < size);
+      ASSERT_TRUE(right == INVALID_WAYPOINT_INDEX || right < size);
+    }
+    cooked.ForEachWaypointInBox(
+        cg::Location(-1000.0f, -1000.0f, -1000.0f),
+        cg::Location(1000.0f, 1000.0f, 1000.0f),
+        [&](const WaypointIndex index) {
+          EXPECT_LT(index, size);
+          return true;
+        });
+  }
+  ASSERT_GT(rejected, 0u);
+  ASSERT_TRUE(cooked.View(nullptr, content.data(), content.size(), CHECKSUM));
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/trafficmanager/RandomGenerator.h>
+#include <carla/trafficmanager/WorkerPool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using carla::traffic_manager::RandomGenerator;
+using carla::traffic_manager::WorkerPool;
+
+TEST(traffic_manager_worker_pool, every_index_runs_once) {
+  WorkerPool pool;
+  for (auto threads : {0u, 1u, 2u, 5u, 8u}) {
+    pool.SetNumberOfThreads(threads);
+    for (auto size : {0ul, 1ul, 3ul, 100ul, 1013ul}) {
+      std::vector<std::atomic<int>> counts(size);
+      for (auto &count : counts) {
+        count = 0;
+      }
+      pool.ParallelFor(size, [&](const unsigned long index) {
+        ++counts[index];
+      });
+      for (auto &count : counts) {
+        ASSERT_EQ(count.load(), 1);
+      }
+    }
+  }
+}
+
+TEST(traffic_manager_worker_pool, unbalanced_load) {
+  WorkerPool pool;
+  pool.SetNumberOfThreads(4u);
+  constexpr unsigned long size = 64u;
+  std::atomic<unsigned long> total{0u};
+  pool.ParallelFor(size, [&](const unsigned long index) {
+    // The first block is much more expensive than the rest, the other threads
+    // have to steal from it.
+    if (index < size / 4u) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    total += index;
+  });
+  ASSERT_EQ(total.load(), size * (size - 1u) / 2u);
+}
+
+TEST(traffic_manager_worker_pool, exception) {
+  WorkerPool pool;
+  pool.SetNumberOfThreads(4u);
+  ASSERT_THROW(pool.ParallelFor(100u, [](const unsigned long index) {
+    if (index == 42u) {
+      throw std::runtime_error("expected");
+    }
+  }), std::runtime_error);
+  // The pool is still usable afterwards.
+  std::atomic<unsigned long> count{0u};
+  pool.ParallelFor(100u, [&](const unsigned long) { ++count; });
+  ASSERT_EQ(count.load(), 100u);
+}
+
+TEST(traffic_manager_worker_pool, actor_random_streams) {
+  const std::vector<carla::ActorId> actors = {3u, 7u, 11u};
+  const std::vector<carla::ActorId> reversed = {11u, 7u, 3u};
+
+  RandomGenerator lhs(2000u);
+  RandomGenerator rhs(2000u);
+  lhs.AddActorStreams(actors);
+  rhs.AddActorStreams(reversed);
+
+  // Drawing from the streams in a different order gives the same numbers.
+  std::vector<double> lhs_values;
+  for (auto actor : actors) {
+    lhs_values.emplace_back(lhs.next(actor));
+  }
+  std::vector<double> rhs_values(actors.size());
+  for (auto i = actors.size(); i > 0u; --i) {
+    rhs_values[i - 1u] = rhs.next(actors[i - 1u]);
+  }
+  ASSERT_EQ(lhs_values, rhs_values);
+
+  // And they do not affect the shared stream.
+  RandomGenerator plain(2000u);
+  ASSERT_EQ(plain.next(), lhs.next());
+
+  RandomGenerator other_seed(2001u);
+  other_seed.AddActorStreams(actors);
+  ASSERT_NE(other_seed.next(actors[0u]), lhs_values[0u]);
+}
@@ -13,6 +13,7 @@
 #include <list>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace util::buffer;
@@ -134,3 +135,95 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, buffer_pool_size_classes) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  const size_t small_size = 1000u;
+  const size_t big_size = 3u * 1024u * 1024u + 17u;
+  const void *small_data = nullptr;
+  const void *big_data = nullptr;
+  {
+    auto small = pool->Pop(small_size);
+    ASSERT_EQ(small.size(), small_size);
+    ASSERT_EQ(small.capacity(), carla::BufferPool::GetAllocationSize(small_size));
+    auto big = pool->Pop(big_size);
+    ASSERT_EQ(big.size(), big_size);
+    ASSERT_GE(big.capacity(), big_size);
+    ASSERT_LE(big.capacity(), big_size + big_size / 4u);
+    small_data = small.data();
+    big_data = big.data();
+  }
+  auto stats = pool->GetStatistics();
+  ASSERT_EQ(stats.misses, 2u);
+  ASSERT_EQ(stats.buffers_resident, 2u);
+  // Each size reuses its own buffer.
+  auto big = pool->Pop(big_size - 100u);
+  ASSERT_EQ(big.data(), big_data);
+  auto small = pool->Pop(small_size);
+  ASSERT_EQ(small.data(), small_data);
+  stats = pool->GetStatistics();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.buffers_resident, 0u);
+  ASSERT_EQ(stats.bytes_resident, 0u);
+}
+
+TEST(buffer, buffer_pool_small_buffers) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  const void *small_data = nullptr;
+  {
+    auto small = pool->Pop();
+    small.copy_from(std::string(100u, 'a'));
+    ASSERT_LT(small.capacity(), 1024u);
+    small_data = small.data();
+  }
+  ASSERT_EQ(pool->GetStatistics().buffers_resident, 1u);
+  // A pop with size never gets a buffer smaller than its size class.
+  {
+    auto sized = pool->Pop(100u);
+    ASSERT_GE(sized.capacity(), carla::BufferPool::GetAllocationSize(100u));
+    ASSERT_NE(sized.data(), small_data);
+  }
+  // The small buffer is still kept for the pops without size.
+  auto stats = pool->GetStatistics();
+  ASSERT_EQ(stats.misses, 2u);
+  ASSERT_EQ(stats.buffers_resident, 2u);
+  ASSERT_EQ(stats.discarded, 0u);
+}
+
+TEST(buffer, buffer_pool_limits) {
+  carla::BufferPoolSettings settings;
+  settings.max_buffers_per_class = 2u;
+  settings.trim_after = carla::time_duration::milliseconds(0u);
+  auto pool = std::make_shared<carla::BufferPool>(settings);
+  {
+    std::vector<Buffer> buffers;
+    for (auto i = 0u; i < 5u; ++i) {
+      buffers.emplace_back(pool->Pop(4096u));
+    }
+  }
+  auto stats = pool->GetStatistics();
+  ASSERT_EQ(stats.buffers_resident, 2u);
+  ASSERT_EQ(stats.discarded, 3u);
+  ASSERT_EQ(stats.bytes_resident, 2u * carla::BufferPool::GetAllocationSize(4096u));
+  pool->Clear();
+  stats = pool->GetStatistics();
+  ASSERT_EQ(stats.buffers_resident, 0u);
+  ASSERT_EQ(stats.bytes_resident, 0u);
+  ASSERT_EQ(stats.trimmed, 2u);
+}
+
+TEST(buffer, buffer_pool_trim) {
+  carla::BufferPoolSettings settings;
+  settings.trim_after = carla::time_duration::milliseconds(20u);
+  auto pool = std::make_shared<carla::BufferPool>(settings);
+  pool->Pop(1024u * 1024u);
+  ASSERT_EQ(pool->GetStatistics().buffers_resident, 1u);
+  pool->Trim();
+  ASSERT_EQ(pool->GetStatistics().buffers_resident, 1u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // Popping a different size class releases the idle one.
+  pool->Pop(100u);
+  auto stats = pool->GetStatistics();
+  ASSERT_EQ(stats.trimmed, 1u);
+  ASSERT_EQ(stats.buffers_resident, 1u);
+}
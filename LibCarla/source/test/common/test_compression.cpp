@@ -0,0 +1,146 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/streaming/detail/Compression.h>
+
+#include <vector>
+
+using namespace util::buffer;
+using namespace carla::streaming::detail;
+
+static Buffer compress(const Buffer &input) {
+  Buffer output;
+  output.reset(static_cast<uint64_t>(lz::max_compressed_size(input.size())));
+  output.reset(static_cast<uint64_t>(lz::Compress(input.data(), input.size(), output.data())));
+  return output;
+}
+
+static Buffer decompress(const Buffer &input, size_t size) {
+  Buffer output;
+  output.reset(static_cast<uint64_t>(size));
+  EXPECT_TRUE(lz::Decompress(input.data(), input.size(), output.data(), size));
+  return output;
+}
+
+TEST(compression, lz_round_trip) {
+  for (auto size : {1u, 12u, 13u, 64u, 1000u, 100000u}) {
+    auto random = make_random(size);
+    ASSERT_EQ(*random, decompress(compress(*random), size));
+
+    Buffer flat(size);
+    std::fill(flat.begin(), flat.end(), 7u);
+    auto compressed = compress(flat);
+    ASSERT_EQ(flat, decompress(compressed, size));
+    if (size >= 1000u) {
+      ASSERT_LT(compressed.size(), size / 50u);
+    }
+
+    Buffer pattern(size);
+    for (auto i = 0u; i < size; ++i) {
+      pattern.data()[i] = static_cast<unsigned char>((i / 3u) % 17u);
+    }
+    ASSERT_EQ(pattern, decompress(compress(pattern), size));
+  }
+}
+
+TEST(compression, lz_reused_hash_table) {
+  // The entries left by a larger input must not be used as matches.
+  lz::HashTable table;
+  for (auto size : {100000u, 1000u, 100000u, 64u, 13u}) {
+    Buffer pattern(size);
+    for (auto i = 0u; i < size; ++i) {
+      pattern.data()[i] = static_cast<unsigned char>((i / 5u) % (size % 23u + 2u));
+    }
+    Buffer compressed;
+    compressed.reset(static_cast<uint64_t>(lz::max_compressed_size(size)));
+    compressed.reset(static_cast<uint64_t>(
+        lz::Compress(pattern.data(), size, compressed.data(), table)));
+    ASSERT_EQ(pattern, decompress(compressed, size));
+  }
+}
+
+TEST(compression, lz_corrupted_input) {
+  Buffer flat(1000u);
+  std::fill(flat.begin(), flat.end(), 1u);
+  auto compressed = compress(flat);
+  Buffer output(1000u);
+  // Truncated input.
+  ASSERT_FALSE(lz::Decompress(compressed.data(), compressed.size() - 1u, output.data(), output.size()));
+  // Wrong output size.
+  ASSERT_FALSE(lz::Decompress(compressed.data(), compressed.size(), output.data(), output.size() - 1u));
+  // Offset pointing before the beginning of the output.
+  compressed.data()[2u] = 0xffu;
+  compressed.data()[3u] = 0xffu;
+  ASSERT_FALSE(lz::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+}
+
+TEST(compression, delta_frames) {
+  constexpr size_t size = 4096u;
+  constexpr size_t number_of_frames = 10u;
+  Compressor compressor(CompressionMode::DeltaLz, 4u);
+  Decompressor decompressor;
+  Decompressor late_decompressor;
+
+  Buffer frame(size);
+  std::fill(frame.begin(), frame.end(), 0u);
+  size_t synchronized_frames = 0u;
+  for (auto i = 0u; i < number_of_frames; ++i) {
+    frame.data()[(i * 97u) % size] += 1u;
+    Buffer compressed;
+    ASSERT_TRUE(compressor.Compress(frame.cbuffer(), compressed));
+    ASSERT_LT(compressed.size(), size / 10u);
+
+    Buffer output;
+    ASSERT_TRUE(decompressor.Decompress(compressed, output));
+    ASSERT_EQ(frame, output);
+
+    // A decompressor that missed the first frames must wait for a key frame.
+    if (i >= 2u) {
+      Buffer late_output;
+      if (late_decompressor.Decompress(compressed, late_output)) {
+        ASSERT_EQ(frame, late_output);
+        ++synchronized_frames;
+      } else {
+        ASSERT_EQ(synchronized_frames, 0u);
+      }
+    }
+  }
+  ASSERT_GT(synchronized_frames, 0u);
+}
+
+TEST(compression, incompressible_message) {
+  Compressor compressor(CompressionMode::Lz);
+  auto random = make_random(4096u);
+  Buffer compressed;
+  ASSERT_FALSE(compressor.Compress(random->cbuffer(), compressed));
+}
+
+TEST(compression, delta_key_frame_on_request) {
+  constexpr size_t size = 4096u;
+  Compressor compressor(CompressionMode::DeltaLz, 1000u);
+  Decompressor decompressor;
+
+  Buffer frame(size);
+  std::fill(frame.begin(), frame.end(), 0u);
+  for (auto i = 0u; i < 6u; ++i) {
+    frame.data()[i] = 1u;
+    if (i == 3u) {
+      // The previous message was dropped, without a key frame the client
+      // would not decompress anything until the next interval.
+      compressor.RequestKeyFrame();
+    }
+    Buffer compressed;
+    ASSERT_TRUE(compressor.Compress(frame.cbuffer(), compressed));
+    if (i == 2u) {
+      continue;
+    }
+    Buffer output;
+    ASSERT_TRUE(decompressor.Decompress(compressed, output));
+    ASSERT_EQ(frame, output);
+  }
+}
@@ -9,6 +9,7 @@
 #include <carla/MsgPackAdaptors.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Response.h>
+#include <carla/rpc/VehicleControlBatch.h>
 
 #include <thread>
 
@@ -105,3 +106,25 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, vehicle_control_batch) {
+  using mp = carla::MsgPack;
+
+  VehicleControlBatch batch;
+  auto result = mp::UnPack<VehicleControlBatch>(mp::Pack(batch));
+  ASSERT_TRUE(result.empty());
+
+  const VehicleControl control{0.5f, -0.25f, 0.1f, true, false, true, 3};
+  batch.Add(42u, control);
+  batch.Add(7u, VehicleControl{});
+  batch.AddLightState(7u, static_cast<VehicleLightState::flag_type>(VehicleLightState::LightState::Brake));
+  result = mp::UnPack<VehicleControlBatch>(mp::Pack(batch));
+  ASSERT_EQ(result.size(), 2u);
+  ASSERT_EQ(result.GetActorId(0u), 42u);
+  ASSERT_EQ(result.GetControl(0u), control);
+  ASSERT_EQ(result.GetActorId(1u), 7u);
+  ASSERT_EQ(result.GetControl(1u), VehicleControl{});
+  ASSERT_EQ(result.GetNumberOfLightStates(), 1u);
+  ASSERT_EQ(result.GetLightStateActorId(0u), 7u);
+  ASSERT_EQ(result.GetLightState(0u), static_cast<VehicleLightState::flag_type>(VehicleLightState::LightState::Brake));
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ParallelFor.h>
+#include <carla/ThreadPool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using carla::ParallelForRanges;
+
+static void CheckEveryIndexOnce(size_t size, size_t number_of_threads) {
+  std::vector<std::atomic_int> visits(size);
+  for (auto &count : visits) {
+    count = 0;
+  }
+  ParallelForRanges(size, number_of_threads, [&](size_t begin, size_t end) {
+    ASSERT_LE(begin, end);
+    ASSERT_LE(end, size);
+    for (size_t i = begin; i < end; ++i) {
+      ++visits[i];
+    }
+  });
+  for (const auto &count : visits) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(parallel_for, every_index_once) {
+  for (size_t number_of_threads : {0u, 1u, 3u, 16u}) {
+    for (size_t size : {0u, 1u, 7u, 1000u}) {
+      CheckEveryIndexOnce(size, number_of_threads);
+    }
+  }
+}
+
+TEST(parallel_for, pool_is_reused) {
+  carla::ThreadPool pool;
+  pool.AsyncRun(2u);
+  for (int i = 0; i < 200; ++i) {
+    std::atomic_size_t total{0u};
+    ParallelForRanges(pool, 100u, 4u, [&](size_t begin, size_t end) {
+      total += end - begin;
+    });
+    ASSERT_EQ(total, 100u);
+  }
+}
+
+TEST(parallel_for, nested_calls_on_a_busy_pool) {
+  carla::ThreadPool pool;
+  pool.AsyncRun(1u);
+  std::atomic_size_t total{0u};
+  ParallelForRanges(pool, 8u, 8u, [&](size_t begin, size_t end) {
+    ParallelForRanges(pool, end - begin, 4u, [&](size_t inner_begin, size_t inner_end) {
+      total += inner_end - inner_begin;
+    });
+  });
+  ASSERT_EQ(total, 8u);
+}
+
+TEST(parallel_for, exception_is_rethrown) {
+  ASSERT_THROW(
+      ParallelForRanges(100u, 4u, [](size_t begin, size_t) {
+        if (begin == 0u) {
+          throw std::runtime_error("failed");
+        }
+      }),
+      std::runtime_error);
+}
@@ -10,13 +10,22 @@
 #include <carla/streaming/Client.h>
 #include <carla/streaming/Server.h>
 #include <carla/streaming/detail/Dispatcher.h>
+#include <carla/streaming/detail/shm/SharedMemoryRing.h>
 #include <carla/streaming/detail/tcp/Client.h>
 #include <carla/streaming/detail/tcp/Server.h>
 #include <carla/streaming/low_level/Client.h>
 #include <carla/streaming/low_level/Server.h>
 
+#include <algorithm>
 #include <atomic>
 
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // _WIN32
+
 using namespace std::chrono_literals;
 
 // This is required for low level to properly stop the threads in case of
@@ -259,3 +268,224 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+TEST(streaming, shared_memory_stream) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 100u;
+  const std::string message = "Hello from shared memory!";
+
+  Server srv(TESTING_PORT);
+  srv.SetSharedMemory(true);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  ASSERT_TRUE(carla::streaming::detail::token_type(stream.token()).protocol_is_shm());
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](auto buffer) {
+    const std::string result = as_string(buffer);
+    ASSERT_EQ(result, message);
+    ++message_count;
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    std::this_thread::sleep_for(2ms);
+    stream << message;
+  }
+  std::this_thread::sleep_for(20ms);
+
+  ASSERT_GE(message_count, number_of_messages - 3u);
+}
+
+TEST(streaming, shared_memory_ring_segments) {
+  using carla::streaming::detail::shm::SharedMemoryRing;
+  const auto name = SharedMemoryRing::MakeName(TESTING_PORT, 1u, 1u);
+#ifndef _WIN32
+  // A segment left behind by a server that crashed.
+  const auto posix_name = "/" + name;
+  const int fd = shm_open(posix_name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  ASSERT_GE(fd, 0);
+  close(fd);
+#endif // _WIN32
+  auto ring = SharedMemoryRing::Create(name, 1024u);
+  ASSERT_NE(ring, nullptr);
+  ASSERT_EQ(ring->capacity(), 1024u);
+  auto reader = SharedMemoryRing::Open(name);
+  ASSERT_NE(reader, nullptr);
+  ASSERT_EQ(reader->capacity(), 1024u);
+#ifdef __linux__
+  // There is never enough shared memory to back the whole segment.
+  const size_t huge_capacity = size_t(1u) << 50u;
+  ASSERT_EQ(SharedMemoryRing::Create(name + "-huge", huge_capacity), nullptr);
+#endif // __linux__
+}
+
+TEST(streaming, send_queue_statistics) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+  constexpr size_t number_of_messages = 200u;
+  const std::string message = "Hello client!";
+
+  Server srv(TESTING_PORT);
+  tcp::SendQueueSettings settings;
+  settings.policy = tcp::SendPolicy::KeepN;
+  settings.max_size = 4u;
+  srv.SetSendQueueSettings(false, settings);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](auto) { ++message_count; });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream << message;
+  }
+  std::this_thread::sleep_for(50ms);
+
+  const auto statistics = srv.GetSendQueueStatistics();
+  ASSERT_EQ(statistics.messages_sent + statistics.messages_dropped, number_of_messages);
+  ASSERT_EQ(statistics.messages_sent, message_count);
+  ASSERT_EQ(statistics.queue_depth, 0u);
+  ASSERT_LE(statistics.max_queue_depth, settings.max_size);
+  ASSERT_LE(statistics.writes, statistics.messages_sent);
+}
+
+TEST(streaming, synchronous_mode_does_not_drop_messages) {
+  using namespace carla::streaming;
+  constexpr size_t number_of_messages = 50u;
+  // Large enough to fill the socket buffers, so the writes stall.
+  const std::string message(1u << 20u, 'x');
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(1u);
+  c.Subscribe(stream.token(), [&](auto) {
+    std::this_thread::sleep_for(10ms);
+    ++message_count;
+  });
+
+  std::this_thread::sleep_for(20ms);
+  // The writer waits for the slow client, each write at most the timeout.
+  const auto timeout = detail::tcp::SendQueueSettings().timeout.to_chrono();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    stream << message;
+    ASSERT_LE(std::chrono::steady_clock::now() - start, timeout + 100ms);
+  }
+  for (auto i = 0; (i < 100) && (message_count < number_of_messages); ++i) {
+    std::this_thread::sleep_for(20ms);
+  }
+
+  const auto statistics = srv.GetSendQueueStatistics();
+  ASSERT_EQ(statistics.messages_dropped, 0u);
+  ASSERT_EQ(statistics.messages_sent, number_of_messages);
+  ASSERT_EQ(message_count, number_of_messages);
+  ASSERT_EQ(statistics.queue_depth, 0u);
+}
+
+TEST(streaming, synchronous_mode_blocks_up_to_the_timeout) {
+  using namespace carla::streaming;
+  constexpr size_t number_of_messages = 20u;
+  constexpr auto timeout = 50ms;
+  const std::string message(1u << 20u, 'x');
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  detail::tcp::SendQueueSettings settings;
+  settings.policy = detail::tcp::SendPolicy::BlockWithTimeout;
+  settings.max_size = 2u;
+  settings.timeout = carla::time_duration(timeout);
+  srv.SetSendQueueSettings(true, settings);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_bool stalled{false};
+  Client c;
+  c.AsyncRun(1u);
+  c.Subscribe(stream.token(), [&](auto) {
+    // The client stops reading for a while after the first message.
+    if (!stalled.exchange(true)) {
+      std::this_thread::sleep_for(1s);
+    }
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    stream << message;
+    ASSERT_LE(std::chrono::steady_clock::now() - start, timeout + 100ms);
+  }
+  std::this_thread::sleep_for(1500ms);
+
+  const auto statistics = srv.GetSendQueueStatistics();
+  ASSERT_GT(statistics.messages_dropped, 0u);
+  ASSERT_EQ(statistics.messages_sent + statistics.messages_dropped, number_of_messages);
+  ASSERT_EQ(statistics.queue_depth, 0u);
+}
+
+static void stream_compressed_messages(
+    carla::streaming::detail::CompressionMode mode,
+    bool use_shared_memory) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 100u;
+  constexpr size_t message_size = 1024u * 1024u;
+
+  Server srv(TESTING_PORT);
+  srv.SetSharedMemory(use_shared_memory);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  stream.SetCompression(mode);
+  ASSERT_EQ(stream.GetCompression(), mode);
+
+  std::atomic_size_t message_count{0u};
+  std::atomic_size_t error_count{0u};
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](auto buffer) {
+    // Each message is filled with its own index.
+    if ((buffer.size() != message_size) ||
+        (static_cast<size_t>(std::count(buffer.begin(), buffer.end(), buffer.data()[0u])) != message_size)) {
+      ++error_count;
+    }
+    ++message_count;
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    std::this_thread::sleep_for(2ms);
+    auto buffer = stream.MakeBuffer();
+    buffer.reset(message_size);
+    std::fill(buffer.begin(), buffer.end(), static_cast<unsigned char>(i));
+    stream.Write(std::move(buffer));
+  }
+  std::this_thread::sleep_for(50ms);
+
+  ASSERT_EQ(error_count, 0u);
+  // Delta frames following a dropped frame are discarded until the next key
+  // frame.
+  ASSERT_GE(message_count, number_of_messages / 2u);
+}
+
+TEST(streaming, compressed_stream) {
+  using carla::streaming::detail::CompressionMode;
+  stream_compressed_messages(CompressionMode::Lz, false);
+  stream_compressed_messages(CompressionMode::DeltaLz, false);
+}
+
+TEST(streaming, compressed_shared_memory_stream) {
+  using carla::streaming::detail::CompressionMode;
+  stream_compressed_messages(CompressionMode::Lz, true);
+  stream_compressed_messages(CompressionMode::DeltaLz, true);
+}
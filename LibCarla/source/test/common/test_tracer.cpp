@@ -0,0 +1,144 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/profiler/Histogram.h>
+#include <carla/profiler/Tracer.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using carla::profiler::Histogram;
+using carla::profiler::TraceStats;
+using carla::profiler::Tracer;
+
+static const TraceStats *FindStats(
+    const std::vector<TraceStats> &stats,
+    const std::string &category,
+    const std::string &name) {
+  auto it = std::find_if(stats.begin(), stats.end(), [&](const TraceStats &item) {
+    return (item.category == category) && (item.name == name);
+  });
+  return it != stats.end() ? &*it : nullptr;
+}
+
+TEST(tracer, histogram_buckets) {
+  const size_t number_of_buckets = Histogram::NUMBER_OF_BUCKETS;
+  size_t previous_index = 0u;
+  for (uint64_t value = 0u; value < (1u << 20u); value += 7u) {
+    const auto index = Histogram::GetBucketIndex(value);
+    ASSERT_LT(index, number_of_buckets);
+    ASSERT_GE(index, previous_index);
+    ASSERT_LE(value, Histogram::GetBucketUpperBound(index));
+    if (index > 0u) {
+      ASSERT_GT(value, Histogram::GetBucketUpperBound(index - 1u));
+    }
+    previous_index = index;
+  }
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+  ASSERT_EQ(Histogram::GetBucketIndex(max), number_of_buckets - 1u);
+  ASSERT_EQ(Histogram::GetBucketUpperBound(number_of_buckets - 1u), max);
+}
+
+TEST(tracer, histogram_percentiles) {
+  Histogram histogram;
+  ASSERT_EQ(histogram.GetPercentile(0.5), 0u);
+  for (uint64_t value = 1u; value <= 1000u; ++value) {
+    histogram.Add(1000u * value);
+  }
+  ASSERT_EQ(histogram.GetCount(), 1000u);
+  ASSERT_EQ(histogram.GetMin(), 1000u);
+  ASSERT_EQ(histogram.GetMax(), 1000000u);
+  // Within the relative error of the buckets.
+  const auto expect_near = [](uint64_t value, double expected) {
+    ASSERT_GE(static_cast<double>(value), expected);
+    ASSERT_LE(static_cast<double>(value), expected * (1.0 + 1.0 / 16.0));
+  };
+  expect_near(histogram.GetPercentile(0.5), 500000.0);
+  expect_near(histogram.GetPercentile(0.9), 900000.0);
+  expect_near(histogram.GetPercentile(0.99), 990000.0);
+  ASSERT_EQ(histogram.GetPercentile(1.0), 1000000u);
+  histogram.Reset();
+  ASSERT_EQ(histogram.GetCount(), 0u);
+  ASSERT_EQ(histogram.GetMin(), 0u);
+}
+
+static void TracedFunction() {
+  CARLA_TRACE_SCOPE(test_tracer, traced_function);
+  std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+TEST(tracer, scope_stats) {
+  Tracer::Reset();
+  TracedFunction();
+  ASSERT_EQ(FindStats(Tracer::GetStats(), "test_tracer", "traced_function"), nullptr);
+
+  Tracer::Start();
+  std::vector<std::thread> threads;
+  for (auto i = 0u; i < 4u; ++i) {
+    threads.emplace_back([]() {
+      for (auto j = 0u; j < 10u; ++j) {
+        TracedFunction();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  Tracer::Stop();
+  TracedFunction();
+
+  const auto stats = Tracer::GetStats();
+  const auto *function_stats = FindStats(stats, "test_tracer", "traced_function");
+  ASSERT_NE(function_stats, nullptr);
+  ASSERT_EQ(function_stats->count, 40u);
+  ASSERT_GE(function_stats->minimum, 0.1);
+  ASSERT_LE(function_stats->minimum, function_stats->p50);
+  ASSERT_LE(function_stats->p50, function_stats->p99);
+  ASSERT_LE(function_stats->p99, function_stats->maximum);
+
+  std::ostringstream out;
+  Tracer::WriteStats(out);
+  ASSERT_NE(out.str().find("test_tracer, traced_function, 40,"), std::string::npos);
+
+  Tracer::Reset();
+  ASSERT_EQ(FindStats(Tracer::GetStats(), "test_tracer", "traced_function"), nullptr);
+}
+
+TEST(tracer, chrome_trace) {
+  Tracer::Reset();
+  Tracer::Start();
+  for (auto i = 0u; i < 3u; ++i) {
+    TracedFunction();
+  }
+  Tracer::Stop();
+
+  const auto path = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("carla-trace-%%%%-%%%%.json")).string();
+  ASSERT_TRUE(Tracer::WriteChromeTrace(path));
+  std::ifstream file(path);
+  const std::string trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  file.close();
+  boost::filesystem::remove(path);
+
+  ASSERT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  size_t events = 0u;
+  const std::string event = "{\"name\":\"traced_function\",\"cat\":\"test_tracer\",\"ph\":\"X\"";
+  for (auto pos = trace.find(event); pos != std::string::npos; pos = trace.find(event, pos + 1u)) {
+    ++events;
+  }
+  ASSERT_EQ(events, 3u);
+  Tracer::Reset();
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/streaming/detail/Compression.h>
+
+#include <functional>
+#include <random>
+#include <string>
+
+using namespace carla::streaming::detail;
+
+using clock_type = std::chrono::steady_clock;
+
+using pixel_function_type = std::function<void(size_t x, size_t y, size_t frame, unsigned char *bgra)>;
+
+constexpr size_t WIDTH = 1280u;
+constexpr size_t HEIGHT = 720u;
+
+/// Renders a sequence of synthetic BGRA images with @a pixel, compresses them
+/// with @a mode and reports the compression ratio and the time spent encoding
+/// and decoding each frame.
+static void benchmark_compression(
+    const std::string &name,
+    const CompressionMode mode,
+    const pixel_function_type &pixel) {
+  constexpr size_t number_of_frames = 30u;
+  Compressor compressor(mode);
+  Decompressor decompressor;
+
+  size_t total_size = 0u;
+  size_t total_compressed_size = 0u;
+  std::chrono::duration<double, std::milli> encode_time{0};
+  std::chrono::duration<double, std::milli> decode_time{0};
+
+  carla::Buffer image(WIDTH * HEIGHT * 4u);
+  for (auto frame = 0u; frame < number_of_frames; ++frame) {
+    for (auto y = 0u; y < HEIGHT; ++y) {
+      for (auto x = 0u; x < WIDTH; ++x) {
+        pixel(x, y, frame, image.data() + 4u * (y * WIDTH + x));
+      }
+    }
+
+    carla::Buffer compressed;
+    auto start = clock_type::now();
+    const bool is_compressed = compressor.Compress(image.cbuffer(), compressed);
+    encode_time += clock_type::now() - start;
+
+    total_size += image.size();
+    if (!is_compressed) {
+      total_compressed_size += image.size();
+      continue;
+    }
+    total_compressed_size += compressed.size();
+
+    carla::Buffer output;
+    start = clock_type::now();
+    ASSERT_TRUE(decompressor.Decompress(compressed, output));
+    decode_time += clock_type::now() - start;
+    ASSERT_EQ(output, image);
+  }
+
+  std::cout << name
+            << (mode == CompressionMode::DeltaLz ? " delta" : " lz")
+            << ": ratio " << static_cast<double>(total_size) / static_cast<double>(total_compressed_size)
+            << ", encode " << encode_time.count() / number_of_frames << " ms"
+            << ", decode " << decode_time.count() / number_of_frames << " ms"
+            << std::endl;
+}
+
+/// Depth encoded in 24 bits, smooth gradient moving with the frame.
+static void depth_pixel(size_t x, size_t y, size_t frame, unsigned char *bgra) {
+  const uint32_t depth = static_cast<uint32_t>(1000u + 40u * y + x / 8u + frame);
+  bgra[0u] = static_cast<unsigned char>(depth >> 16u);
+  bgra[1u] = static_cast<unsigned char>(depth >> 8u);
+  bgra[2u] = static_cast<unsigned char>(depth);
+  bgra[3u] = 255u;
+}
+
+/// Semantic tags in the red channel, large flat regions.
+static void semantic_segmentation_pixel(size_t x, size_t y, size_t frame, unsigned char *bgra) {
+  bgra[0u] = 0u;
+  bgra[1u] = 0u;
+  bgra[2u] = static_cast<unsigned char>(((x + frame) / 160u + y / 120u) % 23u);
+  bgra[3u] = 255u;
+}
+
+/// Textured colour image with per-pixel noise, close to the worst case.
+static void rgb_pixel(size_t x, size_t y, size_t frame, unsigned char *bgra) {
+  static thread_local std::mt19937 engine(42u);
+  const auto noise = static_cast<unsigned char>(engine() & 0x0fu);
+  bgra[0u] = static_cast<unsigned char>((x + frame) ^ y) + noise;
+  bgra[1u] = static_cast<unsigned char>(x * y / 64u) + noise;
+  bgra[2u] = static_cast<unsigned char>(y + frame) + noise;
+  bgra[3u] = 255u;
+}
+
+TEST(benchmark_compression, depth) {
+  benchmark_compression("depth", CompressionMode::Lz, depth_pixel);
+  benchmark_compression("depth", CompressionMode::DeltaLz, depth_pixel);
+}
+
+TEST(benchmark_compression, semantic_segmentation) {
+  benchmark_compression("semantic segmentation", CompressionMode::Lz, semantic_segmentation_pixel);
+  benchmark_compression("semantic segmentation", CompressionMode::DeltaLz, semantic_segmentation_pixel);
+}
+
+TEST(benchmark_compression, rgb) {
+  benchmark_compression("rgb", CompressionMode::Lz, rgb_pixel);
+  benchmark_compression("rgb", CompressionMode::DeltaLz, rgb_pixel);
+}
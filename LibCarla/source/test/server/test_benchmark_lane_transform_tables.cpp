@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/geom/Math.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/Map.h>
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using carla::geom::Math;
+using carla::opendrive::OpenDriveParser;
+using carla::road::element::Waypoint;
+
+static constexpr double WAYPOINT_DISTANCE = 0.5;
+
+static constexpr double MAX_LOCATION_ERROR = 0.001;
+
+static constexpr float MAX_ANGLE_ERROR = 0.05f;
+
+/// Towns of the OpenDRIVE test files, the missing ones are skipped.
+static const char *TOWNS[] = {
+  "Town01", "Town02", "Town03", "Town04", "Town05",
+  "Town06", "Town07", "Town10HD", "Town11", "Town12"
+};
+
+static float angle_difference(float a, float b) {
+  const float diff = std::fmod(std::abs(a - b), 360.0f);
+  return std::min(diff, 360.0f - diff);
+}
+
+/// Computes the transform of every waypoint of @a town without and with the
+/// lane transform tables, and reports the time taken, the memory used by the
+/// tables and the maximum error.
+static void benchmark_lane_transform_tables(const std::string &town) {
+  std::ifstream file(LIBCARLA_TEST_CONTENT_FOLDER "/OpenDrive/" + town + ".xodr");
+  if (!file.is_open()) {
+    std::cout << town << " not found, skipped" << std::endl;
+    return;
+  }
+  const std::string xodr{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  auto map = OpenDriveParser::Load(xodr);
+  ASSERT_TRUE(map.has_value());
+
+  std::vector<Waypoint> waypoints;
+  for (auto &waypoint : map->GenerateWaypoints(WAYPOINT_DISTANCE)) {
+    waypoints.emplace_back(waypoint);
+  }
+
+  map->ClearLaneTransformTables();
+  std::vector<carla::geom::Transform> exact;
+  exact.reserve(waypoints.size());
+  carla::StopWatch exact_watch;
+  for (auto &waypoint : waypoints) {
+    exact.emplace_back(map->ComputeTransform(waypoint));
+  }
+  exact_watch.Stop();
+
+  carla::StopWatch build_watch;
+  const size_t memory_usage = map->BuildLaneTransformTables(MAX_LOCATION_ERROR);
+  build_watch.Stop();
+
+  std::vector<carla::geom::Transform> sampled;
+  sampled.reserve(waypoints.size());
+  carla::StopWatch sampled_watch;
+  for (auto &waypoint : waypoints) {
+    sampled.emplace_back(map->ComputeTransform(waypoint));
+  }
+  sampled_watch.Stop();
+
+  double location_error = 0.0;
+  float angle_error = 0.0f;
+  for (auto i = 0u; i < waypoints.size(); ++i) {
+    location_error = std::max<double>(location_error,
+        Math::Distance(exact[i].location, sampled[i].location));
+    angle_error = std::max(angle_error,
+        angle_difference(exact[i].rotation.yaw, sampled[i].rotation.yaw));
+    angle_error = std::max(angle_error,
+        angle_difference(exact[i].rotation.pitch, sampled[i].rotation.pitch));
+  }
+
+  std::cout << town << ": " << waypoints.size() << " transforms"
+            << ", exact " << exact_watch.GetElapsedTime() << " ms"
+            << ", sampled " << sampled_watch.GetElapsedTime() << " ms"
+            << ", build " << build_watch.GetElapsedTime() << " ms"
+            << ", " << memory_usage / 1024u << " KiB"
+            << ", max error " << location_error << " m " << angle_error << " deg"
+            << std::endl;
+
+  ASSERT_LE(location_error, MAX_LOCATION_ERROR);
+  ASSERT_LE(angle_error, MAX_ANGLE_ERROR);
+}
+
+TEST(benchmark_lane_transform_tables, towns) {
+  for (auto town : TOWNS) {
+    benchmark_lane_transform_tables(town);
+  }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/rpc/Client.h>
+#include <carla/rpc/Server.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace carla::rpc;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+static constexpr auto NUMBER_OF_QUERIES = 1000;
+
+/// Runs NUMBER_OF_QUERIES calls to @a function one after the other, and
+/// then all of them at once, and reports the time taken by each.
+static void benchmark_rpc_pipelining(const uint16_t port, const std::string &function) {
+  Client client("localhost", port);
+
+  auto start = clock_type::now();
+  for (auto i = 0; i < NUMBER_OF_QUERIES; ++i) {
+    ASSERT_EQ(client.call(function, i).as<int>(), 2 * i);
+  }
+  const std::chrono::duration<double, std::milli> sequential_time = clock_type::now() - start;
+
+  start = clock_type::now();
+  std::vector<std::future<clmdep_msgpack::object_handle>> futures;
+  futures.reserve(NUMBER_OF_QUERIES);
+  for (auto i = 0; i < NUMBER_OF_QUERIES; ++i) {
+    futures.emplace_back(client.future_call(function, i));
+  }
+  for (auto i = 0; i < NUMBER_OF_QUERIES; ++i) {
+    ASSERT_EQ(futures[i].get().as<int>(), 2 * i);
+  }
+  const std::chrono::duration<double, std::milli> pipelined_time = clock_type::now() - start;
+
+  std::cout << NUMBER_OF_QUERIES << " queries to " << function
+            << ": sequential " << sequential_time.count() << " ms"
+            << ", pipelined " << pipelined_time.count() << " ms"
+            << std::endl;
+}
+
+TEST(benchmark_rpc_pipelining, sync_calls) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+  server.BindSync("sync_call", [](int x) -> int { return 2 * x; });
+  server.AsyncRun(2u);
+
+  // Stand-in for the game thread of the simulator, which serves the sync
+  // calls between frames.
+  std::atomic_bool done{false};
+  carla::ThreadGroup game_thread;
+  game_thread.CreateThread([&]() {
+    while (!done) {
+      std::this_thread::sleep_for(1ms);
+      server.SyncRunFor(carla::time_duration::milliseconds(1u));
+    }
+  });
+
+  benchmark_rpc_pipelining(port, "sync_call");
+  done = true;
+}
+
+TEST(benchmark_rpc_pipelining, read_only_calls) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+  server.BindReadOnly("read_only_call", [](int x) -> int { return 2 * x; });
+  server.AsyncRun(2u, 2u);
+
+  benchmark_rpc_pipelining(port, "read_only_call");
+}
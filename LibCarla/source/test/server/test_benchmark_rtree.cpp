@@ -0,0 +1,146 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/geom/Rtree.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+using clock_type = std::chrono::steady_clock;
+
+using Rtree = carla::geom::SegmentCloudRtree<uint32_t>;
+
+/// Polylines of 1m segments wandering through a square of 2km, similar to
+/// the lanes of a map.
+static std::vector<Rtree::TreeElement> make_lane_segments(size_t number_of_segments) {
+  constexpr size_t segments_per_lane = 200u;
+  std::mt19937 rng(42u);
+  std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+  std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+  std::uniform_real_distribution<float> turn(-0.05f, 0.05f);
+
+  std::vector<Rtree::TreeElement> elements;
+  elements.reserve(number_of_segments);
+  float x = 0.0f;
+  float y = 0.0f;
+  float yaw = 0.0f;
+  for (uint32_t i = 0u; i < number_of_segments; ++i) {
+    if (i % segments_per_lane == 0u) {
+      x = position(rng);
+      y = position(rng);
+      yaw = angle(rng);
+    }
+    yaw += turn(rng);
+    const float next_x = x + std::cos(yaw);
+    const float next_y = y + std::sin(yaw);
+    elements.emplace_back(
+        Rtree::BSegment(Rtree::BPoint(x, y, 0.0f), Rtree::BPoint(next_x, next_y, 0.0f)),
+        std::make_pair(i, i + 1u));
+    x = next_x;
+    y = next_y;
+  }
+  return elements;
+}
+
+static std::vector<Rtree::BPoint> make_query_points(size_t number_of_points) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+  std::vector<Rtree::BPoint> points;
+  points.reserve(number_of_points);
+  for (auto i = 0u; i < number_of_points; ++i) {
+    points.emplace_back(position(rng), position(rng), 0.0f);
+  }
+  return points;
+}
+
+template <typename FuncT>
+static double measure_ms(FuncT &&func) {
+  const auto start = clock_type::now();
+  func();
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+/// Compares building the tree by inserting the elements with building it
+/// with the packing algorithm, and the k-NN query latency of both trees.
+static void benchmark_rtree(
+    size_t number_of_segments,
+    size_t number_neighbours,
+    size_t number_of_queries) {
+  const auto elements = make_lane_segments(number_of_segments);
+  const auto points = make_query_points(number_of_queries);
+
+  Rtree inserted;
+  const double insert_time = measure_ms([&]() { inserted.InsertElements(elements); });
+  std::unique_ptr<Rtree> packed;
+  const double pack_time = measure_ms([&]() { packed = std::make_unique<Rtree>(elements); });
+  ASSERT_EQ(inserted.GetTreeSize(), elements.size());
+  ASSERT_EQ(packed->GetTreeSize(), elements.size());
+
+  std::vector<std::vector<Rtree::TreeElement>> inserted_results;
+  std::vector<std::vector<Rtree::TreeElement>> packed_results;
+  const double inserted_query_time = measure_ms([&]() {
+    for (const auto &point : points) {
+      inserted_results.emplace_back(inserted.GetNearestNeighbours(point, number_neighbours));
+    }
+  });
+  const double packed_query_time = measure_ms([&]() {
+    for (const auto &point : points) {
+      packed_results.emplace_back(packed->GetNearestNeighbours(point, number_neighbours));
+    }
+  });
+  std::vector<std::vector<Rtree::TreeElement>> batch_results;
+  const double batch_time = measure_ms([&]() {
+    batch_results = packed->GetNearestNeighboursBatch(points, number_neighbours);
+  });
+  const double batch_mt_time = measure_ms([&]() {
+    packed->GetNearestNeighboursBatch(points, number_neighbours, 4u);
+  });
+
+  // Both trees hold the same segments, so the nearest ones are at the same
+  // distance even if ties are resolved differently.
+  ASSERT_EQ(packed_results.size(), inserted_results.size());
+  ASSERT_EQ(batch_results.size(), points.size());
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_EQ(packed_results[i].size(), number_neighbours);
+    ASSERT_EQ(inserted_results[i].size(), number_neighbours);
+    ASSERT_EQ(batch_results[i].size(), number_neighbours);
+    auto max_distance = [&](const std::vector<Rtree::TreeElement> &result) {
+      float distance = 0.0f;
+      for (const auto &element : result) {
+        distance = std::max(distance, static_cast<float>(
+            boost::geometry::distance(points[i], element.first)));
+      }
+      return distance;
+    };
+    ASSERT_FLOAT_EQ(max_distance(packed_results[i]), max_distance(inserted_results[i]));
+    ASSERT_FLOAT_EQ(max_distance(batch_results[i]), max_distance(inserted_results[i]));
+  }
+
+  const double us_per_query = 1e3 / static_cast<double>(number_of_queries);
+  std::cout << number_of_segments << " segments, " << number_neighbours << "-NN"
+            << ": build inserting " << insert_time << " ms, packing " << pack_time << " ms"
+            << "; query inserted " << inserted_query_time * us_per_query << " us"
+            << ", packed " << packed_query_time * us_per_query << " us"
+            << ", packed batch " << batch_time * us_per_query << " us"
+            << ", packed batch 4 threads " << batch_mt_time * us_per_query << " us"
+            << std::endl;
+}
+
+TEST(benchmark_rtree, segments_100k_1nn) {
+  benchmark_rtree(100'000u, 1u, 20'000u);
+}
+
+TEST(benchmark_rtree, segments_100k_10nn) {
+  benchmark_rtree(100'000u, 10u, 20'000u);
+}
+
+TEST(benchmark_rtree, segments_1m_1nn) {
+  benchmark_rtree(1'000'000u, 1u, 1'000u);
+}
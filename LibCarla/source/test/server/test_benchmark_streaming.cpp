@@ -12,6 +12,8 @@
 #include <boost/asio/post.hpp>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 using namespace carla::streaming;
 using namespace std::chrono_literals;
@@ -41,7 +43,7 @@ public:
       DEBUG_ASSERT_EQ(msg.size(), _message.size());
       DEBUG_ASSERT(msg == _message);
       boost::asio::post(_client_callback, [this]() {
-        CARLA_PROFILE_FPS(client, listen_callback);
+        CARLA_TRACE_INTERVAL(client, listen_callback);
         ++_number_of_messages_received;
       });
     });
@@ -68,7 +70,7 @@ public:
         for (auto i = 0u; i < number_of_messages; ++i) {
           std::this_thread::sleep_for(11ms); // ~90FPS.
           {
-            CARLA_PROFILE_SCOPE(game, write_to_stream);
+            CARLA_TRACE_SCOPE(game, write_to_stream);
             stream << _message.buffer();
           }
         }
@@ -135,9 +137,15 @@ static void benchmark_image(
     const double success_ratio = 1.0) {
   constexpr auto number_of_messages = 100u;
   carla::logging::log("Benchmark:", number_of_streams, "streams at 90FPS.");
-  Benchmark benchmark(TESTING_PORT, 4u * dimensions, success_ratio);
-  benchmark.AddStreams(number_of_streams);
-  benchmark.Run(number_of_messages);
+  carla::profiler::Tracer::Reset();
+  carla::profiler::Tracer::Start();
+  {
+    Benchmark benchmark(TESTING_PORT, 4u * dimensions, success_ratio);
+    benchmark.AddStreams(number_of_streams);
+    benchmark.Run(number_of_messages);
+  }
+  carla::profiler::Tracer::Stop();
+  carla::profiler::Tracer::WriteStats(std::cout);
 }
 
 TEST(benchmark_streaming, image_200x200) {
@@ -163,3 +171,60 @@ TEST(benchmark_streaming, image_800x600_mt) {
 TEST(benchmark_streaming, image_1920x1080_mt) {
   benchmark_image(1920u * 1080u, get_max_concurrency(), 0.9);
 }
+
+/// Writes as fast as the sessions allow into a single stream with @a
+/// number_of_subscribers clients subscribed, measuring the throughput of the
+/// fan-out as seen by the clients.
+static void benchmark_fan_out(const size_t number_of_subscribers) {
+  constexpr auto number_of_messages = 1000u;
+  constexpr size_t message_size = 4u * 200u * 200u;
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true); // sessions block the writer instead of dropping.
+  srv.AsyncRun(get_max_concurrency());
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t number_of_messages_received{0u};
+  std::vector<std::unique_ptr<Client>> clients;
+  for (auto i = 0u; i < number_of_subscribers; ++i) {
+    clients.emplace_back(std::make_unique<Client>());
+    clients.back()->AsyncRun(1u);
+    clients.back()->Subscribe(stream.token(), [&](carla::Buffer DEBUG_ONLY(msg)) {
+      DEBUG_ASSERT_EQ(msg.size(), message_size);
+      ++number_of_messages_received;
+    });
+  }
+
+  std::this_thread::sleep_for(1s); // the clients need to be ready.
+
+  const auto message = make_special_message(message_size);
+  const auto expected_number_of_messages = number_of_subscribers * number_of_messages;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream << message.buffer();
+  }
+  const std::chrono::duration<double> write_time = std::chrono::steady_clock::now() - start;
+  for (auto i = 0u; (i < 200u) && (number_of_messages_received < expected_number_of_messages); ++i) {
+    std::this_thread::sleep_for(50ms);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  const auto received = static_cast<double>(number_of_messages_received);
+  std::cout << number_of_subscribers << " subscribers: "
+            << received / elapsed.count() << " messages/s, "
+            << received * message_size / (1024.0 * 1024.0 * elapsed.count()) << " MB/s, "
+            << 1e6 * write_time.count() / number_of_messages << " us per write" << std::endl;
+  ASSERT_EQ(number_of_messages_received, expected_number_of_messages);
+}
+
+TEST(benchmark_streaming, fan_out_1_subscriber) {
+  benchmark_fan_out(1u);
+}
+
+TEST(benchmark_streaming, fan_out_4_subscribers) {
+  benchmark_fan_out(4u);
+}
+
+TEST(benchmark_streaming, fan_out_16_subscribers) {
+  benchmark_fan_out(16u);
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/streaming/Client.h>
+#include <carla/streaming/Server.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace carla::streaming;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+/// Sends 4K BGRA images through a single stream and measures the throughput
+/// and the latency between the write and the client callback. At most a couple
+/// of messages are kept in flight so both transports see the same load.
+static void benchmark_transport(const bool use_shared_memory) {
+  constexpr auto number_of_messages = 200u;
+  constexpr size_t image_size = 3840u * 2160u * 4u;
+  constexpr size_t max_messages_in_flight = 2u;
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  srv.SetSharedMemory(use_shared_memory);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::mutex mutex;
+  std::vector<double> latencies;
+  latencies.reserve(number_of_messages);
+  std::atomic_size_t received{0u};
+
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](carla::Buffer buffer) {
+    const auto now = clock_type::now().time_since_epoch().count();
+    ASSERT_EQ(buffer.size(), image_size);
+    clock_type::rep sent;
+    std::memcpy(&sent, buffer.data(), sizeof(sent));
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      latencies.emplace_back(1e-6 * static_cast<double>(now - sent));
+    }
+    ++received;
+  });
+
+  std::this_thread::sleep_for(1s); // the client needs to be ready.
+
+  const std::vector<unsigned char> image(image_size, 42u);
+  const auto start = clock_type::now();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    while (i - received > max_messages_in_flight) {
+      std::this_thread::yield();
+    }
+    auto buffer = stream.MakeBuffer();
+    buffer.copy_from(image);
+    const auto now = clock_type::now().time_since_epoch().count();
+    std::memcpy(buffer.data(), &now, sizeof(now));
+    stream.Write(std::move(buffer));
+  }
+  for (auto i = 0u; (i < 100u) && (received < number_of_messages); ++i) {
+    std::this_thread::sleep_for(50ms);
+  }
+  const std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+  ASSERT_EQ(received, number_of_messages);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::sort(latencies.begin(), latencies.end());
+  const auto p50 = latencies[latencies.size() / 2u];
+  const auto p99 = latencies[(latencies.size() * 99u) / 100u];
+  const auto megabytes = static_cast<double>(number_of_messages * image_size) / (1024.0 * 1024.0);
+  std::cout << (use_shared_memory ? "shared memory" : "tcp")
+            << ": " << megabytes / elapsed.count() << " MB/s"
+            << ", latency p50 " << p50 << " ms"
+            << ", p99 " << p99 << " ms" << std::endl;
+}
+
+TEST(benchmark_streaming_transport, image_3840x2160_tcp) {
+  benchmark_transport(false);
+}
+
+TEST(benchmark_streaming_transport, image_3840x2160_shm) {
+  benchmark_transport(true);
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/MsgPack.h>
+#include <carla/MsgPackAdaptors.h>
+#include <carla/rpc/Command.h>
+#include <carla/rpc/VehicleControlBatch.h>
+
+#include <vector>
+
+using namespace carla::rpc;
+
+using clock_type = std::chrono::steady_clock;
+
+/// Sum of the controls, so the dispatch loops are not optimized away.
+static float sum_control(const VehicleControl &control) {
+  return control.throttle + control.steer + control.brake + static_cast<float>(control.gear);
+}
+
+/// Serializes, deserializes and dispatches the controls of @a number_of_vehicles
+/// as the traffic manager does every cycle, as a list of commands and as a
+/// packed batch, and reports the time per cycle and the message size of each.
+static void benchmark_vehicle_control_batch(const size_t number_of_vehicles) {
+  constexpr auto number_of_cycles = 100u;
+
+  std::vector<Command> commands;
+  VehicleControlBatch batch;
+  batch.Reserve(number_of_vehicles);
+  for (auto i = 0u; i < number_of_vehicles; ++i) {
+    const VehicleControl control{0.5f, 0.001f * i, 0.0f, false, false, false, 1};
+    commands.emplace_back(Command::ApplyVehicleControl{static_cast<ActorId>(i), control});
+    batch.Add(static_cast<ActorId>(i), control);
+  }
+
+  std::chrono::duration<double, std::milli> commands_time{0};
+  std::chrono::duration<double, std::milli> batch_time{0};
+  size_t commands_size = 0u;
+  size_t batch_size = 0u;
+  float commands_sum = 0.0f;
+  float batch_sum = 0.0f;
+
+  for (auto cycle = 0u; cycle < number_of_cycles; ++cycle) {
+    auto start = clock_type::now();
+    {
+      const auto buffer = carla::MsgPack::Pack(commands);
+      const auto received = carla::MsgPack::UnPack<std::vector<Command>>(buffer);
+      for (const auto &command : received) {
+        if (const auto *apply = boost::variant2::get_if<Command::ApplyVehicleControl>(&command.command)) {
+          commands_sum += sum_control(apply->control);
+        }
+      }
+      commands_size = buffer.size();
+    }
+    commands_time += clock_type::now() - start;
+
+    start = clock_type::now();
+    {
+      const auto buffer = carla::MsgPack::Pack(batch);
+      const auto received = carla::MsgPack::UnPack<VehicleControlBatch>(buffer);
+      for (auto i = 0u; i < received.size(); ++i) {
+        batch_sum += sum_control(received.GetControl(i));
+      }
+      batch_size = buffer.size();
+    }
+    batch_time += clock_type::now() - start;
+  }
+
+  ASSERT_EQ(commands_sum, batch_sum);
+  std::cout << number_of_vehicles << " vehicles"
+            << ": commands " << commands_time.count() / number_of_cycles << " ms"
+            << " (" << commands_size << " bytes)"
+            << ", batch " << batch_time.count() / number_of_cycles << " ms"
+            << " (" << batch_size << " bytes)"
+            << std::endl;
+}
+
+TEST(benchmark_vehicle_control_batch, 100_vehicles) {
+  benchmark_vehicle_control_batch(100u);
+}
+
+TEST(benchmark_vehicle_control_batch, 1000_vehicles) {
+  benchmark_vehicle_control_batch(1000u);
+}
+
+TEST(benchmark_vehicle_control_batch, 5000_vehicles) {
+  benchmark_vehicle_control_batch(5000u);
+}
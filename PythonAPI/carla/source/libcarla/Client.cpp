@@ -49,6 +49,22 @@ static void ApplyBatchCommands(
   self.ApplyBatch(std::move(cmds), do_tick);
 }
 
+static auto ApplyVehicleControlBatchSync(
+    const carla::client::Client &self,
+    const carla::rpc::VehicleControlBatch &batch,
+    bool do_tick) {
+  std::vector<carla::rpc::ActorId> failed;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    failed = self.ApplyVehicleControlBatchSync(batch, do_tick);
+  }
+  boost::python::list result;
+  for (auto id : failed) {
+    result.append(id);
+  }
+  return result;
+}
+
 static auto ApplyBatchCommandsSync(
     const carla::client::Client &self,
     const boost::python::object &commands,
@@ -186,11 +202,21 @@ void export_client() {
     .def_readwrite("enable_pedestrian_navigation", &rpc::OpendriveGenerationParameters::enable_pedestrian_navigation)
   ;
 
+  class_<carla::BufferPoolStatistics>("BufferPoolStatistics", no_init)
+    .def_readonly("hits", &carla::BufferPoolStatistics::hits)
+    .def_readonly("misses", &carla::BufferPoolStatistics::misses)
+    .def_readonly("discarded", &carla::BufferPoolStatistics::discarded)
+    .def_readonly("trimmed", &carla::BufferPoolStatistics::trimmed)
+    .def_readonly("buffers_resident", &carla::BufferPoolStatistics::buffers_resident)
+    .def_readonly("bytes_resident", &carla::BufferPoolStatistics::bytes_resident)
+  ;
+
   class_<cc::Client>("Client",
       init<std::string, uint16_t, size_t>((arg("host"), arg("port"), arg("worker_threads")=0u)))
     .def("set_timeout", &::SetTimeout, (arg("seconds")))
     .def("get_client_version", &cc::Client::GetClientVersion)
     .def("get_server_version", CONST_CALL_WITHOUT_GIL(cc::Client, GetServerVersion))
+    .def("get_buffer_pool_statistics", &cc::Client::GetBufferPoolStatistics)
     .def("get_world", &cc::Client::GetWorld)
     .def("get_available_maps", &GetAvailableMaps)
     .def("set_files_base_folder", &cc::Client::SetFilesBaseFolder, (arg("path")))
@@ -212,6 +238,8 @@ void export_client() {
     .def("set_replayer_ignore_hero", &cc::Client::SetReplayerIgnoreHero, (arg("ignore_hero")))
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
+    .def("apply_vehicle_control_batch", &cc::Client::ApplyVehicleControlBatch, (arg("batch"), arg("do_tick")=false))
+    .def("apply_vehicle_control_batch_sync", &ApplyVehicleControlBatchSync, (arg("batch"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
   ;
 }
@@ -7,6 +7,7 @@
 
 #include <carla/rpc/VehicleAckermannControl.h>
 #include <carla/rpc/VehicleControl.h>
+#include <carla/rpc/VehicleControlBatch.h>
 #include <carla/rpc/VehiclePhysicsControl.h>
 #include <carla/rpc/WheelPhysicsControl.h>
 #include <carla/rpc/WalkerControl.h>
@@ -336,6 +337,14 @@ void export_control() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<cr::VehicleControlBatch>("VehicleControlBatch")
+    .def("__len__", &cr::VehicleControlBatch::size)
+    .def("reserve", &cr::VehicleControlBatch::Reserve, (arg("number_of_vehicles")))
+    .def("add", &cr::VehicleControlBatch::Add, (arg("actor_id"), arg("control")))
+    .def("add_light_state", &cr::VehicleControlBatch::AddLightState, (arg("actor_id"), arg("light_state")))
+    .def("clear", &cr::VehicleControlBatch::Clear)
+  ;
+
   class_<cr::VehicleAckermannControl>("VehicleAckermannControl")
     .def(init<float, float, float, float, float>(
       (arg("steer") = 0.0f,
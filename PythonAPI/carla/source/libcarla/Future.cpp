@@ -0,0 +1,117 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/PythonUtil.h>
+#include <carla/client/Future.h>
+
+#include <boost/python/stl_iterator.hpp>
+
+#include <functional>
+#include <vector>
+
+/// A carla::client::Future of any type, exposed as carla.Future. The result
+/// is waited for without the GIL and converted to a Python object with it.
+class PythonFuture {
+public:
+
+  template <typename T, typename ConverterT>
+  PythonFuture(carla::client::Future<T> future, ConverterT converter)
+    : _wait_for([future](carla::time_duration timeout) { return future.WaitFor(timeout); }),
+      _get([future]() { future.Get(); }),
+      _to_python([future, converter]() { return converter(future.Get()); }) {}
+
+  bool IsDone() const {
+    carla::PythonUtil::ReleaseGIL unlock;
+    return _wait_for(carla::time_duration::milliseconds(0u));
+  }
+
+  bool WaitFor(double seconds) const {
+    carla::PythonUtil::ReleaseGIL unlock;
+    return _wait_for(TimeDurationFromSeconds(seconds));
+  }
+
+  /// Wait for the result, must be called without the GIL.
+  void Wait() const {
+    _get();
+  }
+
+  boost::python::object GetResult() const {
+    {
+      carla::PythonUtil::ReleaseGIL unlock;
+      Wait();
+    }
+    return _to_python();
+  }
+
+private:
+
+  std::function<bool(carla::time_duration)> _wait_for;
+
+  std::function<void()> _get;
+
+  std::function<boost::python::object()> _to_python;
+};
+
+template <typename T>
+static PythonFuture MakePythonFuture(carla::client::Future<T> future) {
+  return {std::move(future), [](const T &value) { return boost::python::object(value); }};
+}
+
+template <typename T>
+static PythonFuture MakePythonFutureOfList(carla::client::Future<std::vector<T>> future) {
+  return {std::move(future), [](const std::vector<T> &values) {
+    boost::python::list result;
+    for (const auto &value : values) {
+      result.append(value);
+    }
+    return result;
+  }};
+}
+
+// Convenient for const requests returning a future, the request is sent
+// without the GIL.
+#define CALL_RETURNING_FUTURE(cls, fn) +[](const cls &self) { \
+      auto future = [&]() { carla::PythonUtil::ReleaseGIL unlock; return self.fn(); }(); \
+      return MakePythonFuture(std::move(future)); \
+    }
+
+// Convenient for const requests returning a future of a list, the request is
+// sent without the GIL.
+#define CALL_RETURNING_FUTURE_OF_LIST_1(cls, fn, T1_) +[](const cls &self, T1_ t1) { \
+      auto future = [&]() { carla::PythonUtil::ReleaseGIL unlock; return self.fn(std::forward<T1_>(t1)); }(); \
+      return MakePythonFutureOfList(std::move(future)); \
+    }
+
+/// Wait for all the @a futures and return the list of their results, in the
+/// same order. Raises the error of the first one that failed.
+static boost::python::list Gather(boost::python::object futures) {
+  std::vector<PythonFuture> items{
+      boost::python::stl_input_iterator<PythonFuture>(futures),
+      boost::python::stl_input_iterator<PythonFuture>()};
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    for (const auto &item : items) {
+      item.Wait();
+    }
+  }
+  boost::python::list result;
+  for (const auto &item : items) {
+    result.append(item.GetResult());
+  }
+  return result;
+}
+
+void export_future() {
+  using namespace boost::python;
+
+  class_<PythonFuture>("Future", no_init)
+    .def("done", &PythonFuture::IsDone)
+    .def("wait", &PythonFuture::WaitFor, (arg("seconds")))
+    .def("result", &PythonFuture::GetResult)
+  ;
+
+  def("gather", &Gather, (arg("futures")));
+}
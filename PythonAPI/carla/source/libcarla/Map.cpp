@@ -72,6 +72,67 @@ static auto GetLaneValidities(const carla::client::Landmark &self){
   return result;
 }
 
+// Accepts either a sequence of carla.Location or an object exposing a
+// contiguous (N, 3) buffer of float32 or float64, like a numpy array.
+static std::vector<carla::geom::Location> LocationsFromPython(boost::python::object locations) {
+  namespace py = boost::python;
+  std::vector<carla::geom::Location> result;
+  if (PyObject_CheckBuffer(locations.ptr())) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(locations.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      py::throw_error_already_set();
+    }
+    const std::string format = view.format != nullptr ? view.format : "B";
+    const bool is_float = (format == "f" || format == "<f" || format == "=f");
+    const bool is_double = (format == "d" || format == "<d" || format == "=d");
+    if (view.ndim != 2 || view.shape[1] != 3 || !(is_float || is_double)) {
+      PyBuffer_Release(&view);
+      PyErr_SetString(PyExc_TypeError, "expected an array of shape (N, 3) and type float32 or float64");
+      py::throw_error_already_set();
+    }
+    const size_t size = static_cast<size_t>(view.shape[0]);
+    result.reserve(size);
+    for (size_t i = 0u; i < size; ++i) {
+      if (is_float) {
+        const float *p = static_cast<const float *>(view.buf) + 3u * i;
+        result.emplace_back(p[0], p[1], p[2]);
+      } else {
+        const double *p = static_cast<const double *>(view.buf) + 3u * i;
+        result.emplace_back(
+            static_cast<float>(p[0]),
+            static_cast<float>(p[1]),
+            static_cast<float>(p[2]));
+      }
+    }
+    PyBuffer_Release(&view);
+  } else {
+    result.assign(
+        py::stl_input_iterator<carla::geom::Location>(locations),
+        py::stl_input_iterator<carla::geom::Location>());
+  }
+  return result;
+}
+
+static auto GetWaypoints(
+    const carla::client::Map &self,
+    boost::python::object py_locations,
+    bool project_to_road,
+    int32_t lane_type,
+    size_t number_of_threads) {
+  namespace py = boost::python;
+  const auto locations = LocationsFromPython(py_locations);
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> waypoints;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    waypoints = self.GetWaypoints(locations, project_to_road, lane_type, number_of_threads);
+  }
+  py::list result;
+  for (auto &waypoint : waypoints) {
+    result.append(waypoint);
+  }
+  return result;
+}
+
 static carla::geom::GeoLocation ToGeolocation(
     const carla::client::Map &self,
     const carla::geom::Location &location) {
@@ -159,6 +220,7 @@ void export_map() {
     .add_property("name", CALL_RETURNING_COPY(cc::Map, GetName))
     .def("get_spawn_points", CALL_RETURNING_LIST(cc::Map, GetRecommendedSpawnPoints))
     .def("get_waypoint", &cc::Map::GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("get_waypoints", &GetWaypoints, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving, arg("number_of_threads")=0u))
     .def("get_waypoint_xodr", &cc::Map::GetWaypointXODR, (arg("road_id"), arg("lane_id"), arg("s")))
     .def("get_topology", &GetTopology)
     .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
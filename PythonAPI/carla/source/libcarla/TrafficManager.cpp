@@ -109,6 +109,7 @@ void export_trafficmanager() {
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius)
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed)
     .def("set_osm_mode", &carla::traffic_manager::TrafficManager::SetOSMMode)
+    .def("set_number_of_threads", &ctm::TrafficManager::SetNumberOfThreads, (arg("number_of_threads")))
     .def("set_path", &InterSetCustomPath, (arg("empty_buffer") = true))
     .def("set_route", &InterSetImportedRoute, (arg("empty_buffer") = true))
     .def("set_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetRespawnDormantVehicles)
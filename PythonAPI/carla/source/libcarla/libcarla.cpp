@@ -217,6 +217,7 @@ static auto MakeCallback(boost::python::object callback) {
 }
 
 #include "Geom.cpp"
+#include "Future.cpp"
 #include "Actor.cpp"
 #include "Blueprint.cpp"
 #include "Client.cpp"
@@ -244,6 +245,7 @@ BOOST_PYTHON_MODULE(libcarla) {
 #endif
   scope().attr("__path__") = "libcarla";
   export_geom();
+  export_future();
   export_control();
   export_blueprint();
   export_actor();
@@ -0,0 +1,188 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Benchmark of the Traffic Manager step time.
+
+Spawns increasing numbers of autopilot vehicles and measures the time of a
+synchronous tick for each number of Traffic Manager threads. The vehicles are
+spawned at the same spawn points with the same seed for every thread count, so
+the rows of a vehicle count are comparable.
+"""
+
+import glob
+import os
+import sys
+import argparse
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    index = min(len(values) - 1, int(round(fraction * (len(values) - 1))))
+    return values[index]
+
+
+def spawn_vehicles(client, world, traffic_manager, number_of_vehicles, seed):
+    blueprints = [
+        bp for bp in world.get_blueprint_library().filter('vehicle.*')
+        if int(bp.get_attribute('number_of_wheels')) == 4]
+    blueprints = sorted(blueprints, key=lambda bp: bp.id)
+    spawn_points = world.get_map().get_spawn_points()
+    if number_of_vehicles > len(spawn_points):
+        print('warning: only %d spawn points, spawning %d vehicles' % (
+            len(spawn_points), len(spawn_points)))
+        number_of_vehicles = len(spawn_points)
+
+    batch = []
+    for n, transform in enumerate(spawn_points[:number_of_vehicles]):
+        blueprint = blueprints[(n * 7 + seed) % len(blueprints)]
+        blueprint.set_attribute('role_name', 'autopilot')
+        batch.append(carla.command.SpawnActor(blueprint, transform)
+            .then(carla.command.SetAutopilot(carla.command.FutureActor, True, traffic_manager.get_port())))
+
+    vehicles = []
+    for response in client.apply_batch_sync(batch, True):
+        if response.error:
+            print('warning: %s' % response.error)
+        else:
+            vehicles.append(response.actor_id)
+    return vehicles
+
+
+def run(client, world, traffic_manager, args, number_of_vehicles, number_of_threads):
+    traffic_manager.set_random_device_seed(args.seed)
+    traffic_manager.set_number_of_threads(number_of_threads)
+    vehicles = spawn_vehicles(client, world, traffic_manager, number_of_vehicles, args.seed)
+    try:
+        for _ in range(args.warmup):
+            world.tick()
+        step_times = []
+        for _ in range(args.ticks):
+            start = time.perf_counter()
+            world.tick()
+            step_times.append(time.perf_counter() - start)
+    finally:
+        client.apply_batch_sync([carla.command.DestroyActor(x) for x in vehicles])
+        world.tick()
+    return len(vehicles), step_times
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port',
+        metavar='P',
+        default=8000,
+        type=int,
+        help='Port to communicate with TM (default: 8000)')
+    argparser.add_argument(
+        '-n', '--number-of-vehicles',
+        metavar='N',
+        nargs='+',
+        default=[50, 100, 200],
+        type=int,
+        help='Numbers of vehicles to benchmark (default: 50 100 200)')
+    argparser.add_argument(
+        '-t', '--threads',
+        metavar='T',
+        nargs='+',
+        default=[0, 2, 4, 8],
+        type=int,
+        help='Numbers of TM threads to benchmark, 0 is the sequential update (default: 0 2 4 8)')
+    argparser.add_argument(
+        '--ticks',
+        metavar='N',
+        default=200,
+        type=int,
+        help='Number of measured ticks for each case (default: 200)')
+    argparser.add_argument(
+        '--warmup',
+        metavar='N',
+        default=50,
+        type=int,
+        help='Number of ticks before measuring (default: 50)')
+    argparser.add_argument(
+        '--delta',
+        metavar='S',
+        default=0.05,
+        type=float,
+        help='Fixed delta seconds of the simulation (default: 0.05)')
+    argparser.add_argument(
+        '-s', '--seed',
+        metavar='S',
+        default=0,
+        type=int,
+        help='Seed of the traffic manager (default: 0)')
+    args = argparser.parse_args()
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(20.0)
+    world = client.get_world()
+    traffic_manager = client.get_trafficmanager(args.tm_port)
+
+    original_settings = world.get_settings()
+    settings = world.get_settings()
+    settings.synchronous_mode = True
+    settings.fixed_delta_seconds = args.delta
+    settings.no_rendering_mode = True
+    world.apply_settings(settings)
+    traffic_manager.set_synchronous_mode(True)
+
+    results = []
+    try:
+        for number_of_vehicles in args.number_of_vehicles:
+            for number_of_threads in args.threads:
+                spawned, step_times = run(
+                    client, world, traffic_manager, args, number_of_vehicles, number_of_threads)
+                mean = sum(step_times) / len(step_times)
+                results.append((spawned, number_of_threads, mean,
+                                percentile(step_times, 0.5), percentile(step_times, 0.95)))
+                print('%4d vehicles, %2d threads: mean %.2f ms' % (
+                    spawned, number_of_threads, mean * 1000.0))
+    finally:
+        traffic_manager.set_number_of_threads(0)
+        traffic_manager.set_synchronous_mode(False)
+        world.apply_settings(original_settings)
+
+    print('\n| Vehicles | Threads | Mean step (ms) | Median step (ms) | P95 step (ms) |')
+    print('| -------- | ------- | -------------- | ---------------- | ------------- |')
+    for spawned, threads, mean, median, p95 in results:
+        print('| %d | %d | %.2f | %.2f | %.2f |' % (
+            spawned, threads, mean * 1000.0, median * 1000.0, p95 * 1000.0))
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print('\ndone.')
@@ -0,0 +1,98 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Benchmark of the Traffic Manager startup time.
+
+Creates Traffic Managers on consecutive ports and measures the time until each
+one is ready, which is dominated by setting up the local map. The first one
+may have to download the cooked map of the current town into the cache folder,
+the following ones only load it from the cache.
+"""
+
+import glob
+import os
+import sys
+import argparse
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port',
+        metavar='P',
+        default=8000,
+        type=int,
+        help='First port of the created Traffic Managers (default: 8000)')
+    argparser.add_argument(
+        '-n', '--number-of-managers',
+        metavar='N',
+        default=5,
+        type=int,
+        help='Number of Traffic Managers to create (default: 5)')
+    argparser.add_argument(
+        '--cache-folder',
+        metavar='PATH',
+        default='',
+        help='Folder of the cached files, e.g. an empty one to measure the download')
+    args = argparser.parse_args()
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(60.0)
+    if args.cache_folder:
+        client.set_files_base_folder(args.cache_folder)
+    world = client.get_world()
+    print('map: %s, cooked files: %s' % (
+        world.get_map().name, ', '.join(client.get_required_files('TM', False)) or 'none'))
+
+    startup_times = []
+    for i in range(args.number_of_managers):
+        start = time.perf_counter()
+        client.get_trafficmanager(args.tm_port + i)
+        startup_times.append(time.perf_counter() - start)
+        print('traffic manager %d: %.1f ms' % (i, startup_times[-1] * 1000.0))
+
+    cached = startup_times[1:] or startup_times
+    print('\n| First startup (ms) | Cached startup, mean (ms) | Cached startup, min (ms) |')
+    print('| ------------------ | ------------------------- | ------------------------ |')
+    print('| %.1f | %.1f | %.1f |' % (
+        startup_times[0] * 1000.0,
+        sum(cached) / len(cached) * 1000.0,
+        min(cached) * 1000.0))
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print('\ndone.')
@@ -0,0 +1,196 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Benchmark of the pedestrians crowd update time.
+
+Spawns increasing numbers of walkers with AI controllers and measures the time
+of a synchronous tick, which includes the update of the crowd in the client,
+for each number of crowd threads. The walkers are spawned at the same random
+locations of the navigation mesh for every thread count, so the rows of a
+walker count are comparable.
+"""
+
+import glob
+import os
+import sys
+import argparse
+import random
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    index = min(len(values) - 1, int(round(fraction * (len(values) - 1))))
+    return values[index]
+
+
+def get_spawn_points(world, number_of_walkers, seed):
+    world.set_pedestrians_seed(seed)
+    spawn_points = []
+    for _ in range(number_of_walkers):
+        location = world.get_random_location_from_navigation()
+        if location is not None:
+            spawn_points.append(carla.Transform(location))
+    return spawn_points
+
+
+def spawn_walkers(client, world, spawn_points, seed):
+    rng = random.Random(seed)
+    blueprints = sorted(world.get_blueprint_library().filter('walker.pedestrian.*'), key=lambda bp: bp.id)
+    batch = []
+    for transform in spawn_points:
+        blueprint = rng.choice(blueprints)
+        if blueprint.has_attribute('is_invincible'):
+            blueprint.set_attribute('is_invincible', 'false')
+        batch.append(carla.command.SpawnActor(blueprint, transform))
+    walkers = []
+    for response in client.apply_batch_sync(batch, True):
+        if response.error:
+            print('warning: %s' % response.error)
+        else:
+            walkers.append(response.actor_id)
+
+    controller_bp = world.get_blueprint_library().find('controller.ai.walker')
+    batch = [carla.command.SpawnActor(controller_bp, carla.Transform(), walker) for walker in walkers]
+    controllers = []
+    for response in client.apply_batch_sync(batch, True):
+        if response.error:
+            print('warning: %s' % response.error)
+        else:
+            controllers.append(response.actor_id)
+    world.tick()
+
+    for controller in world.get_actors(controllers):
+        controller.start()
+        controller.go_to_location(world.get_random_location_from_navigation())
+    return walkers, controllers
+
+
+def run(client, world, args, spawn_points, number_of_threads):
+    world.set_pedestrians_number_of_threads(number_of_threads)
+    walkers, controllers = spawn_walkers(client, world, spawn_points, args.seed)
+    try:
+        for _ in range(args.warmup):
+            world.tick()
+        step_times = []
+        for _ in range(args.ticks):
+            start = time.perf_counter()
+            world.tick()
+            step_times.append(time.perf_counter() - start)
+    finally:
+        for controller in world.get_actors(controllers):
+            controller.stop()
+        client.apply_batch_sync([carla.command.DestroyActor(x) for x in controllers + walkers])
+        world.tick()
+    return len(walkers), step_times
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '-n', '--number-of-walkers',
+        metavar='N',
+        nargs='+',
+        default=[250, 500, 1000, 2000],
+        type=int,
+        help='Numbers of walkers to benchmark (default: 250 500 1000 2000)')
+    argparser.add_argument(
+        '-t', '--threads',
+        metavar='T',
+        nargs='+',
+        default=[0, 2, 4, 8],
+        type=int,
+        help='Numbers of crowd threads to benchmark, 0 is the sequential update (default: 0 2 4 8)')
+    argparser.add_argument(
+        '--ticks',
+        metavar='N',
+        default=200,
+        type=int,
+        help='Number of measured ticks for each case (default: 200)')
+    argparser.add_argument(
+        '--warmup',
+        metavar='N',
+        default=50,
+        type=int,
+        help='Number of ticks before measuring (default: 50)')
+    argparser.add_argument(
+        '--delta',
+        metavar='S',
+        default=0.05,
+        type=float,
+        help='Fixed delta seconds of the simulation (default: 0.05)')
+    argparser.add_argument(
+        '-s', '--seed',
+        metavar='S',
+        default=0,
+        type=int,
+        help='Seed of the pedestrians (default: 0)')
+    args = argparser.parse_args()
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(20.0)
+    world = client.get_world()
+
+    original_settings = world.get_settings()
+    settings = world.get_settings()
+    settings.synchronous_mode = True
+    settings.fixed_delta_seconds = args.delta
+    settings.no_rendering_mode = True
+    world.apply_settings(settings)
+
+    results = []
+    try:
+        for number_of_walkers in args.number_of_walkers:
+            spawn_points = get_spawn_points(world, number_of_walkers, args.seed)
+            for number_of_threads in args.threads:
+                spawned, step_times = run(client, world, args, spawn_points, number_of_threads)
+                mean = sum(step_times) / len(step_times)
+                results.append((spawned, number_of_threads, mean,
+                                percentile(step_times, 0.5), percentile(step_times, 0.95)))
+                print('%4d walkers, %2d threads: mean %.2f ms' % (
+                    spawned, number_of_threads, mean * 1000.0))
+    finally:
+        world.apply_settings(original_settings)
+
+    print('\n| Walkers | Threads | Mean step (ms) | Median step (ms) | P95 step (ms) |')
+    print('| ------- | ------- | -------------- | ---------------- | ------------- |')
+    for spawned, threads, mean, median, p95 in results:
+        print('| %d | %d | %.2f | %.2f | %.2f |' % (
+            spawned, threads, mean * 1000.0, median * 1000.0, p95 * 1000.0))
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print('\ndone.')
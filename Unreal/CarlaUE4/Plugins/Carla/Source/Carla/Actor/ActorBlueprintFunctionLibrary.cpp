@@ -360,6 +360,14 @@ void UActorBlueprintFunctionLibrary::MakeCameraDefinition(
   LensYSize.RecommendedValues = { TEXT("0.08") };
   LensYSize.bRestrictToRecommended = false;
 
+  // Compression of the image stream, "delta" only sends the pixels that
+  // changed since the previous image.
+  FActorVariation StreamCompression;
+  StreamCompression.Id = TEXT("stream_compression");
+  StreamCompression.Type = EActorAttributeType::String;
+  StreamCompression.RecommendedValues = { TEXT("none"), TEXT("lz"), TEXT("delta") };
+  StreamCompression.bRestrictToRecommended = true;
+
   Definition.Variations.Append({
       ResX,
       ResY,
@@ -369,7 +377,8 @@ void UActorBlueprintFunctionLibrary::MakeCameraDefinition(
       LensK,
       LensKcube,
       LensXSize,
-      LensYSize});
+      LensYSize,
+      StreamCompression});
 
   if (bEnableModifyingPostProcessEffects)
   {
@@ -718,6 +727,14 @@ void UActorBlueprintFunctionLibrary::MakeNormalsCameraDefinition(bool &Success,
   LensYSize.RecommendedValues = { TEXT("0.08") };
   LensYSize.bRestrictToRecommended = false;
 
+  // Compression of the image stream, "delta" only sends the pixels that
+  // changed since the previous image.
+  FActorVariation StreamCompression;
+  StreamCompression.Id = TEXT("stream_compression");
+  StreamCompression.Type = EActorAttributeType::String;
+  StreamCompression.RecommendedValues = { TEXT("none"), TEXT("lz"), TEXT("delta") };
+  StreamCompression.bRestrictToRecommended = true;
+
   Definition.Variations.Append({
       ResX,
       ResY,
@@ -727,7 +744,8 @@ void UActorBlueprintFunctionLibrary::MakeNormalsCameraDefinition(bool &Success,
       LensK,
       LensKcube,
       LensXSize,
-      LensYSize});
+      LensYSize,
+      StreamCompression});
 
   Success = CheckActorDefinition(Definition);
 }
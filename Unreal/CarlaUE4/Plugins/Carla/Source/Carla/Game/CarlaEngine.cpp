@@ -82,6 +82,15 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
 
     WorldObserver.SetStream(BroadcastStream);
 
+    // Send only the actors that changed since the last keyframe.
+    if (FParse::Param(FCommandLine::Get(), TEXT("-carla-episode-state-delta")))
+    {
+      uint32 KeyframeInterval = 60u;
+      FParse::Value(FCommandLine::Get(), TEXT("-carla-episode-state-keyframe-interval="), KeyframeInterval);
+      UE_LOG(LogCarla, Log, TEXT("Episode state delta encoding, keyframe every %u frames"), KeyframeInterval);
+      WorldObserver.SetDeltaEncoding(true, std::max(KeyframeInterval, 1u));
+    }
+
     OnPreTickHandle = FWorldDelegates::OnWorldTickStart.AddRaw(
         this,
         &FCarlaEngine::OnPreTick);
@@ -324,6 +333,10 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
     }
 
     // send the worldsnapshot
+    if (Server.EpisodeStateKeyframeRequested())
+    {
+      WorldObserver.RequestKeyframe();
+    }
     WorldObserver.BroadcastTick(*CurrentEpisode, DeltaSeconds, bMapChanged, LightUpdatePending);
     CurrentEpisode->GetSensorManager().PostPhysTick(World, TickType, DeltaSeconds);
     ResetSimulationState();
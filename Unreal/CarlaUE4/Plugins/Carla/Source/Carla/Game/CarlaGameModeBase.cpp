@@ -444,7 +444,9 @@ void ACarlaGameModeBase::GenerateSpawnPoints()
 void ACarlaGameModeBase::ParseOpenDrive()
 {
   std::string opendrive_xml = carla::rpc::FromLongFString(UOpenDrive::GetXODR(GetWorld()));
-  Map = carla::opendrive::OpenDriveParser::Load(opendrive_xml);
+  Map = carla::opendrive::OpenDriveParser::Load(
+      opendrive_xml,
+      FPlatformMisc::NumberOfCoresIncludingHyperthreads());
   if (!Map.has_value()) {
     UE_LOG(LogCarla, Error, TEXT("Invalid Map"));
   }
@@ -55,6 +55,19 @@ public:
     return Stream ? Stream->AreClientsListening() : false;
   }
 
+  /// Number of clients that subscribed to this stream since it was created.
+  size_t GetNumberOfConnections() const
+  {
+    return Stream ? Stream->GetNumberOfConnections() : 0u;
+  }
+
+  /// Compress the data sent through this stream.
+  void SetCompression(carla::streaming::detail::CompressionMode Mode)
+  {
+    check(Stream.has_value());
+    Stream->SetCompression(Mode);
+  }
+
 private:
 
   boost::optional<StreamType> Stream;
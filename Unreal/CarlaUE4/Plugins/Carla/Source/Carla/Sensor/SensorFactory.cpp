@@ -7,6 +7,7 @@
 #include "Carla.h"
 #include "Carla/Sensor/SensorFactory.h"
 
+#include "Carla/Actor/ActorBlueprintFunctionLibrary.h"
 #include "Carla/Game/CarlaGameInstance.h"
 #include "Carla/Game/CarlaStatics.h"
 #include "Carla/Sensor/Sensor.h"
@@ -14,6 +15,7 @@
 
 #include <compiler/disable-ue4-macros.h>
 #include <carla/sensor/SensorRegistry.h>
+#include <carla/streaming/detail/Compression.h>
 #include <compiler/enable-ue4-macros.h>
 
 #define LIBCARLA_SENSOR_REGISTRY_WITH_SENSOR_INCLUDES
@@ -97,6 +99,25 @@ private:
 // -- ASensorFactory -----------------------------------------------------------
 // =============================================================================
 
+static carla::streaming::detail::CompressionMode GetStreamCompression(
+    const FActorDescription &Description)
+{
+  using carla::streaming::detail::CompressionMode;
+  const FString Mode = UActorBlueprintFunctionLibrary::RetrieveActorAttributeToString(
+      "stream_compression",
+      Description.Variations,
+      "none");
+  if (Mode == "lz")
+  {
+    return CompressionMode::Lz;
+  }
+  if (Mode == "delta")
+  {
+    return CompressionMode::DeltaLz;
+  }
+  return CompressionMode::None;
+}
+
 TArray<FActorDefinition> ASensorFactory::GetDefinitions()
 {
   return FSensorDefinitionGatherer::GetSensorDefinitions();
@@ -137,7 +158,9 @@ FActorSpawnResult ASensorFactory::SpawnActor(
     
     Sensor->SetEpisode(*Episode);
     Sensor->Set(Description);
-    Sensor->SetDataStream(GameInstance->GetServer().OpenStream());
+    auto Stream = GameInstance->GetServer().OpenStream();
+    Stream.SetCompression(GetStreamCompression(Description));
+    Sensor->SetDataStream(std::move(Stream));
     ASceneCaptureSensor * SceneCaptureSensor = Cast<ASceneCaptureSensor>(Sensor);
     if(SceneCaptureSensor)
     {
@@ -7,6 +7,7 @@
 #include "Carla.h"
 #include "Carla/Sensor/WorldObserver.h"
 #include "Carla/Actor/ActorData.h"
+#include "Carla/Game/CarlaEngine.h"
 
 #include "Carla/Traffic/TrafficLightBase.h"
 #include "Carla/Traffic/TrafficLightComponent.h"
@@ -262,12 +263,63 @@ static carla::geom::Vector3D FWorldObserver_GetAcceleration(
   return {Acceleration.X, Acceleration.Y, Acceleration.Z};
 }
 
+static carla::sensor::data::ActorDynamicState FWorldObserver_GetActorDynamicState(
+    const FCarlaActor &View,
+    const FActorRegistry &Registry,
+    float DeltaSeconds)
+{
+  constexpr float TO_METERS = 1e-2;
+
+  FTransform ActorTransform;
+  FVector Velocity(0.0f);
+  carla::geom::Vector3D AngularVelocity(0.0f, 0.0f, 0.0f);
+  carla::geom::Vector3D Acceleration(0.0f, 0.0f, 0.0f);
+  carla::sensor::data::ActorDynamicState::TypeDependentState State{};
+
+  if(View.IsDormant())
+  {
+    const FActorData* ActorData = View.GetActorData();
+    Velocity = TO_METERS * ActorData->Velocity;
+    AngularVelocity = carla::geom::Vector3D
+                      {ActorData->AngularVelocity.X,
+                       ActorData->AngularVelocity.Y,
+                       ActorData->AngularVelocity.Z};
+    Acceleration = FWorldObserver_GetAcceleration(View, Velocity, DeltaSeconds);
+    State = FWorldObserver_GetDormantActorState(View, Registry);
+  }
+  else
+  {
+    Velocity = TO_METERS * View.GetActor()->GetVelocity();
+    AngularVelocity = FWorldObserver_GetAngularVelocity(*View.GetActor());
+    Acceleration = FWorldObserver_GetAcceleration(View, Velocity, DeltaSeconds);
+    State = FWorldObserver_GetActorState(View, Registry);
+  }
+  ActorTransform = View.GetActorGlobalTransform();
+
+  return {
+    View.GetActorId(),
+    View.GetActorState(),
+    carla::geom::Transform(ActorTransform),
+    carla::geom::Vector3D(Velocity.X, Velocity.Y, Velocity.Z),
+    AngularVelocity,
+    Acceleration,
+    State,
+  };
+}
+
+/// Serializes the episode with the ids in @a RemovedActors, and the state of
+/// the actors for which @a ShouldSend returns true.
+template <typename FilterT>
 static carla::Buffer FWorldObserver_Serialize(
     carla::Buffer &&buffer,
     const UCarlaEpisode &Episode,
     float DeltaSeconds,
     bool MapChange,
-    bool PendingLightUpdates)
+    bool PendingLightUpdates,
+    carla::sensor::s11n::EpisodeStateSerializer::Encoding Encoding,
+    uint64 BaseFrame,
+    const TArray<uint32> &RemovedActors,
+    FilterT &&ShouldSend)
 {
   TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
   using Serializer = carla::sensor::s11n::EpisodeStateSerializer;
@@ -277,7 +329,10 @@ static carla::Buffer FWorldObserver_Serialize(
 
   const FActorRegistry &Registry = Episode.GetActorRegistry();
 
-  auto total_size = sizeof(Serializer::Header) + sizeof(ActorDynamicState) * Registry.Num();
+  auto total_size =
+      sizeof(Serializer::Header) +
+      sizeof(carla::ActorId) * RemovedActors.Num() +
+      sizeof(ActorDynamicState) * Registry.Num();
   auto current_size = 0;
   // Set up buffer for writing.
   buffer.reset(total_size);
@@ -288,8 +343,6 @@ static carla::Buffer FWorldObserver_Serialize(
     current_size += sizeof(data);
   };
 
-  constexpr float TO_METERS = 1e-2;
-
   // Write header.
   Serializer::Header header;
   header.episode_id = Episode.GetId();
@@ -304,53 +357,31 @@ static carla::Buffer FWorldObserver_Serialize(
 
   header.simulation_state = static_cast<SimulationState>(simulation_state);
 
+  header.encoding = Encoding;
+  header.base_frame = BaseFrame;
+  header.number_of_removed_actors = RemovedActors.Num();
+
   write_data(header);
 
+  // Write the removed actors.
+  for (uint32 ActorId : RemovedActors)
+  {
+    write_data(static_cast<carla::ActorId>(ActorId));
+  }
+
   // Write every actor.
   for (auto& It : Registry)
   {
     const FCarlaActor* View = It.Value.Get();
-    const FActorInfo* ActorInfo = View->GetActorInfo();
-
-    FTransform ActorTransform;
-    FVector Velocity(0.0f);
-    carla::geom::Vector3D AngularVelocity(0.0f, 0.0f, 0.0f);
-    carla::geom::Vector3D Acceleration(0.0f, 0.0f, 0.0f);
-    carla::sensor::data::ActorDynamicState::TypeDependentState State{};
-
-
     check(View);
 
-    if(View->IsDormant())
-    {
-      const FActorData* ActorData = View->GetActorData();
-      Velocity = TO_METERS * ActorData->Velocity;
-      AngularVelocity = carla::geom::Vector3D
-                        {ActorData->AngularVelocity.X,
-                         ActorData->AngularVelocity.Y,
-                         ActorData->AngularVelocity.Z};
-      Acceleration = FWorldObserver_GetAcceleration(*View, Velocity, DeltaSeconds);
-      State = FWorldObserver_GetDormantActorState(*View, Registry);
-    }
-    else
+    // The state is computed even if not sent, as it updates the velocity used
+    // for the acceleration.
+    ActorDynamicState info = FWorldObserver_GetActorDynamicState(*View, Registry, DeltaSeconds);
+    if (ShouldSend(info))
     {
-      Velocity = TO_METERS * View->GetActor()->GetVelocity();
-      AngularVelocity = FWorldObserver_GetAngularVelocity(*View->GetActor());
-      Acceleration = FWorldObserver_GetAcceleration(*View, Velocity, DeltaSeconds);
-      State = FWorldObserver_GetActorState(*View, Registry);
+      write_data(info);
     }
-    ActorTransform = View->GetActorGlobalTransform();
-
-    ActorDynamicState info = {
-      View->GetActorId(),
-      View->GetActorState(),
-      carla::geom::Transform(ActorTransform),
-      carla::geom::Vector3D(Velocity.X, Velocity.Y, Velocity.Z),
-      AngularVelocity,
-      Acceleration,
-      State,
-    };
-    write_data(info);
   }
 
   // Shrink buffer
@@ -361,6 +392,27 @@ static carla::Buffer FWorldObserver_Serialize(
   return std::move(buffer);
 }
 
+bool FWorldObserver::IsKeyframeNeeded(const UCarlaEpisode &Episode, bool MapChange)
+{
+  // A new client has no state to apply a delta on. Read before sending, so a
+  // client subscribing meanwhile gets the keyframe of the next tick.
+  const size_t NumberOfConnections = Stream.GetNumberOfConnections();
+  const bool bNewClients = (NumberOfConnections != Keyframe.NumberOfConnections);
+  Keyframe.NumberOfConnections = NumberOfConnections;
+
+  const bool bRequested = bKeyframeRequested;
+  bKeyframeRequested = false;
+
+  const uint64 Frame = FCarlaEngine::GetFrameCounter();
+  return
+      bNewClients ||
+      bRequested ||
+      MapChange ||
+      (Episode.GetId() != Keyframe.EpisodeId) ||
+      (Frame < Keyframe.Frame) ||
+      (Frame - Keyframe.Frame >= KeyframeInterval);
+}
+
 void FWorldObserver::BroadcastTick(
     const UCarlaEpisode &Episode,
     float DeltaSecond,
@@ -368,14 +420,77 @@ void FWorldObserver::BroadcastTick(
     bool PendingLightUpdates)
 {
   TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
+  using Encoding = carla::sensor::s11n::EpisodeStateSerializer::Encoding;
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
+
   auto AsyncStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
 
+  const bool bKeyframe = !bDeltaEncoding || IsKeyframeNeeded(Episode, MapChange);
+  TArray<uint32> RemovedActors;
+  if (bDeltaEncoding && bKeyframe)
+  {
+    Keyframe.EpisodeId = Episode.GetId();
+    Keyframe.Frame = FCarlaEngine::GetFrameCounter();
+    Keyframe.Actors.Reset();
+    Keyframe.ChangedActors.Reset();
+  }
+  else if (!bKeyframe)
+  {
+    // The removals are relative to the keyframe too, including the actors
+    // spawned and destroyed after it.
+    const FActorRegistry &Registry = Episode.GetActorRegistry();
+    for (const auto &Pair : Keyframe.Actors)
+    {
+      if (!Registry.Contains(Pair.Key))
+      {
+        RemovedActors.Add(Pair.Key);
+      }
+    }
+    for (uint32 ActorId : Keyframe.ChangedActors)
+    {
+      if (!Keyframe.Actors.Contains(ActorId) && !Registry.Contains(ActorId))
+      {
+        RemovedActors.Add(ActorId);
+      }
+    }
+  }
+
+  auto ShouldSend = [this, bKeyframe](const ActorDynamicState &State)
+  {
+    if (!bDeltaEncoding)
+    {
+      return true;
+    }
+    if (bKeyframe)
+    {
+      Keyframe.Actors.Add(State.id, State);
+      return true;
+    }
+    // Once changed, an actor is sent until the next keyframe, as the client
+    // may have applied any of the previous deltas.
+    if (Keyframe.ChangedActors.Contains(State.id))
+    {
+      return true;
+    }
+    const ActorDynamicState *Previous = Keyframe.Actors.Find(State.id);
+    if (Previous != nullptr && std::memcmp(Previous, &State, sizeof(State)) == 0)
+    {
+      return false;
+    }
+    Keyframe.ChangedActors.Add(State.id);
+    return true;
+  };
+
   carla::Buffer buffer = FWorldObserver_Serialize(
       AsyncStream.PopBufferFromPool(),
       Episode,
       DeltaSecond,
       MapChange,
-      PendingLightUpdates);
+      PendingLightUpdates,
+      bKeyframe ? Encoding::Keyframe : Encoding::Delta,
+      Keyframe.Frame,
+      RemovedActors,
+      ShouldSend);
 
   AsyncStream.Send(*this, std::move(buffer));
 }
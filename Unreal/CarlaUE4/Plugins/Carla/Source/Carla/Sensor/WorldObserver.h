@@ -8,6 +8,10 @@
 
 #include "Carla/Sensor/DataStream.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/data/ActorDynamicState.h>
+#include <compiler/enable-ue4-macros.h>
+
 class UCarlaEpisode;
 
 /// Serializes and sends all the actors in the current UCarlaEpisode.
@@ -24,6 +28,23 @@ public:
     Stream = std::move(InStream);
   }
 
+  /// Send only the actors that changed since the last keyframe instead of
+  /// every actor each tick. A keyframe with every actor is sent each
+  /// @a InKeyframeInterval frames, and also when the episode or the map
+  /// changes, a new client subscribes or a client requests one.
+  void SetDeltaEncoding(bool bEnabled, uint32 InKeyframeInterval)
+  {
+    bDeltaEncoding = bEnabled;
+    KeyframeInterval = InKeyframeInterval;
+    Keyframe = FKeyframe{};
+  }
+
+  /// Send the next tick as a keyframe, e.g. when a client lost the last one.
+  void RequestKeyframe()
+  {
+    bKeyframeRequested = true;
+  }
+
   /// Return the token that allows subscribing to this sensor's stream.
   auto GetToken() const
   {
@@ -46,5 +67,33 @@ public:
 
 private:
 
+  /// Actors sent since the last keyframe, a delta holds the changes relative
+  /// to it.
+  struct FKeyframe
+  {
+    uint64 EpisodeId = 0u;
+
+    uint64 Frame = 0u;
+
+    size_t NumberOfConnections = 0u;
+
+    /// State of the actors at the keyframe.
+    TMap<uint32, carla::sensor::data::ActorDynamicState> Actors;
+
+    /// Actors sent in a delta since the keyframe, they are sent in every delta
+    /// until the next keyframe.
+    TSet<uint32> ChangedActors;
+  };
+
+  bool IsKeyframeNeeded(const UCarlaEpisode &Episode, bool MapChange);
+
   FDataMultiStream Stream;
+
+  bool bDeltaEncoding = false;
+
+  uint32 KeyframeInterval = 60u;
+
+  bool bKeyframeRequested = false;
+
+  FKeyframe Keyframe;
 };
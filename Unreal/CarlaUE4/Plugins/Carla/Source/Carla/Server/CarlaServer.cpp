@@ -27,9 +27,11 @@
 #include "Misc/FileHelper.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/AtomicSharedPtr.h>
 #include <carla/Functional.h>
 #include <carla/multigpu/router.h>
 #include <carla/Version.h>
+#include <carla/road/MapSnapshot.h>
 #include <carla/rpc/AckermannControllerSettings.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/ActorDefinition.h>
@@ -54,6 +56,7 @@
 #include <carla/rpc/VehicleDoor.h>
 #include <carla/rpc/VehicleAckermannControl.h>
 #include <carla/rpc/VehicleControl.h>
+#include <carla/rpc/VehicleControlBatch.h>
 #include <carla/rpc/VehiclePhysicsControl.h>
 #include <carla/rpc/VehicleLightState.h>
 #include <carla/rpc/VehicleLightStateList.h>
@@ -123,6 +126,37 @@ public:
 
   std::atomic_size_t TickCuesReceived { 0u };
 
+  /// Set by a client that received an episode state delta without its
+  /// keyframe, the next episode state is sent as a keyframe.
+  std::atomic_bool EpisodeStateKeyframeRequested { false };
+
+  /// Episode data served by the read-only calls. The game thread publishes a
+  /// new one when an episode begins and never modifies it afterwards, so the
+  /// read-only workers can use it without locking.
+  struct FReadOnlyState
+  {
+    carla::rpc::EpisodeInfo EpisodeInfo;
+
+    carla::rpc::MapInfo MapInfo;
+
+    std::string MapData;
+
+    /// Serialized road map, empty if the map is not available.
+    std::vector<uint8_t> MapSnapshot;
+
+    std::vector<carla::rpc::ActorDefinition> ActorDefinitions;
+
+    FString FullMapPath;
+
+    FString MapName;
+  };
+
+  carla::AtomicSharedPtr<const FReadOnlyState> ReadOnlyState;
+
+  /// Publishes the read-only state of the current episode, must be called
+  /// from the game thread.
+  void PublishReadOnlyState();
+
 private:
 
   void BindActions();
@@ -173,21 +207,25 @@ class ServerBinder
 {
 public:
 
-  constexpr ServerBinder(const char *name, carla::rpc::Server &srv, bool sync)
+  constexpr ServerBinder(const char *name, carla::rpc::Server &srv, carla::rpc::BindingType binding)
     : _name(name),
       _server(srv),
-      _sync(sync) {}
+      _binding(binding) {}
 
   template <typename FuncT>
   auto operator<<(FuncT func)
   {
-    if (_sync)
+    switch (_binding)
     {
-      _server.BindSync(_name, func);
-    }
-    else
-    {
-      _server.BindAsync(_name, func);
+      case carla::rpc::BindingType::Sync:
+        _server.BindSync(_name, func);
+        break;
+      case carla::rpc::BindingType::Async:
+        _server.BindAsync(_name, func);
+        break;
+      case carla::rpc::BindingType::ReadOnly:
+        _server.BindReadOnly(_name, func);
+        break;
     }
     return func;
   }
@@ -198,11 +236,56 @@ private:
 
   carla::rpc::Server &_server;
 
-  bool _sync;
+  carla::rpc::BindingType _binding;
 };
 
-#define BIND_SYNC(name)   auto name = ServerBinder(# name, Server, true)
-#define BIND_ASYNC(name)  auto name = ServerBinder(# name, Server, false)
+#define BIND_SYNC(name)       auto name = ServerBinder(# name, Server, carla::rpc::BindingType::Sync)
+#define BIND_ASYNC(name)      auto name = ServerBinder(# name, Server, carla::rpc::BindingType::Async)
+/// Read-only calls run in worker threads, they can only use the ReadOnlyState.
+#define BIND_READ_ONLY(name)  auto name = ServerBinder(# name, Server, carla::rpc::BindingType::ReadOnly)
+
+#define REQUIRE_READ_ONLY_STATE(state) \
+    auto state = ReadOnlyState.load(); \
+    if (state == nullptr) { RESPOND_ERROR("episode not ready"); }
+
+// =============================================================================
+// -- Read-only state ----------------------------------------------------------
+// =============================================================================
+
+void FCarlaServer::FPimpl::PublishReadOnlyState()
+{
+  namespace cr = carla::rpc;
+  namespace cg = carla::geom;
+  CARLA_ENSURE_GAME_THREAD();
+  if (Episode == nullptr)
+  {
+    ReadOnlyState.reset();
+    return;
+  }
+  auto State = std::make_shared<FReadOnlyState>();
+  State->EpisodeInfo = cr::EpisodeInfo{Episode->GetId(), BroadcastStream.token()};
+
+  ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(Episode->GetWorld());
+  const auto &SpawnPoints = Episode->GetRecommendedSpawnPoints();
+  State->FullMapPath = GameMode->GetFullMapPath();
+  State->MapName = Episode->GetMapName();
+  FString MapDir = State->FullMapPath.RightChop(State->FullMapPath.Find("Content/", ESearchCase::CaseSensitive) + 8);
+  MapDir += "/" + State->MapName;
+  State->MapInfo = cr::MapInfo{
+    cr::FromFString(MapDir),
+    MakeVectorFromTArray<cg::Transform>(SpawnPoints)};
+
+  State->MapData = cr::FromLongFString(UOpenDrive::GetXODR(Episode->GetWorld()));
+  const auto &Map = GameMode->GetMap();
+  if (Map.has_value())
+  {
+    State->MapSnapshot = carla::road::MapSnapshot::Write(
+        *Map,
+        carla::road::MapSnapshot::ComputeChecksum(State->MapData));
+  }
+  State->ActorDefinitions = MakeVectorFromTArray<cr::ActorDefinition>(Episode->GetActorDefinitions());
+  ReadOnlyState = std::move(State);
+}
 
 // =============================================================================
 // -- Bind Actions -------------------------------------------------------------
@@ -269,6 +352,12 @@ void FCarlaServer::FPimpl::BindActions()
     return Current + 1;
   };
 
+  BIND_ASYNC(request_episode_state_keyframe) << [this]() -> R<void>
+  {
+    EpisodeStateKeyframeRequested.store(true, std::memory_order_release);
+    return R<void>::Success();
+  };
+
   // ~~ Load new episode ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_ASYNC(get_available_maps) << [this]() -> R<std::vector<std::string>>
@@ -444,29 +533,32 @@ void FCarlaServer::FPimpl::BindActions()
 
   // ~~ Episode settings and info ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-  BIND_SYNC(get_episode_info) << [this]() -> R<cr::EpisodeInfo>
+  BIND_READ_ONLY(get_episode_info) << [this]() -> R<cr::EpisodeInfo>
   {
-    REQUIRE_CARLA_EPISODE();
-    return cr::EpisodeInfo{Episode->GetId(), BroadcastStream.token()};
+    REQUIRE_READ_ONLY_STATE(State);
+    return State->EpisodeInfo;
   };
 
-  BIND_SYNC(get_map_info) << [this]() -> R<cr::MapInfo>
+  BIND_READ_ONLY(get_map_info) << [this]() -> R<cr::MapInfo>
   {
-    REQUIRE_CARLA_EPISODE();
-    ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(Episode->GetWorld());
-    const auto &SpawnPoints = Episode->GetRecommendedSpawnPoints();
-    FString FullMapPath = GameMode->GetFullMapPath();
-    FString MapDir = FullMapPath.RightChop(FullMapPath.Find("Content/", ESearchCase::CaseSensitive) + 8);
-    MapDir += "/" + Episode->GetMapName();
-    return cr::MapInfo{
-      cr::FromFString(MapDir),
-      MakeVectorFromTArray<cg::Transform>(SpawnPoints)};
+    REQUIRE_READ_ONLY_STATE(State);
+    return State->MapInfo;
   };
 
-  BIND_SYNC(get_map_data) << [this]() -> R<std::string>
+  BIND_READ_ONLY(get_map_data) << [this]() -> R<std::string>
   {
-    REQUIRE_CARLA_EPISODE();
-    return cr::FromLongFString(UOpenDrive::GetXODR(Episode->GetWorld()));
+    REQUIRE_READ_ONLY_STATE(State);
+    return State->MapData;
+  };
+
+  BIND_READ_ONLY(get_map_snapshot) << [this]() -> R<std::vector<uint8_t>>
+  {
+    REQUIRE_READ_ONLY_STATE(State);
+    if (State->MapSnapshot.empty())
+    {
+      RESPOND_ERROR("map not available");
+    }
+    return State->MapSnapshot;
   };
 
   BIND_SYNC(get_navigation_mesh) << [this]() -> R<std::vector<uint8_t>>
@@ -479,9 +571,9 @@ void FCarlaServer::FPimpl::BindActions()
     return Result;
   };
 
-  BIND_SYNC(get_required_files) << [this](std::string folder = "") -> R<std::vector<std::string>>
+  BIND_READ_ONLY(get_required_files) << [this](std::string folder = "") -> R<std::vector<std::string>>
   {
-    REQUIRE_CARLA_EPISODE();
+    REQUIRE_READ_ONLY_STATE(State);
 
     // Check that the path ends in a slash, add it otherwise
     if (folder[folder.size() - 1] != '/' && folder[folder.size() - 1] != '\\') {
@@ -489,10 +581,9 @@ void FCarlaServer::FPimpl::BindActions()
     }
 
     // Get the map's folder absolute path and check if it's in its own folder
-    ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(Episode->GetWorld());
-    const auto mapDir = GameMode->GetFullMapPath();
+    const auto &mapDir = State->FullMapPath;
     const auto folderDir = mapDir + "/" + folder.c_str();
-    const auto fileName = mapDir.EndsWith(Episode->GetMapName()) ? "*" : Episode->GetMapName();
+    const auto fileName = mapDir.EndsWith(State->MapName) ? "*" : State->MapName;
 
     // Find all the xodr and bin files from the map
     TArray<FString> Files;
@@ -540,10 +631,10 @@ void FCarlaServer::FPimpl::BindActions()
     return FCarlaEngine::GetFrameCounter();
   };
 
-  BIND_SYNC(get_actor_definitions) << [this]() -> R<std::vector<cr::ActorDefinition>>
+  BIND_READ_ONLY(get_actor_definitions) << [this]() -> R<std::vector<cr::ActorDefinition>>
   {
-    REQUIRE_CARLA_EPISODE();
-    return MakeVectorFromTArray<cr::ActorDefinition>(Episode->GetActorDefinitions());
+    REQUIRE_READ_ONLY_STATE(State);
+    return State->ActorDefinitions;
   };
 
   BIND_SYNC(get_spectator) << [this]() -> R<cr::Actor>
@@ -2332,6 +2423,41 @@ void FCarlaServer::FPimpl::BindActions()
     return result;
   };
 
+  BIND_SYNC(apply_vehicle_control_batch) << [=](
+      const cr::VehicleControlBatch &Batch,
+      bool do_tick_cue) -> R<std::vector<ActorId>>
+  {
+    REQUIRE_CARLA_EPISODE();
+    // Actors whose control or light state could not be applied.
+    std::vector<ActorId> Failed;
+    for (size_t i = 0u; i < Batch.size(); ++i)
+    {
+      const ActorId Id = Batch.GetActorId(i);
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(Id);
+      if (!CarlaActor ||
+          CarlaActor->ApplyControlToVehicle(Batch.GetControl(i), EVehicleInputPriority::Client) != ECarlaServerResponse::Success)
+      {
+        Failed.emplace_back(Id);
+      }
+    }
+    for (size_t i = 0u; i < Batch.GetNumberOfLightStates(); ++i)
+    {
+      const ActorId Id = Batch.GetLightStateActorId(i);
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(Id);
+      const cr::VehicleLightState LightState(Batch.GetLightState(i));
+      if (!CarlaActor ||
+          CarlaActor->SetVehicleLightState(FVehicleLightState(LightState)) != ECarlaServerResponse::Success)
+      {
+        Failed.emplace_back(Id);
+      }
+    }
+    if (do_tick_cue)
+    {
+      tick_cue();
+    }
+    return Failed;
+  };
+
   // ~~ Light Subsystem ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_SYNC(query_lights_state) << [this](std::string client) -> R<std::vector<cr::LightState>>
@@ -2415,8 +2541,10 @@ void FCarlaServer::FPimpl::BindActions()
 // -- Undef helper macros ------------------------------------------------------
 // =============================================================================
 
+#undef BIND_READ_ONLY
 #undef BIND_ASYNC
 #undef BIND_SYNC
+#undef REQUIRE_READ_ONLY_STATE
 #undef REQUIRE_CARLA_EPISODE
 #undef RESPOND_ERROR_FSTRING
 #undef RESPOND_ERROR
@@ -2453,12 +2581,14 @@ void FCarlaServer::NotifyBeginEpisode(UCarlaEpisode &Episode)
   check(Pimpl != nullptr);
   UE_LOG(LogCarlaServer, Log, TEXT("New episode '%s' started"), *Episode.GetMapName());
   Pimpl->Episode = &Episode;
+  Pimpl->PublishReadOnlyState();
 }
 
 void FCarlaServer::NotifyEndEpisode()
 {
   check(Pimpl != nullptr);
   Pimpl->Episode = nullptr;
+  Pimpl->PublishReadOnlyState();
 }
 
 void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
@@ -2467,6 +2597,7 @@ void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
   /// @todo Define better the number of threads each server gets.
   int ThreadsPerServer = std::max(2u, NumberOfWorkerThreads / 3u);
   int32_t RPCThreads;
+  int32_t RPCReadOnlyThreads;
   int32_t StreamingThreads;
   int32_t SecondaryThreads;
 
@@ -2476,6 +2607,10 @@ void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
   {
     RPCThreads = ThreadsPerServer;
   }
+  if(!FParse::Value(FCommandLine::Get(), TEXT("-RPCReadOnlyThreads="), RPCReadOnlyThreads))
+  {
+    RPCReadOnlyThreads = ThreadsPerServer;
+  }
   if(!FParse::Value(FCommandLine::Get(), TEXT("-StreamingThreads="), StreamingThreads))
   {
     StreamingThreads = ThreadsPerServer;
@@ -2485,10 +2620,17 @@ void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
     SecondaryThreads = ThreadsPerServer;
   }
 
-  UE_LOG(LogCarla, Log, TEXT("FCarlaServer AsyncRun %d, RPCThreads %d, StreamingThreads %d, SecondaryThreads %d"),
-        NumberOfWorkerThreads, RPCThreads, StreamingThreads, SecondaryThreads);
+  UE_LOG(LogCarla, Log, TEXT("FCarlaServer AsyncRun %d, RPCThreads %d, RPCReadOnlyThreads %d, StreamingThreads %d, SecondaryThreads %d"),
+        NumberOfWorkerThreads, RPCThreads, RPCReadOnlyThreads, StreamingThreads, SecondaryThreads);
 
-  Pimpl->Server.AsyncRun(RPCThreads);
+  // Sensor data goes through shared memory for clients on the same host.
+  if (FParse::Param(FCommandLine::Get(), TEXT("-carla-streaming-shm")))
+  {
+    UE_LOG(LogCarla, Log, TEXT("FCarlaServer streaming through shared memory for local clients"));
+    Pimpl->StreamingServer.SetSharedMemory(true);
+  }
+
+  Pimpl->Server.AsyncRun(RPCThreads, RPCReadOnlyThreads);
   Pimpl->StreamingServer.AsyncRun(StreamingThreads);
   Pimpl->SecondaryServer->AsyncRun(SecondaryThreads);
 }
@@ -2513,12 +2655,26 @@ bool FCarlaServer::TickCueReceived()
   return flag;
 }
 
+bool FCarlaServer::EpisodeStateKeyframeRequested()
+{
+  return Pimpl->EpisodeStateKeyframeRequested.exchange(false, std::memory_order_acquire);
+}
+
 void FCarlaServer::Stop()
 {
   if (Pimpl)
   {
     Pimpl->Server.Stop();
     Pimpl->SecondaryServer->Stop();
+    for (const auto &Stats : Pimpl->Server.GetEndpointStats())
+    {
+      if (Stats.calls > 0u)
+      {
+        UE_LOG(LogCarlaServer, Log, TEXT("RPC %s: %llu calls, mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms"),
+            UTF8_TO_TCHAR(Stats.name.c_str()), Stats.calls, Stats.mean, Stats.p50, Stats.p99, Stats.maximum);
+      }
+    }
+    Pimpl->Server.ResetEndpointStats();
   }
 }
 
@@ -40,6 +40,10 @@ public:
   
   bool TickCueReceived();
 
+  /// Whether a client requested an episode state keyframe since the last
+  /// call.
+  bool EpisodeStateKeyframeRequested();
+
   void Stop();
 
   FDataStream OpenStream() const;